@@ -0,0 +1,550 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+//
+//  Imports.
+//
+#include "harness.h"
+
+#include <xap/core/buffer/buffer.h>
+#include <xap/core/buffer/checksum.h>
+#include <xap/core/buffer/fetcher.h>
+#include <xap/core/buffer/parallel.h>
+#include <xap/core/buffer/queue.h>
+#include <xap/core/buffer/writer.h>
+#include <string>
+#include <utility>
+
+using xap::bench::BenchState;
+using xap::bench::do_not_optimize;
+using xap::bench::register_bench;
+using xap::core::buffer::Buffer;
+using xap::core::buffer::BufferAdler32;
+using xap::core::buffer::BufferCrc32;
+using xap::core::buffer::BufferCrc32c;
+using xap::core::buffer::BufferFetcher;
+using xap::core::buffer::BufferQueue;
+using xap::core::buffer::BufferThreadPool;
+using xap::core::buffer::BufferWriter;
+using xap::core::buffer::BufferXxh64;
+
+//
+//  Constants.
+//
+
+//  The chunk sizes (64 B - 1 MiB).
+static const size_t BENCH_CHUNK_SIZES[] = {64U, 1024U, 65536U, 1048576U};
+
+//  The size of the buffers of parallel operations (64 MiB).
+static const size_t BENCH_PARALLEL_SIZE = 67108864U;
+
+//  The size of the buffer accessed by typed reads / writes (fits in L1).
+static const size_t BENCH_TYPED_SIZE = 4096U;
+
+//  The count of values in the buffer accessed by typed reads / writes.
+static const size_t BENCH_TYPED_SLOTS = BENCH_TYPED_SIZE / 8U;
+
+//
+//  Private functions.
+//
+
+/**
+ *  Get the name with the size suffix.
+ *
+ *  @param name
+ *      The name.
+ *  @param size
+ *      The size.
+ *  @return
+ *      The name (e.g. "buffer/copy/64").
+ */
+static std::string bench_name(const char *name, const size_t size) {
+    return std::string(name) + "/" + std::to_string(size);
+}
+
+/**
+ *  Benchmark a typed read of Buffer.
+ *
+ *  @param state
+ *      The state.
+ */
+template <class T, T (Buffer::*Reader)(const size_t) const>
+static void bench_read(BenchState &state) {
+    Buffer buffer(BENCH_TYPED_SIZE);
+    state.begin();
+    for (size_t i = 0U; i < state.get_iterations(); ++i) {
+        const size_t offset = (i & (BENCH_TYPED_SLOTS - 1U)) * 8U;
+        do_not_optimize((buffer.*Reader)(offset));
+    }
+}
+
+/**
+ *  Benchmark a typed write of Buffer.
+ *
+ *  @param state
+ *      The state.
+ */
+template <class T, void (Buffer::*Writer)(const T, const size_t)>
+static void bench_write(BenchState &state) {
+    Buffer buffer(BENCH_TYPED_SIZE);
+    state.begin();
+    for (size_t i = 0U; i < state.get_iterations(); ++i) {
+        const size_t offset = (i & (BENCH_TYPED_SLOTS - 1U)) * 8U;
+        (buffer.*Writer)(static_cast<T>(i), offset);
+    }
+    do_not_optimize(buffer.get_pointer()[0U]);
+}
+
+/**
+ *  Register the benchmarks of Buffer.
+ */
+static void bench_register_buffer() {
+    for (const size_t size : BENCH_CHUNK_SIZES) {
+        register_bench(
+            bench_name("buffer/construct", size),
+            size,
+            [size](BenchState &state) {
+                state.begin();
+                for (size_t i = 0U; i < state.get_iterations(); ++i) {
+                    Buffer buffer(size, true);
+                    do_not_optimize(buffer.get_pointer());
+                }
+            }
+        );
+        register_bench(
+            bench_name("buffer/construct_zeroed", size),
+            size,
+            [size](BenchState &state) {
+                state.begin();
+                for (size_t i = 0U; i < state.get_iterations(); ++i) {
+                    Buffer buffer(size);
+                    do_not_optimize(buffer.get_pointer());
+                }
+            }
+        );
+        register_bench(
+            bench_name("buffer/copy", size),
+            size,
+            [size](BenchState &state) {
+                Buffer source(size);
+                Buffer destination(size, true);
+                state.begin();
+                for (size_t i = 0U; i < state.get_iterations(); ++i) {
+                    do_not_optimize(source.copy(destination));
+                }
+            }
+        );
+        register_bench(
+            bench_name("buffer/concat4", size),
+            size * 4U,
+            [size](BenchState &state) {
+                const Buffer parts[] = {
+                    Buffer(size), Buffer(size), Buffer(size), Buffer(size)
+                };
+                state.begin();
+                for (size_t i = 0U; i < state.get_iterations(); ++i) {
+                    Buffer joined = Buffer::concat(parts, 4U);
+                    do_not_optimize(joined.get_pointer());
+                }
+            }
+        );
+    }
+
+    register_bench("buffer/slice", 0U, [](BenchState &state) {
+        Buffer buffer(BENCH_TYPED_SIZE);
+        state.begin();
+        for (size_t i = 0U; i < state.get_iterations(); ++i) {
+            Buffer sliced = buffer.slice(i & 0xFFU, 256U);
+            do_not_optimize(sliced.get_pointer());
+        }
+    });
+    register_bench("buffer/copy_construct", 0U, [](BenchState &state) {
+        Buffer buffer(BENCH_TYPED_SIZE);
+        state.begin();
+        for (size_t i = 0U; i < state.get_iterations(); ++i) {
+            Buffer copied(buffer);
+            do_not_optimize(copied.get_pointer());
+        }
+    });
+
+    register_bench(
+        "buffer/read_uint8", 1U, bench_read<uint8_t, &Buffer::read_uint8>
+    );
+    register_bench(
+        "buffer/read_uint16_be", 2U,
+        bench_read<uint16_t, &Buffer::read_uint16_be>
+    );
+    register_bench(
+        "buffer/read_uint16_le", 2U,
+        bench_read<uint16_t, &Buffer::read_uint16_le>
+    );
+    register_bench(
+        "buffer/read_sint16_le", 2U,
+        bench_read<int16_t, &Buffer::read_sint16_le>
+    );
+    register_bench(
+        "buffer/read_uint32_be", 4U,
+        bench_read<uint32_t, &Buffer::read_uint32_be>
+    );
+    register_bench(
+        "buffer/read_uint32_le", 4U,
+        bench_read<uint32_t, &Buffer::read_uint32_le>
+    );
+    register_bench(
+        "buffer/read_uint64_be", 8U,
+        bench_read<uint64_t, &Buffer::read_uint64_be>
+    );
+    register_bench(
+        "buffer/read_uint64_le", 8U,
+        bench_read<uint64_t, &Buffer::read_uint64_le>
+    );
+    register_bench(
+        "buffer/read_float_be", 4U,
+        bench_read<float, &Buffer::read_float_be>
+    );
+    register_bench(
+        "buffer/read_float_le", 4U,
+        bench_read<float, &Buffer::read_float_le>
+    );
+    register_bench(
+        "buffer/read_double_be", 8U,
+        bench_read<double, &Buffer::read_double_be>
+    );
+    register_bench(
+        "buffer/read_double_le", 8U,
+        bench_read<double, &Buffer::read_double_le>
+    );
+
+    register_bench(
+        "buffer/write_uint8", 1U, bench_write<uint8_t, &Buffer::write_uint8>
+    );
+    register_bench(
+        "buffer/write_uint16_be", 2U,
+        bench_write<uint16_t, &Buffer::write_uint16_be>
+    );
+    register_bench(
+        "buffer/write_uint16_le", 2U,
+        bench_write<uint16_t, &Buffer::write_uint16_le>
+    );
+    register_bench(
+        "buffer/write_uint32_be", 4U,
+        bench_write<uint32_t, &Buffer::write_uint32_be>
+    );
+    register_bench(
+        "buffer/write_uint32_le", 4U,
+        bench_write<uint32_t, &Buffer::write_uint32_le>
+    );
+    register_bench(
+        "buffer/write_uint64_be", 8U,
+        bench_write<uint64_t, &Buffer::write_uint64_be>
+    );
+    register_bench(
+        "buffer/write_uint64_le", 8U,
+        bench_write<uint64_t, &Buffer::write_uint64_le>
+    );
+    register_bench(
+        "buffer/write_float_be", 4U,
+        bench_write<float, &Buffer::write_float_be>
+    );
+    register_bench(
+        "buffer/write_float_le", 4U,
+        bench_write<float, &Buffer::write_float_le>
+    );
+    register_bench(
+        "buffer/write_double_be", 8U,
+        bench_write<double, &Buffer::write_double_be>
+    );
+    register_bench(
+        "buffer/write_double_le", 8U,
+        bench_write<double, &Buffer::write_double_le>
+    );
+}
+
+/**
+ *  Register the benchmarks of BufferFetcher.
+ */
+static void bench_register_fetcher() {
+    register_bench("fetcher/fetch", 1U, [](BenchState &state) {
+        const Buffer buffer(BENCH_TYPED_SIZE);
+        BufferFetcher fetcher(buffer);
+        state.begin();
+        for (size_t i = 0U; i < state.get_iterations(); ++i) {
+            if (fetcher.is_end()) {
+                fetcher.reset();
+            }
+            do_not_optimize(fetcher.fetch());
+        }
+    });
+    register_bench("fetcher/fetch_uint32_be", 4U, [](BenchState &state) {
+        const Buffer buffer(BENCH_TYPED_SIZE);
+        BufferFetcher fetcher(buffer);
+        state.begin();
+        for (size_t i = 0U; i < state.get_iterations(); ++i) {
+            if (fetcher.is_end()) {
+                fetcher.reset();
+            }
+            do_not_optimize(fetcher.fetch_uint32_be());
+        }
+    });
+
+    for (const size_t size : BENCH_CHUNK_SIZES) {
+        register_bench(
+            bench_name("fetcher/fetch_to", size),
+            size,
+            [size](BenchState &state) {
+                const Buffer buffer(size * 4U);
+                BufferFetcher fetcher(buffer);
+                Buffer destination(size, true);
+                state.begin();
+                for (size_t i = 0U; i < state.get_iterations(); ++i) {
+                    if (fetcher.is_end()) {
+                        fetcher.reset();
+                    }
+                    do_not_optimize(fetcher.fetch_to(destination));
+                }
+            }
+        );
+        register_bench(
+            bench_name("fetcher/fetch_bytes", size),
+            size,
+            [size](BenchState &state) {
+                const Buffer buffer(size * 4U);
+                BufferFetcher fetcher(buffer);
+                state.begin();
+                for (size_t i = 0U; i < state.get_iterations(); ++i) {
+                    if (fetcher.is_end()) {
+                        fetcher.reset();
+                    }
+                    Buffer fetched = fetcher.fetch_bytes(size);
+                    do_not_optimize(fetched.get_pointer());
+                }
+            }
+        );
+    }
+}
+
+/**
+ *  Register the benchmarks of BufferQueue.
+ */
+static void bench_register_queue() {
+    for (const size_t size : BENCH_CHUNK_SIZES) {
+        register_bench(
+            bench_name("queue/push_pop", size),
+            size,
+            [size](BenchState &state) {
+                BufferQueue queue;
+                const Buffer chunk(size);
+                state.begin();
+                for (size_t i = 0U; i < state.get_iterations(); ++i) {
+                    queue.push(chunk);
+                    Buffer popped = queue.pop(size);
+                    do_not_optimize(popped.get_pointer());
+                }
+            }
+        );
+        register_bench(
+            bench_name("queue/push_pop_view", size),
+            size,
+            [size](BenchState &state) {
+                BufferQueue queue;
+                const Buffer chunk(size);
+                state.begin();
+                for (size_t i = 0U; i < state.get_iterations(); ++i) {
+                    queue.push(chunk);
+                    Buffer popped = queue.pop_view(size);
+                    do_not_optimize(popped.get_pointer());
+                }
+            }
+        );
+        register_bench(
+            bench_name("queue/push_pop_straddled", size),
+            size,
+            [size](BenchState &state) {
+                //  Each pop spans two chunks.
+                BufferQueue queue;
+                const Buffer chunk(size);
+                queue.push(chunk.slice(0U, size / 2U));
+                state.begin();
+                for (size_t i = 0U; i < state.get_iterations(); ++i) {
+                    queue.push(chunk);
+                    Buffer popped = queue.pop(size);
+                    do_not_optimize(popped.get_pointer());
+                }
+            }
+        );
+    }
+
+    register_bench("queue/pop_uint32_be", 4U, [](BenchState &state) {
+        BufferQueue queue;
+        const Buffer chunk(BENCH_TYPED_SIZE);
+        state.begin();
+        for (size_t i = 0U; i < state.get_iterations(); ++i) {
+            if (queue.get_remaining_size() < 4U) {
+                queue.push(chunk);
+            }
+            do_not_optimize(queue.pop_uint32_be());
+        }
+    });
+}
+
+/**
+ *  Register the benchmarks of BufferWriter.
+ */
+static void bench_register_writer() {
+    register_bench("writer/write_uint32_be", 4U, [](BenchState &state) {
+        BufferWriter writer(BENCH_TYPED_SIZE);
+        state.begin();
+        for (size_t i = 0U; i < state.get_iterations(); ++i) {
+            if (writer.get_length() == BENCH_TYPED_SIZE) {
+                writer.clear();
+            }
+            writer.write_uint32_be(static_cast<uint32_t>(i));
+        }
+        do_not_optimize(writer.get_length());
+    });
+    register_bench("writer/write_varint", 0U, [](BenchState &state) {
+        BufferWriter writer(BENCH_TYPED_SIZE);
+        state.begin();
+        for (size_t i = 0U; i < state.get_iterations(); ++i) {
+            if (writer.get_length() > BENCH_TYPED_SIZE - 10U) {
+                writer.clear();
+            }
+            writer.write_varint(static_cast<uint64_t>(i) * 2654435761U);
+        }
+        do_not_optimize(writer.get_length());
+    });
+}
+
+/**
+ *  Benchmark a checksum over a buffer.
+ *
+ *  @param state
+ *      The state.
+ *  @param size
+ *      The size of the buffer.
+ */
+template <class T>
+static void bench_checksum(BenchState &state, const size_t size) {
+    Buffer buffer(size);
+    state.begin();
+    for (size_t i = 0U; i < state.get_iterations(); ++i) {
+        T checksum;
+        checksum.update(buffer);
+        do_not_optimize(checksum.get_value());
+    }
+}
+
+/**
+ *  Register the benchmarks of the checksums.
+ */
+static void bench_register_checksum() {
+    for (const size_t size : BENCH_CHUNK_SIZES) {
+        register_bench(
+            bench_name("checksum/crc32", size),
+            size,
+            [size](BenchState &state) {
+                bench_checksum<BufferCrc32>(state, size);
+            }
+        );
+        register_bench(
+            bench_name("checksum/crc32c", size),
+            size,
+            [size](BenchState &state) {
+                bench_checksum<BufferCrc32c>(state, size);
+            }
+        );
+        register_bench(
+            bench_name("checksum/adler32", size),
+            size,
+            [size](BenchState &state) {
+                bench_checksum<BufferAdler32>(state, size);
+            }
+        );
+        register_bench(
+            bench_name("checksum/xxh64", size),
+            size,
+            [size](BenchState &state) {
+                bench_checksum<BufferXxh64>(state, size);
+            }
+        );
+    }
+}
+
+//
+//  Entry.
+//
+/**
+ *  Register the benchmarks of parallel operations (against the serial
+ *  ones).
+ */
+static void bench_register_parallel() {
+    register_bench(
+        "parallel/copy-serial",
+        BENCH_PARALLEL_SIZE,
+        [](BenchState &state) {
+            const Buffer src(BENCH_PARALLEL_SIZE);
+            Buffer dst(BENCH_PARALLEL_SIZE);
+            state.begin();
+            for (size_t i = 0U; i < state.get_iterations(); ++i) {
+                do_not_optimize(src.copy(dst));
+            }
+        }
+    );
+    register_bench(
+        "parallel/copy",
+        BENCH_PARALLEL_SIZE,
+        [](BenchState &state) {
+            BufferThreadPool pool;
+            const Buffer src(BENCH_PARALLEL_SIZE);
+            Buffer dst(BENCH_PARALLEL_SIZE);
+            state.begin();
+            for (size_t i = 0U; i < state.get_iterations(); ++i) {
+                do_not_optimize(
+                    xap::core::buffer::buffer_parallel_copy(src, dst, pool)
+                );
+            }
+        }
+    );
+    register_bench(
+        "parallel/fill-serial",
+        BENCH_PARALLEL_SIZE,
+        [](BenchState &state) {
+            Buffer buffer(BENCH_PARALLEL_SIZE);
+            state.begin();
+            for (size_t i = 0U; i < state.get_iterations(); ++i) {
+                buffer.fill(static_cast<uint8_t>(i));
+            }
+            do_not_optimize(buffer[0U]);
+        }
+    );
+    register_bench(
+        "parallel/fill",
+        BENCH_PARALLEL_SIZE,
+        [](BenchState &state) {
+            BufferThreadPool pool;
+            Buffer buffer(BENCH_PARALLEL_SIZE);
+            state.begin();
+            for (size_t i = 0U; i < state.get_iterations(); ++i) {
+                xap::core::buffer::buffer_parallel_fill(
+                    buffer,
+                    static_cast<uint8_t>(i),
+                    pool
+                );
+            }
+            do_not_optimize(buffer[0U]);
+        }
+    );
+}
+
+int main(int argc, char *argv[]) {
+    bench_register_buffer();
+    bench_register_fetcher();
+    bench_register_queue();
+    bench_register_writer();
+    bench_register_checksum();
+    bench_register_parallel();
+    return xap::bench::run_benches(argc, argv);
+}
@@ -0,0 +1,442 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+//
+//  Imports.
+//
+#include "harness.h"
+
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <utility>
+#include <vector>
+
+//
+//  Private variables.
+//
+
+//  The count of global operator new calls.
+static std::atomic<size_t> g_bench_allocations(0U);
+
+//
+//  Global operators (count the allocations).
+//
+
+void* operator new(size_t size) {
+    g_bench_allocations.fetch_add(1U, std::memory_order_relaxed);
+    void *pointer = malloc(size == 0U ? 1U : size);
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new[](size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void *pointer) noexcept {
+    free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept {
+    free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+    free(pointer);
+}
+
+void operator delete[](void *pointer, size_t) noexcept {
+    free(pointer);
+}
+
+namespace xap {
+namespace bench {
+
+//
+//  Private structures.
+//
+
+//
+//  Registered benchmark.
+//
+struct BenchEntry {
+    std::string     name;
+    size_t          bytes_per_op;
+    BenchFunction   function;
+};
+
+//
+//  Result of a benchmark.
+//
+struct BenchResult {
+    std::string     name;
+    size_t          iterations;
+    double          ns_per_op;
+    double          bytes_per_second;
+    double          allocations_per_op;
+};
+
+//
+//  Output format.
+//
+enum BenchFormat {
+    BENCH_FORMAT_TABLE,
+    BENCH_FORMAT_CSV,
+    BENCH_FORMAT_JSON
+};
+
+//
+//  Private functions declare.
+//
+
+/**
+ *  Get the registered benchmarks.
+ *
+ *  @return
+ *      The benchmarks.
+ */
+static std::vector<BenchEntry>& bench_get_entries();
+
+/**
+ *  Get the time of a monotonic clock.
+ *
+ *  @return
+ *      The time (in nanoseconds).
+ */
+static uint64_t bench_get_time() noexcept;
+
+/**
+ *  Run a benchmark until it takes at least 'min_time' nanoseconds.
+ *
+ *  @param entry
+ *      The benchmark.
+ *  @param min_time
+ *      The minimum time of the measured run (in nanoseconds).
+ *  @return
+ *      The result.
+ */
+static BenchResult bench_run(const BenchEntry &entry, const uint64_t min_time);
+
+/**
+ *  Print a result.
+ *
+ *  @param result
+ *      The result.
+ *  @param format
+ *      The output format.
+ *  @param first
+ *      True if it is the first result.
+ */
+static void bench_print(
+    const BenchResult   &result,
+    const BenchFormat   format,
+    const bool          first
+);
+
+//
+//  BenchState constructor.
+//
+
+/**
+ *  Construct the object.
+ *
+ *  @param iterations
+ *      The count of operations to run.
+ */
+BenchState::BenchState(const size_t iterations) noexcept :
+    m_iterations(iterations),
+    m_begin_time(bench_get_time()),
+    m_begin_allocations(get_allocations())
+{
+    //  Do nothing.
+}
+
+//
+//  BenchState public methods.
+//
+
+/**
+ *  Get the count of operations to run.
+ *
+ *  @return
+ *      The count.
+ */
+size_t BenchState::get_iterations() const noexcept {
+    return this->m_iterations;
+}
+
+/**
+ *  Mark the end of the setup (the time and the allocations before are
+ *  not measured).
+ */
+void BenchState::begin() noexcept {
+    this->m_begin_allocations = get_allocations();
+    this->m_begin_time = bench_get_time();
+}
+
+/**
+ *  Get the time when the measurement began.
+ *
+ *  @return
+ *      The time (in nanoseconds, from a monotonic clock).
+ */
+uint64_t BenchState::get_begin_time() const noexcept {
+    return this->m_begin_time;
+}
+
+/**
+ *  Get the count of allocations when the measurement began.
+ *
+ *  @return
+ *      The count.
+ */
+size_t BenchState::get_begin_allocations() const noexcept {
+    return this->m_begin_allocations;
+}
+
+//
+//  Public functions.
+//
+
+/**
+ *  Register a benchmark.
+ *
+ *  @param name
+ *      The name (e.g. "queue/push_pop/64").
+ *  @param bytes_per_op
+ *      The count of bytes processed by each operation (0 if not
+ *      meaningful).
+ *  @param function
+ *      The benchmark body.
+ */
+void register_bench(
+    const std::string   &name,
+    const size_t        bytes_per_op,
+    BenchFunction       function
+) {
+    bench_get_entries().push_back(
+        BenchEntry{name, bytes_per_op, std::move(function)}
+    );
+}
+
+/**
+ *  Run the registered benchmarks and report the results.
+ *
+ *  @note
+ *      Options: '--format=table|csv|json', '--filter=<substring>' and
+ *      '--min-time=<milliseconds>' (default 100).
+ *  @param argc
+ *      The count of command line arguments.
+ *  @param argv
+ *      The command line arguments.
+ *  @return
+ *      The exit code.
+ */
+int run_benches(int argc, char *argv[]) {
+    BenchFormat format = BENCH_FORMAT_TABLE;
+    std::string filter;
+    uint64_t min_time = 100000000U;
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        if (strcmp(arg, "--format=table") == 0) {
+            format = BENCH_FORMAT_TABLE;
+        } else if (strcmp(arg, "--format=csv") == 0) {
+            format = BENCH_FORMAT_CSV;
+        } else if (strcmp(arg, "--format=json") == 0) {
+            format = BENCH_FORMAT_JSON;
+        } else if (strncmp(arg, "--filter=", 9U) == 0) {
+            filter = arg + 9U;
+        } else if (strncmp(arg, "--min-time=", 11U) == 0) {
+            min_time = strtoull(arg + 11U, nullptr, 10) * 1000000U;
+        } else {
+            fprintf(
+                stderr,
+                "Usage: %s [--format=table|csv|json] [--filter=<substring>] "
+                "[--min-time=<milliseconds>]\n",
+                argv[0]
+            );
+            return 1;
+        }
+    }
+
+    bool first = true;
+    for (const BenchEntry &entry : bench_get_entries()) {
+        if (!filter.empty() && entry.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        bench_print(bench_run(entry, min_time), format, first);
+        first = false;
+    }
+    if (format == BENCH_FORMAT_JSON) {
+        printf(first ? "[]\n" : "\n]\n");
+    }
+    return 0;
+}
+
+/**
+ *  Get the count of global operator new calls so far.
+ *
+ *  @return
+ *      The count.
+ */
+size_t get_allocations() noexcept {
+    return g_bench_allocations.load(std::memory_order_relaxed);
+}
+
+//
+//  Private functions.
+//
+
+/**
+ *  Get the registered benchmarks.
+ *
+ *  @return
+ *      The benchmarks.
+ */
+static std::vector<BenchEntry>& bench_get_entries() {
+    static std::vector<BenchEntry> entries;
+    return entries;
+}
+
+/**
+ *  Get the time of a monotonic clock.
+ *
+ *  @return
+ *      The time (in nanoseconds).
+ */
+static uint64_t bench_get_time() noexcept {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()
+        ).count()
+    );
+}
+
+/**
+ *  Run a benchmark until it takes at least 'min_time' nanoseconds.
+ *
+ *  @param entry
+ *      The benchmark.
+ *  @param min_time
+ *      The minimum time of the measured run (in nanoseconds).
+ *  @return
+ *      The result.
+ */
+static BenchResult bench_run(const BenchEntry &entry, const uint64_t min_time) {
+    size_t iterations = 1U;
+    while (true) {
+        BenchState state(iterations);
+        entry.function(state);
+        const uint64_t elapsed = bench_get_time() - state.get_begin_time();
+        const size_t allocations =
+            get_allocations() - state.get_begin_allocations();
+
+        if (elapsed >= min_time || iterations >= (SIZE_MAX >> 4U)) {
+            const double seconds = static_cast<double>(elapsed) / 1e9;
+            BenchResult result;
+            result.name = entry.name;
+            result.iterations = iterations;
+            result.ns_per_op =
+                static_cast<double>(elapsed) / static_cast<double>(iterations);
+            result.bytes_per_second = seconds > 0.0 ?
+                static_cast<double>(entry.bytes_per_op) *
+                    static_cast<double>(iterations) / seconds :
+                0.0;
+            result.allocations_per_op =
+                static_cast<double>(allocations) /
+                static_cast<double>(iterations);
+            return result;
+        }
+
+        //  Predict the count which takes 'min_time' (at most 10x a step).
+        size_t next = iterations * 10U;
+        if (elapsed != 0U) {
+            const double predicted = static_cast<double>(iterations) *
+                static_cast<double>(min_time) * 1.2 /
+                static_cast<double>(elapsed);
+            if (predicted < static_cast<double>(next)) {
+                next = static_cast<size_t>(predicted);
+            }
+        }
+        iterations = next > iterations ? next : iterations + 1U;
+    }
+}
+
+/**
+ *  Print a result.
+ *
+ *  @param result
+ *      The result.
+ *  @param format
+ *      The output format.
+ *  @param first
+ *      True if it is the first result.
+ */
+static void bench_print(
+    const BenchResult   &result,
+    const BenchFormat   format,
+    const bool          first
+) {
+    switch (format) {
+    case BENCH_FORMAT_CSV:
+        if (first) {
+            printf(
+                "name,iterations,ns_per_op,bytes_per_second,allocs_per_op\n"
+            );
+        }
+        printf(
+            "%s,%zu,%.3f,%.0f,%.3f\n",
+            result.name.c_str(),
+            result.iterations,
+            result.ns_per_op,
+            result.bytes_per_second,
+            result.allocations_per_op
+        );
+        break;
+    case BENCH_FORMAT_JSON:
+        printf(
+            "%s\n  {\"name\": \"%s\", \"iterations\": %zu, "
+            "\"ns_per_op\": %.3f, \"bytes_per_second\": %.0f, "
+            "\"allocs_per_op\": %.3f}",
+            first ? "[" : ",",
+            result.name.c_str(),
+            result.iterations,
+            result.ns_per_op,
+            result.bytes_per_second,
+            result.allocations_per_op
+        );
+        break;
+    default:
+        if (first) {
+            printf(
+                "%-40s %14s %12s %12s %10s\n",
+                "name",
+                "iterations",
+                "ns/op",
+                "MiB/s",
+                "allocs/op"
+            );
+        }
+        printf(
+            "%-40s %14zu %12.2f %12.1f %10.2f\n",
+            result.name.c_str(),
+            result.iterations,
+            result.ns_per_op,
+            result.bytes_per_second / 1048576.0,
+            result.allocations_per_op
+        );
+        break;
+    }
+}
+
+}  //  namespace bench
+}  //  namespace xap
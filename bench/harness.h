@@ -0,0 +1,154 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+#ifndef XAPBENCH_HARNESS_H__
+#define XAPBENCH_HARNESS_H__
+
+//
+//  Imports.
+//
+#include <functional>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+namespace xap {
+namespace bench {
+
+//
+//  Classes.
+//
+
+//
+//  State of one benchmark run.
+//
+class BenchState {
+public:
+    //
+    //  Constructor.
+    //
+
+    /**
+     *  Construct the object.
+     *
+     *  @param iterations
+     *      The count of operations to run.
+     */
+    explicit BenchState(const size_t iterations) noexcept;
+
+    //
+    //  Public methods.
+    //
+
+    /**
+     *  Get the count of operations to run.
+     *
+     *  @return
+     *      The count.
+     */
+    size_t get_iterations() const noexcept;
+
+    /**
+     *  Mark the end of the setup (the time and the allocations before are
+     *  not measured).
+     */
+    void begin() noexcept;
+
+    /**
+     *  Get the time when the measurement began.
+     *
+     *  @return
+     *      The time (in nanoseconds, from a monotonic clock).
+     */
+    uint64_t get_begin_time() const noexcept;
+
+    /**
+     *  Get the count of allocations when the measurement began.
+     *
+     *  @return
+     *      The count.
+     */
+    size_t get_begin_allocations() const noexcept;
+
+private:
+    //
+    //  Members.
+    //
+    size_t      m_iterations;
+    uint64_t    m_begin_time;
+    size_t      m_begin_allocations;
+};
+
+//
+//  Types.
+//
+
+//  The benchmark body (runs 'state.get_iterations()' operations).
+typedef std::function<void(BenchState &state)> BenchFunction;
+
+//
+//  Public functions.
+//
+
+/**
+ *  Register a benchmark.
+ *
+ *  @param name
+ *      The name (e.g. "queue/push_pop/64").
+ *  @param bytes_per_op
+ *      The count of bytes processed by each operation (0 if not
+ *      meaningful).
+ *  @param function
+ *      The benchmark body.
+ */
+void register_bench(
+    const std::string   &name,
+    const size_t        bytes_per_op,
+    BenchFunction       function
+);
+
+/**
+ *  Run the registered benchmarks and report the results.
+ *
+ *  @param argc
+ *      The count of command line arguments.
+ *  @param argv
+ *      The command line arguments.
+ *  @return
+ *      The exit code.
+ */
+int run_benches(int argc, char *argv[]);
+
+/**
+ *  Get the count of global operator new calls so far.
+ *
+ *  @return
+ *      The count.
+ */
+size_t get_allocations() noexcept;
+
+/**
+ *  Prevent the compiler from optimizing away a value.
+ *
+ *  @param value
+ *      The value.
+ */
+template <class T>
+inline void do_not_optimize(const T &value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    const volatile char *pointer =
+        reinterpret_cast<const volatile char*>(&value);
+    (void)*pointer;
+#endif
+}
+
+}  //  namespace bench
+}  //  namespace xap
+
+
+#endif  //  #ifndef XAPBENCH_HARNESS_H__
@@ -0,0 +1,564 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+#ifndef XAP_CORE_BUFFER_ACCESSOR_H__
+#define XAP_CORE_BUFFER_ACCESSOR_H__
+
+//
+//  Imports.
+//
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <xap/core/buffer/build.h>
+#include <xap/core/buffer/endian.h>
+
+namespace xap {
+namespace core {
+namespace buffer {
+
+//
+//  Classes.
+//
+
+//
+//  Unchecked accessor to a validated range of buffer (see Buffer::access()).
+//
+//  The range was checked once when the accessor was created, so the read
+//  and write methods don't check 'offset' (relative to the range start)
+//  and never throw. The accessor doesn't own the memory, the buffer must
+//  outlive it.
+//
+class BufferAccessor {
+public:
+    //
+    //  Constructor.
+    //
+
+    /**
+     *  Construct the object.
+     *
+     *  @param pointer
+     *      The pointer to the first byte of the range.
+     *  @param length
+     *      The length of the range.
+     */
+    BufferAccessor(uint8_t *pointer, const size_t length) noexcept :
+        m_pointer(pointer),
+        m_length(length)
+    {}
+
+    //
+    //  Public methods.
+    //
+
+    /**
+     *  Get the length of the range.
+     *
+     *  @return
+     *      The length.
+     */
+    size_t get_length() const noexcept {
+        return this->m_length;
+    }
+
+    /**
+     *  Get the raw pointer of the range.
+     *
+     *  @return
+     *      The raw pointer.
+     */
+    uint8_t* get_pointer() const noexcept {
+        return this->m_pointer;
+    }
+
+    /**
+     *  Read an unsigned 8-bit integer.
+     *
+     *  @param offset
+     *      The offset.
+     *  @return
+     *      The unsigned 8-bit integer value.
+     */
+    uint8_t read_uint8(const size_t offset = 0U) const noexcept {
+        return this->m_pointer[offset];
+    }
+
+    /**
+     *  Read an unsigned 16-bit integer with big-endian.
+     *
+     *  @param offset
+     *      The offset.
+     *  @return
+     *      The unsigned 16-bit integer.
+     */
+    uint16_t read_uint16_be(const size_t offset = 0U) const noexcept {
+        return endian_read_uint16_be(this->m_pointer + offset);
+    }
+
+    /**
+     *  Read an unsigned 16-bit integer with little-endian.
+     *
+     *  @param offset
+     *      The offset.
+     *  @return
+     *      The unsigned 16-bit integer.
+     */
+    uint16_t read_uint16_le(const size_t offset = 0U) const noexcept {
+        return endian_read_uint16_le(this->m_pointer + offset);
+    }
+
+    /**
+     *  Read a signed 16-bit integer with little-endian.
+     *
+     *  @param offset
+     *      The offset.
+     *  @return
+     *      The signed 16-bit integer.
+     */
+    int16_t read_sint16_le(const size_t offset = 0U) const noexcept {
+        return static_cast<int16_t>(
+            endian_read_uint16_le(this->m_pointer + offset)
+        );
+    }
+
+    /**
+     *  Read an unsigned 32-bit integer with big-endian.
+     *
+     *  @param offset
+     *      The offset.
+     *  @return
+     *      The unsigned 32-bit integer.
+     */
+    uint32_t read_uint32_be(const size_t offset = 0U) const noexcept {
+        return endian_read_uint32_be(this->m_pointer + offset);
+    }
+
+    /**
+     *  Read an unsigned 32-bit integer with little-endian.
+     *
+     *  @param offset
+     *      The offset.
+     *  @return
+     *      The unsigned 32-bit integer.
+     */
+    uint32_t read_uint32_le(const size_t offset = 0U) const noexcept {
+        return endian_read_uint32_le(this->m_pointer + offset);
+    }
+
+#if defined(UINT64_MAX)
+
+    /**
+     *  Read an unsigned 64-bit integer with big-endian.
+     *
+     *  @param offset
+     *      The offset.
+     *  @return
+     *      The unsigned 64-bit integer.
+     */
+    uint64_t read_uint64_be(const size_t offset = 0U) const noexcept {
+        return endian_read_uint64_be(this->m_pointer + offset);
+    }
+
+    /**
+     *  Read an unsigned 64-bit integer with little-endian.
+     *
+     *  @param offset
+     *      The offset.
+     *  @return
+     *      The unsigned 64-bit integer.
+     */
+    uint64_t read_uint64_le(const size_t offset = 0U) const noexcept {
+        return endian_read_uint64_le(this->m_pointer + offset);
+    }
+
+    /**
+     *  Read double-precision float-point with big-endian.
+     *
+     *  @param offset
+     *      The offset.
+     *  @return
+     *      The double-precision float-point value.
+     */
+    double read_double_be(const size_t offset = 0U) const noexcept {
+#if defined(XAP_CORE_BUFFER_IEEE_754)
+        const uint64_t bits = endian_read_uint64_be(this->m_pointer + offset);
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+#else
+        return BufferAccessor::portable_read_double(
+            this->m_pointer + offset,
+            false
+        );
+#endif
+    }
+
+    /**
+     *  Read double-precision float-point with little-endian.
+     *
+     *  @param offset
+     *      The offset.
+     *  @return
+     *      The double-precision float-point value.
+     */
+    double read_double_le(const size_t offset = 0U) const noexcept {
+#if defined(XAP_CORE_BUFFER_IEEE_754)
+        const uint64_t bits = endian_read_uint64_le(this->m_pointer + offset);
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+#else
+        return BufferAccessor::portable_read_double(
+            this->m_pointer + offset,
+            true
+        );
+#endif
+    }
+
+#endif  //  #if defined(UINT64_MAX)
+
+    /**
+     *  Read single-precision float-point with big-endian.
+     *
+     *  @param offset
+     *      The offset.
+     *  @return
+     *      The single-precision float-point value.
+     */
+    float read_float_be(const size_t offset = 0U) const noexcept {
+#if defined(XAP_CORE_BUFFER_IEEE_754)
+        const uint32_t bits = endian_read_uint32_be(this->m_pointer + offset);
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+#else
+        return BufferAccessor::portable_read_float(
+            this->m_pointer + offset,
+            false
+        );
+#endif
+    }
+
+    /**
+     *  Read single-precision float-point with little-endian.
+     *
+     *  @param offset
+     *      The offset.
+     *  @return
+     *      The single-precision float-point value.
+     */
+    float read_float_le(const size_t offset = 0U) const noexcept {
+#if defined(XAP_CORE_BUFFER_IEEE_754)
+        const uint32_t bits = endian_read_uint32_le(this->m_pointer + offset);
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+#else
+        return BufferAccessor::portable_read_float(
+            this->m_pointer + offset,
+            true
+        );
+#endif
+    }
+
+    /**
+     *  Write unsigned 8-bit integer at the specified offset.
+     *
+     *  @param value
+     *      The unsigned 8-bit integer.
+     *  @param offset
+     *      The offset (default 0).
+     */
+    void write_uint8(const uint8_t value, const size_t offset = 0U) noexcept {
+        this->m_pointer[offset] = value;
+    }
+
+    /**
+     *  Write unsigned 16-bit integer with big-endian at the specified offset.
+     *
+     *  @param value
+     *      The unsigned 16-bit integer.
+     *  @param offset
+     *      The offset (default 0).
+     */
+    void write_uint16_be(
+        const uint16_t  value,
+        const size_t    offset = 0U
+    ) noexcept {
+        endian_write_uint16_be(this->m_pointer + offset, value);
+    }
+
+    /**
+     *  Write unsigned 16-bit integer with little-endian at the specified
+     *  offset.
+     *
+     *  @param value
+     *      The unsigned 16-bit integer.
+     *  @param offset
+     *      The offset (default 0).
+     */
+    void write_uint16_le(
+        const uint16_t  value,
+        const size_t    offset = 0U
+    ) noexcept {
+        endian_write_uint16_le(this->m_pointer + offset, value);
+    }
+
+    /**
+     *  Write unsigned 32-bit integer with big-endian at the specified offset.
+     *
+     *  @param value
+     *      The unsigned 32-bit integer.
+     *  @param offset
+     *      The offset (default 0).
+     */
+    void write_uint32_be(
+        const uint32_t  value,
+        const size_t    offset = 0U
+    ) noexcept {
+        endian_write_uint32_be(this->m_pointer + offset, value);
+    }
+
+    /**
+     *  Write unsigned 32-bit integer with little-endian at the specified
+     *  offset.
+     *
+     *  @param value
+     *      The unsigned 32-bit integer.
+     *  @param offset
+     *      The offset (default 0).
+     */
+    void write_uint32_le(
+        const uint32_t  value,
+        const size_t    offset = 0U
+    ) noexcept {
+        endian_write_uint32_le(this->m_pointer + offset, value);
+    }
+
+#if defined(UINT64_MAX)
+
+    /**
+     *  Write unsigned 64-bit integer with big-endian at the specified offset.
+     *
+     *  @param value
+     *      The unsigned 64-bit integer.
+     *  @param offset
+     *      The offset (default 0).
+     */
+    void write_uint64_be(
+        const uint64_t  value,
+        const size_t    offset = 0U
+    ) noexcept {
+        endian_write_uint64_be(this->m_pointer + offset, value);
+    }
+
+    /**
+     *  Write unsigned 64-bit integer with little-endian at the specified
+     *  offset.
+     *
+     *  @param value
+     *      The unsigned 64-bit integer.
+     *  @param offset
+     *      The offset (default 0).
+     */
+    void write_uint64_le(
+        const uint64_t  value,
+        const size_t    offset = 0U
+    ) noexcept {
+        endian_write_uint64_le(this->m_pointer + offset, value);
+    }
+
+    /**
+     *  Write double-precision float-point with big-endian at the specified
+     *  offset.
+     *
+     *  @param value
+     *      The double-precision float-point value.
+     *  @param offset
+     *      The offset (default 0).
+     */
+    void write_double_be(
+        const double    value,
+        const size_t    offset = 0U
+    ) noexcept {
+#if defined(XAP_CORE_BUFFER_IEEE_754)
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        endian_write_uint64_be(this->m_pointer + offset, bits);
+#else
+        BufferAccessor::portable_write_double(
+            this->m_pointer + offset,
+            value,
+            false
+        );
+#endif
+    }
+
+    /**
+     *  Write double-precision float-point with little-endian at the specified
+     *  offset.
+     *
+     *  @param value
+     *      The double-precision float-point value.
+     *  @param offset
+     *      The offset (default 0).
+     */
+    void write_double_le(
+        const double    value,
+        const size_t    offset = 0U
+    ) noexcept {
+#if defined(XAP_CORE_BUFFER_IEEE_754)
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        endian_write_uint64_le(this->m_pointer + offset, bits);
+#else
+        BufferAccessor::portable_write_double(
+            this->m_pointer + offset,
+            value,
+            true
+        );
+#endif
+    }
+
+#endif  //  #if defined(UINT64_MAX)
+
+    /**
+     *  Write single-precision float-point with big-endian at the specified
+     *  offset.
+     *
+     *  @param value
+     *      The single-precision float-point value.
+     *  @param offset
+     *      The offset (default 0).
+     */
+    void write_float_be(
+        const float     value,
+        const size_t    offset = 0U
+    ) noexcept {
+#if defined(XAP_CORE_BUFFER_IEEE_754)
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        endian_write_uint32_be(this->m_pointer + offset, bits);
+#else
+        BufferAccessor::portable_write_float(
+            this->m_pointer + offset,
+            value,
+            false
+        );
+#endif
+    }
+
+    /**
+     *  Write single-precision float-point with little-endian at the specified
+     *  offset.
+     *
+     *  @param value
+     *      The single-precision float-point value.
+     *  @param offset
+     *      The offset (default 0).
+     */
+    void write_float_le(
+        const float     value,
+        const size_t    offset = 0U
+    ) noexcept {
+#if defined(XAP_CORE_BUFFER_IEEE_754)
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        endian_write_uint32_le(this->m_pointer + offset, bits);
+#else
+        BufferAccessor::portable_write_float(
+            this->m_pointer + offset,
+            value,
+            true
+        );
+#endif
+    }
+
+private:
+#if !defined(XAP_CORE_BUFFER_IEEE_754)
+
+    //
+    //  Private functions (the portable float-point codec of Buffer).
+    //
+
+    /**
+     *  Read IEEE 754 single-precision float-point value.
+     *
+     *  @param pointer
+     *      The pointer to the first byte.
+     *  @param isle
+     *      True if with little-endian.
+     *  @return
+     *      The single-precision float-point value.
+     */
+    static float portable_read_float(
+        const uint8_t   *pointer,
+        const bool      isle
+    ) noexcept;
+
+    /**
+     *  Read IEEE 754 double-precision float-point value.
+     *
+     *  @param pointer
+     *      The pointer to the first byte.
+     *  @param isle
+     *      True if with little-endian.
+     *  @return
+     *      The double-precision float-point value.
+     */
+    static double portable_read_double(
+        const uint8_t   *pointer,
+        const bool      isle
+    ) noexcept;
+
+    /**
+     *  Write IEEE 754 single-precision float-point value.
+     *
+     *  @param pointer
+     *      The pointer to the first byte.
+     *  @param value
+     *      The single-precision float-point value.
+     *  @param isle
+     *      True if with little-endian.
+     */
+    static void portable_write_float(
+        uint8_t         *pointer,
+        const float     value,
+        const bool      isle
+    ) noexcept;
+
+    /**
+     *  Write IEEE 754 double-precision float-point value.
+     *
+     *  @param pointer
+     *      The pointer to the first byte.
+     *  @param value
+     *      The double-precision float-point value.
+     *  @param isle
+     *      True if with little-endian.
+     */
+    static void portable_write_double(
+        uint8_t         *pointer,
+        const double    value,
+        const bool      isle
+    ) noexcept;
+
+#endif  //  #if !defined(XAP_CORE_BUFFER_IEEE_754)
+
+    //
+    //  Members.
+    //
+    uint8_t    *m_pointer;
+    size_t      m_length;
+};
+
+}  //  namespace buffer
+}  //  namespace core
+}  //  namespace xap
+
+
+#endif  //  #ifndef XAP_CORE_BUFFER_ACCESSOR_H__
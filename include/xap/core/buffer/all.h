@@ -7,8 +7,19 @@
 //
 //  Imports.
 //
+#include <xap/core/buffer/accessor.h>
+#include <xap/core/buffer/allocator.h>
 #include <xap/core/buffer/buffer.h>
+#include <xap/core/buffer/chain.h>
+#include <xap/core/buffer/checksum.h>
+#include <xap/core/buffer/concurrent.h>
+#include <xap/core/buffer/endian.h>
 #include <xap/core/buffer/error.h>
 #include <xap/core/buffer/fetcher.h>
+#include <xap/core/buffer/io.h>
+#include <xap/core/buffer/parallel.h>
 #include <xap/core/buffer/queue.h>
+#include <xap/core/buffer/record.h>
+#include <xap/core/buffer/stats.h>
 #include <xap/core/buffer/version.h>
+#include <xap/core/buffer/writer.h>
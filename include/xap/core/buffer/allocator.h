@@ -0,0 +1,534 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+#ifndef XAP_CORE_BUFFER_ALLOCATOR_H__
+#define XAP_CORE_BUFFER_ALLOCATOR_H__
+
+//
+//  Imports.
+//
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace xap {
+namespace core {
+namespace buffer {
+
+//
+//  Enumerations.
+//
+
+//
+//  Huge page policy of the page allocator (see BufferPageAllocator).
+//
+enum BufferHugePageMode {
+    //  Use normal pages only.
+    BUFFER_HUGE_PAGE_NONE           = 0,
+
+    //  Align large mappings (at least the huge page size, 2 MiB) to the 
+    //  huge page size and advise the kernel to back them with transparent 
+    //  huge pages.
+    BUFFER_HUGE_PAGE_TRANSPARENT    = 1,
+
+    //  Request explicit huge pages (e.g. hugetlbfs) for large mappings, and
+    //  fall back to transparent huge pages if none is available. Smaller 
+    //  mappings use normal pages (in both huge page modes).
+    BUFFER_HUGE_PAGE_EXPLICIT       = 2
+};
+
+//
+//  Classes.
+//
+
+//
+//  Buffer storage allocator interface.
+//
+//  Buffers keep a reference to the allocator which allocated its storage,
+//  so the allocator must outlive all buffers (and slices of them) it
+//  allocated.
+//
+class BufferAllocator {
+public:
+    //
+    //  Constructor & destructor.
+    //
+
+    /**
+     *  Destruct the object.
+     */
+    virtual ~BufferAllocator() noexcept;
+
+    //
+    //  Public methods.
+    //
+
+    /**
+     *  Allocate memory.
+     *
+     *  @throw std::bad_alloc
+     *      Raised if failed to allocate memory.
+     *  @param size
+     *      The size of memory.
+     *  @param alignment
+     *      The alignment of memory (must be a power of 2).
+     *  @return
+     *      The pointer to the memory.
+     */
+    virtual void* allocate(const size_t size, const size_t alignment) = 0;
+
+    /**
+     *  Deallocate memory.
+     *
+     *  @param pointer
+     *      The pointer returned by allocate().
+     *  @param size
+     *      The size passed to allocate().
+     *  @param alignment
+     *      The alignment passed to allocate().
+     */
+    virtual void deallocate(
+        void            *pointer,
+        const size_t    size,
+        const size_t    alignment
+    ) noexcept = 0;
+
+    /**
+     *  Get the allocator of the control blocks (reference counters) of 
+     *  buffer storage allocated by this allocator.
+     *
+     *  @note
+     *      By default, the control block is placed in front of the storage,
+     *      and both of them are allocated with one request. Allocators 
+     *      whose blocks are sized or aligned for the storage itself (e.g. 
+     *      size classes, page mappings) return the allocator of control 
+     *      blocks instead, so that the storage is requested with its exact 
+     *      size.
+     *  @return
+     *      The allocator (nullptr if the control block is allocated with 
+     *      the storage).
+     */
+    virtual BufferAllocator* get_control_allocator() noexcept;
+
+    //
+    //  Static functions.
+    //
+
+    /**
+     *  Get the default allocator of current thread.
+     *
+     *  @return
+     *      The allocator (the heap allocator if not set).
+     */
+    static BufferAllocator& get_default() noexcept;
+
+    /**
+     *  Set the default allocator of current thread.
+     *
+     *  @param allocator
+     *      The allocator (nullptr to restore the heap allocator).
+     */
+    static void set_default(BufferAllocator *allocator) noexcept;
+
+    /**
+     *  Get the heap allocator (shared by all threads).
+     *
+     *  @return
+     *      The allocator.
+     */
+    static BufferAllocator& get_heap() noexcept;
+};
+
+//
+//  Heap allocator (uses global operator new and delete).
+//
+class BufferHeapAllocator: public BufferAllocator {
+public:
+    //
+    //  Public methods.
+    //
+
+    /**
+     *  Allocate memory.
+     *
+     *  @throw std::bad_alloc
+     *      Raised if failed to allocate memory.
+     *  @param size
+     *      The size of memory.
+     *  @param alignment
+     *      The alignment of memory (must be a power of 2).
+     *  @return
+     *      The pointer to the memory.
+     */
+    virtual void* allocate(const size_t size, const size_t alignment);
+
+    /**
+     *  Deallocate memory.
+     *
+     *  @param pointer
+     *      The pointer returned by allocate().
+     *  @param size
+     *      The size passed to allocate().
+     *  @param alignment
+     *      The alignment passed to allocate().
+     */
+    virtual void deallocate(
+        void            *pointer,
+        const size_t    size,
+        const size_t    alignment
+    ) noexcept;
+};
+
+//
+//  Size-class slab pool allocator (thread-safe).
+//
+//  Memory is carved out of slabs into power-of-2 size classes and recycled
+//  through per-class free lists. Requests larger than the biggest class
+//  fall back to the heap allocator. Slabs are released when the pool is
+//  destructed.
+//
+//  Buffer storage is requested with its exact length (so a 4 KiB buffer 
+//  takes a 4 KiB block), and the control blocks of buffers are served by 
+//  the smallest classes.
+//
+class BufferPoolAllocator: public BufferAllocator {
+public:
+    //
+    //  Constructor & destructor.
+    //
+
+    /**
+     *  Construct the object.
+     *
+     *  @param max_block_size
+     *      The size of the biggest class (rounded up to a power of 2).
+     */
+    explicit BufferPoolAllocator(const size_t max_block_size = 65536U);
+
+    /**
+     *  Destruct the object.
+     */
+    virtual ~BufferPoolAllocator() noexcept;
+
+    //
+    //  Public methods.
+    //
+
+    /**
+     *  Allocate memory.
+     *
+     *  @throw std::bad_alloc
+     *      Raised if failed to allocate memory.
+     *  @param size
+     *      The size of memory.
+     *  @param alignment
+     *      The alignment of memory (must be a power of 2).
+     *  @return
+     *      The pointer to the memory.
+     */
+    virtual void* allocate(const size_t size, const size_t alignment);
+
+    /**
+     *  Deallocate memory.
+     *
+     *  @param pointer
+     *      The pointer returned by allocate().
+     *  @param size
+     *      The size passed to allocate().
+     *  @param alignment
+     *      The alignment passed to allocate().
+     */
+    virtual void deallocate(
+        void            *pointer,
+        const size_t    size,
+        const size_t    alignment
+    ) noexcept;
+
+    /**
+     *  Get the allocator of the control blocks (reference counters) of 
+     *  buffer storage allocated by this allocator.
+     *
+     *  @return
+     *      The allocator (the pool itself).
+     */
+    virtual BufferAllocator* get_control_allocator() noexcept;
+
+private:
+    //
+    //  Private structures.
+    //
+
+    //
+    //  Size class.
+    //
+    struct SizeClass {
+        //  The lock.
+        std::mutex          lock;
+
+        //  The size of blocks.
+        size_t              block_size;
+
+        //  The first free block (free blocks are linked through their
+        //  first bytes).
+        void               *free_list;
+
+        //  The slabs allocated for the class.
+        std::vector<void*>  slabs;
+    };
+
+    //
+    //  Private methods.
+    //
+
+    /**
+     *  Get the size class which serves specified request.
+     *
+     *  @param size
+     *      The size of memory.
+     *  @param alignment
+     *      The alignment of memory.
+     *  @return
+     *      The size class (nullptr if the request should be served by the
+     *      heap).
+     */
+    SizeClass* get_size_class(
+        const size_t size,
+        const size_t alignment
+    ) noexcept;
+
+    //
+    //  Members.
+    //
+    std::vector<SizeClass*> m_classes;
+};
+
+//
+//  Bump arena allocator (not thread-safe).
+//
+//  Memory is carved sequentially out of blocks and is only released when
+//  the arena is reset or destructed, which suits request-scoped lifetimes.
+//  The caller must guarantee that no buffer allocated from the arena is
+//  still alive at that time.
+//
+class BufferArenaAllocator: public BufferAllocator {
+public:
+    //
+    //  Constructor & destructor.
+    //
+
+    /**
+     *  Construct the object.
+     *
+     *  @param block_size
+     *      The size of arena blocks.
+     */
+    explicit BufferArenaAllocator(const size_t block_size = 65536U);
+
+    /**
+     *  Destruct the object.
+     */
+    virtual ~BufferArenaAllocator() noexcept;
+
+    //
+    //  Public methods.
+    //
+
+    /**
+     *  Allocate memory.
+     *
+     *  @throw std::bad_alloc
+     *      Raised if failed to allocate memory.
+     *  @param size
+     *      The size of memory.
+     *  @param alignment
+     *      The alignment of memory (must be a power of 2).
+     *  @return
+     *      The pointer to the memory.
+     */
+    virtual void* allocate(const size_t size, const size_t alignment);
+
+    /**
+     *  Deallocate memory (do nothing, memory is released by reset()).
+     *
+     *  @param pointer
+     *      The pointer returned by allocate().
+     *  @param size
+     *      The size passed to allocate().
+     *  @param alignment
+     *      The alignment passed to allocate().
+     */
+    virtual void deallocate(
+        void            *pointer,
+        const size_t    size,
+        const size_t    alignment
+    ) noexcept;
+
+    /**
+     *  Release all memory allocated from the arena (the first block is kept
+     *  for reuse).
+     */
+    void reset() noexcept;
+
+    /**
+     *  Get the count of bytes allocated from the arena since last reset.
+     *
+     *  @return
+     *      The count of bytes.
+     */
+    size_t get_used_size() const noexcept;
+
+private:
+    //
+    //  Members.
+    //
+    size_t              m_block_size;
+    std::vector<void*>  m_blocks;
+    std::vector<void*>  m_large_blocks;
+    uint8_t            *m_cursor;
+    uint8_t            *m_end;
+    size_t              m_used;
+};
+
+//
+//  Page allocator (maps memory from the operating system directly).
+//
+//  Each allocation is a dedicated mapping which is at least page-aligned
+//  and is returned to the operating system on deallocation, which suits
+//  big, long-lived buffers (e.g. jitter buffers or direct I/O buffers). 
+//  With a huge page mode, large mappings are backed with huge pages to 
+//  reduce TLB misses. Targets without memory mapping fall back to the heap 
+//  allocator.
+//
+//  The control blocks of buffers are allocated from the heap, so buffer 
+//  storage begins at the mapping base and an exact multiple of the (huge)
+//  page size maps no extra page.
+//
+class BufferPageAllocator: public BufferAllocator {
+public:
+    //
+    //  Constructor & destructor.
+    //
+
+    /**
+     *  Construct the object.
+     *
+     *  @param mode
+     *      The huge page mode.
+     */
+    explicit BufferPageAllocator(
+        const BufferHugePageMode mode = BUFFER_HUGE_PAGE_NONE
+    ) noexcept;
+
+    /**
+     *  Destruct the object.
+     */
+    virtual ~BufferPageAllocator() noexcept;
+
+    //
+    //  Public methods.
+    //
+
+    /**
+     *  Allocate memory.
+     *
+     *  @throw std::bad_alloc
+     *      Raised if failed to allocate memory.
+     *  @param size
+     *      The size of memory.
+     *  @param alignment
+     *      The alignment of memory (must be a power of 2).
+     *  @return
+     *      The pointer to the memory.
+     */
+    virtual void* allocate(const size_t size, const size_t alignment);
+
+    /**
+     *  Deallocate memory.
+     *
+     *  @param pointer
+     *      The pointer returned by allocate().
+     *  @param size
+     *      The size passed to allocate().
+     *  @param alignment
+     *      The alignment passed to allocate().
+     */
+    virtual void deallocate(
+        void            *pointer,
+        const size_t    size,
+        const size_t    alignment
+    ) noexcept;
+
+    /**
+     *  Get the huge page mode.
+     *
+     *  @return
+     *      The mode.
+     */
+    BufferHugePageMode get_mode() const noexcept;
+
+    /**
+     *  Get the allocator of the control blocks (reference counters) of 
+     *  buffer storage allocated by this allocator.
+     *
+     *  @return
+     *      The allocator (the heap allocator).
+     */
+    virtual BufferAllocator* get_control_allocator() noexcept;
+
+    /**
+     *  Get the length of the mapping which serves a request (the memory 
+     *  an allocation costs, on targets with memory mapping).
+     *
+     *  @note
+     *      The size is rounded up to the huge page size if the request is 
+     *      served with huge pages, or to the normal page size otherwise.
+     *  @param size
+     *      The size of memory.
+     *  @return
+     *      The length.
+     */
+    size_t get_mapping_length(const size_t size) const noexcept;
+
+    //
+    //  Static functions.
+    //
+
+    /**
+     *  Get the size of normal pages.
+     *
+     *  @return
+     *      The size.
+     */
+    static size_t get_page_size() noexcept;
+
+private:
+    //
+    //  Private methods.
+    //
+
+    /**
+     *  Get whether a request is served with huge pages.
+     *
+     *  @param size
+     *      The size of memory.
+     *  @return
+     *      True if so.
+     */
+    bool is_huge(const size_t size) const noexcept;
+
+    //
+    //  Members.
+    //
+    BufferHugePageMode  m_mode;
+};
+
+}  //  namespace buffer
+}  //  namespace core
+}  //  namespace xap
+
+
+#endif  //  #ifndef XAP_CORE_BUFFER_ALLOCATOR_H__
@@ -12,19 +12,72 @@
 //
 #include <memory>
 #include <stdint.h>
+#include <xap/core/buffer/accessor.h>
+#include <xap/core/buffer/allocator.h>
 #include <xap/core/buffer/build.h>
+#include <xap/core/buffer/endian.h>
 #include <xap/core/buffer/error.h>
 
 namespace xap {
 namespace core {
 namespace buffer {
 
+//
+//  Enumerations.
+//
+
+//
+//  Access pattern hint of a file mapping (see Buffer::map_file()).
+//
+enum BufferMapHint {
+    //  No hint.
+    BUFFER_MAP_NORMAL       = 0,
+
+    //  The bytes would be accessed from the beginning to the end (the 
+    //  pages are read ahead aggressively and may be freed soon after).
+    BUFFER_MAP_SEQUENTIAL   = 1,
+
+    //  The bytes would be accessed randomly (read-ahead is disabled).
+    BUFFER_MAP_RANDOM       = 2
+};
+
+//
+//  Types.
+//
+
+/**
+ *  Callback which releases memory adopted by Buffer::wrap().
+ *
+ *  @param data
+ *      The pointer passed to Buffer::wrap().
+ *  @param datalen
+ *      The length passed to Buffer::wrap().
+ *  @param context
+ *      The context passed to Buffer::wrap().
+ */
+typedef void (*BufferReleaseCallback)(
+    uint8_t         *data,
+    const size_t    datalen,
+    void            *context
+);
+
 //
 //  Classes.
 //
 class Buffer {
 
 public:
+    //
+    //  Public constants.
+    //
+
+    //  The position returned by index_of() if nothing was found.
+    static const size_t NPOS = SIZE_MAX;
+
+    //  The common alignment boundaries of buffer storage.
+    static const size_t CACHE_LINE_ALIGNMENT = 64U;
+    static const size_t PAGE_ALIGNMENT = 4096U;
+
     //
     //  Constructor & desctructor.
     //
@@ -45,6 +98,14 @@ public:
      */
     Buffer(const Buffer &source);
 
+    /**
+     *  Construct (move) the object.
+     * 
+     *  @param source
+     *      The source buffer (would be empty after moved).
+     */
+    Buffer(Buffer &&source) noexcept;
+
     /**
      *  Construct the object.
      * 
@@ -55,6 +116,67 @@ public:
      */
     Buffer(const size_t length, const bool unsafe);
 
+    /**
+     *  Construct the object.
+     * 
+     *  @throw std::bad_alloc
+     *      Raised if the allocator failed to allocate memory.
+     *  @param length
+     *      The length of buffer.
+     *  @param unsafe
+     *      True if not initialze with zero.
+     *  @param allocator
+     *      The allocator of buffer storage (must outlive the buffer).
+     */
+    Buffer(
+        const size_t    length, 
+        const bool      unsafe, 
+        BufferAllocator &allocator
+    );
+
+    /**
+     *  Construct the object with aligned storage.
+     * 
+     *  @throw BufferException
+     *      Raised if 'alignment' is not a power of 2 
+     *      (XAPCORE_BUF_ERROR_INVALID_SIZE).
+     *  @param length
+     *      The length of buffer.
+     *  @param unsafe
+     *      True if not initialze with zero.
+     *  @param alignment
+     *      The alignment of buffer storage (e.g. CACHE_LINE_ALIGNMENT, 
+     *      PAGE_ALIGNMENT).
+     */
+    Buffer(const size_t length, const bool unsafe, const size_t alignment);
+
+    /**
+     *  Construct the object with aligned storage.
+     * 
+     *  @note
+     *      Use BufferPageAllocator to back big buffers with (huge) pages.
+     *  @throw BufferException
+     *      Raised if 'alignment' is not a power of 2 
+     *      (XAPCORE_BUF_ERROR_INVALID_SIZE).
+     *  @throw std::bad_alloc
+     *      Raised if the allocator failed to allocate memory.
+     *  @param length
+     *      The length of buffer.
+     *  @param unsafe
+     *      True if not initialze with zero.
+     *  @param alignment
+     *      The alignment of buffer storage (e.g. CACHE_LINE_ALIGNMENT, 
+     *      PAGE_ALIGNMENT).
+     *  @param allocator
+     *      The allocator of buffer storage (must outlive the buffer).
+     */
+    Buffer(
+        const size_t    length, 
+        const bool      unsafe, 
+        const size_t    alignment,
+        BufferAllocator &allocator
+    );
+
     /**
      *  Construct (copy) the object.
      * 
@@ -65,6 +187,24 @@ public:
      */
     Buffer(const uint8_t *data, const size_t datalen);
 
+    /**
+     *  Construct (copy) the object.
+     * 
+     *  @throw std::bad_alloc
+     *      Raised if the allocator failed to allocate memory.
+     *  @param data
+     *      The source data.
+     *  @param datalen
+     *      The length of source data.
+     *  @param allocator
+     *      The allocator of buffer storage (must outlive the buffer).
+     */
+    Buffer(
+        const uint8_t   *data, 
+        const size_t    datalen, 
+        BufferAllocator &allocator
+    );
+
     /**
      *  Destruct the object.
      */
@@ -84,6 +224,16 @@ public:
      */
     Buffer& operator=(const Buffer &source);
 
+    /**
+     *  Operator '=' (move).
+     * 
+     *  @param source
+     *      The source buffer (would be empty after moved).
+     *  @return
+     *      The target buffer.
+     */
+    Buffer& operator=(Buffer &&source) noexcept;
+
     /**
      *  Operator '[]'. Get the buffer value of specified position.
      * 
@@ -144,6 +294,91 @@ public:
      */
     const uint8_t* get_pointer() const noexcept;
 
+    /**
+     *  Get whether the raw pointer of buffer is aligned.
+     * 
+     *  @param alignment
+     *      The alignment.
+     *  @return
+     *      True if so (always false if 'alignment' is 0).
+     */
+    bool is_aligned(const size_t alignment) const noexcept;
+
+    /**
+     *  Get whether the buffer is the only owner of its storage.
+     * 
+     *  @note
+     *      The answer is based on the reference count of the storage, so it
+     *      is only reliable if no other thread copies or destroys the 
+     *      buffers sharing the storage meanwhile. A buffer wrapping unowned
+     *      memory is never unique, an empty buffer is always unique.
+     *  @return
+     *      True if so.
+     */
+    bool is_unique() const noexcept;
+
+    /**
+     *  Get the length of the storage which the buffer keeps alive (e.g. 
+     *  the whole allocation a slice was taken from).
+     * 
+     *  @note
+     *      A buffer wrapping unowned memory keeps nothing alive, the 
+     *      length of the buffer is returned.
+     *  @return
+     *      The length (not less than the length of the buffer).
+     */
+    size_t get_storage_length() const noexcept;
+
+    /**
+     *  Get whether the buffer shares its storage with another buffer 
+     *  (e.g. both are slices of the same buffer).
+     * 
+     *  @note
+     *      Buffers wrapping unowned memory never share storage.
+     *  @param other
+     *      The other buffer.
+     *  @return
+     *      True if so.
+     */
+    bool is_sharing_storage(const Buffer &other) const noexcept;
+
+    /**
+     *  Make the buffer the only owner of its storage, copy the bytes into 
+     *  new storage if the storage is shared (or unowned).
+     * 
+     *  @note
+     *      The new storage is allocated from the default allocator with the
+     *      default alignment.
+     *  @throw std::bad_alloc
+     *      Raised if failed to allocate memory.
+     *  @return
+     *      True if the bytes were copied.
+     */
+    bool detach();
+
+    /**
+     *  Set whether the buffer is in copy-on-write mode.
+     * 
+     *  @note
+     *      In copy-on-write mode, the write methods (write_*(), fill(), 
+     *      swap*() and copy() into the buffer) detach the buffer before 
+     *      writing if the storage is shared, so that the other buffers 
+     *      never see the change. The raw accesses (get_pointer(), 
+     *      operator[] and access()) don't. The mode is inherited by copies 
+     *      and slices of the buffer.
+     *  @param enabled
+     *      True if enable.
+     */
+    void set_copy_on_write(const bool enabled) noexcept;
+
+    /**
+     *  Get whether the buffer is in copy-on-write mode.
+     * 
+     *  @return
+     *      True if so.
+     */
+    bool is_copy_on_write() const noexcept;
+
     /**
      *  Return a new Buffer that references the same memory as the original, but
      *  offset and cropped by the 'offset' indices.
@@ -173,6 +408,22 @@ public:
      *      The new buffer.
      */
     Buffer slice(const size_t offset, const size_t length) const;
+
+    /**
+     *  Validate a range once and get an accessor whose typed reads and 
+     *  writes skip per-call range checks.
+     * 
+     *  @throw BufferException
+     *      Raised if 'offset' or 'length' is out of range 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset of the range.
+     *  @param length
+     *      The length of the range.
+     *  @return
+     *      The accessor (offsets are relative to the range start).
+     */
+    BufferAccessor access(const size_t offset, const size_t length) const;
     
     /**
      *  Copies data to destination.
@@ -182,7 +433,7 @@ public:
      *  @return
      *      The number of bytes copied.
      */
-    size_t copy(Buffer &destination) const noexcept;
+    size_t copy(Buffer &destination) const;
     
     /**
      *  Copies data to destination.
@@ -226,7 +477,7 @@ public:
      *  @param value
      *      The value with which to fill buffer.
      */
-    void fill(const uint8_t value) noexcept;
+    void fill(const uint8_t value);
 
     /**
      *  Fills buffer with the specified.
@@ -242,6 +493,36 @@ public:
      *      The length of buffer to fill.
      */
     void fill(const uint8_t value, const size_t offset, const size_t length);
+
+    /**
+     *  Interpret buffer as an array of unsigned 16-bit integers and swap the
+     *  byte order in place.
+     * 
+     *  @throw BufferException
+     *      Raised if the length is not a multiple of 2 
+     *      (XAPCORE_BUF_ERROR_INVALID_SIZE).
+     */
+    void swap16();
+
+    /**
+     *  Interpret buffer as an array of unsigned 32-bit integers and swap the
+     *  byte order in place.
+     * 
+     *  @throw BufferException
+     *      Raised if the length is not a multiple of 4 
+     *      (XAPCORE_BUF_ERROR_INVALID_SIZE).
+     */
+    void swap32();
+
+    /**
+     *  Interpret buffer as an array of 64-bit integers and swap the byte 
+     *  order in place.
+     * 
+     *  @throw BufferException
+     *      Raised if the length is not a multiple of 8 
+     *      (XAPCORE_BUF_ERROR_INVALID_SIZE).
+     */
+    void swap64();
     
     /**
      *  Read an unsigned 8-bit integer.
@@ -341,6 +622,244 @@ public:
      */
     uint64_t read_uint64_le(const size_t offset = 0U) const;
 #endif  //  #if defined(UINT64_MAX)
+
+    /**
+     *  Read an array of unsigned 16-bit integers with big-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if 'offset' or 'count' is out of range 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset.
+     *  @param dst
+     *      The destination array.
+     *  @param count
+     *      The count of integers.
+     */
+    void read_uint16_be_array(
+        const size_t    offset, 
+        uint16_t        *dst, 
+        const size_t    count
+    ) const;
+
+    /**
+     *  Read an array of unsigned 16-bit integers with little-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if 'offset' or 'count' is out of range 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset.
+     *  @param dst
+     *      The destination array.
+     *  @param count
+     *      The count of integers.
+     */
+    void read_uint16_le_array(
+        const size_t    offset, 
+        uint16_t        *dst, 
+        const size_t    count
+    ) const;
+
+    /**
+     *  Read an array of unsigned 32-bit integers with big-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if 'offset' or 'count' is out of range 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset.
+     *  @param dst
+     *      The destination array.
+     *  @param count
+     *      The count of integers.
+     */
+    void read_uint32_be_array(
+        const size_t    offset, 
+        uint32_t        *dst, 
+        const size_t    count
+    ) const;
+
+    /**
+     *  Read an array of unsigned 32-bit integers with little-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if 'offset' or 'count' is out of range 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset.
+     *  @param dst
+     *      The destination array.
+     *  @param count
+     *      The count of integers.
+     */
+    void read_uint32_le_array(
+        const size_t    offset, 
+        uint32_t        *dst, 
+        const size_t    count
+    ) const;
+
+#if defined(UINT64_MAX)
+
+    /**
+     *  Read an array of unsigned 64-bit integers with big-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if 'offset' or 'count' is out of range 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset.
+     *  @param dst
+     *      The destination array.
+     *  @param count
+     *      The count of integers.
+     */
+    void read_uint64_be_array(
+        const size_t    offset, 
+        uint64_t        *dst, 
+        const size_t    count
+    ) const;
+
+    /**
+     *  Read an array of unsigned 64-bit integers with little-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if 'offset' or 'count' is out of range 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset.
+     *  @param dst
+     *      The destination array.
+     *  @param count
+     *      The count of integers.
+     */
+    void read_uint64_le_array(
+        const size_t    offset, 
+        uint64_t        *dst, 
+        const size_t    count
+    ) const;
+
+#endif  //  #if defined(UINT64_MAX)
+
+    /**
+     *  Read an array of signed 16-bit samples with big-endian and convert 
+     *  them to float samples in [-1.0, 1.0).
+     * 
+     *  @throw BufferException
+     *      Raised if 'offset' or 'count' is out of range 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset.
+     *  @param dst
+     *      The destination array.
+     *  @param count
+     *      The count of samples.
+     */
+    void read_sint16_be_normalized(
+        const size_t    offset, 
+        float           *dst, 
+        const size_t    count
+    ) const;
+
+    /**
+     *  Read an array of signed 16-bit samples with little-endian and convert 
+     *  them to float samples in [-1.0, 1.0).
+     * 
+     *  @throw BufferException
+     *      Raised if 'offset' or 'count' is out of range 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset.
+     *  @param dst
+     *      The destination array.
+     *  @param count
+     *      The count of samples.
+     */
+    void read_sint16_le_normalized(
+        const size_t    offset, 
+        float           *dst, 
+        const size_t    count
+    ) const;
+
+    /**
+     *  Read an array of packed signed 24-bit samples with big-endian and 
+     *  convert them to float samples in [-1.0, 1.0).
+     * 
+     *  @throw BufferException
+     *      Raised if 'offset' or 'count' is out of range 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset.
+     *  @param dst
+     *      The destination array.
+     *  @param count
+     *      The count of samples.
+     */
+    void read_sint24_be_normalized(
+        const size_t    offset, 
+        float           *dst, 
+        const size_t    count
+    ) const;
+
+    /**
+     *  Read an array of packed signed 24-bit samples with little-endian and 
+     *  convert them to float samples in [-1.0, 1.0).
+     * 
+     *  @throw BufferException
+     *      Raised if 'offset' or 'count' is out of range 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset.
+     *  @param dst
+     *      The destination array.
+     *  @param count
+     *      The count of samples.
+     */
+    void read_sint24_le_normalized(
+        const size_t    offset, 
+        float           *dst, 
+        const size_t    count
+    ) const;
+
+    /**
+     *  Read an array of signed 32-bit samples with big-endian and convert 
+     *  them to float samples in [-1.0, 1.0].
+     * 
+     *  @throw BufferException
+     *      Raised if 'offset' or 'count' is out of range 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset.
+     *  @param dst
+     *      The destination array.
+     *  @param count
+     *      The count of samples.
+     */
+    void read_sint32_be_normalized(
+        const size_t    offset, 
+        float           *dst, 
+        const size_t    count
+    ) const;
+
+    /**
+     *  Read an array of signed 32-bit samples with little-endian and convert 
+     *  them to float samples in [-1.0, 1.0].
+     * 
+     *  @throw BufferException
+     *      Raised if 'offset' or 'count' is out of range 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset.
+     *  @param dst
+     *      The destination array.
+     *  @param count
+     *      The count of samples.
+     */
+    void read_sint32_le_normalized(
+        const size_t    offset, 
+        float           *dst, 
+        const size_t    count
+    ) const;
     /**
      *  Read a signal-precision float-point value with big-endian.
      * 
@@ -482,6 +1001,166 @@ public:
 
 #endif  //  #if defined(UINT64_MAX)
 
+    /**
+     *  Write an array of unsigned 16-bit integers with big-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if 'offset' or 'count' is out of range 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset.
+     *  @param src
+     *      The source array.
+     *  @param count
+     *      The count of integers.
+     */
+    void write_uint16_be_array(
+        const size_t    offset, 
+        const uint16_t  *src, 
+        const size_t    count
+    );
+
+    /**
+     *  Write an array of unsigned 16-bit integers with little-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if 'offset' or 'count' is out of range 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset.
+     *  @param src
+     *      The source array.
+     *  @param count
+     *      The count of integers.
+     */
+    void write_uint16_le_array(
+        const size_t    offset, 
+        const uint16_t  *src, 
+        const size_t    count
+    );
+
+    /**
+     *  Write an array of unsigned 32-bit integers with big-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if 'offset' or 'count' is out of range 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset.
+     *  @param src
+     *      The source array.
+     *  @param count
+     *      The count of integers.
+     */
+    void write_uint32_be_array(
+        const size_t    offset, 
+        const uint32_t  *src, 
+        const size_t    count
+    );
+
+    /**
+     *  Write an array of unsigned 32-bit integers with little-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if 'offset' or 'count' is out of range 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset.
+     *  @param src
+     *      The source array.
+     *  @param count
+     *      The count of integers.
+     */
+    void write_uint32_le_array(
+        const size_t    offset, 
+        const uint32_t  *src, 
+        const size_t    count
+    );
+
+#if defined(UINT64_MAX)
+
+    /**
+     *  Write an array of unsigned 64-bit integers with big-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if 'offset' or 'count' is out of range 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset.
+     *  @param src
+     *      The source array.
+     *  @param count
+     *      The count of integers.
+     */
+    void write_uint64_be_array(
+        const size_t    offset, 
+        const uint64_t  *src, 
+        const size_t    count
+    );
+
+    /**
+     *  Write an array of unsigned 64-bit integers with little-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if 'offset' or 'count' is out of range 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset.
+     *  @param src
+     *      The source array.
+     *  @param count
+     *      The count of integers.
+     */
+    void write_uint64_le_array(
+        const size_t    offset, 
+        const uint64_t  *src, 
+        const size_t    count
+    );
+
+#endif  //  #if defined(UINT64_MAX)
+
+    /**
+     *  Convert an array of float samples in [-1.0, 1.0] to signed 16-bit 
+     *  samples (rounded to nearest and saturated) and write them with 
+     *  big-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if 'offset' or 'count' is out of range 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset.
+     *  @param src
+     *      The source array.
+     *  @param count
+     *      The count of samples.
+     */
+    void write_sint16_be_normalized(
+        const size_t    offset, 
+        const float     *src, 
+        const size_t    count
+    );
+
+    /**
+     *  Convert an array of float samples in [-1.0, 1.0] to signed 16-bit 
+     *  samples (rounded to nearest and saturated) and write them with 
+     *  little-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if 'offset' or 'count' is out of range 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset.
+     *  @param src
+     *      The source array.
+     *  @param count
+     *      The count of samples.
+     */
+    void write_sint16_le_normalized(
+        const size_t    offset, 
+        const float     *src, 
+        const size_t    count
+    );
+
     /**
      *  Write signal-precision float-point with big-endian at the 
      *  specified offset.
@@ -545,6 +1224,63 @@ public:
      *      True if equal.
      */
     bool is_equal(const uint8_t *other, const size_t other_len) const noexcept;
+
+    /**
+     *  Compare self with another buffer (byte-wise, like memcmp(), shorter 
+     *  buffer goes first if one is a prefix of the other).
+     * 
+     *  @param other
+     *      The other buffer.
+     *  @return
+     *      Negative if self goes first, positive if 'other' goes first, or
+     *      0 if equal.
+     */
+    int compare(const Buffer &other) const noexcept;
+
+    /**
+     *  Find the first occurrence of a byte.
+     * 
+     *  @param value
+     *      The byte.
+     *  @param from
+     *      The offset where to begin searching.
+     *  @return
+     *      The offset of the occurrence (NPOS if not found).
+     */
+    size_t index_of(const uint8_t value, const size_t from = 0U) const noexcept;
+
+    /**
+     *  Find the first occurrence of a byte sequence.
+     * 
+     *  @param needle
+     *      The byte sequence (an empty one is found at 'from').
+     *  @param from
+     *      The offset where to begin searching.
+     *  @return
+     *      The offset of the occurrence (NPOS if not found).
+     */
+    size_t index_of(
+        const Buffer    &needle, 
+        const size_t    from = 0U
+    ) const noexcept;
+
+    /**
+     *  Find the first occurrence of a byte sequence.
+     * 
+     *  @param needle
+     *      The byte sequence (an empty one is found at 'from').
+     *  @param needle_len
+     *      The length of the byte sequence.
+     *  @param from
+     *      The offset where to begin searching.
+     *  @return
+     *      The offset of the occurrence (NPOS if not found).
+     */
+    size_t index_of(
+        const uint8_t   *needle, 
+        const size_t    needle_len, 
+        const size_t    from = 0U
+    ) const noexcept;
     
     //
     //  Static functions.
@@ -554,6 +1290,9 @@ public:
      *  Return a new buffer which is the result of concatenating all buffer 
      *  instances in array together.
      * 
+     *  @throw BufferException
+     *      Raised if the total length overflowed 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
      *  @param buffers
      *      The buffer instances to concatenate.
      *  @param count
@@ -565,6 +1304,83 @@ public:
         const Buffer buffers[], 
         const size_t count
     );
+
+    /**
+     *  Adopt external memory as a new buffer (without copying).
+     * 
+     *  @note
+     *      The buffer (and its slices) references the memory directly. 
+     *      The release callback is called once the last reference is 
+     *      destroyed (or immediately if 'datalen' is 0, or if failed to 
+     *      allocate the reference counter, before std::bad_alloc is 
+     *      raised).
+     *  @throw std::bad_alloc
+     *      Raised if failed to allocate memory.
+     *  @param data
+     *      The memory (must not be nullptr unless 'datalen' is 0).
+     *  @param datalen
+     *      The length of the memory.
+     *  @param release
+     *      The release callback (nullptr if nothing to release).
+     *  @param context
+     *      The context passed to the release callback.
+     *  @return
+     *      The new buffer.
+     */
+    static Buffer wrap(
+        uint8_t                 *data, 
+        const size_t            datalen, 
+        BufferReleaseCallback   release, 
+        void                    *context = nullptr
+    );
+
+    /**
+     *  Reference external memory as a new buffer (without copying or 
+     *  owning it).
+     * 
+     *  @note
+     *      The caller must guarantee that the memory outlives the buffer 
+     *      and all buffers (and slices) that share it.
+     *  @param data
+     *      The memory (must not be nullptr unless 'datalen' is 0).
+     *  @param datalen
+     *      The length of the memory.
+     *  @return
+     *      The new buffer.
+     */
+    static Buffer wrap_unowned(uint8_t *data, const size_t datalen);
+
+    /**
+     *  Map a range of a file into a new buffer (without copying it onto the 
+     *  heap).
+     * 
+     *  @note
+     *      The mapping is private (copy-on-write): the buffer may be 
+     *      written, but the changes are never written back to the file. 
+     *      The mapping is released when the last buffer (or slice) which 
+     *      references it is destroyed. The file must not be truncated 
+     *      while it is mapped.
+     *  @throw BufferException
+     *      Raised if 'offset' or 'length' is out of the file 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW), or failed to open or map the file
+     *      (XAPCORE_BUF_ERROR_IO).
+     *  @param path
+     *      The path of the file.
+     *  @param offset
+     *      The offset of the range in the file.
+     *  @param length
+     *      The length of the range (NPOS to map until the end of the file).
+     *  @param hint
+     *      The access pattern hint.
+     *  @return
+     *      The new buffer.
+     */
+    static Buffer map_file(
+        const char          *path, 
+        const uint64_t      offset = 0U, 
+        const size_t        length = NPOS,
+        const BufferMapHint hint = BUFFER_MAP_NORMAL
+    );
     
 private:
     //
@@ -616,6 +1432,34 @@ private:
         const size_t offset,
         const size_t length
     ) const;
+
+    /**
+     *  Raise the out-of-range error of check_access() (kept out of line, 
+     *  so that the inlined checks stay small).
+     * 
+     *  @throw BufferException
+     *      Always (XAPCORE_BUF_ERROR_OVERFLOW).
+     */
+    [[noreturn]] static void raise_overflow();
+
+    /**
+     *  Check if an array access at 'offset' is out of range.
+     * 
+     *  @throw BufferException
+     *      Raised if 'offset' or 'count' is out of range 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset.
+     *  @param count
+     *      The count of elements.
+     *  @param width
+     *      The width of each element.
+     */
+    void check_array_access(
+        const size_t offset,
+        const size_t count,
+        const size_t width
+    ) const;
     
     /**
      *  Prepare the buffer.
@@ -631,7 +1475,16 @@ private:
         std::shared_ptr<uint8_t>    buffer,
         const size_t                offset,
         const size_t                length
-    );
+    ) noexcept;
+
+    /**
+     *  Detach the buffer before writing if it is in copy-on-write mode and
+     *  the storage is shared.
+     * 
+     *  @throw std::bad_alloc
+     *      Raised if failed to allocate memory.
+     */
+    void prepare_write();
 
     /**
      *  Read IEEE 754 signal-precision float-point value.
@@ -700,10 +1553,342 @@ private:
     //
     std::shared_ptr<uint8_t> m_buffer;
     uint8_t                 *m_bufferstart;
-    uint8_t                 *m_bufferend;
+    size_t                   m_storagelength;
     size_t                   m_bufferlength;
+    bool                     m_cow;
 };
 
+//
+//  Inline methods.
+//
+//  The hot accessors are defined here so that they can be inlined into the 
+//  callers (also across the shared library boundary). The cold paths 
+//  (raise_overflow(), detach(), ...) stay in buffer.cc.
+//
+
+/**
+ *  Operator '[]'. Get the buffer value of specified position.
+ * 
+ *  @throw BufferException
+ *      Raised if offset is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset.
+ *  @return
+ *      The value of buffer in specified position. 
+ */
+inline uint8_t& Buffer::operator[](const size_t offset) const {
+    this->check_access(offset, 1U);
+    return *(this->m_bufferstart + offset);
+}
+
+/**
+ *  Get the length of buffer.
+ * 
+ *  @return
+ *      The length.
+ */
+inline size_t Buffer::get_length() const noexcept {
+    return this->m_bufferlength;
+}
+
+/**
+ *  Get the raw pointer of buffer.
+ * 
+ *  @return
+ *      The raw pointer.
+ */
+inline uint8_t* Buffer::get_pointer() noexcept {
+    return this->m_bufferstart;
+}
+
+/**
+ *  Get the raw pointer of buffer.
+ * 
+ *  @return
+ *      The raw pointer.
+ */
+inline const uint8_t* Buffer::get_pointer() const noexcept {
+    return this->m_bufferstart;
+}
+
+/**
+ *  Read an unsigned 8-bit integer.
+ * 
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset.
+ *  @return
+ *      The unsigned 8-bit integer value.
+ */
+inline uint8_t Buffer::read_uint8(const size_t offset) const {
+    this->check_access(offset, 1U);
+    return this->m_bufferstart[offset];
+}
+
+/**
+ *  Read an unsigned 16-bit integer with big-endian.
+ * 
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset.
+ *  @return
+ *      The unsigned 16-bit integer.
+ */
+inline uint16_t Buffer::read_uint16_be(const size_t offset) const {
+    this->check_access(offset, 2U);
+    return endian_read_uint16_be(this->m_bufferstart + offset);
+}
+
+/**
+ *  Read an unsigned 16-bit integer with little-endian.
+ * 
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset.
+ *  @return
+ *      The unsigned 16-bit integer.
+ */
+inline uint16_t Buffer::read_uint16_le(const size_t offset) const {
+    this->check_access(offset, 2U);
+    return endian_read_uint16_le(this->m_bufferstart + offset);
+}
+
+/**
+ *  Read a signed 16-bit integer with little-endian.
+ * 
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset.
+ *  @return
+ *      The signed 16-bit integer.
+ */
+inline int16_t Buffer::read_sint16_le(const size_t offset) const {
+    this->check_access(offset, 2U);
+    return static_cast<int16_t>(
+        endian_read_uint16_le(this->m_bufferstart + offset)
+    );
+}
+
+/**
+ *  Read an unsigned 32-bit integer with big-endian.
+ * 
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset.
+ *  @return
+ *      The unsigned 32-bit integer.
+ */
+inline uint32_t Buffer::read_uint32_be(const size_t offset) const {
+    this->check_access(offset, 4U);
+    return endian_read_uint32_be(this->m_bufferstart + offset);
+}
+
+/**
+ *  Read an unsigned 32-bit integer with little-endian.
+ * 
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset.
+ *  @return
+ *      The unsigned 32-bit integer.
+ */
+inline uint32_t Buffer::read_uint32_le(const size_t offset) const {
+    this->check_access(offset, 4U);
+    return endian_read_uint32_le(this->m_bufferstart + offset);
+}
+
+#if defined(UINT64_MAX)
+
+/**
+ *  Read an unsigned 64-bit integer with big-endian.
+ * 
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset.
+ *  @return
+ *      The unsigned 64-bit integer.
+ */
+inline uint64_t Buffer::read_uint64_be(const size_t offset) const {
+    this->check_access(offset, 8U);
+    return endian_read_uint64_be(this->m_bufferstart + offset);
+}
+
+/**
+ *  Read an unsigned 64-bit integer with little-endian.
+ * 
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset.
+ *  @return
+ *      The unsigned 64-bit integer.
+ */
+inline uint64_t Buffer::read_uint64_le(const size_t offset) const {
+    this->check_access(offset, 8U);
+    return endian_read_uint64_le(this->m_bufferstart + offset);
+}
+
+#endif  //  #if defined(UINT64_MAX)
+
+/**
+ *  Write unsigned 8-bit integer at the specified offset.
+ * 
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param value
+ *      The unsigned 8-bit integer.
+ *  @param offset
+ *      The offset (default 0).
+ */
+inline void Buffer::write_uint8(const uint8_t value, const size_t offset) {
+    this->check_access(offset, 1U);
+    this->prepare_write();
+    this->m_bufferstart[offset] = value;
+}
+
+/**
+ *  Write unsigned 16-bit integer with big-endian at the specified offset.
+ * 
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param value
+ *      The unsigned 16-bit integer.
+ *  @param offset
+ *      The offset (default 0).
+ */
+inline void Buffer::write_uint16_be(const uint16_t value, const size_t offset) {
+    this->check_access(offset, 2U);
+    this->prepare_write();
+    endian_write_uint16_be(this->m_bufferstart + offset, value);
+}
+
+/**
+ *  Write unsigned 16-bit integer with little-endian at the specified offset.
+ * 
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param value
+ *      The unsigned 16-bit integer.
+ *  @param offset
+ *      The offset (default 0).
+ */
+inline void Buffer::write_uint16_le(const uint16_t value, const size_t offset) {
+    this->check_access(offset, 2U);
+    this->prepare_write();
+    endian_write_uint16_le(this->m_bufferstart + offset, value);
+}
+
+/**
+ *  Write unsigned 32-bit integer with big-endian at the specified offset.
+ * 
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param value
+ *      The unsigned 32-bit integer.
+ *  @param offset
+ *      The offset (default 0).
+ */
+inline void Buffer::write_uint32_be(const uint32_t value, const size_t offset) {
+    this->check_access(offset, 4U);
+    this->prepare_write();
+    endian_write_uint32_be(this->m_bufferstart + offset, value);
+}
+
+/**
+ *  Write unsigned 32-bit integer with little-endian at the specified offset.
+ * 
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param value
+ *      The unsigned 32-bit integer.
+ *  @param offset
+ *      The offset (default 0).
+ */
+inline void Buffer::write_uint32_le(const uint32_t value, const size_t offset) {
+    this->check_access(offset, 4U);
+    this->prepare_write();
+    endian_write_uint32_le(this->m_bufferstart + offset, value);
+}
+
+#if defined(UINT64_MAX)
+
+/**
+ *  Write unsigned 64-bit integer with big-endian at the specified offset.
+ * 
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param value
+ *      The unsigned 64-bit integer.
+ *  @param offset
+ *      The offset (default 0).
+ */
+inline void Buffer::write_uint64_be(const uint64_t value, const size_t offset) {
+    this->check_access(offset, 8U);
+    this->prepare_write();
+    endian_write_uint64_be(this->m_bufferstart + offset, value);
+}
+
+/**
+ *  Write unsigned 64-bit integer with little-endian at the specified offset.
+ * 
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param value
+ *      The unsigned 64-bit integer.
+ *  @param offset
+ *      The offset (default 0).
+ */
+inline void Buffer::write_uint64_le(const uint64_t value, const size_t offset) {
+    this->check_access(offset, 8U);
+    this->prepare_write();
+    endian_write_uint64_le(this->m_bufferstart + offset, value);
+}
+
+#endif  //  #if defined(UINT64_MAX)
+
+/**
+ *  Check if 'offset' or 'length is out of range.
+ * 
+ *  @throw BufferException
+ *      Raisd if 'offset' or 'length is out of range 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset.
+ *  @param length
+ *      The length.
+ */
+inline void Buffer::check_access(
+    const size_t offset, 
+    const size_t length
+) const {
+    if (length != 0U && (
+        offset >= this->m_bufferlength || 
+        length > this->m_bufferlength - offset
+    )) {
+        raise_overflow();
+    }
+}
+
+/**
+ *  Detach the buffer before writing if it is in copy-on-write mode and 
+ *  the storage is shared.
+ * 
+ *  @throw std::bad_alloc
+ *      Raised if failed to allocate memory.
+ */
+inline void Buffer::prepare_write() {
+    if (this->m_cow && !this->is_unique()) {
+        this->detach();
+    }
+}
+
 }  //  namespace buffer
 }  //  namespace core
 }  //  namespace xap
@@ -7,6 +7,16 @@
 #ifndef XAP_CORE_BUFFER_BUILD_H__
 #define XAP_CORE_BUFFER_BUILD_H__
 
+//
+//  Operating system flag.
+//
+#if defined(WIN32) || defined(_WIN32)
+# define XAP_CORE_BUFFER_OS_WIN
+#elif defined(__unix__) || defined(__unix) || \
+      (defined(__APPLE__) && defined(__MACH__))
+# define XAP_CORE_BUFFER_OS_POSIX
+#endif
+
 //
 //  Endian flag.
 //
@@ -109,4 +119,53 @@
 # error "Cannot check compiler endian order."
 #endif
 
+//
+//  SIMD flags.
+//
+//  The vectorized kernels are selected at compile time from the target
+//  architecture (e.g. compile with -mavx2 to enable AVX2, or -msse4.2 or
+//  -march=armv8-a+crc to enable the CRC instructions). They are only
+//  enabled on little-endian targets. Define XAP_CORE_BUFFER_DISABLE_SIMD
+//  to force the scalar code.
+//
+#if !defined(XAP_CORE_BUFFER_DISABLE_SIMD) && ARCH_CPU_LITTLE_ENDIAN
+#if ARCH_CPU_X86_FAMILY
+# if defined(__SSE2__) || defined(_M_X64) || \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define XAP_CORE_BUFFER_SIMD_SSE2
+# endif
+# if defined(__AVX2__)
+#  define XAP_CORE_BUFFER_SIMD_AVX2
+# endif
+# if defined(__SSE4_2__)
+#  define XAP_CORE_BUFFER_SIMD_SSE42
+# endif
+#elif ARCH_CPU_ARM_FAMILY
+# if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#  define XAP_CORE_BUFFER_SIMD_NEON
+# endif
+# if defined(__ARM_FEATURE_CRC32)
+#  define XAP_CORE_BUFFER_SIMD_ARM_CRC32
+# endif
+#endif
+#endif
+
+//
+//  Float-point format flag.
+//
+//  Defined if 'float' and 'double' are IEEE 754 binary32 / binary64 and are
+//  stored with the same byte order as integers, so that they can be bit 
+//  casted from / to integers. Define XAP_CORE_BUFFER_DISABLE_IEEE_754 to 
+//  force the portable codec.
+//
+#if !defined(XAP_CORE_BUFFER_DISABLE_IEEE_754) && \
+    (defined(XAP_CORE_BUFFER_LITTLE_ENDIAN) || \
+     defined(XAP_CORE_BUFFER_BIG_ENDIAN))
+#if ARCH_CPU_X86_FAMILY || ARCH_CPU_ARM_FAMILY || \
+    defined(__STDC_IEC_559__) || \
+    (defined(__GCC_IEC_559) && __GCC_IEC_559 > 0)
+# define XAP_CORE_BUFFER_IEEE_754
+#endif
+#endif
+
 #endif  //  #ifndef XAP_CORE_BUFFER_BUILD_H__
\ No newline at end of file
@@ -0,0 +1,492 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+#ifndef XAP_CORE_BUFFER_CHAIN_H__
+#define XAP_CORE_BUFFER_CHAIN_H__
+
+//
+//  Imports.
+//
+#include <deque>
+#include <stdint.h>
+#include <xap/core/buffer/buffer.h>
+#include <xap/core/buffer/error.h>
+#include <xap/core/buffer/queue.h>
+
+namespace xap {
+namespace core {
+namespace buffer {
+
+//
+//  Classes.
+//
+
+//
+//  Chain of buffers (rope).
+//
+//  The chain holds references to (slices of) existing buffers, so that
+//  appending, prepending and slicing never copy bytes. The bytes are only
+//  coalesced when flatten() is called (or a read spans segments).
+//
+class BufferChain {
+public:
+    //
+    //  Constructor.
+    //
+
+    /**
+     *  Construct an empty chain.
+     */
+    BufferChain() noexcept;
+
+    /**
+     *  Construct a chain with one buffer.
+     *
+     *  @param buffer
+     *      The buffer.
+     */
+    explicit BufferChain(const Buffer &buffer);
+
+    //
+    //  Public methods.
+    //
+
+    /**
+     *  Append a buffer to the chain back (without copying).
+     *
+     *  @throw BufferException
+     *      Raised if the chain length overflowed
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param buffer
+     *      The buffer.
+     */
+    void append(const Buffer &buffer);
+
+    /**
+     *  Append a buffer to the chain back (without copying).
+     *
+     *  @throw BufferException
+     *      Raised if the chain length overflowed
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param buffer
+     *      The buffer (would be moved into chain).
+     */
+    void append(Buffer &&buffer);
+
+    /**
+     *  Append all segments of another chain to the chain back (without
+     *  copying).
+     *
+     *  @throw BufferException
+     *      Raised if the chain length overflowed
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param chain
+     *      The chain.
+     */
+    void append(const BufferChain &chain);
+
+    /**
+     *  Prepend a buffer to the chain front (without copying).
+     *
+     *  @throw BufferException
+     *      Raised if the chain length overflowed
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param buffer
+     *      The buffer.
+     */
+    void prepend(const Buffer &buffer);
+
+    /**
+     *  Prepend a buffer to the chain front (without copying).
+     *
+     *  @throw BufferException
+     *      Raised if the chain length overflowed
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param buffer
+     *      The buffer (would be moved into chain).
+     */
+    void prepend(Buffer &&buffer);
+
+    /**
+     *  Remove all segments.
+     */
+    void clear() noexcept;
+
+    /**
+     *  Get the total length of all segments.
+     *
+     *  @return
+     *      The length.
+     */
+    size_t get_length() const noexcept;
+
+    /**
+     *  Get the count of segments.
+     *
+     *  @return
+     *      The count.
+     */
+    size_t get_segment_count() const noexcept;
+
+    /**
+     *  Get a segment.
+     *
+     *  @throw BufferException
+     *      Raised if 'index' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param index
+     *      The position of the segment.
+     *  @return
+     *      The segment.
+     */
+    const Buffer& get_segment(const size_t index) const;
+
+    /**
+     *  Get the segments (for vectored I/O, without copying).
+     *
+     *  @note
+     *      The segments are valid until the chain is modified.
+     *  @param segments
+     *      The segments array to fill.
+     *  @param max_segments
+     *      The capacity of segments array.
+     *  @return
+     *      The count of segments filled.
+     */
+    size_t get_segments(
+        BufferSegment   segments[],
+        const size_t    max_segments
+    ) const noexcept;
+
+    /**
+     *  Return a new chain that references a range of the chain (without
+     *  copying).
+     *
+     *  @throw BufferException
+     *      Raised if 'offset' or 'length' is out of range
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset.
+     *  @param length
+     *      The length.
+     *  @return
+     *      The new chain.
+     */
+    BufferChain slice(const size_t offset, const size_t length) const;
+
+    /**
+     *  Coalesce all segments into one buffer.
+     *
+     *  @note
+     *      No byte is copied if the chain has at most one segment.
+     *  @return
+     *      The buffer.
+     */
+    Buffer flatten() const;
+
+    /**
+     *  Copy bytes of the chain to a buffer.
+     *
+     *  @throw BufferException
+     *      Raised if the offset of destination buffer is out of range
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param destination
+     *      The buffer to copy into.
+     *  @param destination_offset
+     *      The offset of destination buffer.
+     *  @return
+     *      The number of bytes copied.
+     */
+    size_t copy(
+        Buffer          &destination,
+        const size_t    destination_offset = 0U
+    ) const;
+
+    /**
+     *  Read an unsigned 8-bit integer.
+     *
+     *  @throw BufferException
+     *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset.
+     *  @return
+     *      The unsigned 8-bit integer.
+     */
+    uint8_t read_uint8(const size_t offset = 0U) const;
+
+    /**
+     *  Read an unsigned 16-bit integer with big-endian.
+     *
+     *  @throw BufferException
+     *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset.
+     *  @return
+     *      The unsigned 16-bit integer.
+     */
+    uint16_t read_uint16_be(const size_t offset = 0U) const;
+
+    /**
+     *  Read an unsigned 16-bit integer with little-endian.
+     *
+     *  @throw BufferException
+     *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset.
+     *  @return
+     *      The unsigned 16-bit integer.
+     */
+    uint16_t read_uint16_le(const size_t offset = 0U) const;
+
+    /**
+     *  Read an unsigned 32-bit integer with big-endian.
+     *
+     *  @throw BufferException
+     *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset.
+     *  @return
+     *      The unsigned 32-bit integer.
+     */
+    uint32_t read_uint32_be(const size_t offset = 0U) const;
+
+    /**
+     *  Read an unsigned 32-bit integer with little-endian.
+     *
+     *  @throw BufferException
+     *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset.
+     *  @return
+     *      The unsigned 32-bit integer.
+     */
+    uint32_t read_uint32_le(const size_t offset = 0U) const;
+
+#if defined(UINT64_MAX)
+
+    /**
+     *  Read an unsigned 64-bit integer with big-endian.
+     *
+     *  @throw BufferException
+     *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset.
+     *  @return
+     *      The unsigned 64-bit integer.
+     */
+    uint64_t read_uint64_be(const size_t offset = 0U) const;
+
+    /**
+     *  Read an unsigned 64-bit integer with little-endian.
+     *
+     *  @throw BufferException
+     *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset.
+     *  @return
+     *      The unsigned 64-bit integer.
+     */
+    uint64_t read_uint64_le(const size_t offset = 0U) const;
+
+#endif  //  #if defined(UINT64_MAX)
+
+private:
+    //
+    //  Friends.
+    //
+    friend class BufferChainFetcher;
+
+    //
+    //  Private methods.
+    //
+
+    /**
+     *  Locate the segment which contains a byte.
+     *
+     *  @param offset
+     *      The offset of the byte (must be less than the length).
+     *  @param inner
+     *      The pointer to receive the offset inside the segment.
+     *  @return
+     *      The position of the segment.
+     */
+    size_t locate(const size_t offset, size_t *inner) const noexcept;
+
+    /**
+     *  Get the pointer to bytes in chain.
+     *
+     *  @throw BufferException
+     *      Raised if 'offset' or 'size' is out of range
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset.
+     *  @param size
+     *      The count of bytes (must not be 0).
+     *  @param scratch
+     *      The memory (at least 'size' bytes) where to copy the bytes if
+     *      they span multiple segments.
+     *  @return
+     *      The pointer to the bytes (either inside a segment or 'scratch').
+     */
+    const uint8_t* peek_bytes(
+        const size_t    offset,
+        const size_t    size,
+        uint8_t         *scratch
+    ) const;
+
+    //
+    //  Members.
+    //
+    std::deque<Buffer>  m_segments;
+    size_t              m_length;
+};
+
+//
+//  Cursor over a buffer chain (with the same interface as BufferFetcher).
+//
+class BufferChainFetcher {
+public:
+    //
+    //  Constructor.
+    //
+
+    /**
+     *  Construct the object.
+     *
+     *  @param chain
+     *      The chain which would be fetched (must outlive the fetcher, and 
+     *      must not be changed while being fetched).
+     */
+    explicit BufferChainFetcher(const BufferChain &chain) noexcept;
+
+    //
+    //  Public methods.
+    //
+
+    /**
+     *  Check whether the fetcher is ended.
+     *
+     *  @return
+     *      True if so.
+     */
+    bool is_end() const noexcept;
+
+    /**
+     *  Reset the fetcher. Move the cursor to the begin position.
+     */
+    void reset() noexcept;
+
+    /**
+     *  Fetch one byte.
+     *
+     *  @throw BufferException
+     *      Raised if the fetcher was ended (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The byte.
+     */
+    uint8_t fetch();
+
+    /**
+     *  Fetch bytes to buffer.
+     *
+     *  @note
+     *      Nothing would be done if destination size is zero.
+     *  @throw BufferException
+     *      Raised if the fetcher was ended (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param destination
+     *      The destination buffer.
+     *  @return
+     *      The number of bytes fetched.
+     */
+    size_t fetch_to(Buffer &destination);
+
+    /**
+     *  Fetch bytes to buffer.
+     *
+     *  @note
+     *      Nothing would be done if destination size is zero.
+     *  @throw BufferException
+     *      Raised if the fetcher was ended, or the offset of destination
+     *      buffer is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param destination
+     *      The destination buffer.
+     *  @param destination_offset
+     *      The offset of destination buffer.
+     *  @return
+     *      The number of bytes fetched.
+     */
+    size_t fetch_to(Buffer &destination, const size_t destination_offset);
+
+    /**
+     *  Fetch all bytes in chain.
+     *
+     *  @note
+     *      Return zero-size buffer if fetcher is ended.
+     *  @return
+     *      The destination buffer.
+     */
+    Buffer fetch_all();
+
+    /**
+     *  Fetch bytes in chain.
+     *
+     *  @note
+     *      No byte is copied if the bytes are inside one segment.
+     *  @throw BufferException
+     *      Parameter 'count' was out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param count
+     *      The count of bytes would be fetched.
+     *  @return
+     *      The destination buffer.
+     */
+    Buffer fetch_bytes(const size_t count);
+
+    /**
+     *  Skip bytes.
+     *
+     *  @throw BufferException
+     *      Raised if parameter 'count' was out of range
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param count
+     *      The count of bytes would be skiped.
+     */
+    void skip(const size_t count);
+
+    /**
+     *  Get the remaining size.
+     *
+     *  @return
+     *      The remaining size.
+     */
+    size_t get_remaining_size() const noexcept;
+
+private:
+    //
+    //  Private methods.
+    //
+
+    /**
+     *  Move the cursor forward (inside the remaining bytes).
+     *
+     *  @param count
+     *      The count of bytes.
+     */
+    void advance(size_t count) noexcept;
+
+    //
+    //  Members.
+    //
+    const BufferChain  *m_chain;
+    size_t              m_index;
+    size_t              m_inner;
+    size_t              m_position;
+};
+
+}  //  namespace buffer
+}  //  namespace core
+}  //  namespace xap
+
+
+#endif  //  #ifndef XAP_CORE_BUFFER_CHAIN_H__
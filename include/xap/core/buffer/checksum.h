@@ -0,0 +1,415 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+#ifndef XAP_CORE_BUFFER_CHECKSUM_H__
+#define XAP_CORE_BUFFER_CHECKSUM_H__
+
+//
+//  Imports.
+//
+#include <stddef.h>
+#include <stdint.h>
+#include <xap/core/buffer/buffer.h>
+#include <xap/core/buffer/chain.h>
+#include <xap/core/buffer/queue.h>
+
+namespace xap {
+namespace core {
+namespace buffer {
+
+//
+//  Classes.
+//
+//  The checksums are streaming: update() may be called any number of times
+//  (e.g. once per chunk pushed into or fetched from a queue), the value is
+//  the same as computing it over the concatenated bytes at once.
+//
+
+//
+//  CRC-32 (ISO-HDLC, as used by zlib / Ethernet).
+//
+//  Uses the ARMv8 CRC instructions if available (see build.h), otherwise
+//  a slicing-by-8 table.
+//
+class BufferCrc32 {
+public:
+    //
+    //  Constructor.
+    //
+
+    /**
+     *  Construct the object.
+     */
+    BufferCrc32() noexcept;
+
+    //
+    //  Public methods.
+    //
+
+    /**
+     *  Update the checksum with bytes.
+     *
+     *  @param data
+     *      The bytes.
+     *  @param datalen
+     *      The count of bytes.
+     */
+    void update(const uint8_t *data, const size_t datalen) noexcept;
+
+    /**
+     *  Update the checksum with the bytes of a buffer.
+     *
+     *  @param buffer
+     *      The buffer.
+     */
+    void update(const Buffer &buffer) noexcept;
+
+    /**
+     *  Update the checksum with the bytes of a chain (without flattening).
+     *
+     *  @param chain
+     *      The chain.
+     */
+    void update(const BufferChain &chain) noexcept;
+
+    /**
+     *  Update the checksum with the remaining bytes of a queue (without
+     *  coalescing or consuming).
+     *
+     *  @throw std::bad_alloc
+     *      Raised if failed to allocate memory.
+     *  @param queue
+     *      The queue.
+     */
+    void update(const BufferQueue &queue);
+
+    /**
+     *  Get the checksum of the bytes so far.
+     *
+     *  @return
+     *      The checksum.
+     */
+    uint32_t get_value() const noexcept;
+
+    /**
+     *  Reset the checksum (as if no byte was updated).
+     */
+    void reset() noexcept;
+
+    //
+    //  Public functions.
+    //
+
+    /**
+     *  Compute the checksum of the bytes of a buffer.
+     *
+     *  @param buffer
+     *      The buffer.
+     *  @return
+     *      The checksum.
+     */
+    static uint32_t compute(const Buffer &buffer) noexcept;
+
+private:
+    //
+    //  Members.
+    //
+    uint32_t        m_state;
+};
+
+//
+//  CRC-32C (Castagnoli, as used by iSCSI / SCTP / ext4).
+//
+//  Uses the SSE4.2 or ARMv8 CRC instructions if available (see build.h),
+//  otherwise a slicing-by-8 table.
+//
+class BufferCrc32c {
+public:
+    //
+    //  Constructor.
+    //
+
+    /**
+     *  Construct the object.
+     */
+    BufferCrc32c() noexcept;
+
+    //
+    //  Public methods.
+    //
+
+    /**
+     *  Update the checksum with bytes.
+     *
+     *  @param data
+     *      The bytes.
+     *  @param datalen
+     *      The count of bytes.
+     */
+    void update(const uint8_t *data, const size_t datalen) noexcept;
+
+    /**
+     *  Update the checksum with the bytes of a buffer.
+     *
+     *  @param buffer
+     *      The buffer.
+     */
+    void update(const Buffer &buffer) noexcept;
+
+    /**
+     *  Update the checksum with the bytes of a chain (without flattening).
+     *
+     *  @param chain
+     *      The chain.
+     */
+    void update(const BufferChain &chain) noexcept;
+
+    /**
+     *  Update the checksum with the remaining bytes of a queue (without
+     *  coalescing or consuming).
+     *
+     *  @throw std::bad_alloc
+     *      Raised if failed to allocate memory.
+     *  @param queue
+     *      The queue.
+     */
+    void update(const BufferQueue &queue);
+
+    /**
+     *  Get the checksum of the bytes so far.
+     *
+     *  @return
+     *      The checksum.
+     */
+    uint32_t get_value() const noexcept;
+
+    /**
+     *  Reset the checksum (as if no byte was updated).
+     */
+    void reset() noexcept;
+
+    //
+    //  Public functions.
+    //
+
+    /**
+     *  Compute the checksum of the bytes of a buffer.
+     *
+     *  @param buffer
+     *      The buffer.
+     *  @return
+     *      The checksum.
+     */
+    static uint32_t compute(const Buffer &buffer) noexcept;
+
+private:
+    //
+    //  Members.
+    //
+    uint32_t        m_state;
+};
+
+//
+//  Adler-32 (as used by zlib).
+//
+class BufferAdler32 {
+public:
+    //
+    //  Constructor.
+    //
+
+    /**
+     *  Construct the object.
+     */
+    BufferAdler32() noexcept;
+
+    //
+    //  Public methods.
+    //
+
+    /**
+     *  Update the checksum with bytes.
+     *
+     *  @param data
+     *      The bytes.
+     *  @param datalen
+     *      The count of bytes.
+     */
+    void update(const uint8_t *data, const size_t datalen) noexcept;
+
+    /**
+     *  Update the checksum with the bytes of a buffer.
+     *
+     *  @param buffer
+     *      The buffer.
+     */
+    void update(const Buffer &buffer) noexcept;
+
+    /**
+     *  Update the checksum with the bytes of a chain (without flattening).
+     *
+     *  @param chain
+     *      The chain.
+     */
+    void update(const BufferChain &chain) noexcept;
+
+    /**
+     *  Update the checksum with the remaining bytes of a queue (without
+     *  coalescing or consuming).
+     *
+     *  @throw std::bad_alloc
+     *      Raised if failed to allocate memory.
+     *  @param queue
+     *      The queue.
+     */
+    void update(const BufferQueue &queue);
+
+    /**
+     *  Get the checksum of the bytes so far.
+     *
+     *  @return
+     *      The checksum.
+     */
+    uint32_t get_value() const noexcept;
+
+    /**
+     *  Reset the checksum (as if no byte was updated).
+     */
+    void reset() noexcept;
+
+    //
+    //  Public functions.
+    //
+
+    /**
+     *  Compute the checksum of the bytes of a buffer.
+     *
+     *  @param buffer
+     *      The buffer.
+     *  @return
+     *      The checksum.
+     */
+    static uint32_t compute(const Buffer &buffer) noexcept;
+
+private:
+    //
+    //  Members.
+    //
+    uint32_t        m_a;
+    uint32_t        m_b;
+};
+
+#if defined(UINT64_MAX)
+
+//
+//  XXH64 hash (non-cryptographic, e.g. for deduplication).
+//
+class BufferXxh64 {
+public:
+    //
+    //  Constructor.
+    //
+
+    /**
+     *  Construct the object.
+     *
+     *  @param seed
+     *      The seed (default 0).
+     */
+    explicit BufferXxh64(const uint64_t seed = 0U) noexcept;
+
+    //
+    //  Public methods.
+    //
+
+    /**
+     *  Update the hash with bytes.
+     *
+     *  @param data
+     *      The bytes.
+     *  @param datalen
+     *      The count of bytes.
+     */
+    void update(const uint8_t *data, const size_t datalen) noexcept;
+
+    /**
+     *  Update the hash with the bytes of a buffer.
+     *
+     *  @param buffer
+     *      The buffer.
+     */
+    void update(const Buffer &buffer) noexcept;
+
+    /**
+     *  Update the hash with the bytes of a chain (without flattening).
+     *
+     *  @param chain
+     *      The chain.
+     */
+    void update(const BufferChain &chain) noexcept;
+
+    /**
+     *  Update the hash with the remaining bytes of a queue (without
+     *  coalescing or consuming).
+     *
+     *  @throw std::bad_alloc
+     *      Raised if failed to allocate memory.
+     *  @param queue
+     *      The queue.
+     */
+    void update(const BufferQueue &queue);
+
+    /**
+     *  Get the hash of the bytes so far.
+     *
+     *  @return
+     *      The hash.
+     */
+    uint64_t get_value() const noexcept;
+
+    /**
+     *  Reset the hash (as if no byte was updated, the seed is kept).
+     */
+    void reset() noexcept;
+
+    //
+    //  Public functions.
+    //
+
+    /**
+     *  Compute the hash of the bytes of a buffer.
+     *
+     *  @param buffer
+     *      The buffer.
+     *  @param seed
+     *      The seed (default 0).
+     *  @return
+     *      The hash.
+     */
+    static uint64_t compute(
+        const Buffer    &buffer,
+        const uint64_t  seed = 0U
+    ) noexcept;
+
+private:
+    //
+    //  Members.
+    //
+    uint64_t        m_seed;
+    uint64_t        m_total;
+    uint64_t        m_accumulators[4];
+    uint8_t         m_pending[32];
+    size_t          m_pending_length;
+};
+
+#endif  //  #if defined(UINT64_MAX)
+
+}  //  namespace buffer
+}  //  namespace core
+}  //  namespace xap
+
+
+#endif  //  #ifndef XAP_CORE_BUFFER_CHECKSUM_H__
@@ -0,0 +1,190 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+#ifndef XAP_CORE_BUFFER_CONCURRENT_H__
+#define XAP_CORE_BUFFER_CONCURRENT_H__
+
+//
+//  Imports.
+//
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+#include <xap/core/buffer/buffer.h>
+#include <xap/core/buffer/error.h>
+
+namespace xap {
+namespace core {
+namespace buffer {
+
+//
+//  Classes.
+//
+
+//
+//  Lock-free single-producer / single-consumer buffer queue.
+//
+//  One thread may call push(), another thread may call pop(), pop_all()
+//  and wait(). get_remaining_size() may be called from any thread. Chunks
+//  are handed over through a linked list of segments (fixed-size arrays of
+//  64 chunk slots). Drained segments are handed back to the producer 
+//  through a lock-free free list (up to 16 of them), so segments are only 
+//  allocated while the backlog grows beyond what was recycled. push() 
+//  never blocks, and takes the mutex only to wake the consumer up while it
+//  is blocked in wait().
+//
+class ConcurrentBufferQueue {
+public:
+    //
+    //  Constructor & destructor.
+    //
+
+    /**
+     *  Construct the object.
+     */
+    ConcurrentBufferQueue();
+
+    /**
+     *  Destruct the object.
+     */
+    ~ConcurrentBufferQueue() noexcept;
+
+    //
+    //  Public methods.
+    //
+
+    /**
+     *  Push buffer to queue (producer only).
+     *
+     *  @param data
+     *      The data.
+     */
+    void push(const Buffer &data);
+
+    /**
+     *  Push buffer to queue (producer only).
+     *
+     *  @param data
+     *      The data (would be moved into queue).
+     */
+    void push(Buffer &&data);
+
+    /**
+     *  Pop buffer from queue (consumer only).
+     *
+     *  @throw BufferException
+     *      Raised if parameter 'size' was out of range
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param size
+     *      The size of buffer.
+     *  @return
+     *      The buffer.
+     */
+    Buffer pop(const size_t size);
+
+    /**
+     *  Pop all data from queue (consumer only).
+     *
+     *  @return
+     *      The buffer.
+     */
+    Buffer pop_all();
+
+    /**
+     *  Wait until the queue holds at least specified count of bytes
+     *  (consumer only).
+     *
+     *  @param size
+     *      The count of bytes.
+     *  @param timeout_ms
+     *      The timeout in milliseconds.
+     *  @return
+     *      True if the bytes are available, false if timed out.
+     */
+    bool wait(const size_t size, const uint32_t timeout_ms);
+
+    /**
+     *  Get the remaining size.
+     *
+     *  @return
+     *      The size of remaining bytes.
+     */
+    size_t get_remaining_size() const noexcept;
+
+private:
+    //
+    //  Private structures.
+    //
+
+    //
+    //  Segment of chunk slots.
+    //
+    struct Segment;
+
+    //
+    //  Private methods.
+    //
+
+    /**
+     *  Take the next chunk into the front chunk (consumer only).
+     *
+     *  @note
+     *      The caller must guarantee that a chunk was published.
+     */
+    void take_chunk() noexcept;
+
+    /**
+     *  Get an empty segment, recycled if possible (producer only).
+     *
+     *  @throw std::bad_alloc
+     *      Raised if failed to allocate memory.
+     *  @return
+     *      The segment.
+     */
+    Segment* acquire_segment();
+
+    /**
+     *  Hand a drained segment back to the producer, or delete it if enough
+     *  segments are spare (consumer only).
+     *
+     *  @param segment
+     *      The segment.
+     */
+    void recycle_segment(Segment *segment) noexcept;
+
+    //
+    //  Members.
+    //
+
+    //  The remaining size (written by both sides).
+    std::atomic<size_t>         m_remaining;
+
+    //  The producer side.
+    Segment                    *m_tail;
+
+    //  The consumer side (the front chunk and its read cursor).
+    Segment                    *m_head;
+    size_t                      m_head_index;
+    Buffer                      m_front;
+    size_t                      m_front_cursor;
+
+    //  The spare segments (pushed by the consumer, popped by the producer).
+    std::atomic<Segment*>       m_spare;
+    std::atomic<size_t>         m_spare_count;
+
+    //  Waiting path.
+    std::atomic<bool>           m_waiting;
+    std::mutex                  m_wait_lock;
+    std::condition_variable     m_wait_condition;
+};
+
+}  //  namespace buffer
+}  //  namespace core
+}  //  namespace xap
+
+
+#endif  //  #ifndef XAP_CORE_BUFFER_CONCURRENT_H__
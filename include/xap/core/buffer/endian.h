@@ -0,0 +1,259 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+#ifndef XAP_CORE_BUFFER_ENDIAN_H__
+#define XAP_CORE_BUFFER_ENDIAN_H__
+
+//
+//  Imports.
+//
+#include <stdint.h>
+
+namespace xap {
+namespace core {
+namespace buffer {
+
+//
+//  Public functions.
+//
+//  These functions don't check the memory range, the caller must guarantee
+//  that the bytes are accessible. The shift patterns are recognized by
+//  mainstream compilers and compiled into single (byte-swapped) loads and
+//  stores.
+//
+
+/**
+ *  Read an unsigned 16-bit integer with big-endian.
+ *
+ *  @param pointer
+ *      The pointer to the first byte.
+ *  @return
+ *      The unsigned 16-bit integer.
+ */
+inline uint16_t endian_read_uint16_be(const uint8_t *pointer) noexcept {
+    return static_cast<uint16_t>(
+        (static_cast<uint16_t>(pointer[0U]) << 8U) |
+        (static_cast<uint16_t>(pointer[1U]))
+    );
+}
+
+/**
+ *  Read an unsigned 16-bit integer with little-endian.
+ *
+ *  @param pointer
+ *      The pointer to the first byte.
+ *  @return
+ *      The unsigned 16-bit integer.
+ */
+inline uint16_t endian_read_uint16_le(const uint8_t *pointer) noexcept {
+    return static_cast<uint16_t>(
+        (static_cast<uint16_t>(pointer[1U]) << 8U) |
+        (static_cast<uint16_t>(pointer[0U]))
+    );
+}
+
+/**
+ *  Read an unsigned 32-bit integer with big-endian.
+ *
+ *  @param pointer
+ *      The pointer to the first byte.
+ *  @return
+ *      The unsigned 32-bit integer.
+ */
+inline uint32_t endian_read_uint32_be(const uint8_t *pointer) noexcept {
+    return static_cast<uint32_t>(
+        (static_cast<uint32_t>(pointer[0U]) << 24U) |
+        (static_cast<uint32_t>(pointer[1U]) << 16U) |
+        (static_cast<uint32_t>(pointer[2U]) <<  8U) |
+        (static_cast<uint32_t>(pointer[3U]))
+    );
+}
+
+/**
+ *  Read an unsigned 32-bit integer with little-endian.
+ *
+ *  @param pointer
+ *      The pointer to the first byte.
+ *  @return
+ *      The unsigned 32-bit integer.
+ */
+inline uint32_t endian_read_uint32_le(const uint8_t *pointer) noexcept {
+    return static_cast<uint32_t>(
+        (static_cast<uint32_t>(pointer[3U]) << 24U) |
+        (static_cast<uint32_t>(pointer[2U]) << 16U) |
+        (static_cast<uint32_t>(pointer[1U]) <<  8U) |
+        (static_cast<uint32_t>(pointer[0U]))
+    );
+}
+
+#if defined(UINT64_MAX)
+
+/**
+ *  Read an unsigned 64-bit integer with big-endian.
+ *
+ *  @param pointer
+ *      The pointer to the first byte.
+ *  @return
+ *      The unsigned 64-bit integer.
+ */
+inline uint64_t endian_read_uint64_be(const uint8_t *pointer) noexcept {
+    return static_cast<uint64_t>(
+        (static_cast<uint64_t>(pointer[0U]) << 56U) |
+        (static_cast<uint64_t>(pointer[1U]) << 48U) |
+        (static_cast<uint64_t>(pointer[2U]) << 40U) |
+        (static_cast<uint64_t>(pointer[3U]) << 32U) |
+        (static_cast<uint64_t>(pointer[4U]) << 24U) |
+        (static_cast<uint64_t>(pointer[5U]) << 16U) |
+        (static_cast<uint64_t>(pointer[6U]) <<  8U) |
+        (static_cast<uint64_t>(pointer[7U]))
+    );
+}
+
+/**
+ *  Read an unsigned 64-bit integer with little-endian.
+ *
+ *  @param pointer
+ *      The pointer to the first byte.
+ *  @return
+ *      The unsigned 64-bit integer.
+ */
+inline uint64_t endian_read_uint64_le(const uint8_t *pointer) noexcept {
+    return static_cast<uint64_t>(
+        (static_cast<uint64_t>(pointer[7U]) << 56U) |
+        (static_cast<uint64_t>(pointer[6U]) << 48U) |
+        (static_cast<uint64_t>(pointer[5U]) << 40U) |
+        (static_cast<uint64_t>(pointer[4U]) << 32U) |
+        (static_cast<uint64_t>(pointer[3U]) << 24U) |
+        (static_cast<uint64_t>(pointer[2U]) << 16U) |
+        (static_cast<uint64_t>(pointer[1U]) <<  8U) |
+        (static_cast<uint64_t>(pointer[0U]))
+    );
+}
+
+#endif  //  #if defined(UINT64_MAX)
+
+/**
+ *  Write an unsigned 16-bit integer with big-endian.
+ *
+ *  @param pointer
+ *      The pointer to the first byte.
+ *  @param value
+ *      The unsigned 16-bit integer.
+ */
+inline void endian_write_uint16_be(
+    uint8_t         *pointer,
+    const uint16_t  value
+) noexcept {
+    pointer[0U] = static_cast<uint8_t>(value >> 8U);
+    pointer[1U] = static_cast<uint8_t>(value);
+}
+
+/**
+ *  Write an unsigned 16-bit integer with little-endian.
+ *
+ *  @param pointer
+ *      The pointer to the first byte.
+ *  @param value
+ *      The unsigned 16-bit integer.
+ */
+inline void endian_write_uint16_le(
+    uint8_t         *pointer,
+    const uint16_t  value
+) noexcept {
+    pointer[1U] = static_cast<uint8_t>(value >> 8U);
+    pointer[0U] = static_cast<uint8_t>(value);
+}
+
+/**
+ *  Write an unsigned 32-bit integer with big-endian.
+ *
+ *  @param pointer
+ *      The pointer to the first byte.
+ *  @param value
+ *      The unsigned 32-bit integer.
+ */
+inline void endian_write_uint32_be(
+    uint8_t         *pointer,
+    const uint32_t  value
+) noexcept {
+    pointer[0U] = static_cast<uint8_t>(value >> 24U);
+    pointer[1U] = static_cast<uint8_t>(value >> 16U);
+    pointer[2U] = static_cast<uint8_t>(value >>  8U);
+    pointer[3U] = static_cast<uint8_t>(value);
+}
+
+/**
+ *  Write an unsigned 32-bit integer with little-endian.
+ *
+ *  @param pointer
+ *      The pointer to the first byte.
+ *  @param value
+ *      The unsigned 32-bit integer.
+ */
+inline void endian_write_uint32_le(
+    uint8_t         *pointer,
+    const uint32_t  value
+) noexcept {
+    pointer[3U] = static_cast<uint8_t>(value >> 24U);
+    pointer[2U] = static_cast<uint8_t>(value >> 16U);
+    pointer[1U] = static_cast<uint8_t>(value >>  8U);
+    pointer[0U] = static_cast<uint8_t>(value);
+}
+
+#if defined(UINT64_MAX)
+
+/**
+ *  Write an unsigned 64-bit integer with big-endian.
+ *
+ *  @param pointer
+ *      The pointer to the first byte.
+ *  @param value
+ *      The unsigned 64-bit integer.
+ */
+inline void endian_write_uint64_be(
+    uint8_t         *pointer,
+    const uint64_t  value
+) noexcept {
+    pointer[0U] = static_cast<uint8_t>(value >> 56U);
+    pointer[1U] = static_cast<uint8_t>(value >> 48U);
+    pointer[2U] = static_cast<uint8_t>(value >> 40U);
+    pointer[3U] = static_cast<uint8_t>(value >> 32U);
+    pointer[4U] = static_cast<uint8_t>(value >> 24U);
+    pointer[5U] = static_cast<uint8_t>(value >> 16U);
+    pointer[6U] = static_cast<uint8_t>(value >>  8U);
+    pointer[7U] = static_cast<uint8_t>(value);
+}
+
+/**
+ *  Write an unsigned 64-bit integer with little-endian.
+ *
+ *  @param pointer
+ *      The pointer to the first byte.
+ *  @param value
+ *      The unsigned 64-bit integer.
+ */
+inline void endian_write_uint64_le(
+    uint8_t         *pointer,
+    const uint64_t  value
+) noexcept {
+    pointer[7U] = static_cast<uint8_t>(value >> 56U);
+    pointer[6U] = static_cast<uint8_t>(value >> 48U);
+    pointer[5U] = static_cast<uint8_t>(value >> 40U);
+    pointer[4U] = static_cast<uint8_t>(value >> 32U);
+    pointer[3U] = static_cast<uint8_t>(value >> 24U);
+    pointer[2U] = static_cast<uint8_t>(value >> 16U);
+    pointer[1U] = static_cast<uint8_t>(value >>  8U);
+    pointer[0U] = static_cast<uint8_t>(value);
+}
+
+#endif  //  #if defined(UINT64_MAX)
+
+}  //  namespace buffer
+}  //  namespace core
+}  //  namespace xap
+
+
+#endif  //  #ifndef XAP_CORE_BUFFER_ENDIAN_H__
@@ -23,8 +23,10 @@ namespace buffer {
 //
 
 //  Error code.
-static const uint16_t XAPCORE_BUF_ERROR           = 4000U;
-static const uint16_t XAPCORE_BUF_ERROR_OVERFLOW  = 4001U;
+static const uint16_t XAPCORE_BUF_ERROR               = 4000U;
+static const uint16_t XAPCORE_BUF_ERROR_OVERFLOW      = 4001U;
+static const uint16_t XAPCORE_BUF_ERROR_INVALID_SIZE  = 4002U;
+static const uint16_t XAPCORE_BUF_ERROR_IO            = 4003U;
 
 //
 //  Classes.
@@ -13,6 +13,7 @@
 #include <memory>
 #include <stdint.h>
 #include <xap/core/buffer/buffer.h>
+#include <xap/core/buffer/endian.h>
 #include <xap/core/buffer/error.h>
 
 namespace xap {
@@ -37,6 +38,14 @@ public:
      */
     BufferFetcher(const Buffer &buffer);
 
+    /**
+     *  Cosntruct the object.
+     * 
+     *  @param buffer
+     *      The buffer which would be fetched (would be moved into fetcher).
+     */
+    BufferFetcher(Buffer &&buffer);
+
     /**
      *  Construct (Copy) the object.
      * 
@@ -45,6 +54,14 @@ public:
      */
     BufferFetcher(const BufferFetcher &src) noexcept;
 
+    /**
+     *  Construct (Move) the object.
+     * 
+     *  @param src
+     *      The source fetcher (would be empty after moved).
+     */
+    BufferFetcher(BufferFetcher &&src) noexcept;
+
     /**
      *  Destruct the object.
      */
@@ -64,6 +81,16 @@ public:
      */
     BufferFetcher& operator=(const BufferFetcher& src) noexcept;
 
+    /**
+     *  Operator '=' (move).
+     * 
+     *  @param src
+     *      The source fetcher (would be empty after moved).
+     *  @return
+     *      The destination fetcher.
+     */
+    BufferFetcher& operator=(BufferFetcher&& src) noexcept;
+
     //
     //  Public methods.
     //
@@ -143,6 +170,165 @@ public:
      */
     Buffer fetch_bytes(const size_t count);
 
+    /**
+     *  Fetch an unsigned 8-bit integer.
+     * 
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The unsigned 8-bit integer.
+     */
+    uint8_t fetch_uint8();
+
+    /**
+     *  Fetch an unsigned 16-bit integer with big-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The unsigned 16-bit integer.
+     */
+    uint16_t fetch_uint16_be();
+
+    /**
+     *  Fetch an unsigned 16-bit integer with little-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The unsigned 16-bit integer.
+     */
+    uint16_t fetch_uint16_le();
+
+    /**
+     *  Fetch a signed 16-bit integer with little-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The signed 16-bit integer.
+     */
+    int16_t fetch_sint16_le();
+
+    /**
+     *  Fetch an unsigned 32-bit integer with big-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The unsigned 32-bit integer.
+     */
+    uint32_t fetch_uint32_be();
+
+    /**
+     *  Fetch an unsigned 32-bit integer with little-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The unsigned 32-bit integer.
+     */
+    uint32_t fetch_uint32_le();
+
+#if defined(UINT64_MAX)
+
+    /**
+     *  Fetch an unsigned 64-bit integer with big-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The unsigned 64-bit integer.
+     */
+    uint64_t fetch_uint64_be();
+
+    /**
+     *  Fetch an unsigned 64-bit integer with little-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The unsigned 64-bit integer.
+     */
+    uint64_t fetch_uint64_le();
+
+    /**
+     *  Fetch an unsigned integer with variable-length (LEB128) encoding.
+     * 
+     *  @throw BufferException
+     *      Raised if the encoding is truncated or longer than 64 bits, the
+     *      cursor is not moved (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The unsigned integer.
+     */
+    uint64_t fetch_varint();
+
+    /**
+     *  Fetch a signed integer with zigzag and variable-length (LEB128) 
+     *  encoding.
+     * 
+     *  @throw BufferException
+     *      Raised if the encoding is truncated or longer than 64 bits, the
+     *      cursor is not moved (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The signed integer.
+     */
+    int64_t fetch_varint_signed();
+
+#endif  //  #if defined(UINT64_MAX)
+
+    /**
+     *  Fetch a single-precision float-point with big-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The single-precision float-point value.
+     */
+    float fetch_float_be();
+
+    /**
+     *  Fetch a single-precision float-point with little-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The single-precision float-point value.
+     */
+    float fetch_float_le();
+
+    /**
+     *  Fetch a double-precision float-point with big-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The double-precision float-point value.
+     */
+    double fetch_double_be();
+
+    /**
+     *  Fetch a double-precision float-point with little-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The double-precision float-point value.
+     */
+    double fetch_double_le();
+
     /**
      *  Skip bytes.
      * 
@@ -164,6 +350,37 @@ public:
      */
     size_t get_remaining_size() const noexcept;
 
+    /**
+     *  Get the raw pointer to the cursor position.
+     * 
+     *  @note
+     *      The remaining bytes (see get_remaining_size()) are readable from 
+     *      the pointer.
+     *  @return
+     *      The raw pointer.
+     */
+    const uint8_t* get_pointer() const noexcept;
+
+    /**
+     *  Find the first occurrence of a byte in the remaining bytes.
+     * 
+     *  @param value
+     *      The byte.
+     *  @return
+     *      The offset relative to the cursor (Buffer::NPOS if not found).
+     */
+    size_t index_of(const uint8_t value) const noexcept;
+
+    /**
+     *  Find the first occurrence of a byte sequence in the remaining bytes.
+     * 
+     *  @param needle
+     *      The byte sequence.
+     *  @return
+     *      The offset relative to the cursor (Buffer::NPOS if not found).
+     */
+    size_t index_of(const Buffer &needle) const noexcept;
+
     /**
      *  Replace (reset) the fetch with another new buffer.
      * 
@@ -172,11 +389,28 @@ public:
      */
     void replace(const Buffer &new_buffer);
 
+    /**
+     *  Replace (reset) the fetch with another new buffer.
+     * 
+     *  @param new_buffer
+     *      The buffer (would be moved into fetcher).
+     */
+    void replace(Buffer &&new_buffer);
+
 private:
     //
     //  Private functions.
     //
 
+    /**
+     *  Raise the end-of-buffer error (kept out of line, so that the 
+     *  inlined fetches stay small).
+     * 
+     *  @throw BufferException
+     *      Always (XAPCORE_BUF_ERROR_OVERFLOW).
+     */
+    [[noreturn]] static void raise_eof();
+
     /**
      *  Expected fetcher was not ended.
      * 
@@ -185,15 +419,235 @@ private:
      */
     void assert_not_eof();
 
+    /**
+     *  Move the cursor over bytes, get the pointer to them.
+     * 
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param count
+     *      The count of bytes.
+     *  @return
+     *      The pointer to the first byte.
+     */
+    const uint8_t* take(const size_t count);
+
+    /**
+     *  Get the offset of the cursor.
+     * 
+     *  @return
+     *      The offset.
+     */
+    size_t get_offset() const noexcept;
+
+    /**
+     *  Prepare the cached pointers (, and move the cursor to the begin 
+     *  position).
+     */
+    void prepare() noexcept;
+
     //
     //  Members.
     //
-    size_t                   m_cursor;
-    Buffer                  *m_buffer;
-    size_t                   m_buffer_length;
-    std::shared_ptr<Buffer>  m_buffer_shared_pointer;
+    Buffer              m_buffer;
+    const uint8_t      *m_begin;
+    const uint8_t      *m_cursor;
+    const uint8_t      *m_end;
 };
 
+//
+//  Inline methods.
+//
+//  The hot accessors are defined here so that they can be inlined into the 
+//  callers. The cold paths stay in fetcher.cc.
+//
+
+/**
+ *  Check whether the fetcher is ended.
+ * 
+ *  @return
+ *      True if so.
+ */
+inline bool BufferFetcher::is_end() const noexcept {
+    return this->m_cursor == this->m_end;
+}
+
+/**
+ *  Fetch one byte.
+ * 
+ *  @throw BufferException
+ *      Raised if the buffer fetcher was ended (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The byte.
+ */
+inline uint8_t BufferFetcher::fetch() {
+    if (this->m_cursor == this->m_end) {
+        raise_eof();
+    }
+    return *(this->m_cursor++);
+}
+
+/**
+ *  Fetch an unsigned 8-bit integer.
+ * 
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The unsigned 8-bit integer.
+ */
+inline uint8_t BufferFetcher::fetch_uint8() {
+    return *(this->take(1U));
+}
+
+/**
+ *  Fetch an unsigned 16-bit integer with big-endian.
+ * 
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The unsigned 16-bit integer.
+ */
+inline uint16_t BufferFetcher::fetch_uint16_be() {
+    return endian_read_uint16_be(this->take(2U));
+}
+
+/**
+ *  Fetch an unsigned 16-bit integer with little-endian.
+ * 
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The unsigned 16-bit integer.
+ */
+inline uint16_t BufferFetcher::fetch_uint16_le() {
+    return endian_read_uint16_le(this->take(2U));
+}
+
+/**
+ *  Fetch a signed 16-bit integer with little-endian.
+ * 
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The signed 16-bit integer.
+ */
+inline int16_t BufferFetcher::fetch_sint16_le() {
+    return static_cast<int16_t>(endian_read_uint16_le(this->take(2U)));
+}
+
+/**
+ *  Fetch an unsigned 32-bit integer with big-endian.
+ * 
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The unsigned 32-bit integer.
+ */
+inline uint32_t BufferFetcher::fetch_uint32_be() {
+    return endian_read_uint32_be(this->take(4U));
+}
+
+/**
+ *  Fetch an unsigned 32-bit integer with little-endian.
+ * 
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The unsigned 32-bit integer.
+ */
+inline uint32_t BufferFetcher::fetch_uint32_le() {
+    return endian_read_uint32_le(this->take(4U));
+}
+
+#if defined(UINT64_MAX)
+
+/**
+ *  Fetch an unsigned 64-bit integer with big-endian.
+ * 
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The unsigned 64-bit integer.
+ */
+inline uint64_t BufferFetcher::fetch_uint64_be() {
+    return endian_read_uint64_be(this->take(8U));
+}
+
+/**
+ *  Fetch an unsigned 64-bit integer with little-endian.
+ * 
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The unsigned 64-bit integer.
+ */
+inline uint64_t BufferFetcher::fetch_uint64_le() {
+    return endian_read_uint64_le(this->take(8U));
+}
+
+#endif  //  #if defined(UINT64_MAX)
+
+/**
+ *  Get the remaining size.
+ * 
+ *  @return
+ *      The remaining size.
+ */
+inline size_t BufferFetcher::get_remaining_size() const noexcept {
+    return static_cast<size_t>(this->m_end - this->m_cursor);
+}
+
+/**
+ *  Get the raw pointer to the cursor position.
+ * 
+ *  @note
+ *      The remaining bytes (see get_remaining_size()) are readable from 
+ *      the pointer.
+ *  @return
+ *      The raw pointer.
+ */
+inline const uint8_t* BufferFetcher::get_pointer() const noexcept {
+    return this->m_cursor;
+}
+
+/**
+ *  Move the cursor over bytes, get the pointer to them.
+ * 
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param count
+ *      The count of bytes.
+ *  @return
+ *      The pointer to the first byte.
+ */
+inline const uint8_t* BufferFetcher::take(const size_t count) {
+    if (count > this->get_remaining_size()) {
+        raise_eof();
+    }
+    const uint8_t *pointer = this->m_cursor;
+    this->m_cursor += count;
+    return pointer;
+}
+
+/**
+ *  Get the offset of the cursor.
+ * 
+ *  @return
+ *      The offset.
+ */
+inline size_t BufferFetcher::get_offset() const noexcept {
+    return static_cast<size_t>(this->m_cursor - this->m_begin);
+}
+
 }  //  namespace buffer
 }  //  namespace core
 }  //  namespace xap
@@ -0,0 +1,233 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+#ifndef XAP_CORE_BUFFER_IO_H__
+#define XAP_CORE_BUFFER_IO_H__
+
+//
+//  Imports.
+//
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include <xap/core/buffer/allocator.h>
+#include <xap/core/buffer/buffer.h>
+#include <xap/core/buffer/queue.h>
+
+namespace xap {
+namespace core {
+namespace buffer {
+
+//
+//  Enumerations.
+//
+
+//
+//  Result of BufferReader::read_some().
+//
+enum BufferReadStatus {
+    //  Some bytes were read and pushed into the queue.
+    BUFFER_READ_DATA        = 0,
+
+    //  No byte is available now (the descriptor is non-blocking).
+    BUFFER_READ_AGAIN       = 1,
+
+    //  The end of file was reached (or the peer closed the connection).
+    BUFFER_READ_END         = 2,
+
+    //  The queue reached its maximum size, nothing was read.
+    BUFFER_READ_FULL        = 3
+};
+
+//
+//  Classes.
+//
+
+//
+//  Reader which fills a queue from a file descriptor (POSIX only).
+//
+//  Each read is a single readv() into a batch of chunks, the bytes read are
+//  pushed into the queue as slices of the chunks (without copying). A chunk
+//  which was only partially filled is kept for the next read, so the
+//  storage is allocated once per 'chunk_size' bytes rather than once per
+//  read. Allocate the chunks from a BufferPoolAllocator (with a biggest 
+//  class not less than 'chunk_size') to recycle the storage: a chunk 
+//  returns to the pool as soon as the last buffer which references it is 
+//  destroyed. The pool serves the control blocks of chunks apart from 
+//  their storage, so a power-of-2 chunk (e.g. the default 16 KiB) takes 
+//  exactly one block of its own class.
+//
+//  The reader is designed for readiness-based event loops (e.g. epoll /
+//  kqueue), call read_some() (or read_available()) when the descriptor
+//  becomes readable.
+//
+class BufferReader {
+public:
+    //
+    //  Constructor & destructor.
+    //
+
+    /**
+     *  Construct the object.
+     *
+     *  @throw BufferException
+     *      Raised if 'chunk_size' or 'batch' is 0
+     *      (XAPCORE_BUF_ERROR_INVALID_SIZE).
+     *  @param queue
+     *      The queue to fill (must outlive the reader).
+     *  @param chunk_size
+     *      The size of chunks (default 16 KiB, a pool class size).
+     *  @param batch
+     *      The maximum count of chunks filled by one read (default 4, at
+     *      most 64).
+     *  @param allocator
+     *      The allocator of chunk storage (must outlive the chunks).
+     */
+    explicit BufferReader(
+        BufferQueue     &queue,
+        const size_t    chunk_size = 16384U,
+        const size_t    batch = 4U,
+        BufferAllocator &allocator = BufferAllocator::get_default()
+    );
+
+    /**
+     *  Construct (copy) the object (deleted).
+     */
+    BufferReader(const BufferReader&) = delete;
+
+    /**
+     *  Destruct the object.
+     */
+    ~BufferReader() noexcept;
+
+    //
+    //  Public operators.
+    //
+
+    /**
+     *  Operator '=' (deleted).
+     */
+    BufferReader& operator=(const BufferReader&) = delete;
+
+    //
+    //  Public methods.
+    //
+
+    /**
+     *  Read once from a file descriptor (one system call, retried if
+     *  interrupted by a signal).
+     *
+     *  @note
+     *      The read is limited by the free space of the queue if its
+     *      maximum size was set.
+     *  @throw BufferException
+     *      Raised if failed to read (XAPCORE_BUF_ERROR_IO).
+     *  @throw std::bad_alloc
+     *      Raised if failed to allocate memory.
+     *  @param fd
+     *      The file descriptor.
+     *  @return
+     *      The status.
+     */
+    BufferReadStatus read_some(const int fd);
+
+    /**
+     *  Read from a file descriptor until no byte is available, the end of
+     *  file, the queue being full, or 'max_size' bytes were read.
+     *
+     *  @note
+     *      Use with non-blocking descriptors (a blocking descriptor would
+     *      block once the available bytes were read).
+     *  @throw BufferException
+     *      Raised if failed to read (XAPCORE_BUF_ERROR_IO).
+     *  @throw std::bad_alloc
+     *      Raised if failed to allocate memory.
+     *  @param fd
+     *      The file descriptor.
+     *  @param max_size
+     *      The maximum count of bytes to read (default no limit).
+     *  @return
+     *      The status of the last read (BUFFER_READ_DATA if stopped by
+     *      'max_size').
+     */
+    BufferReadStatus read_available(
+        const int       fd,
+        const size_t    max_size = SIZE_MAX
+    );
+
+    /**
+     *  Get the count of bytes read so far.
+     *
+     *  @return
+     *      The count.
+     */
+    uint64_t get_total_read() const noexcept;
+
+    /**
+     *  Get the count of read system calls so far.
+     *
+     *  @return
+     *      The count.
+     */
+    uint64_t get_read_calls() const noexcept;
+
+private:
+    //
+    //  Private methods.
+    //
+
+    /**
+     *  Read once from a file descriptor (see read_some()), but not more 
+     *  than 'limit' bytes.
+     *
+     *  @throw BufferException
+     *      Raised if failed to read (XAPCORE_BUF_ERROR_IO).
+     *  @throw std::bad_alloc
+     *      Raised if failed to allocate memory.
+     *  @param fd
+     *      The file descriptor.
+     *  @param limit
+     *      The maximum count of bytes to read (must not be 0).
+     *  @return
+     *      The status.
+     */
+    BufferReadStatus read_once(const int fd, const size_t limit);
+
+    /**
+     *  Allocate the chunks of the next read.
+     *
+     *  @throw std::bad_alloc
+     *      Raised if failed to allocate memory.
+     */
+    void prepare_chunks();
+
+    /**
+     *  Push the bytes read into the queue.
+     *
+     *  @param size
+     *      The count of bytes read.
+     */
+    void push_read(size_t size);
+
+    //
+    //  Members.
+    //
+    BufferQueue        *m_queue;
+    size_t              m_chunk_size;
+    size_t              m_batch;
+    BufferAllocator    *m_allocator;
+    std::vector<Buffer> m_chunks;
+    size_t              m_offset;
+    uint64_t            m_total_read;
+    uint64_t            m_read_calls;
+};
+
+}  //  namespace buffer
+}  //  namespace core
+}  //  namespace xap
+
+
+#endif  //  #ifndef XAP_CORE_BUFFER_IO_H__
@@ -0,0 +1,324 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+#ifndef XAP_CORE_BUFFER_PARALLEL_H__
+#define XAP_CORE_BUFFER_PARALLEL_H__
+
+//
+//  Imports.
+//
+#include <condition_variable>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+#include <xap/core/buffer/buffer.h>
+
+namespace xap {
+namespace core {
+namespace buffer {
+
+//
+//  Constants.
+//
+
+//  The minimum count of bytes processed in parallel (smaller operations
+//  are done by the calling thread only, waking the workers up costs more).
+static const size_t BUFFER_PARALLEL_THRESHOLD = 4194304U;
+
+//  The count of bytes processed by each task (fits in a L2 cache).
+static const size_t BUFFER_PARALLEL_BLOCK_SIZE = 262144U;
+
+//  The minimum count of bytes copied (or filled) with non-temporal stores
+//  (bigger than common last-level caches, so that the destination would be
+//  evicted before being read anyway).
+static const size_t BUFFER_PARALLEL_STREAM_THRESHOLD = 33554432U;
+
+//
+//  Types.
+//
+
+//
+//  Task callback of executors.
+//
+//  @param index
+//      The index of the task.
+//  @param context
+//      The context passed to BufferExecutor::run().
+//
+typedef void (*BufferTask)(const size_t index, void *context);
+
+//
+//  Classes.
+//
+
+//
+//  Executor of parallel buffer operations (abstract).
+//
+//  Implement this interface to run the tasks with an existing thread pool.
+//
+class BufferExecutor {
+public:
+    //
+    //  Destructor.
+    //
+
+    /**
+     *  Destruct the object.
+     */
+    virtual ~BufferExecutor() noexcept;
+
+    //
+    //  Public methods.
+    //
+
+    /**
+     *  Run tasks and wait for them to complete.
+     *
+     *  @note
+     *      The tasks may run concurrently, in any order, and on any thread
+     *      (including the calling thread). If a task throws, the tasks not
+     *      started yet may be skipped, and the exception is rethrown on 
+     *      the calling thread once the running tasks completed.
+     *  @throw ...
+     *      Raised if a task threw (the first exception only).
+     *  @param task
+     *      The task callback (called once for each index in [0, count)).
+     *  @param context
+     *      The context passed to the task callback.
+     *  @param count
+     *      The count of tasks.
+     */
+    virtual void run(
+        BufferTask      task,
+        void            *context,
+        const size_t    count
+    ) = 0;
+
+    /**
+     *  Get the count of threads which run tasks.
+     *
+     *  @return
+     *      The count.
+     */
+    virtual size_t get_concurrency() const noexcept = 0;
+};
+
+//
+//  Fixed-size thread pool executor.
+//
+//  The calling thread of run() also runs tasks, so a pool of N threads has
+//  a concurrency of N + 1. Only one run() is in flight at a time (the
+//  concurrent calls are serialized).
+//
+class BufferThreadPool : public BufferExecutor {
+public:
+    //
+    //  Constructor & destructor.
+    //
+
+    /**
+     *  Construct the object.
+     *
+     *  @throw std::system_error
+     *      Raised if failed to create the threads.
+     *  @param thread_count
+     *      The count of threads (SIZE_MAX to use the hardware concurrency
+     *      minus 1, 0 to run all tasks on the calling thread).
+     */
+    explicit BufferThreadPool(const size_t thread_count = SIZE_MAX);
+
+    /**
+     *  Construct (copy) the object (deleted).
+     */
+    BufferThreadPool(const BufferThreadPool&) = delete;
+
+    /**
+     *  Destruct the object (and join the threads).
+     */
+    virtual ~BufferThreadPool() noexcept;
+
+    //
+    //  Public operators.
+    //
+
+    /**
+     *  Operator '=' (deleted).
+     */
+    BufferThreadPool& operator=(const BufferThreadPool&) = delete;
+
+    //
+    //  Public methods.
+    //
+
+    /**
+     *  Run tasks and wait for them to complete.
+     *
+     *  @note
+     *      If a task throws, the tasks not claimed yet are skipped, and the
+     *      first exception is rethrown once the running tasks completed.
+     *  @throw ...
+     *      Raised if a task threw (the first exception only).
+     *  @param task
+     *      The task callback (called once for each index in [0, count)).
+     *  @param context
+     *      The context passed to the task callback.
+     *  @param count
+     *      The count of tasks.
+     */
+    virtual void run(
+        BufferTask      task,
+        void            *context,
+        const size_t    count
+    );
+
+    /**
+     *  Get the count of threads which run tasks.
+     *
+     *  @return
+     *      The count (the pool threads and the calling thread).
+     */
+    virtual size_t get_concurrency() const noexcept;
+
+private:
+    //
+    //  Private structures.
+    //
+    struct Job;
+
+    //
+    //  Private methods.
+    //
+
+    /**
+     *  Claim and run the tasks of a job until all of them are claimed.
+     *
+     *  @note
+     *      The first exception thrown by the tasks is kept in the job (and
+     *      the tasks not claimed yet are skipped).
+     *  @param job
+     *      The job.
+     */
+    void run_tasks(Job *job) noexcept;
+
+    /**
+     *  Main loop of pool threads.
+     */
+    void work() noexcept;
+
+    //
+    //  Members.
+    //
+    std::vector<std::thread>    m_threads;
+    std::mutex                  m_run_lock;
+    std::mutex                  m_lock;
+    std::condition_variable     m_wake;
+    std::condition_variable     m_idle;
+    Job                        *m_job;
+    uint64_t                    m_generation;
+    size_t                      m_active;
+    bool                        m_stop;
+};
+
+//
+//  Public functions.
+//
+//  The functions below have the same semantics as their Buffer
+//  counterparts. The work is split into blocks of BUFFER_PARALLEL_BLOCK_SIZE
+//  bytes which are run by the executor if the operation is at least
+//  BUFFER_PARALLEL_THRESHOLD bytes, the copies and fills of at least
+//  BUFFER_PARALLEL_STREAM_THRESHOLD bytes use non-temporal stores (if
+//  supported by the target, see build.h).
+//
+
+/**
+ *  Return a new buffer which is the result of concatenating all buffer
+ *  instances in array together (see Buffer::concat()).
+ *
+ *  @throw BufferException
+ *      Raised if the total length overflowed (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @throw std::bad_alloc
+ *      Raised if failed to allocate memory.
+ *  @param buffers
+ *      The buffer instances to concatenate.
+ *  @param count
+ *      The count of buffer instances.
+ *  @param executor
+ *      The executor.
+ *  @return
+ *      The new buffer.
+ */
+Buffer buffer_parallel_concat(
+    const Buffer    buffers[],
+    const size_t    count,
+    BufferExecutor  &executor
+);
+
+/**
+ *  Copy data to destination (see Buffer::copy()).
+ *
+ *  @throw std::bad_alloc
+ *      Raised if failed to detach the destination (in copy-on-write mode).
+ *  @param source
+ *      The buffer to copy from.
+ *  @param destination
+ *      The buffer to copy into.
+ *  @param executor
+ *      The executor.
+ *  @return
+ *      The number of bytes copied.
+ */
+size_t buffer_parallel_copy(
+    const Buffer    &source,
+    Buffer          &destination,
+    BufferExecutor  &executor
+);
+
+/**
+ *  Fill buffer with the specified value (see Buffer::fill()).
+ *
+ *  @throw std::bad_alloc
+ *      Raised if failed to detach the buffer (in copy-on-write mode).
+ *  @param buffer
+ *      The buffer.
+ *  @param value
+ *      The value with which to fill buffer.
+ *  @param executor
+ *      The executor.
+ */
+void buffer_parallel_fill(
+    Buffer          &buffer,
+    const uint8_t   value,
+    BufferExecutor  &executor
+);
+
+/**
+ *  Get whether two buffers are equal (see Buffer::operator==()).
+ *
+ *  @throw std::bad_alloc
+ *      Raised if failed to allocate memory.
+ *  @param first
+ *      The first buffer.
+ *  @param second
+ *      The second buffer.
+ *  @param executor
+ *      The executor.
+ *  @return
+ *      True if equal.
+ */
+bool buffer_parallel_is_equal(
+    const Buffer    &first,
+    const Buffer    &second,
+    BufferExecutor  &executor
+);
+
+}  //  namespace buffer
+}  //  namespace core
+}  //  namespace xap
+
+
+#endif  //  #ifndef XAP_CORE_BUFFER_PARALLEL_H__
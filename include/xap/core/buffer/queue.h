@@ -10,7 +10,7 @@
 //
 //  Imports.
 //
-#include <list>
+#include <stdint.h>
 #include <xap/core/buffer/buffer.h>
 #include <xap/core/buffer/error.h>
 #include <xap/core/buffer/fetcher.h>
@@ -19,6 +19,73 @@ namespace xap {
 namespace core {
 namespace buffer {
 
+//
+//  Structures.
+//
+
+//
+//  Buffer segment.
+//
+//  On POSIX targets, the memory layout is the same as 'struct iovec' (which
+//  is checked when building), so that an array of segments can be passed to
+//  writev() or sendmsg() directly. The layout doesn't match Windows 
+//  'WSABUF' (whose length goes first and is 32-bit), convert the segments 
+//  for WSASend().
+//
+struct BufferSegment {
+    //  The pointer to the first byte of the segment.
+    const uint8_t  *pointer;
+
+    //  The length of the segment.
+    size_t          length;
+};
+
+//
+//  Classes.
+//
+
+class BufferQueue;
+
+//
+//  Buffer queue watermark listener interface.
+//
+//  The listener is notified when the remaining size of a queue reaches its
+//  high watermark, and again when it falls to its low watermark (so the
+//  notifications always alternate). The listener must not modify the queue
+//  inside the notification.
+//
+class BufferQueueListener {
+public:
+    //
+    //  Constructor & destructor.
+    //
+
+    /**
+     *  Destruct the object.
+     */
+    virtual ~BufferQueueListener() noexcept;
+
+    //
+    //  Public methods.
+    //
+
+    /**
+     *  Notify that the remaining size reached the high watermark.
+     *
+     *  @param queue
+     *      The queue.
+     */
+    virtual void on_high_watermark(BufferQueue &queue) = 0;
+
+    /**
+     *  Notify that the remaining size fell to the low watermark.
+     *
+     *  @param queue
+     *      The queue.
+     */
+    virtual void on_low_watermark(BufferQueue &queue) = 0;
+};
+
 class BufferQueue {
 public:
     //
@@ -38,6 +105,14 @@ public:
      */
     BufferQueue(const BufferQueue &src);
 
+    /**
+     *  Construct (Move) the object.
+     * 
+     *  @param src
+     *      The source object (would be empty after moved).
+     */
+    BufferQueue(BufferQueue &&src) noexcept;
+
     /**
      *  Destructor the object.
      */
@@ -57,13 +132,59 @@ public:
      */
     BufferQueue& operator=(const BufferQueue &src);
 
+    /**
+     *  Operator '=' (move).
+     * 
+     *  @param src
+     *      The source (would be empty after moved).
+     *  @return
+     *      The destination.
+     */
+    BufferQueue& operator=(BufferQueue &&src) noexcept;
+
     /**
      *  Push buffer to queue.
      * 
+     *  @throw BufferException
+     *      Raised if the maximum size would be exceeded 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
      *  @param data
      *      The data.
      */
     void push(const Buffer &data);
+
+    /**
+     *  Push buffer to queue.
+     * 
+     *  @throw BufferException
+     *      Raised if the maximum size would be exceeded 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param data
+     *      The data (would be moved into queue).
+     */
+    void push(Buffer &&data);
+
+    /**
+     *  Push buffer to queue if the maximum size wouldn't be exceeded.
+     * 
+     *  @param data
+     *      The data.
+     *  @return
+     *      True if pushed, false if the maximum size would be exceeded 
+     *      (nothing is pushed).
+     */
+    bool try_push(const Buffer &data);
+
+    /**
+     *  Push buffer to queue if the maximum size wouldn't be exceeded.
+     * 
+     *  @param data
+     *      The data (would be moved into queue only if pushed).
+     *  @return
+     *      True if pushed, false if the maximum size would be exceeded 
+     *      (nothing is pushed).
+     */
+    bool try_push(Buffer &&data);
     
     /**
      *  Pop buffer from queue.
@@ -77,6 +198,24 @@ public:
      *      The buffer.
      */
     Buffer pop(const size_t size);
+
+    /**
+     *  Pop buffer from queue without copying if possible.
+     * 
+     *  @note
+     *      If the requested bytes are contiguous in the front chunk, the 
+     *      returned buffer references the same memory as the pushed buffer 
+     *      (like Buffer::slice()). Otherwise, the bytes are coalesced into a 
+     *      new buffer (like pop()).
+     *  @throw BufferException
+     *      Raised if parameter 'size' was out of range 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param size
+     *      The size of buffer.
+     *  @return
+     *      The buffer.
+     */
+    Buffer pop_view(const size_t size);
     
     /**
      *  Pop all data from queue.
@@ -87,20 +226,1021 @@ public:
     Buffer pop_all();
 
     /**
-     *  Get the remaining size.
+     *  Get the segments of front bytes in queue (without copying or 
+     *  consuming).
      * 
+     *  @note
+     *      The segments are valid until the queue is modified. Call 
+     *      consume() to drop the bytes after they were used.
+     *  @param segments
+     *      The segments array to fill.
+     *  @param max_segments
+     *      The capacity of segments array.
+     *  @param size
+     *      The maximum count of bytes to export (default all).
      *  @return
-     *      The size of remaining bytes.
+     *      The count of segments filled.
      */
-    size_t get_remaining_size() const noexcept;
+    size_t get_segments(
+        BufferSegment   segments[],
+        const size_t    max_segments,
+        const size_t    size = SIZE_MAX
+    ) const noexcept;
 
-private:
+    /**
+     *  Get the count of segments needed to export all bytes in queue (see 
+     *  get_segments()).
+     * 
+     *  @return
+     *      The count.
+     */
+    size_t get_segment_count() const noexcept;
+
+    /**
+     *  Drop bytes from the front of queue.
+     * 
+     *  @throw BufferException
+     *      Raised if parameter 'size' was out of range 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param size
+     *      The count of bytes to drop.
+     */
+    void consume(const size_t size);
+
+    /**
+     *  Peek an unsigned 8-bit integer (without consuming).
+     * 
+     *  @throw BufferException
+     *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset (relative to the queue front).
+     *  @return
+     *      The unsigned 8-bit integer.
+     */
+    uint8_t peek_uint8(const size_t offset = 0U) const;
+
+    /**
+     *  Peek an unsigned 16-bit integer with big-endian (without consuming).
+     * 
+     *  @throw BufferException
+     *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset (relative to the queue front).
+     *  @return
+     *      The unsigned 16-bit integer.
+     */
+    uint16_t peek_uint16_be(const size_t offset = 0U) const;
+
+    /**
+     *  Peek an unsigned 16-bit integer with little-endian (without 
+     *  consuming).
+     * 
+     *  @throw BufferException
+     *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset (relative to the queue front).
+     *  @return
+     *      The unsigned 16-bit integer.
+     */
+    uint16_t peek_uint16_le(const size_t offset = 0U) const;
+
+    /**
+     *  Peek an unsigned 32-bit integer with big-endian (without consuming).
+     * 
+     *  @throw BufferException
+     *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset (relative to the queue front).
+     *  @return
+     *      The unsigned 32-bit integer.
+     */
+    uint32_t peek_uint32_be(const size_t offset = 0U) const;
+
+    /**
+     *  Peek an unsigned 32-bit integer with little-endian (without 
+     *  consuming).
+     * 
+     *  @throw BufferException
+     *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset (relative to the queue front).
+     *  @return
+     *      The unsigned 32-bit integer.
+     */
+    uint32_t peek_uint32_le(const size_t offset = 0U) const;
+
+#if defined(UINT64_MAX)
+
+    /**
+     *  Peek an unsigned 64-bit integer with big-endian (without consuming).
+     * 
+     *  @throw BufferException
+     *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset (relative to the queue front).
+     *  @return
+     *      The unsigned 64-bit integer.
+     */
+    uint64_t peek_uint64_be(const size_t offset = 0U) const;
+
+    /**
+     *  Peek an unsigned 64-bit integer with little-endian (without 
+     *  consuming).
+     * 
+     *  @throw BufferException
+     *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset (relative to the queue front).
+     *  @return
+     *      The unsigned 64-bit integer.
+     */
+    uint64_t peek_uint64_le(const size_t offset = 0U) const;
+
+#endif  //  #if defined(UINT64_MAX)
+
+    /**
+     *  Pop an unsigned 8-bit integer.
+     * 
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The unsigned 8-bit integer.
+     */
+    uint8_t pop_uint8();
+
+    /**
+     *  Pop an unsigned 16-bit integer with big-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The unsigned 16-bit integer.
+     */
+    uint16_t pop_uint16_be();
+
+    /**
+     *  Pop an unsigned 16-bit integer with little-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The unsigned 16-bit integer.
+     */
+    uint16_t pop_uint16_le();
+
+    /**
+     *  Pop a signed 16-bit integer with little-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The signed 16-bit integer.
+     */
+    int16_t pop_sint16_le();
+
+    /**
+     *  Pop an unsigned 32-bit integer with big-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The unsigned 32-bit integer.
+     */
+    uint32_t pop_uint32_be();
+
+    /**
+     *  Pop an unsigned 32-bit integer with little-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The unsigned 32-bit integer.
+     */
+    uint32_t pop_uint32_le();
+
+    /**
+     *  Pop a single-precision float-point with big-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The single-precision float-point value.
+     */
+    float pop_float_be();
+
+    /**
+     *  Pop a single-precision float-point with little-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The single-precision float-point value.
+     */
+    float pop_float_le();
+
+#if defined(UINT64_MAX)
+
+    /**
+     *  Pop an unsigned 64-bit integer with big-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The unsigned 64-bit integer.
+     */
+    uint64_t pop_uint64_be();
+
+    /**
+     *  Pop an unsigned 64-bit integer with little-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The unsigned 64-bit integer.
+     */
+    uint64_t pop_uint64_le();
+
+    /**
+     *  Pop a double-precision float-point with big-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The double-precision float-point value.
+     */
+    double pop_double_be();
+
+    /**
+     *  Pop a double-precision float-point with little-endian.
+     * 
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The double-precision float-point value.
+     */
+    double pop_double_le();
+
+    /**
+     *  Pop an unsigned integer with variable-length (LEB128) encoding.
+     * 
+     *  @throw BufferException
+     *      Raised if the encoding is truncated or longer than 64 bits, 
+     *      nothing is popped (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The unsigned integer.
+     */
+    uint64_t pop_varint();
+
+    /**
+     *  Pop a signed integer with zigzag and variable-length (LEB128) 
+     *  encoding.
+     * 
+     *  @throw BufferException
+     *      Raised if the encoding is truncated or longer than 64 bits, 
+     *      nothing is popped (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The signed integer.
+     */
+    int64_t pop_varint_signed();
+
+#endif  //  #if defined(UINT64_MAX)
+
+    /**
+     *  Find the first occurrence of a byte sequence (across chunks, without
+     *  coalescing them).
+     * 
+     *  @param needle
+     *      The byte sequence (an empty one is found at 'from').
+     *  @param from
+     *      The offset (relative to the queue front) where to begin 
+     *      searching.
+     *  @return
+     *      The offset relative to the queue front (Buffer::NPOS if not 
+     *      found).
+     */
+    size_t index_of(
+        const Buffer    &needle,
+        const size_t    from = 0U
+    ) const noexcept;
+
+    /**
+     *  Pop a frame which is prefixed with its length if it was completely 
+     *  received.
+     * 
+     *  @note
+     *      The length header is dropped and the frame is popped like 
+     *      pop_view() (zero-copy if it is contiguous in one chunk).
+     *  @throw BufferException
+     *      Raised if 'header_width' is not 1, 2, 4 or 8 
+     *      (XAPCORE_BUF_ERROR_INVALID_SIZE), or the frame length can't be 
+     *      represented with size_t (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param header_width
+     *      The width of the length header.
+     *  @param isle
+     *      True if the length header is with little-endian.
+     *  @param frame
+     *      The buffer to receive the frame.
+     *  @return
+     *      True if popped, false if more bytes are needed (nothing is 
+     *      consumed).
+     */
+    bool try_pop_frame_length_prefixed(
+        const size_t    header_width,
+        const bool      isle,
+        Buffer          &frame
+    );
+
+    /**
+     *  Pop the bytes before the first occurrence of a delimiter if it was 
+     *  received.
+     * 
+     *  @note
+     *      The delimiter is dropped and the frame is popped like pop_view() 
+     *      (zero-copy if it is contiguous in one chunk). If not found, the
+     *      search of the next call with the same delimiter resumes where 
+     *      this one stopped (until bytes are popped or consumed), so that 
+     *      polling a frame received in many pushes is linear.
+     *  @throw std::bad_alloc
+     *      Raised if failed to allocate memory (to remember a new 
+     *      delimiter).
+     *  @param delimiter
+     *      The delimiter (must not be empty).
+     *  @param frame
+     *      The buffer to receive the frame (without the delimiter).
+     *  @return
+     *      True if popped, false if the delimiter was not found (nothing is 
+     *      consumed).
+     */
+    bool try_pop_until(const Buffer &delimiter, Buffer &frame);
+
+    /**
+     *  Get the remaining size.
+     * 
+     *  @return
+     *      The size of remaining bytes.
+     */
+    size_t get_remaining_size() const noexcept;
+
+    /**
+     *  Set the maximum size (the byte budget of queued data).
+     * 
+     *  @note
+     *      Lowering the maximum size below the remaining size drops 
+     *      nothing, but further pushes fail until the queue was drained.
+     *  @param max_size
+     *      The maximum size (SIZE_MAX if unbounded, which is the default).
+     */
+    void set_max_size(const size_t max_size) noexcept;
+
+    /**
+     *  Get the maximum size.
+     * 
+     *  @return
+     *      The maximum size (SIZE_MAX if unbounded).
+     */
+    size_t get_max_size() const noexcept;
+
+    /**
+     *  Set the watermarks and the listener to be notified.
+     * 
+     *  @note
+     *      The remaining size is checked against the new watermarks 
+     *      immediately (, and the listener may be notified).
+     *  @throw BufferException
+     *      Raised if 'low_watermark' is greater than 'high_watermark' 
+     *      (XAPCORE_BUF_ERROR_INVALID_SIZE).
+     *  @param high_watermark
+     *      The high watermark.
+     *  @param low_watermark
+     *      The low watermark.
+     *  @param listener
+     *      The listener (nullptr to disable notifications, it must outlive 
+     *      the queue otherwise).
+     */
+    void set_watermarks(
+        const size_t        high_watermark,
+        const size_t        low_watermark,
+        BufferQueueListener *listener
+    );
+
+    /**
+     *  Get whether the remaining size is above the low watermark since it 
+     *  reached the high watermark.
+     * 
+     *  @return
+     *      True if so.
+     */
+    bool is_high() const noexcept;
+
+    /**
+     *  Set the compaction policy.
+     * 
+     *  @note
+     *      A chunk is compacted if its storage (see 
+     *      Buffer::get_storage_length()) is at least 'min_storage' bytes and
+     *      its remaining bytes are less than 'live_percent' percent of the 
+     *      storage: the remaining bytes are copied into a new buffer from 
+     *      'allocator', and the queue releases its reference to the 
+     *      original storage. Consecutive chunks sharing the same storage 
+     *      are checked (and compacted) together. The front chunk is checked
+     *      after bytes were popped or consumed from it, compact() checks 
+     *      all chunks.
+     *  @throw BufferException
+     *      Raised if 'live_percent' is greater than 100 
+     *      (XAPCORE_BUF_ERROR_INVALID_SIZE).
+     *  @param live_percent
+     *      The threshold of live bytes in percent (0 to disable compaction, 
+     *      which is the default).
+     *  @param min_storage
+     *      The minimum length of storage to compact (default 64 KiB).
+     *  @param allocator
+     *      The allocator of the compacted chunks (must outlive the chunks, 
+     *      e.g. a BufferPoolAllocator).
+     */
+    void set_compaction(
+        const size_t    live_percent,
+        const size_t    min_storage = 65536U,
+        BufferAllocator &allocator = BufferAllocator::get_default()
+    );
+
+    /**
+     *  Compact all chunks which match the compaction policy (see 
+     *  set_compaction()).
+     * 
+     *  @note
+     *      Nothing is done if compaction is disabled. If failed to allocate
+     *      memory, the chunk is kept as is.
+     *  @return
+     *      The count of chunks compacted.
+     */
+    size_t compact() noexcept;
+
+    /**
+     *  Get the count of bytes of storage kept alive by the queue.
+     * 
+     *  @note
+     *      The storage shared by consecutive chunks is counted once. The 
+     *      storage may also be kept alive by buffers outside the queue. 
+     *      Compare with get_remaining_size() (the live bytes) to decide 
+     *      whether to compact().
+     *  @return
+     *      The count of bytes.
+     */
+    size_t get_retained_size() const noexcept;
+
+private:
+    friend class BufferQueueFetcher;
+
+    //
+    //  Private structures.
+    //
+
+    //
+    //  Queued chunk (the buffer and its read cursor).
+    //
+    struct Chunk {
+        //  The buffer.
+        Buffer  buffer;
+
+        //  The offset of the first unread byte.
+        size_t  cursor;
+    };
+
+    //
+    //  Private methods.
+    //
+
+    /**
+     *  Get the chunk at specified position (relative to the queue front).
+     * 
+     *  @param index
+     *      The position.
+     *  @return
+     *      The chunk.
+     */
+    Chunk& get_chunk(const size_t index) const noexcept;
+
+    /**
+     *  Get the pointer to bytes in queue (without consuming).
+     * 
+     *  @throw BufferException
+     *      Raised if 'offset' or 'size' is out of range 
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset (relative to the queue front).
+     *  @param size
+     *      The count of bytes (must not be 0).
+     *  @param scratch
+     *      The memory (at least 'size' bytes) where to copy the bytes if 
+     *      they span multiple chunks.
+     *  @return
+     *      The pointer to the bytes (either inside a chunk or 'scratch').
+     */
+    const uint8_t* peek_bytes(
+        const size_t    offset,
+        const size_t    size,
+        uint8_t         *scratch
+    ) const;
+
+    /**
+     *  Find the first occurrence of a byte sequence, beginning at a chunk.
+     * 
+     *  @param needle
+     *      The byte sequence (must not be empty).
+     *  @param index
+     *      The position of the first chunk to search.
+     *  @param base
+     *      The offset of that chunk (relative to the queue front, not 
+     *      greater than 'from').
+     *  @param from
+     *      The offset (relative to the queue front) where to begin 
+     *      searching.
+     *  @return
+     *      The offset relative to the queue front (Buffer::NPOS if not 
+     *      found).
+     */
+    size_t search(
+        const Buffer    &needle,
+        size_t          index,
+        size_t          base,
+        const size_t    from
+    ) const noexcept;
+
+    /**
+     *  Forget the search position of try_pop_until() (bytes were removed 
+     *  from the queue front).
+     */
+    void reset_scan() noexcept;
+
+    /**
+     *  Check whether a byte sequence occurs at specified position.
+     * 
+     *  @param index
+     *      The position of the chunk where the occurrence begins.
+     *  @param offset
+     *      The offset inside the chunk (from the chunk cursor).
+     *  @param needle
+     *      The byte sequence.
+     *  @param needle_len
+     *      The length of the byte sequence.
+     *  @return
+     *      True if occurs.
+     */
+    bool is_match(
+        size_t          index,
+        size_t          offset,
+        const uint8_t   *needle,
+        const size_t    needle_len
+    ) const noexcept;
+
+    /**
+     *  Append a chunk to the queue back (, and grow the ring if it is full).
+     * 
+     *  @param data
+     *      The data (would be moved into the chunk).
+     */
+    void push_chunk(Buffer &&data);
+
+    /**
+     *  Remove the chunk at the queue front.
+     */
+    void pop_chunk() noexcept;
+
+    /**
+     *  Compact the run of chunks (which share the same storage) at 
+     *  specified position if it matches the compaction policy (if failed 
+     *  to allocate memory, the remaining chunks of the run are kept as is).
+     * 
+     *  @param index
+     *      The position of the first chunk of the run.
+     *  @param compacted
+     *      The pointer to receive the count of chunks compacted.
+     *  @return
+     *      The count of chunks in the run.
+     */
+    size_t compact_run(const size_t index, size_t *compacted) noexcept;
+
+    /**
+     *  Compact the chunks sharing the storage of the front chunk if it was 
+     *  partially consumed and they match the compaction policy.
+     */
+    void compact_front() noexcept;
+
+    /**
+     *  Check whether bytes can be pushed within the maximum size.
+     * 
+     *  @param size
+     *      The count of bytes.
+     *  @return
+     *      True if so.
+     */
+    bool is_within_budget(const size_t size) const noexcept;
+
+    /**
+     *  Notify the listener if the remaining size grew to the high watermark.
+     */
+    void check_high_watermark();
+
+    /**
+     *  Notify the listener if the remaining size fell to the low watermark.
+     */
+    void check_low_watermark();
+
+    /**
+     *  Destroy all chunks and release the ring.
+     */
+    void release() noexcept;
+
+    //
+    //  Members.
+    //
+    size_t              m_remaining;
+    Chunk               *m_chunks;
+    size_t              m_capacity;
+    size_t              m_head;
+    size_t              m_count;
+
+    //  Byte budget and watermarks.
+    size_t              m_max_size;
+    size_t              m_high_watermark;
+    size_t              m_low_watermark;
+    BufferQueueListener *m_listener;
+    bool                m_high;
+
+    //  Compaction policy.
+    size_t              m_compaction_percent;
+    size_t              m_compaction_min_storage;
+    BufferAllocator     *m_compaction_allocator;
+
+    //  Search position of try_pop_until() (no occurrence of the delimiter
+    //  begins before the offset, which is inside the chunk at the index).
+    Buffer              m_scan_delimiter;
+    size_t              m_scan_offset;
+    size_t              m_scan_index;
+    size_t              m_scan_base;
+};
+
+//
+//  Transactional cursor over a buffer queue (with the same interface as
+//  BufferChainFetcher).
+//
+//  The fetcher walks the queued chunks in place (without copying or
+//  consuming), so that an incremental parser can look ahead, rewind() to
+//  the last mark() when a message is incomplete, and commit() to consume
+//  the bytes of complete messages only. Bytes may be pushed into the queue
+//  while the fetcher is used (the position is kept), but the queue must
+//  not be consumed other than by commit(), and must outlive the fetcher.
+//
+class BufferQueueFetcher {
+public:
+    //
+    //  Constructor.
+    //
+
+    /**
+     *  Construct the object (the cursor and the mark are at the queue
+     *  front).
+     *
+     *  @param queue
+     *      The queue which would be fetched.
+     */
+    explicit BufferQueueFetcher(BufferQueue &queue) noexcept;
+
+    //
+    //  Public methods.
+    //
+
+    /**
+     *  Check whether the fetcher is ended (all queued bytes were fetched).
+     *
+     *  @return
+     *      True if so.
+     */
+    bool is_end() const noexcept;
+
+    /**
+     *  Reset the fetcher. Move the cursor and the mark to the queue front.
+     */
+    void reset() noexcept;
+
+    /**
+     *  Remember the cursor position (see rewind()).
+     */
+    void mark() noexcept;
+
+    /**
+     *  Move the cursor back to the position of the last mark() (or to the
+     *  queue front if not marked since the last commit() or reset()).
+     */
+    void rewind() noexcept;
+
+    /**
+     *  Consume the bytes before the cursor from the queue. Then the cursor
+     *  and the mark are at the (new) queue front.
+     */
+    void commit();
+
+    /**
+     *  Fetch one byte.
+     *
+     *  @throw BufferException
+     *      Raised if the fetcher was ended (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The byte.
+     */
+    uint8_t fetch();
+
+    /**
+     *  Fetch an unsigned 8-bit integer (the same as fetch()).
+     *
+     *  @throw BufferException
+     *      Raised if the fetcher was ended (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The unsigned 8-bit integer.
+     */
+    uint8_t fetch_uint8();
+
+    /**
+     *  Fetch an unsigned 16-bit integer with big-endian.
+     *
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The unsigned 16-bit integer.
+     */
+    uint16_t fetch_uint16_be();
+
+    /**
+     *  Fetch an unsigned 16-bit integer with little-endian.
+     *
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The unsigned 16-bit integer.
+     */
+    uint16_t fetch_uint16_le();
+
+    /**
+     *  Fetch a signed 16-bit integer with little-endian.
+     *
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The signed 16-bit integer.
+     */
+    int16_t fetch_sint16_le();
+
+    /**
+     *  Fetch an unsigned 32-bit integer with big-endian.
+     *
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The unsigned 32-bit integer.
+     */
+    uint32_t fetch_uint32_be();
+
+    /**
+     *  Fetch an unsigned 32-bit integer with little-endian.
+     *
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The unsigned 32-bit integer.
+     */
+    uint32_t fetch_uint32_le();
+
+    /**
+     *  Fetch a single-precision float-point with big-endian.
+     *
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The single-precision float-point value.
+     */
+    float fetch_float_be();
+
+    /**
+     *  Fetch a single-precision float-point with little-endian.
+     *
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The single-precision float-point value.
+     */
+    float fetch_float_le();
+
+#if defined(UINT64_MAX)
+
+    /**
+     *  Fetch an unsigned 64-bit integer with big-endian.
+     *
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The unsigned 64-bit integer.
+     */
+    uint64_t fetch_uint64_be();
+
+    /**
+     *  Fetch an unsigned 64-bit integer with little-endian.
+     *
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The unsigned 64-bit integer.
+     */
+    uint64_t fetch_uint64_le();
+
+    /**
+     *  Fetch a double-precision float-point with big-endian.
+     *
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The double-precision float-point value.
+     */
+    double fetch_double_be();
+
+    /**
+     *  Fetch a double-precision float-point with little-endian.
+     *
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The double-precision float-point value.
+     */
+    double fetch_double_le();
+
+    /**
+     *  Fetch an unsigned integer with variable-length (LEB128) encoding.
+     *
+     *  @throw BufferException
+     *      Raised if the encoding is truncated or longer than 64 bits, the
+     *      cursor is not moved (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The unsigned integer.
+     */
+    uint64_t fetch_varint();
+
+    /**
+     *  Fetch a signed integer with zigzag and variable-length (LEB128)
+     *  encoding.
+     *
+     *  @throw BufferException
+     *      Raised if the encoding is truncated or longer than 64 bits, the
+     *      cursor is not moved (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @return
+     *      The signed integer.
+     */
+    int64_t fetch_varint_signed();
+
+#endif  //  #if defined(UINT64_MAX)
+
+    /**
+     *  Fetch bytes to buffer.
+     *
+     *  @note
+     *      Nothing would be done if destination size is zero.
+     *  @throw BufferException
+     *      Raised if the fetcher was ended (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param destination
+     *      The destination buffer.
+     *  @return
+     *      The number of bytes fetched.
+     */
+    size_t fetch_to(Buffer &destination);
+
+    /**
+     *  Fetch bytes to buffer.
+     *
+     *  @note
+     *      Nothing would be done if destination size is zero.
+     *  @throw BufferException
+     *      Raised if the fetcher was ended, or the offset of destination
+     *      buffer is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param destination
+     *      The destination buffer.
+     *  @param destination_offset
+     *      The offset of destination buffer.
+     *  @return
+     *      The number of bytes fetched.
+     */
+    size_t fetch_to(Buffer &destination, const size_t destination_offset);
+
+    /**
+     *  Fetch all remaining bytes in queue.
+     *
+     *  @note
+     *      Return zero-size buffer if fetcher is ended.
+     *  @return
+     *      The destination buffer.
+     */
+    Buffer fetch_all();
+
+    /**
+     *  Fetch bytes in queue.
+     *
+     *  @note
+     *      No byte is copied if the bytes are inside one chunk.
+     *  @throw BufferException
+     *      Parameter 'count' was out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param count
+     *      The count of bytes would be fetched.
+     *  @return
+     *      The destination buffer.
+     */
+    Buffer fetch_bytes(const size_t count);
+
+    /**
+     *  Skip bytes.
+     *
+     *  @throw BufferException
+     *      Raised if parameter 'count' was out of range
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param count
+     *      The count of bytes would be skiped.
+     */
+    void skip(const size_t count);
+
+    /**
+     *  Get the count of bytes fetched since the last commit() (or reset()).
+     *
+     *  @return
+     *      The count.
+     */
+    size_t get_position() const noexcept;
+
+    /**
+     *  Get the remaining size (the queued bytes after the cursor).
+     *
+     *  @return
+     *      The remaining size.
+     */
+    size_t get_remaining_size() const noexcept;
+
+private:
+    //
+    //  Private methods.
+    //
+
+    /**
+     *  Fetch bytes (without copying if they are inside one chunk).
+     *
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param size
+     *      The count of bytes.
+     *  @param scratch
+     *      The memory (at least 'size' bytes) where to copy the bytes if
+     *      they span multiple chunks.
+     *  @return
+     *      The pointer to the bytes (either inside a chunk or 'scratch').
+     */
+    const uint8_t* fetch_pointer(const size_t size, uint8_t *scratch);
+
+    /**
+     *  Move the cursor forward (inside the remaining bytes).
+     *
+     *  @param count
+     *      The count of bytes.
+     */
+    void advance(size_t count) noexcept;
 
     //
     //  Members.
     //
-    size_t m_remaining;
-    std::list<BufferFetcher> m_queue;
+    BufferQueue *m_queue;
+    size_t      m_index;
+    size_t      m_inner;
+    size_t      m_position;
+    size_t      m_mark_index;
+    size_t      m_mark_inner;
+    size_t      m_mark_position;
 };
 
 }  //  namespace buffer
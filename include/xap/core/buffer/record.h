@@ -0,0 +1,778 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+#ifndef XAP_CORE_BUFFER_RECORD_H__
+#define XAP_CORE_BUFFER_RECORD_H__
+
+//
+//  Imports.
+//
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+#include <xap/core/buffer/buffer.h>
+#include <xap/core/buffer/build.h>
+#include <xap/core/buffer/endian.h>
+#include <xap/core/buffer/error.h>
+#include <xap/core/buffer/fetcher.h>
+#include <xap/core/buffer/writer.h>
+
+//
+//  Usage.
+//
+//  A record layout is a compile-time list of fields, each field maps a
+//  member of a C++ structure to a fixed-width (big-endian or little-endian)
+//  value. The offset of each field is the sum of the widths of the fields
+//  before it, so there are no hand-written offsets:
+//
+//      struct Header {
+//          uint16_t    type;
+//          uint32_t    length;
+//          float       scale;
+//      };
+//
+//      typedef RecordLayout<
+//          XAP_CORE_BUFFER_RECORD_FIELD(Header, type, RECORD_BIG_ENDIAN),
+//          RecordPadding<2U>,
+//          XAP_CORE_BUFFER_RECORD_FIELD(Header, length, RECORD_BIG_ENDIAN),
+//          XAP_CORE_BUFFER_RECORD_FIELD(Header, scale, RECORD_LITTLE_ENDIAN)
+//      > HeaderLayout;
+//
+//      Header header = HeaderLayout::decode<Header>(buffer, offset);
+//
+//  The checked methods validate the whole record range once, then decode
+//  or encode the fields with straight-line unchecked accesses.
+//
+
+//
+//  Macros.
+//
+
+//  Declare a scalar field of a record layout ('order' is a RecordByteOrder).
+#define XAP_CORE_BUFFER_RECORD_FIELD(record, member, order) \
+    ::xap::core::buffer::RecordField< \
+        record, \
+        decltype(record::member), \
+        &record::member, \
+        ::xap::core::buffer::order \
+    >
+
+//  Declare an array field (a member of type 'T[N]') of a record layout.
+#define XAP_CORE_BUFFER_RECORD_ARRAY(record, member, order) \
+    ::xap::core::buffer::RecordArrayField< \
+        record, \
+        decltype(record::member), \
+        &record::member, \
+        ::xap::core::buffer::order \
+    >
+
+namespace xap {
+namespace core {
+namespace buffer {
+
+//
+//  Enumerations.
+//
+
+//
+//  Byte order of a record field.
+//
+enum RecordByteOrder {
+    //  Big-endian (network byte order).
+    RECORD_BIG_ENDIAN       = 0,
+
+    //  Little-endian.
+    RECORD_LITTLE_ENDIAN    = 1
+};
+
+//
+//  Classes.
+//
+
+//
+//  Codec of a fixed-width scalar value (integers, float and double).
+//
+//  The accesses don't check the memory range, the caller must guarantee
+//  that the bytes are accessible.
+//
+template<class T>
+class RecordScalar;
+
+//
+//  Codec of an unsigned integer of the same width (the signed integers and
+//  float-point values are bit casted from / to it).
+//
+template<size_t WIDTH>
+class RecordBits;
+
+template<>
+class RecordBits<1U> {
+public:
+    typedef uint8_t Type;
+
+    static Type read(const uint8_t *pointer, const RecordByteOrder) noexcept {
+        return pointer[0U];
+    }
+
+    static void write(
+        uint8_t                 *pointer,
+        const Type              value,
+        const RecordByteOrder
+    ) noexcept {
+        pointer[0U] = value;
+    }
+};
+
+template<>
+class RecordBits<2U> {
+public:
+    typedef uint16_t Type;
+
+    static Type read(
+        const uint8_t           *pointer,
+        const RecordByteOrder   order
+    ) noexcept {
+        return order == RECORD_LITTLE_ENDIAN ?
+            endian_read_uint16_le(pointer) :
+            endian_read_uint16_be(pointer);
+    }
+
+    static void write(
+        uint8_t                 *pointer,
+        const Type              value,
+        const RecordByteOrder   order
+    ) noexcept {
+        if (order == RECORD_LITTLE_ENDIAN) {
+            endian_write_uint16_le(pointer, value);
+        } else {
+            endian_write_uint16_be(pointer, value);
+        }
+    }
+};
+
+template<>
+class RecordBits<4U> {
+public:
+    typedef uint32_t Type;
+
+    static Type read(
+        const uint8_t           *pointer,
+        const RecordByteOrder   order
+    ) noexcept {
+        return order == RECORD_LITTLE_ENDIAN ?
+            endian_read_uint32_le(pointer) :
+            endian_read_uint32_be(pointer);
+    }
+
+    static void write(
+        uint8_t                 *pointer,
+        const Type              value,
+        const RecordByteOrder   order
+    ) noexcept {
+        if (order == RECORD_LITTLE_ENDIAN) {
+            endian_write_uint32_le(pointer, value);
+        } else {
+            endian_write_uint32_be(pointer, value);
+        }
+    }
+};
+
+#if defined(UINT64_MAX)
+
+template<>
+class RecordBits<8U> {
+public:
+    typedef uint64_t Type;
+
+    static Type read(
+        const uint8_t           *pointer,
+        const RecordByteOrder   order
+    ) noexcept {
+        return order == RECORD_LITTLE_ENDIAN ?
+            endian_read_uint64_le(pointer) :
+            endian_read_uint64_be(pointer);
+    }
+
+    static void write(
+        uint8_t                 *pointer,
+        const Type              value,
+        const RecordByteOrder   order
+    ) noexcept {
+        if (order == RECORD_LITTLE_ENDIAN) {
+            endian_write_uint64_le(pointer, value);
+        } else {
+            endian_write_uint64_be(pointer, value);
+        }
+    }
+};
+
+#endif  //  #if defined(UINT64_MAX)
+
+//
+//  Codec of a float-point value without IEEE 754 bit casting (the portable
+//  codec of Buffer, see BufferAccessor).
+//
+template<class T>
+class RecordPortableFloat;
+
+#if !defined(XAP_CORE_BUFFER_IEEE_754)
+
+template<>
+class RecordPortableFloat<float> {
+public:
+    static float read(
+        const uint8_t           *pointer,
+        const RecordByteOrder   order
+    ) noexcept {
+        const BufferAccessor accessor(const_cast<uint8_t*>(pointer), 4U);
+        return order == RECORD_LITTLE_ENDIAN ?
+            accessor.read_float_le(0U) :
+            accessor.read_float_be(0U);
+    }
+
+    static void write(
+        uint8_t                 *pointer,
+        const float             value,
+        const RecordByteOrder   order
+    ) noexcept {
+        BufferAccessor accessor(pointer, 4U);
+        if (order == RECORD_LITTLE_ENDIAN) {
+            accessor.write_float_le(value, 0U);
+        } else {
+            accessor.write_float_be(value, 0U);
+        }
+    }
+};
+
+#if defined(UINT64_MAX)
+
+template<>
+class RecordPortableFloat<double> {
+public:
+    static double read(
+        const uint8_t           *pointer,
+        const RecordByteOrder   order
+    ) noexcept {
+        const BufferAccessor accessor(const_cast<uint8_t*>(pointer), 8U);
+        return order == RECORD_LITTLE_ENDIAN ?
+            accessor.read_double_le(0U) :
+            accessor.read_double_be(0U);
+    }
+
+    static void write(
+        uint8_t                 *pointer,
+        const double            value,
+        const RecordByteOrder   order
+    ) noexcept {
+        BufferAccessor accessor(pointer, 8U);
+        if (order == RECORD_LITTLE_ENDIAN) {
+            accessor.write_double_le(value, 0U);
+        } else {
+            accessor.write_double_be(value, 0U);
+        }
+    }
+};
+
+#endif  //  #if defined(UINT64_MAX)
+
+#endif  //  #if !defined(XAP_CORE_BUFFER_IEEE_754)
+
+template<class T>
+class RecordScalar {
+public:
+    static_assert(
+        std::is_integral<T>::value || std::is_floating_point<T>::value,
+        "Record fields must be integers or float-point values."
+    );
+
+    //  The width of the value (in bytes).
+    static const size_t WIDTH = sizeof(T);
+
+    /**
+     *  Read the value.
+     *
+     *  @param pointer
+     *      The pointer to the first byte.
+     *  @param order
+     *      The byte order.
+     *  @return
+     *      The value.
+     */
+    static T read(
+        const uint8_t           *pointer,
+        const RecordByteOrder   order
+    ) noexcept {
+        return RecordScalar::read(pointer, order, Portable());
+    }
+
+    /**
+     *  Write the value.
+     *
+     *  @param pointer
+     *      The pointer to the first byte.
+     *  @param value
+     *      The value.
+     *  @param order
+     *      The byte order.
+     */
+    static void write(
+        uint8_t                 *pointer,
+        const T                 value,
+        const RecordByteOrder   order
+    ) noexcept {
+        RecordScalar::write(pointer, value, order, Portable());
+    }
+
+private:
+    //  Whether the value is encoded with the portable float-point codec
+    //  (instead of being bit casted).
+#if defined(XAP_CORE_BUFFER_IEEE_754)
+    typedef std::false_type Portable;
+#else
+    typedef std::is_floating_point<T> Portable;
+#endif
+
+    static T read(
+        const uint8_t           *pointer,
+        const RecordByteOrder   order,
+        std::false_type
+    ) noexcept {
+        const typename RecordBits<WIDTH>::Type bits =
+            RecordBits<WIDTH>::read(pointer, order);
+        T value;
+        memcpy(&value, &bits, WIDTH);
+        return value;
+    }
+
+    static T read(
+        const uint8_t           *pointer,
+        const RecordByteOrder   order,
+        std::true_type
+    ) noexcept {
+        return RecordPortableFloat<T>::read(pointer, order);
+    }
+
+    static void write(
+        uint8_t                 *pointer,
+        const T                 value,
+        const RecordByteOrder   order,
+        std::false_type
+    ) noexcept {
+        typename RecordBits<WIDTH>::Type bits;
+        memcpy(&bits, &value, WIDTH);
+        RecordBits<WIDTH>::write(pointer, bits, order);
+    }
+
+    static void write(
+        uint8_t                 *pointer,
+        const T                 value,
+        const RecordByteOrder   order,
+        std::true_type
+    ) noexcept {
+        RecordPortableFloat<T>::write(pointer, value, order);
+    }
+};
+
+template<class T>
+const size_t RecordScalar<T>::WIDTH;
+
+//
+//  Scalar field of a record layout (see XAP_CORE_BUFFER_RECORD_FIELD()).
+//
+template<class R, class T, T R::*MEMBER, RecordByteOrder ORDER>
+class RecordField {
+public:
+    //  The width of the field (in bytes).
+    static const size_t WIDTH = RecordScalar<T>::WIDTH;
+
+    /**
+     *  Decode the field.
+     *
+     *  @param pointer
+     *      The pointer to the first byte of the field.
+     *  @param record
+     *      The record.
+     */
+    static void decode(const uint8_t *pointer, R &record) noexcept {
+        record.*MEMBER = RecordScalar<T>::read(pointer, ORDER);
+    }
+
+    /**
+     *  Encode the field.
+     *
+     *  @param record
+     *      The record.
+     *  @param pointer
+     *      The pointer to the first byte of the field.
+     */
+    static void encode(const R &record, uint8_t *pointer) noexcept {
+        RecordScalar<T>::write(pointer, record.*MEMBER, ORDER);
+    }
+};
+
+template<class R, class T, T R::*MEMBER, RecordByteOrder ORDER>
+const size_t RecordField<R, T, MEMBER, ORDER>::WIDTH;
+
+//
+//  Array field of a record layout (see XAP_CORE_BUFFER_RECORD_ARRAY()).
+//
+template<class R, class A, A R::*MEMBER, RecordByteOrder ORDER>
+class RecordArrayField {
+public:
+    static_assert(
+        std::is_array<A>::value && std::extent<A>::value != 0U,
+        "Record array fields must be arrays with known bound."
+    );
+
+    //  The element type.
+    typedef typename std::remove_extent<A>::type Element;
+
+    //  The count of elements.
+    static const size_t COUNT = std::extent<A>::value;
+
+    //  The width of the field (in bytes).
+    static const size_t WIDTH = RecordScalar<Element>::WIDTH * COUNT;
+
+    /**
+     *  Decode the field.
+     *
+     *  @param pointer
+     *      The pointer to the first byte of the field.
+     *  @param record
+     *      The record.
+     */
+    static void decode(const uint8_t *pointer, R &record) noexcept {
+        Element *elements = record.*MEMBER;
+        for (size_t i = 0U; i < COUNT; ++i) {
+            elements[i] = RecordScalar<Element>::read(
+                pointer + i * RecordScalar<Element>::WIDTH,
+                ORDER
+            );
+        }
+    }
+
+    /**
+     *  Encode the field.
+     *
+     *  @param record
+     *      The record.
+     *  @param pointer
+     *      The pointer to the first byte of the field.
+     */
+    static void encode(const R &record, uint8_t *pointer) noexcept {
+        const Element *elements = record.*MEMBER;
+        for (size_t i = 0U; i < COUNT; ++i) {
+            RecordScalar<Element>::write(
+                pointer + i * RecordScalar<Element>::WIDTH,
+                elements[i],
+                ORDER
+            );
+        }
+    }
+};
+
+template<class R, class A, A R::*MEMBER, RecordByteOrder ORDER>
+const size_t RecordArrayField<R, A, MEMBER, ORDER>::COUNT;
+
+template<class R, class A, A R::*MEMBER, RecordByteOrder ORDER>
+const size_t RecordArrayField<R, A, MEMBER, ORDER>::WIDTH;
+
+//
+//  Padding of a record layout (skipped when decoding, zero-filled when
+//  encoding).
+//
+template<size_t N>
+class RecordPadding {
+public:
+    //  The width of the field (in bytes).
+    static const size_t WIDTH = N;
+
+    /**
+     *  Decode the field (do nothing).
+     *
+     *  @param pointer
+     *      The pointer to the first byte of the field.
+     *  @param record
+     *      The record.
+     */
+    template<class R>
+    static void decode(const uint8_t *pointer, R &record) noexcept {
+        (void)pointer;
+        (void)record;
+    }
+
+    /**
+     *  Encode the field (fill zeros).
+     *
+     *  @param record
+     *      The record.
+     *  @param pointer
+     *      The pointer to the first byte of the field.
+     */
+    template<class R>
+    static void encode(const R &record, uint8_t *pointer) noexcept {
+        (void)record;
+        memset(pointer, 0, N);
+    }
+};
+
+template<size_t N>
+const size_t RecordPadding<N>::WIDTH;
+
+//
+//  Fields of a record layout which begin at 'OFFSET' (internal, see
+//  RecordLayout).
+//
+template<size_t OFFSET, class... FIELDS>
+class RecordFieldSequence;
+
+template<size_t OFFSET>
+class RecordFieldSequence<OFFSET> {
+public:
+    //  The offset after the last field.
+    static const size_t END = OFFSET;
+
+    template<class R>
+    static void decode(const uint8_t *, R &) noexcept {}
+
+    template<class R>
+    static void encode(const R &, uint8_t *) noexcept {}
+};
+
+template<size_t OFFSET, class FIELD, class... REST>
+class RecordFieldSequence<OFFSET, FIELD, REST...> {
+public:
+    //  The fields after this one.
+    typedef RecordFieldSequence<OFFSET + FIELD::WIDTH, REST...> Next;
+
+    //  The offset after the last field.
+    static const size_t END = Next::END;
+
+    template<class R>
+    static void decode(const uint8_t *pointer, R &record) noexcept {
+        FIELD::decode(pointer + OFFSET, record);
+        Next::decode(pointer, record);
+    }
+
+    template<class R>
+    static void encode(const R &record, uint8_t *pointer) noexcept {
+        FIELD::encode(record, pointer + OFFSET);
+        Next::encode(record, pointer);
+    }
+};
+
+//
+//  Offset of the field at 'INDEX' (internal, see RecordLayout).
+//
+template<size_t INDEX, size_t OFFSET, class... FIELDS>
+class RecordFieldOffset;
+
+template<size_t OFFSET, class FIELD, class... REST>
+class RecordFieldOffset<0U, OFFSET, FIELD, REST...> {
+public:
+    static const size_t VALUE = OFFSET;
+};
+
+template<size_t INDEX, size_t OFFSET, class FIELD, class... REST>
+class RecordFieldOffset<INDEX, OFFSET, FIELD, REST...> {
+public:
+    static const size_t VALUE =
+        RecordFieldOffset<INDEX - 1U, OFFSET + FIELD::WIDTH, REST...>::VALUE;
+};
+
+//
+//  Compile-time layout of a fixed-size record.
+//
+//  The checked methods raise BufferException (XAPCORE_BUF_ERROR_OVERFLOW)
+//  before touching any byte if the record doesn't fit, so a failed decode
+//  or encode has no partial effect.
+//
+template<class... FIELDS>
+class RecordLayout {
+public:
+    //  The size of the record (in bytes).
+    static const size_t SIZE = RecordFieldSequence<0U, FIELDS...>::END;
+
+    //  The offset of the field at 'INDEX' (in bytes).
+    template<size_t INDEX>
+    class Offset {
+    public:
+        static_assert(INDEX < sizeof...(FIELDS), "Field index overflowed.");
+        static const size_t VALUE =
+            RecordFieldOffset<INDEX, 0U, FIELDS...>::VALUE;
+    };
+
+    //
+    //  Public functions.
+    //
+
+    /**
+     *  Decode a record from memory (unchecked).
+     *
+     *  @param pointer
+     *      The pointer to the first byte (at least SIZE bytes readable).
+     *  @param record
+     *      The record.
+     */
+    template<class R>
+    static void decode(const uint8_t *pointer, R &record) noexcept {
+        RecordFieldSequence<0U, FIELDS...>::decode(pointer, record);
+    }
+
+    /**
+     *  Encode a record to memory (unchecked).
+     *
+     *  @param record
+     *      The record.
+     *  @param pointer
+     *      The pointer to the first byte (at least SIZE bytes writable).
+     */
+    template<class R>
+    static void encode(const R &record, uint8_t *pointer) noexcept {
+        RecordFieldSequence<0U, FIELDS...>::encode(record, pointer);
+    }
+
+    /**
+     *  Decode a record from a buffer.
+     *
+     *  @throw BufferException
+     *      Raised if the record is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param buffer
+     *      The buffer.
+     *  @param offset
+     *      The offset of the record.
+     *  @param record
+     *      The record.
+     */
+    template<class R>
+    static void decode(const Buffer &buffer, const size_t offset, R &record) {
+        decode(buffer.access(offset, SIZE).get_pointer(), record);
+    }
+
+    /**
+     *  Decode a record from a buffer.
+     *
+     *  @throw BufferException
+     *      Raised if the record is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param buffer
+     *      The buffer.
+     *  @param offset
+     *      The offset of the record (default 0).
+     *  @return
+     *      The record.
+     */
+    template<class R>
+    static R decode(const Buffer &buffer, const size_t offset = 0U) {
+        R record;
+        decode(buffer, offset, record);
+        return record;
+    }
+
+    /**
+     *  Encode a record to a buffer.
+     *
+     *  @note
+     *      The buffer is detached first if it is in copy-on-write mode and
+     *      the storage is shared.
+     *  @throw BufferException
+     *      Raised if the record is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @throw std::bad_alloc
+     *      Raised if failed to allocate memory (when detaching).
+     *  @param record
+     *      The record.
+     *  @param buffer
+     *      The buffer.
+     *  @param offset
+     *      The offset of the record (default 0).
+     */
+    template<class R>
+    static void encode(
+        const R         &record,
+        Buffer          &buffer,
+        const size_t    offset = 0U
+    ) {
+        const BufferAccessor accessor = buffer.access(offset, SIZE);
+        if (buffer.is_copy_on_write() && !buffer.is_unique()) {
+            buffer.detach();
+            encode(record, buffer.get_pointer() + offset);
+        } else {
+            encode(record, accessor.get_pointer());
+        }
+    }
+
+    /**
+     *  Fetch a record (and move the cursor over it).
+     *
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough, the cursor is not
+     *      moved (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param fetcher
+     *      The fetcher.
+     *  @param record
+     *      The record.
+     */
+    template<class R>
+    static void fetch(BufferFetcher &fetcher, R &record) {
+        if (fetcher.get_remaining_size() < SIZE) {
+            throw BufferException(
+                "Reached the end of the buffer.",
+                XAPCORE_BUF_ERROR_OVERFLOW
+            );
+        }
+        decode(fetcher.get_pointer(), record);
+        fetcher.skip(SIZE);
+    }
+
+    /**
+     *  Fetch a record (and move the cursor over it).
+     *
+     *  @throw BufferException
+     *      Raised if the remaining bytes are not enough, the cursor is not
+     *      moved (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param fetcher
+     *      The fetcher.
+     *  @return
+     *      The record.
+     */
+    template<class R>
+    static R fetch(BufferFetcher &fetcher) {
+        R record;
+        fetch(fetcher, record);
+        return record;
+    }
+
+    /**
+     *  Append a record to a writer.
+     *
+     *  @throw BufferException
+     *      Raised if the length overflowed (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param record
+     *      The record.
+     *  @param writer
+     *      The writer.
+     */
+    template<class R>
+    static void write(const R &record, BufferWriter &writer) {
+        uint8_t encoded[SIZE != 0U ? SIZE : 1U];
+        encode(record, encoded);
+        writer.write_bytes(encoded, SIZE);
+    }
+};
+
+template<class... FIELDS>
+const size_t RecordLayout<FIELDS...>::SIZE;
+
+template<class... FIELDS>
+template<size_t INDEX>
+const size_t RecordLayout<FIELDS...>::Offset<INDEX>::VALUE;
+
+}  //  namespace buffer
+}  //  namespace core
+}  //  namespace xap
+
+
+#endif  //  #ifndef XAP_CORE_BUFFER_RECORD_H__
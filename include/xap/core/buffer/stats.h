@@ -0,0 +1,126 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+#ifndef XAP_CORE_BUFFER_STATS_H__
+#define XAP_CORE_BUFFER_STATS_H__
+
+//
+//  Imports.
+//
+#include <stddef.h>
+#include <stdint.h>
+
+namespace xap {
+namespace core {
+namespace buffer {
+
+//
+//  Structures.
+//
+
+//
+//  Instrumentation counters.
+//
+//  The counters are only maintained if the library is compiled with
+//  XAP_CORE_BUFFER_STATS defined (see the CMake option of the same name),
+//  otherwise they are always zero and the instrumentation costs nothing.
+//
+struct BufferStats {
+    //  The count of buffer storages allocated.
+    uint64_t    allocations;
+
+    //  The count of buffer storages released.
+    uint64_t    frees;
+
+    //  The count of bytes allocated for buffer storages.
+    uint64_t    allocated_bytes;
+
+    //  The count of bytes copied (copy(), concat(), detach(), queue pops
+    //  which coalesce chunks, chain flattening and writer growth).
+    uint64_t    copied_bytes;
+
+    //  The count of slices created.
+    uint64_t    slices;
+
+    //  The count of bytes of all live buffer storages (of all threads).
+    uint64_t    live_bytes;
+
+    //  The maximum of 'live_bytes' (of all threads).
+    uint64_t    peak_live_bytes;
+};
+
+//
+//  Types.
+//
+
+/**
+ *  Callback which exports the counters of a thread.
+ *
+ *  @param stats
+ *      The counters accumulated by the thread since the last flush.
+ *  @param context
+ *      The context passed to buffer_stats_set_hook().
+ */
+typedef void (*BufferStatsHook)(const BufferStats &stats, void *context);
+
+//
+//  Public functions.
+//
+
+/**
+ *  Check whether the instrumentation is compiled in.
+ *
+ *  @return
+ *      True if so.
+ */
+bool buffer_stats_is_enabled() noexcept;
+
+/**
+ *  Get the counters of the calling thread.
+ *
+ *  @note
+ *      The counters (except 'live_bytes' and 'peak_live_bytes', which are
+ *      process-wide) only include the operations done by the calling
+ *      thread since it started (or since its last flush / reset).
+ *  @return
+ *      The counters.
+ */
+BufferStats buffer_stats_get_snapshot() noexcept;
+
+/**
+ *  Reset the counters of the calling thread (and the peak live bytes to
+ *  the current live bytes).
+ */
+void buffer_stats_reset() noexcept;
+
+/**
+ *  Pass the counters of the calling thread to the hook (if any), then
+ *  reset them.
+ *
+ *  @note
+ *      The counters of a thread are also flushed when the thread exits.
+ */
+void buffer_stats_flush() noexcept;
+
+/**
+ *  Set the hook which exports the counters.
+ *
+ *  @note
+ *      The hook may be called from any thread (concurrently), and must
+ *      not throw.
+ *  @param hook
+ *      The hook (nullptr to remove).
+ *  @param context
+ *      The context passed to the hook.
+ */
+void buffer_stats_set_hook(BufferStatsHook hook, void *context) noexcept;
+
+}  //  namespace buffer
+}  //  namespace core
+}  //  namespace xap
+
+
+#endif  //  #ifndef XAP_CORE_BUFFER_STATS_H__
@@ -0,0 +1,439 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+#ifndef XAP_CORE_BUFFER_WRITER_H__
+#define XAP_CORE_BUFFER_WRITER_H__
+
+//
+//  Imports.
+//
+#include <stdint.h>
+#include <xap/core/buffer/allocator.h>
+#include <xap/core/buffer/buffer.h>
+#include <xap/core/buffer/error.h>
+
+namespace xap {
+namespace core {
+namespace buffer {
+
+//
+//  Classes.
+//
+
+//
+//  Growable buffer builder (the serialization counterpart of
+//  BufferFetcher).
+//
+//  Values are appended at the end, the storage grows geometrically so
+//  that appending is amortized O(1). finish() hands the written bytes out
+//  as a Buffer which shares the storage (no final copy).
+//
+class BufferWriter {
+public:
+    //
+    //  Constructor & destructor.
+    //
+
+    /**
+     *  Construct the object.
+     *
+     *  @param capacity
+     *      The initial capacity.
+     */
+    explicit BufferWriter(const size_t capacity = 0U);
+
+    /**
+     *  Construct the object.
+     *
+     *  @param capacity
+     *      The initial capacity.
+     *  @param allocator
+     *      The allocator of storage (must outlive the writer and the
+     *      finished buffers).
+     */
+    BufferWriter(const size_t capacity, BufferAllocator &allocator);
+
+    /**
+     *  Construct (copy) the object.
+     *
+     *  @param src
+     *      The source writer (the written bytes are copied).
+     */
+    BufferWriter(const BufferWriter &src);
+
+    /**
+     *  Construct (move) the object.
+     *
+     *  @param src
+     *      The source writer (would be empty after moved).
+     */
+    BufferWriter(BufferWriter &&src) noexcept;
+
+    /**
+     *  Destruct the object.
+     */
+    ~BufferWriter() noexcept;
+
+    //
+    //  Public operators.
+    //
+
+    /**
+     *  Operator '='.
+     *
+     *  @param src
+     *      The source writer (the written bytes are copied).
+     *  @return
+     *      The destination writer.
+     */
+    BufferWriter& operator=(const BufferWriter &src);
+
+    /**
+     *  Operator '=' (move).
+     *
+     *  @param src
+     *      The source writer (would be empty after moved).
+     *  @return
+     *      The destination writer.
+     */
+    BufferWriter& operator=(BufferWriter &&src) noexcept;
+
+    //
+    //  Public methods.
+    //
+
+    /**
+     *  Get the count of written bytes.
+     *
+     *  @return
+     *      The length.
+     */
+    size_t get_length() const noexcept;
+
+    /**
+     *  Get the count of bytes which can be written without growing.
+     *
+     *  @return
+     *      The capacity.
+     */
+    size_t get_capacity() const noexcept;
+
+    /**
+     *  Make sure that at least 'capacity' bytes can be held without
+     *  growing.
+     *
+     *  @param capacity
+     *      The capacity.
+     */
+    void reserve(const size_t capacity);
+
+    /**
+     *  Discard all written bytes (the storage is kept).
+     */
+    void clear() noexcept;
+
+    /**
+     *  Append raw bytes.
+     *
+     *  @throw BufferException
+     *      Raised if the length overflowed (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param data
+     *      The bytes.
+     *  @param datalen
+     *      The count of bytes.
+     */
+    void write_bytes(const uint8_t *data, const size_t datalen);
+
+    /**
+     *  Append the bytes of a buffer.
+     *
+     *  @throw BufferException
+     *      Raised if the length overflowed (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param data
+     *      The buffer.
+     */
+    void write_bytes(const Buffer &data);
+
+    /**
+     *  Append zero bytes (e.g. a placeholder to patch later).
+     *
+     *  @throw BufferException
+     *      Raised if the length overflowed (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param count
+     *      The count of bytes.
+     *  @return
+     *      The offset of the first appended byte.
+     */
+    size_t skip(const size_t count);
+
+    /**
+     *  Append an unsigned 8-bit integer.
+     *
+     *  @param value
+     *      The unsigned 8-bit integer.
+     */
+    void write_uint8(const uint8_t value);
+
+    /**
+     *  Append an unsigned 16-bit integer with big-endian.
+     *
+     *  @param value
+     *      The unsigned 16-bit integer.
+     */
+    void write_uint16_be(const uint16_t value);
+
+    /**
+     *  Append an unsigned 16-bit integer with little-endian.
+     *
+     *  @param value
+     *      The unsigned 16-bit integer.
+     */
+    void write_uint16_le(const uint16_t value);
+
+    /**
+     *  Append an unsigned 32-bit integer with big-endian.
+     *
+     *  @param value
+     *      The unsigned 32-bit integer.
+     */
+    void write_uint32_be(const uint32_t value);
+
+    /**
+     *  Append an unsigned 32-bit integer with little-endian.
+     *
+     *  @param value
+     *      The unsigned 32-bit integer.
+     */
+    void write_uint32_le(const uint32_t value);
+
+#if defined(UINT64_MAX)
+
+    /**
+     *  Append an unsigned 64-bit integer with big-endian.
+     *
+     *  @param value
+     *      The unsigned 64-bit integer.
+     */
+    void write_uint64_be(const uint64_t value);
+
+    /**
+     *  Append an unsigned 64-bit integer with little-endian.
+     *
+     *  @param value
+     *      The unsigned 64-bit integer.
+     */
+    void write_uint64_le(const uint64_t value);
+
+    /**
+     *  Append an unsigned integer with variable-length (LEB128) encoding.
+     *
+     *  @param value
+     *      The unsigned integer (1 to 10 bytes are appended).
+     */
+    void write_varint(const uint64_t value);
+
+    /**
+     *  Append a signed integer with zigzag and variable-length (LEB128)
+     *  encoding.
+     *
+     *  @param value
+     *      The signed integer (1 to 10 bytes are appended).
+     */
+    void write_varint_signed(const int64_t value);
+
+#endif  //  #if defined(UINT64_MAX)
+
+    /**
+     *  Append a single-precision float-point with big-endian.
+     *
+     *  @param value
+     *      The single-precision float-point value.
+     */
+    void write_float_be(const float value);
+
+    /**
+     *  Append a single-precision float-point with little-endian.
+     *
+     *  @param value
+     *      The single-precision float-point value.
+     */
+    void write_float_le(const float value);
+
+    /**
+     *  Append a double-precision float-point with big-endian.
+     *
+     *  @param value
+     *      The double-precision float-point value.
+     */
+    void write_double_be(const double value);
+
+    /**
+     *  Append a double-precision float-point with little-endian.
+     *
+     *  @param value
+     *      The double-precision float-point value.
+     */
+    void write_double_le(const double value);
+
+    /**
+     *  Overwrite an unsigned 8-bit integer in the written bytes.
+     *
+     *  @throw BufferException
+     *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param value
+     *      The unsigned 8-bit integer.
+     *  @param offset
+     *      The offset.
+     */
+    void patch_uint8(const uint8_t value, const size_t offset);
+
+    /**
+     *  Overwrite an unsigned 16-bit integer with big-endian in the written
+     *  bytes.
+     *
+     *  @throw BufferException
+     *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param value
+     *      The unsigned 16-bit integer.
+     *  @param offset
+     *      The offset.
+     */
+    void patch_uint16_be(const uint16_t value, const size_t offset);
+
+    /**
+     *  Overwrite an unsigned 16-bit integer with little-endian in the
+     *  written bytes.
+     *
+     *  @throw BufferException
+     *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param value
+     *      The unsigned 16-bit integer.
+     *  @param offset
+     *      The offset.
+     */
+    void patch_uint16_le(const uint16_t value, const size_t offset);
+
+    /**
+     *  Overwrite an unsigned 32-bit integer with big-endian in the written
+     *  bytes.
+     *
+     *  @throw BufferException
+     *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param value
+     *      The unsigned 32-bit integer.
+     *  @param offset
+     *      The offset.
+     */
+    void patch_uint32_be(const uint32_t value, const size_t offset);
+
+    /**
+     *  Overwrite an unsigned 32-bit integer with little-endian in the
+     *  written bytes.
+     *
+     *  @throw BufferException
+     *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param value
+     *      The unsigned 32-bit integer.
+     *  @param offset
+     *      The offset.
+     */
+    void patch_uint32_le(const uint32_t value, const size_t offset);
+
+#if defined(UINT64_MAX)
+
+    /**
+     *  Overwrite an unsigned 64-bit integer with big-endian in the written
+     *  bytes.
+     *
+     *  @throw BufferException
+     *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param value
+     *      The unsigned 64-bit integer.
+     *  @param offset
+     *      The offset.
+     */
+    void patch_uint64_be(const uint64_t value, const size_t offset);
+
+    /**
+     *  Overwrite an unsigned 64-bit integer with little-endian in the
+     *  written bytes.
+     *
+     *  @throw BufferException
+     *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param value
+     *      The unsigned 64-bit integer.
+     *  @param offset
+     *      The offset.
+     */
+    void patch_uint64_le(const uint64_t value, const size_t offset);
+
+#endif  //  #if defined(UINT64_MAX)
+
+    /**
+     *  Finish writing, get the written bytes (without copying).
+     *
+     *  @note
+     *      The writer is empty (with no storage) after finished.
+     *  @return
+     *      The buffer.
+     */
+    Buffer finish();
+
+private:
+    //
+    //  Private methods.
+    //
+
+    /**
+     *  Make room for appending bytes.
+     *
+     *  @throw BufferException
+     *      Raised if the length overflowed (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param count
+     *      The count of bytes would be appended.
+     *  @return
+     *      The pointer to the first appended byte (the written length is
+     *      increased by 'count').
+     */
+    uint8_t* append(const size_t count);
+
+    /**
+     *  Check if a patch at 'offset' is out of the written bytes.
+     *
+     *  @throw BufferException
+     *      Raised if 'offset' or 'size' is out of range
+     *      (XAPCORE_BUF_ERROR_OVERFLOW).
+     *  @param offset
+     *      The offset.
+     *  @param size
+     *      The size of the patch.
+     *  @return
+     *      The pointer to the patched bytes.
+     */
+    uint8_t* check_patch(const size_t offset, const size_t size);
+
+    /**
+     *  Replace the storage with a bigger one.
+     *
+     *  @param capacity
+     *      The new capacity (must not be less than the written length).
+     */
+    void grow(const size_t capacity);
+
+    //
+    //  Members.
+    //
+    Buffer          m_storage;
+    size_t          m_length;
+    BufferAllocator *m_allocator;
+};
+
+}  //  namespace buffer
+}  //  namespace core
+}  //  namespace xap
+
+
+#endif  //  #ifndef XAP_CORE_BUFFER_WRITER_H__
@@ -0,0 +1,876 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+//
+//  Imports.
+//
+#include <algorithm>
+#include <new>
+#include <xap/core/buffer/allocator.h>
+#include <xap/core/buffer/build.h>
+
+#if defined(XAP_CORE_BUFFER_OS_WIN)
+# include <windows.h>
+#elif defined(XAP_CORE_BUFFER_OS_POSIX)
+# include <sys/mman.h>
+# include <unistd.h>
+# if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#  define MAP_ANONYMOUS MAP_ANON
+# endif
+#endif
+
+namespace xap {
+namespace core {
+namespace buffer {
+
+//
+//  Constants.
+//
+
+//  The alignment guaranteed by global operator new.
+static const size_t HEAP_NATURAL_ALIGNMENT = alignof(max_align_t);
+
+//  The size of the smallest pool class.
+static const size_t POOL_MIN_BLOCK_SIZE = 64U;
+
+//  The alignment of pool slabs.
+static const size_t POOL_SLAB_ALIGNMENT = 64U;
+
+//  The minimum size of pool slabs.
+static const size_t POOL_MIN_SLAB_SIZE = 65536U;
+
+//  The minimum count of blocks in each pool slab.
+static const size_t POOL_MIN_SLAB_BLOCKS = 8U;
+
+//  The size of huge pages (the common size on x86-64 and ARM64).
+static const size_t PAGE_HUGE_SIZE = 2097152U;
+
+//
+//  Private functions declare.
+//
+
+/**
+ *  Round value up to the multiple of specified alignment.
+ *
+ *  @param value
+ *      The value.
+ *  @param alignment
+ *      The alignment (must be a power of 2).
+ *  @return
+ *      The rounded value.
+ */
+static inline size_t allocator_align_up(
+    const size_t value,
+    const size_t alignment
+) noexcept;
+
+/**
+ *  Get the size of slabs of specified pool class.
+ *
+ *  @param block_size
+ *      The size of blocks in the class.
+ *  @return
+ *      The size of slabs.
+ */
+static inline size_t allocator_get_slab_size(const size_t block_size) noexcept;
+
+#if defined(XAP_CORE_BUFFER_OS_POSIX)
+
+/**
+ *  Map anonymous memory which begins at specified alignment.
+ *
+ *  @throw std::bad_alloc
+ *      Raised if failed to map memory.
+ *  @param length
+ *      The length of memory (must be a multiple of the page size).
+ *  @param alignment
+ *      The alignment of memory (must be a power of 2).
+ *  @return
+ *      The pointer to the memory.
+ */
+static void* allocator_map_aligned(
+    const size_t length,
+    const size_t alignment
+);
+
+#endif  //  #if defined(XAP_CORE_BUFFER_OS_POSIX)
+
+//
+//  Global variables.
+//
+
+//  The heap allocator.
+static BufferHeapAllocator g_heap_allocator;
+
+//  The default allocator of current thread.
+static thread_local BufferAllocator *g_default_allocator = nullptr;
+
+//
+//  BufferAllocator destructor.
+//
+
+/**
+ *  Destruct the object.
+ */
+BufferAllocator::~BufferAllocator() noexcept {}
+
+//
+//  BufferAllocator public methods.
+//
+
+/**
+ *  Get the allocator of the control blocks (reference counters) of 
+ *  buffer storage allocated by this allocator.
+ *
+ *  @note
+ *      By default, the control block is placed in front of the storage,
+ *      and both of them are allocated with one request. Allocators 
+ *      whose blocks are sized or aligned for the storage itself (e.g. 
+ *      size classes, page mappings) return the allocator of control 
+ *      blocks instead, so that the storage is requested with its exact 
+ *      size.
+ *  @return
+ *      The allocator (nullptr if the control block is allocated with 
+ *      the storage).
+ */
+BufferAllocator* BufferAllocator::get_control_allocator() noexcept {
+    return nullptr;
+}
+
+//
+//  BufferAllocator static functions.
+//
+
+/**
+ *  Get the default allocator of current thread.
+ *
+ *  @return
+ *      The allocator (the heap allocator if not set).
+ */
+BufferAllocator& BufferAllocator::get_default() noexcept {
+    if (g_default_allocator == nullptr) {
+        return g_heap_allocator;
+    }
+    return *g_default_allocator;
+}
+
+/**
+ *  Set the default allocator of current thread.
+ *
+ *  @param allocator
+ *      The allocator (nullptr to restore the heap allocator).
+ */
+void BufferAllocator::set_default(BufferAllocator *allocator) noexcept {
+    g_default_allocator = allocator;
+}
+
+/**
+ *  Get the heap allocator (shared by all threads).
+ *
+ *  @return
+ *      The allocator.
+ */
+BufferAllocator& BufferAllocator::get_heap() noexcept {
+    return g_heap_allocator;
+}
+
+//
+//  BufferHeapAllocator public methods.
+//
+
+/**
+ *  Allocate memory.
+ *
+ *  @throw std::bad_alloc
+ *      Raised if failed to allocate memory.
+ *  @param size
+ *      The size of memory.
+ *  @param alignment
+ *      The alignment of memory (must be a power of 2).
+ *  @return
+ *      The pointer to the memory.
+ */
+void* BufferHeapAllocator::allocate(const size_t size, const size_t alignment) {
+    if (alignment <= HEAP_NATURAL_ALIGNMENT) {
+        return ::operator new(size);
+    }
+
+    //
+    //  Over-allocate, and keep the raw pointer right before the aligned
+    //  pointer.
+    //
+    const size_t extra = alignment + sizeof(void*) - 1U;
+    if (size > SIZE_MAX - extra) {
+        throw std::bad_alloc();
+    }
+    uint8_t *raw = static_cast<uint8_t*>(::operator new(size + extra));
+    uintptr_t aligned = static_cast<uintptr_t>(allocator_align_up(
+        reinterpret_cast<uintptr_t>(raw + sizeof(void*)),
+        alignment
+    ));
+    reinterpret_cast<void**>(aligned)[-1] = raw;
+    return reinterpret_cast<void*>(aligned);
+}
+
+/**
+ *  Deallocate memory.
+ *
+ *  @param pointer
+ *      The pointer returned by allocate().
+ *  @param size
+ *      The size passed to allocate().
+ *  @param alignment
+ *      The alignment passed to allocate().
+ */
+void BufferHeapAllocator::deallocate(
+    void            *pointer,
+    const size_t    size,
+    const size_t    alignment
+) noexcept {
+    (void)size;
+    if (pointer == nullptr) {
+        return;
+    }
+    if (alignment <= HEAP_NATURAL_ALIGNMENT) {
+        ::operator delete(pointer);
+    } else {
+        ::operator delete(static_cast<void**>(pointer)[-1]);
+    }
+}
+
+//
+//  BufferPoolAllocator constructor & destructor.
+//
+
+/**
+ *  Construct the object.
+ *
+ *  @param max_block_size
+ *      The size of the biggest class (rounded up to a power of 2).
+ */
+BufferPoolAllocator::BufferPoolAllocator(const size_t max_block_size) :
+    m_classes()
+{
+    size_t block_size = POOL_MIN_BLOCK_SIZE;
+    do {
+        SizeClass *size_class = new SizeClass();
+        size_class->block_size = block_size;
+        size_class->free_list = nullptr;
+        this->m_classes.push_back(size_class);
+        block_size <<= 1U;
+    } while ((block_size >> 1U) < max_block_size);
+}
+
+/**
+ *  Destruct the object.
+ */
+BufferPoolAllocator::~BufferPoolAllocator() noexcept {
+    for (SizeClass *size_class: this->m_classes) {
+        size_t slab_size = allocator_get_slab_size(size_class->block_size);
+        for (void *slab: size_class->slabs) {
+            g_heap_allocator.deallocate(slab, slab_size, POOL_SLAB_ALIGNMENT);
+        }
+        delete size_class;
+    }
+    this->m_classes.clear();
+}
+
+//
+//  BufferPoolAllocator public methods.
+//
+
+/**
+ *  Allocate memory.
+ *
+ *  @throw std::bad_alloc
+ *      Raised if failed to allocate memory.
+ *  @param size
+ *      The size of memory.
+ *  @param alignment
+ *      The alignment of memory (must be a power of 2).
+ *  @return
+ *      The pointer to the memory.
+ */
+void* BufferPoolAllocator::allocate(const size_t size, const size_t alignment) {
+    SizeClass *size_class = this->get_size_class(size, alignment);
+    if (size_class == nullptr) {
+        return g_heap_allocator.allocate(size, alignment);
+    }
+
+    std::lock_guard<std::mutex> guard(size_class->lock);
+    if (size_class->free_list == nullptr) {
+        //
+        //  Carve a new slab into free blocks.
+        //
+        const size_t block_size = size_class->block_size;
+        const size_t slab_size = allocator_get_slab_size(block_size);
+        size_class->slabs.reserve(size_class->slabs.size() + 1U);
+        uint8_t *slab = static_cast<uint8_t*>(
+            g_heap_allocator.allocate(slab_size, POOL_SLAB_ALIGNMENT)
+        );
+        size_class->slabs.push_back(slab);
+        for (size_t offset = slab_size; offset != 0U; offset -= block_size) {
+            void *block = slab + offset - block_size;
+            *static_cast<void**>(block) = size_class->free_list;
+            size_class->free_list = block;
+        }
+    }
+
+    void *block = size_class->free_list;
+    size_class->free_list = *static_cast<void**>(block);
+    return block;
+}
+
+/**
+ *  Deallocate memory.
+ *
+ *  @param pointer
+ *      The pointer returned by allocate().
+ *  @param size
+ *      The size passed to allocate().
+ *  @param alignment
+ *      The alignment passed to allocate().
+ */
+void BufferPoolAllocator::deallocate(
+    void            *pointer,
+    const size_t    size,
+    const size_t    alignment
+) noexcept {
+    if (pointer == nullptr) {
+        return;
+    }
+    SizeClass *size_class = this->get_size_class(size, alignment);
+    if (size_class == nullptr) {
+        g_heap_allocator.deallocate(pointer, size, alignment);
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(size_class->lock);
+    *static_cast<void**>(pointer) = size_class->free_list;
+    size_class->free_list = pointer;
+}
+
+/**
+ *  Get the allocator of the control blocks (reference counters) of 
+ *  buffer storage allocated by this allocator.
+ *
+ *  @return
+ *      The allocator (the pool itself).
+ */
+BufferAllocator* BufferPoolAllocator::get_control_allocator() noexcept {
+    return this;
+}
+
+//
+//  BufferPoolAllocator private methods.
+//
+
+/**
+ *  Get the size class which serves specified request.
+ *
+ *  @param size
+ *      The size of memory.
+ *  @param alignment
+ *      The alignment of memory.
+ *  @return
+ *      The size class (nullptr if the request should be served by the
+ *      heap).
+ */
+BufferPoolAllocator::SizeClass* BufferPoolAllocator::get_size_class(
+    const size_t size,
+    const size_t alignment
+) noexcept {
+    if (alignment > POOL_SLAB_ALIGNMENT) {
+        return nullptr;
+    }
+    for (SizeClass *size_class: this->m_classes) {
+        //  Blocks are carved at multiples of the block size (which is not
+        //  less than the slab alignment) from the slab start.
+        if (size <= size_class->block_size) {
+            return size_class;
+        }
+    }
+    return nullptr;
+}
+
+//
+//  BufferArenaAllocator constructor & destructor.
+//
+
+/**
+ *  Construct the object.
+ *
+ *  @param block_size
+ *      The size of arena blocks.
+ */
+BufferArenaAllocator::BufferArenaAllocator(const size_t block_size) :
+    m_block_size(std::max<size_t>(block_size, POOL_MIN_BLOCK_SIZE)),
+    m_blocks(),
+    m_large_blocks(),
+    m_cursor(nullptr),
+    m_end(nullptr),
+    m_used(0U)
+{
+    //  Do nothing.
+}
+
+/**
+ *  Destruct the object.
+ */
+BufferArenaAllocator::~BufferArenaAllocator() noexcept {
+    this->reset();
+    for (void *block: this->m_blocks) {
+        ::operator delete(block);
+    }
+    this->m_blocks.clear();
+}
+
+//
+//  BufferArenaAllocator public methods.
+//
+
+/**
+ *  Allocate memory.
+ *
+ *  @throw std::bad_alloc
+ *      Raised if failed to allocate memory.
+ *  @param size
+ *      The size of memory.
+ *  @param alignment
+ *      The alignment of memory (must be a power of 2).
+ *  @return
+ *      The pointer to the memory.
+ */
+void* BufferArenaAllocator::allocate(const size_t size, const size_t alignment) {
+    if (size > SIZE_MAX - alignment) {
+        throw std::bad_alloc();
+    }
+    if (size + alignment > this->m_block_size) {
+        //  Serve big requests with dedicated blocks.
+        this->m_large_blocks.reserve(this->m_large_blocks.size() + 1U);
+        uint8_t *raw = static_cast<uint8_t*>(
+            ::operator new(size + alignment)
+        );
+        this->m_large_blocks.push_back(raw);
+        this->m_used += size;
+        return reinterpret_cast<void*>(allocator_align_up(
+            reinterpret_cast<uintptr_t>(raw),
+            alignment
+        ));
+    }
+
+    uint8_t *aligned = nullptr;
+    if (this->m_cursor != nullptr) {
+        aligned = reinterpret_cast<uint8_t*>(allocator_align_up(
+            reinterpret_cast<uintptr_t>(this->m_cursor),
+            alignment
+        ));
+    }
+    if (aligned == nullptr ||
+        static_cast<size_t>(this->m_end - aligned) < size) {
+        //
+        //  Switch to a new block (blocks released by reset() are kept in
+        //  'm_blocks' and only the first one is reused).
+        //
+        this->m_blocks.reserve(this->m_blocks.size() + 1U);
+        uint8_t *block = static_cast<uint8_t*>(
+            ::operator new(this->m_block_size)
+        );
+        this->m_blocks.push_back(block);
+        this->m_cursor = block;
+        this->m_end = block + this->m_block_size;
+        aligned = reinterpret_cast<uint8_t*>(allocator_align_up(
+            reinterpret_cast<uintptr_t>(this->m_cursor),
+            alignment
+        ));
+    }
+
+    this->m_cursor = aligned + size;
+    this->m_used += size;
+    return aligned;
+}
+
+/**
+ *  Deallocate memory (do nothing, memory is released by reset()).
+ *
+ *  @param pointer
+ *      The pointer returned by allocate().
+ *  @param size
+ *      The size passed to allocate().
+ *  @param alignment
+ *      The alignment passed to allocate().
+ */
+void BufferArenaAllocator::deallocate(
+    void            *pointer,
+    const size_t    size,
+    const size_t    alignment
+) noexcept {
+    (void)pointer;
+    (void)size;
+    (void)alignment;
+}
+
+/**
+ *  Release all memory allocated from the arena (the first block is kept
+ *  for reuse).
+ */
+void BufferArenaAllocator::reset() noexcept {
+    for (void *block: this->m_large_blocks) {
+        ::operator delete(block);
+    }
+    this->m_large_blocks.clear();
+
+    if (!this->m_blocks.empty()) {
+        for (size_t i = 1U; i < this->m_blocks.size(); ++i) {
+            ::operator delete(this->m_blocks[i]);
+        }
+        this->m_blocks.resize(1U);
+        this->m_cursor = static_cast<uint8_t*>(this->m_blocks[0]);
+        this->m_end = this->m_cursor + this->m_block_size;
+    }
+    this->m_used = 0U;
+}
+
+/**
+ *  Get the count of bytes allocated from the arena since last reset.
+ *
+ *  @return
+ *      The count of bytes.
+ */
+size_t BufferArenaAllocator::get_used_size() const noexcept {
+    return this->m_used;
+}
+
+//
+//  BufferPageAllocator constructor & destructor.
+//
+
+/**
+ *  Construct the object.
+ *
+ *  @param mode
+ *      The huge page mode.
+ */
+BufferPageAllocator::BufferPageAllocator(
+    const BufferHugePageMode mode
+) noexcept :
+    m_mode(mode)
+{
+    //  Do nothing.
+}
+
+/**
+ *  Destruct the object.
+ */
+BufferPageAllocator::~BufferPageAllocator() noexcept {}
+
+//
+//  BufferPageAllocator public methods.
+//
+
+/**
+ *  Allocate memory.
+ *
+ *  @throw std::bad_alloc
+ *      Raised if failed to allocate memory.
+ *  @param size
+ *      The size of memory.
+ *  @param alignment
+ *      The alignment of memory (must be a power of 2).
+ *  @return
+ *      The pointer to the memory.
+ */
+void* BufferPageAllocator::allocate(const size_t size, const size_t alignment) {
+    const size_t length = this->get_mapping_length(size);
+    if (length < size) {
+        throw std::bad_alloc();
+    }
+
+#if defined(XAP_CORE_BUFFER_OS_WIN)
+
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    if (alignment > info.dwAllocationGranularity) {
+        throw std::bad_alloc();
+    }
+    if (this->m_mode == BUFFER_HUGE_PAGE_EXPLICIT) {
+        const size_t large_size = GetLargePageMinimum();
+        if (large_size != 0U && size >= large_size && 
+            alignment <= large_size) {
+            void *pointer = VirtualAlloc(
+                nullptr,
+                allocator_align_up(length, large_size),
+                MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                PAGE_READWRITE
+            );
+            if (pointer != nullptr) {
+                return pointer;
+            }
+        }
+    }
+    void *pointer = VirtualAlloc(
+        nullptr,
+        length,
+        MEM_RESERVE | MEM_COMMIT,
+        PAGE_READWRITE
+    );
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+
+#elif defined(XAP_CORE_BUFFER_OS_POSIX)
+
+    const bool huge = this->is_huge(size);
+#if defined(MAP_HUGETLB)
+    if (huge && this->m_mode == BUFFER_HUGE_PAGE_EXPLICIT && 
+        alignment <= PAGE_HUGE_SIZE) {
+        void *pointer = mmap(
+            nullptr,
+            length,
+            PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+            -1,
+            0
+        );
+        if (pointer != MAP_FAILED) {
+            return pointer;
+        }
+    }
+#endif
+    void *pointer = allocator_map_aligned(
+        length,
+        std::max<size_t>(
+            alignment, 
+            huge ? PAGE_HUGE_SIZE : BufferPageAllocator::get_page_size()
+        )
+    );
+#if defined(MADV_HUGEPAGE)
+    if (huge) {
+        //  The advice is best-effort, ignore the failure.
+        madvise(pointer, length, MADV_HUGEPAGE);
+    }
+#endif
+    return pointer;
+
+#else
+
+    return BufferAllocator::get_heap().allocate(size, alignment);
+
+#endif
+}
+
+/**
+ *  Deallocate memory.
+ *
+ *  @param pointer
+ *      The pointer returned by allocate().
+ *  @param size
+ *      The size passed to allocate().
+ *  @param alignment
+ *      The alignment passed to allocate().
+ */
+void BufferPageAllocator::deallocate(
+    void            *pointer,
+    const size_t    size,
+    const size_t    alignment
+) noexcept {
+    if (pointer == nullptr) {
+        return;
+    }
+
+#if defined(XAP_CORE_BUFFER_OS_WIN)
+    (void)size;
+    (void)alignment;
+    VirtualFree(pointer, 0U, MEM_RELEASE);
+#elif defined(XAP_CORE_BUFFER_OS_POSIX)
+    (void)alignment;
+    munmap(pointer, this->get_mapping_length(size));
+#else
+    BufferAllocator::get_heap().deallocate(pointer, size, alignment);
+#endif
+}
+
+/**
+ *  Get the huge page mode.
+ *
+ *  @return
+ *      The mode.
+ */
+BufferHugePageMode BufferPageAllocator::get_mode() const noexcept {
+    return this->m_mode;
+}
+
+/**
+ *  Get the allocator of the control blocks (reference counters) of 
+ *  buffer storage allocated by this allocator.
+ *
+ *  @return
+ *      The allocator (the heap allocator).
+ */
+BufferAllocator* BufferPageAllocator::get_control_allocator() noexcept {
+    return &g_heap_allocator;
+}
+
+/**
+ *  Get the length of the mapping which serves a request (the memory an 
+ *  allocation costs, on targets with memory mapping).
+ *
+ *  @note
+ *      The size is rounded up to the huge page size if the request is 
+ *      served with huge pages, or to the normal page size otherwise.
+ *  @param size
+ *      The size of memory.
+ *  @return
+ *      The length.
+ */
+size_t BufferPageAllocator::get_mapping_length(
+    const size_t size
+) const noexcept {
+    return allocator_align_up(
+        std::max<size_t>(size, 1U),
+        this->is_huge(size) ? 
+            PAGE_HUGE_SIZE : 
+            BufferPageAllocator::get_page_size()
+    );
+}
+
+//
+//  BufferPageAllocator static functions.
+//
+
+/**
+ *  Get the size of normal pages.
+ *
+ *  @return
+ *      The size.
+ */
+size_t BufferPageAllocator::get_page_size() noexcept {
+#if defined(XAP_CORE_BUFFER_OS_WIN)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return static_cast<size_t>(info.dwPageSize);
+#elif defined(XAP_CORE_BUFFER_OS_POSIX)
+    static const size_t page_size = static_cast<size_t>(
+        sysconf(_SC_PAGESIZE)
+    );
+    return page_size;
+#else
+    return 4096U;
+#endif
+}
+
+//
+//  BufferPageAllocator private methods.
+//
+
+/**
+ *  Get whether a request is served with huge pages.
+ *
+ *  @param size
+ *      The size of memory.
+ *  @return
+ *      True if so.
+ */
+bool BufferPageAllocator::is_huge(const size_t size) const noexcept {
+    //  Smaller requests would waste most of a huge page.
+    return this->m_mode != BUFFER_HUGE_PAGE_NONE && size >= PAGE_HUGE_SIZE;
+}
+
+//
+//  Private functions.
+//
+
+/**
+ *  Round value up to the multiple of specified alignment.
+ *
+ *  @param value
+ *      The value.
+ *  @param alignment
+ *      The alignment (must be a power of 2).
+ *  @return
+ *      The rounded value.
+ */
+static inline size_t allocator_align_up(
+    const size_t value,
+    const size_t alignment
+) noexcept {
+    return (value + alignment - 1U) & ~(alignment - 1U);
+}
+
+/**
+ *  Get the size of slabs of specified pool class.
+ *
+ *  @param block_size
+ *      The size of blocks in the class.
+ *  @return
+ *      The size of slabs.
+ */
+static inline size_t allocator_get_slab_size(const size_t block_size) noexcept {
+    return std::max<size_t>(
+        POOL_MIN_SLAB_SIZE,
+        block_size * POOL_MIN_SLAB_BLOCKS
+    );
+}
+
+#if defined(XAP_CORE_BUFFER_OS_POSIX)
+
+/**
+ *  Map anonymous memory which begins at specified alignment.
+ *
+ *  @throw std::bad_alloc
+ *      Raised if failed to map memory.
+ *  @param length
+ *      The length of memory (must be a multiple of the page size).
+ *  @param alignment
+ *      The alignment of memory (must be a power of 2).
+ *  @return
+ *      The pointer to the memory.
+ */
+static void* allocator_map_aligned(
+    const size_t length,
+    const size_t alignment
+) {
+    const size_t page_size = BufferPageAllocator::get_page_size();
+    const size_t extra = (alignment > page_size) ? (alignment - page_size) : 0U;
+    if (length > SIZE_MAX - extra) {
+        throw std::bad_alloc();
+    }
+
+    //  Over-map, and unmap the misaligned head and the unused tail.
+    const size_t reserved = length + extra;
+    void *raw = mmap(
+        nullptr,
+        reserved,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS,
+        -1,
+        0
+    );
+    if (raw == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    uint8_t *base = static_cast<uint8_t*>(raw);
+    uint8_t *aligned = reinterpret_cast<uint8_t*>(allocator_align_up(
+        reinterpret_cast<uintptr_t>(base),
+        alignment
+    ));
+    const size_t head = static_cast<size_t>(aligned - base);
+    const size_t tail = reserved - head - length;
+    if (head != 0U) {
+        munmap(base, head);
+    }
+    if (tail != 0U) {
+        munmap(aligned + length, tail);
+    }
+    return aligned;
+}
+
+#endif  //  #if defined(XAP_CORE_BUFFER_OS_POSIX)
+
+}  //  namespace buffer
+}  //  namespace core
+}  //  namespace xap
@@ -9,24 +9,429 @@
 //
 #include <cmath>
 #include <algorithm>
+#include <limits>
+#include <new>
+#include <string.h>
+#include <utility>
+#include <xap/core/buffer/endian.h>
 #include <xap/core/buffer/error.h>
 #include <xap/core/buffer/buffer.h>
+#include "instrument.h"
+#include "kernel.h"
 
 namespace xap {
 namespace core {
 namespace buffer {
 
+//
+//  Constants.
+//
+
+//  The default alignment of buffer storage (same as global operator new).
+static const size_t BUFFER_DEFAULT_ALIGNMENT = alignof(max_align_t);
+
+#if defined(XAP_CORE_BUFFER_IEEE_754)
+static_assert(
+    std::numeric_limits<float>::is_iec559 && sizeof(float) == 4U && 
+    std::numeric_limits<double>::is_iec559 && sizeof(double) == 8U,
+    "XAP_CORE_BUFFER_IEEE_754 is defined, but float-point format mismatched."
+);
+#endif
+
+//  Whether the host byte order matches little-endian / big-endian (bulk 
+//  accessors copy the memory directly if so).
+#if defined(XAP_CORE_BUFFER_LITTLE_ENDIAN)
+static const bool BUFFER_HOST_LITTLE_ENDIAN = true;
+static const bool BUFFER_HOST_BIG_ENDIAN = false;
+#elif defined(XAP_CORE_BUFFER_BIG_ENDIAN)
+static const bool BUFFER_HOST_LITTLE_ENDIAN = false;
+static const bool BUFFER_HOST_BIG_ENDIAN = true;
+#else
+static const bool BUFFER_HOST_LITTLE_ENDIAN = false;
+static const bool BUFFER_HOST_BIG_ENDIAN = false;
+#endif
+
+//
+//  Global variables.
+//
+
+//  The storage shared by all empty buffers.
+static uint8_t g_buffer_empty_storage[1] = {0x00};
+
+//
+//  Private classes.
+//
+
+//
+//  Standard allocator adapter which places the buffer storage right after 
+//  the shared pointer control block, so that both of them are allocated 
+//  with one request to the buffer allocator.
+//
+template<class T>
+class BufferStorageAllocator {
+public:
+    //
+    //  Public types.
+    //
+    typedef T value_type;
+
+    //
+    //  Constructors.
+    //
+
+    /**
+     *  Construct the object.
+     * 
+     *  @param allocator
+     *      The buffer allocator.
+     *  @param length
+     *      The length of buffer storage.
+     *  @param alignment
+     *      The alignment of buffer storage.
+     *  @param storage
+     *      The pointer to receive the buffer storage.
+     */
+    BufferStorageAllocator(
+        BufferAllocator *allocator,
+        const size_t    length,
+        const size_t    alignment,
+        uint8_t         **storage
+    ) noexcept :
+        m_allocator(allocator),
+        m_length(length),
+        m_alignment(alignment),
+        m_storage(storage)
+    {}
+
+    /**
+     *  Construct (rebind) the object.
+     * 
+     *  @param src
+     *      The source allocator.
+     */
+    template<class U>
+    BufferStorageAllocator(const BufferStorageAllocator<U> &src) noexcept :
+        m_allocator(src.m_allocator),
+        m_length(src.m_length),
+        m_alignment(src.m_alignment),
+        m_storage(src.m_storage)
+    {}
+
+    //
+    //  Public methods.
+    //
+
+    /**
+     *  Allocate the control block (, and the trailing buffer storage).
+     * 
+     *  @throw std::bad_alloc
+     *      Raised if the total size overflowed or failed to allocate 
+     *      memory.
+     *  @param count
+     *      The count of objects.
+     *  @return
+     *      The pointer to objects.
+     */
+    T* allocate(const size_t count) {
+        const size_t head = this->get_head_size(count);
+        if (this->m_length > SIZE_MAX - head) {
+            throw std::bad_alloc();
+        }
+        uint8_t *block = static_cast<uint8_t*>(this->m_allocator->allocate(
+            head + this->m_length, 
+            this->get_alignment()
+        ));
+        *(this->m_storage) = block + head;
+        XAP_CORE_BUFFER_STATS_ALLOCATE(this->m_length);
+        return reinterpret_cast<T*>(block);
+    }
+
+    /**
+     *  Deallocate the control block (, and the trailing buffer storage).
+     * 
+     *  @param pointer
+     *      The pointer to objects.
+     *  @param count
+     *      The count of objects.
+     */
+    void deallocate(T *pointer, const size_t count) noexcept {
+        XAP_CORE_BUFFER_STATS_FREE(this->m_length);
+        this->m_allocator->deallocate(
+            pointer, 
+            this->get_head_size(count) + this->m_length,
+            this->get_alignment()
+        );
+    }
+
+    //
+    //  Public operators.
+    //
+
+    template<class U>
+    bool operator==(const BufferStorageAllocator<U> &other) const noexcept {
+        return this->m_allocator == other.m_allocator;
+    }
+
+    template<class U>
+    bool operator!=(const BufferStorageAllocator<U> &other) const noexcept {
+        return this->m_allocator != other.m_allocator;
+    }
+
+    //
+    //  Members.
+    //
+    BufferAllocator    *m_allocator;
+    size_t              m_length;
+    size_t              m_alignment;
+    uint8_t           **m_storage;
+
+private:
+    //
+    //  Private methods.
+    //
+
+    /**
+     *  Get the alignment of the whole block.
+     * 
+     *  @return
+     *      The alignment.
+     */
+    size_t get_alignment() const noexcept {
+        return std::max<size_t>(alignof(T), this->m_alignment);
+    }
+
+    /**
+     *  Get the size of objects (rounded up to the storage alignment).
+     * 
+     *  @param count
+     *      The count of objects.
+     *  @return
+     *      The size.
+     */
+    size_t get_head_size(const size_t count) const noexcept {
+        const size_t alignment = this->get_alignment();
+        return (count * sizeof(T) + alignment - 1U) & ~(alignment - 1U);
+    }
+};
+
+//
+//  Standard allocator adapter which allocates the shared pointer control 
+//  block (only) with a buffer allocator.
+//
+template<class T>
+class BufferControlAllocator {
+public:
+    //
+    //  Public types.
+    //
+    typedef T value_type;
+
+    //
+    //  Constructors.
+    //
+
+    /**
+     *  Construct the object.
+     * 
+     *  @param allocator
+     *      The buffer allocator.
+     */
+    explicit BufferControlAllocator(BufferAllocator *allocator) noexcept :
+        m_allocator(allocator)
+    {}
+
+    /**
+     *  Construct (rebind) the object.
+     * 
+     *  @param src
+     *      The source allocator.
+     */
+    template<class U>
+    BufferControlAllocator(const BufferControlAllocator<U> &src) noexcept :
+        m_allocator(src.m_allocator)
+    {}
+
+    //
+    //  Public methods.
+    //
+
+    /**
+     *  Allocate the control block.
+     * 
+     *  @throw std::bad_alloc
+     *      Raised if failed to allocate memory.
+     *  @param count
+     *      The count of objects.
+     *  @return
+     *      The pointer to objects.
+     */
+    T* allocate(const size_t count) {
+        return static_cast<T*>(
+            this->m_allocator->allocate(count * sizeof(T), alignof(T))
+        );
+    }
+
+    /**
+     *  Deallocate the control block.
+     * 
+     *  @param pointer
+     *      The pointer to objects.
+     *  @param count
+     *      The count of objects.
+     */
+    void deallocate(T *pointer, const size_t count) noexcept {
+        this->m_allocator->deallocate(pointer, count * sizeof(T), alignof(T));
+    }
+
+    //
+    //  Public operators.
+    //
+
+    template<class U>
+    bool operator==(const BufferControlAllocator<U> &other) const noexcept {
+        return this->m_allocator == other.m_allocator;
+    }
+
+    template<class U>
+    bool operator!=(const BufferControlAllocator<U> &other) const noexcept {
+        return this->m_allocator != other.m_allocator;
+    }
+
+    //
+    //  Members.
+    //
+    BufferAllocator    *m_allocator;
+};
+
+//
+//  Deleter which returns buffer storage allocated apart from its control 
+//  block to the buffer allocator (used by std::shared_ptr).
+//
+struct BufferStorageDeleter {
+    //  The buffer allocator.
+    BufferAllocator    *allocator;
+
+    //  The length of buffer storage.
+    size_t              length;
+
+    //  The alignment of buffer storage.
+    size_t              alignment;
+
+    /**
+     *  Release the storage.
+     * 
+     *  @param storage
+     *      The storage.
+     */
+    void operator()(uint8_t *storage) const noexcept {
+        XAP_CORE_BUFFER_STATS_FREE(this->length);
+        this->allocator->deallocate(storage, this->length, this->alignment);
+    }
+};
+
+//
+//  Deleter which calls the release callback of adopted memory (used by 
+//  std::shared_ptr).
+//
+struct BufferReleaseDeleter {
+    //  The release callback.
+    BufferReleaseCallback   release;
+
+    //  The length of the memory.
+    size_t                  datalen;
+
+    //  The context of the release callback.
+    void                   *context;
+
+    /**
+     *  Release the memory.
+     * 
+     *  @param data
+     *      The memory.
+     */
+    void operator()(uint8_t *data) const noexcept {
+        this->release(data, this->datalen, this->context);
+    }
+};
+
 //
 //  Private functions declare.
 //
 
 /**
- *  Free buffer space.
+ *  Allocate buffer space.
+ * 
+ *  @throw std::bad_alloc
+ *      Raised if failed to allocate memory.
+ *  @param length
+ *      The length of buffer space.
+ *  @param alignment
+ *      The alignment of buffer space.
+ *  @param allocator
+ *      The allocator.
+ *  @return
+ *      The shared pointer to buffer space.
+ */
+static std::shared_ptr<uint8_t> buffer_allocate_space(
+    const size_t        length,
+    const size_t        alignment,
+    BufferAllocator     &allocator
+);
+
+/**
+ *  Get the buffer space shared by all empty buffers.
  * 
- *  @param ptr
- *      The pointer to buffer which would be free.
+ *  @return
+ *      The shared pointer to buffer space (owns nothing).
  */
-static void buffer_free_space(uint8_t *ptr) noexcept;
+static inline std::shared_ptr<uint8_t> buffer_empty_space() noexcept;
+
+/**
+ *  Read an array of integers.
+ * 
+ *  @param src
+ *      The source memory.
+ *  @param dst
+ *      The destination array.
+ *  @param count
+ *      The count of integers.
+ *  @param native
+ *      True if the source byte order matches the host.
+ */
+template<typename T, T (*READER)(const uint8_t*)>
+static void buffer_read_array(
+    const uint8_t   *src,
+    T               *dst,
+    const size_t    count,
+    const bool      native
+) noexcept;
+
+/**
+ *  Write an array of integers.
+ * 
+ *  @param dst
+ *      The destination memory.
+ *  @param src
+ *      The source array.
+ *  @param count
+ *      The count of integers.
+ *  @param native
+ *      True if the destination byte order matches the host.
+ */
+template<typename T, void (*WRITER)(uint8_t*, const T)>
+static void buffer_write_array(
+    uint8_t         *dst,
+    const T         *src,
+    const size_t    count,
+    const bool      native
+) noexcept;
+
+//
+//  Public constants.
+//
+const size_t Buffer::NPOS;
+const size_t Buffer::CACHE_LINE_ALIGNMENT;
+const size_t Buffer::PAGE_ALIGNMENT;
 
 //
 //  Public class methods (also includes constructors, destructor and operators).
@@ -41,8 +446,25 @@ static void buffer_free_space(uint8_t *ptr) noexcept;
 Buffer::Buffer(const Buffer &source) {
     this->m_buffer = source.m_buffer;
     this->m_bufferstart = source.m_bufferstart;
-    this->m_bufferend = source.m_bufferend;
+    this->m_storagelength = source.m_storagelength;
     this->m_bufferlength = source.m_bufferlength;
+    this->m_cow = source.m_cow;
+}
+
+/**
+ *  Construct (move) the object.
+ * 
+ *  @param source
+ *      The source buffer (would be empty after moved).
+ */
+Buffer::Buffer(Buffer &&source) noexcept :
+    m_buffer(std::move(source.m_buffer)),
+    m_bufferstart(source.m_bufferstart),
+    m_storagelength(source.m_storagelength),
+    m_bufferlength(source.m_bufferlength),
+    m_cow(source.m_cow)
+{
+    source.prepare(buffer_empty_space(), 0U, 0U);
 }
 
 /**
@@ -52,14 +474,15 @@ Buffer::Buffer(const Buffer &source) {
  *      The length of buffer.
  */
 Buffer::Buffer(const size_t length) {
-    uint8_t *data;
-    if (length == 0U) {
-        data = new uint8_t[1];
-    } else {
-        data = new uint8_t[length];
-    }
-    std::shared_ptr<uint8_t> buffer(data, buffer_free_space);
-    this->prepare(buffer, 0U, length);
+    this->prepare(
+        buffer_allocate_space(
+            length, 
+            BUFFER_DEFAULT_ALIGNMENT, 
+            BufferAllocator::get_default()
+        ), 
+        0U, 
+        length
+    );
     this->fill(0x00);
 }
 
@@ -72,9 +495,112 @@ Buffer::Buffer(const size_t length) {
  *      True if not initialze with zero.
  */
 Buffer::Buffer(const size_t length, const bool unsafe) {
-    uint8_t *data = new uint8_t[length];
-    std::shared_ptr<uint8_t> buffer(data, buffer_free_space);
-    this->prepare(buffer, 0U, length);
+    this->prepare(
+        buffer_allocate_space(
+            length, 
+            BUFFER_DEFAULT_ALIGNMENT, 
+            BufferAllocator::get_default()
+        ), 
+        0U, 
+        length
+    );
+    if (!unsafe) {
+        this->fill(0x00);
+    }
+}
+
+/**
+ *  Construct the object.
+ * 
+ *  @throw std::bad_alloc
+ *      Raised if the allocator failed to allocate memory.
+ *  @param length
+ *      The length of buffer.
+ *  @param unsafe
+ *      True if not initialze with zero.
+ *  @param allocator
+ *      The allocator of buffer storage (must outlive the buffer).
+ */
+Buffer::Buffer(
+    const size_t    length, 
+    const bool      unsafe, 
+    BufferAllocator &allocator
+) {
+    this->prepare(
+        buffer_allocate_space(length, BUFFER_DEFAULT_ALIGNMENT, allocator), 
+        0U, 
+        length
+    );
+    if (!unsafe) {
+        this->fill(0x00);
+    }
+}
+
+/**
+ *  Construct the object with aligned storage.
+ * 
+ *  @throw BufferException
+ *      Raised if 'alignment' is not a power of 2 
+ *      (XAPCORE_BUF_ERROR_INVALID_SIZE).
+ *  @param length
+ *      The length of buffer.
+ *  @param unsafe
+ *      True if not initialze with zero.
+ *  @param alignment
+ *      The alignment of buffer storage (e.g. CACHE_LINE_ALIGNMENT, 
+ *      PAGE_ALIGNMENT).
+ */
+Buffer::Buffer(
+    const size_t    length, 
+    const bool      unsafe, 
+    const size_t    alignment
+) : 
+    Buffer(length, unsafe, alignment, BufferAllocator::get_default())
+{
+    //  Do nothing.
+}
+
+/**
+ *  Construct the object with aligned storage.
+ * 
+ *  @note
+ *      Use BufferPageAllocator to back big buffers with (huge) pages.
+ *  @throw BufferException
+ *      Raised if 'alignment' is not a power of 2 
+ *      (XAPCORE_BUF_ERROR_INVALID_SIZE).
+ *  @throw std::bad_alloc
+ *      Raised if the allocator failed to allocate memory.
+ *  @param length
+ *      The length of buffer.
+ *  @param unsafe
+ *      True if not initialze with zero.
+ *  @param alignment
+ *      The alignment of buffer storage (e.g. CACHE_LINE_ALIGNMENT, 
+ *      PAGE_ALIGNMENT).
+ *  @param allocator
+ *      The allocator of buffer storage (must outlive the buffer).
+ */
+Buffer::Buffer(
+    const size_t    length, 
+    const bool      unsafe, 
+    const size_t    alignment,
+    BufferAllocator &allocator
+) {
+    if (alignment == 0U || (alignment & (alignment - 1U)) != 0U) {
+        throw BufferException(
+            "Alignment must be a power of 2.", 
+            XAPCORE_BUF_ERROR_INVALID_SIZE
+        );
+    }
+    this->prepare(
+        buffer_allocate_space(
+            length, 
+            std::max<size_t>(alignment, BUFFER_DEFAULT_ALIGNMENT), 
+            allocator
+        ), 
+        0U, 
+        length
+    );
     if (!unsafe) {
         this->fill(0x00);
     }
@@ -89,10 +615,43 @@ Buffer::Buffer(const size_t length, const bool unsafe) {
  *      The length of source data.
  */
 Buffer::Buffer(const uint8_t *data, const size_t datalen) {
-    uint8_t *inner = new uint8_t[datalen];
-    memcpy(inner, data, datalen);
-    std::shared_ptr<uint8_t> buffer(inner, buffer_free_space);
-    this->prepare(buffer, 0U, datalen);
+    this->prepare(
+        buffer_allocate_space(
+            datalen, 
+            BUFFER_DEFAULT_ALIGNMENT, 
+            BufferAllocator::get_default()
+        ), 
+        0U, 
+        datalen
+    );
+    memcpy(this->m_bufferstart, data, datalen);
+    XAP_CORE_BUFFER_STATS_COPY(datalen);
+}
+
+/**
+ *  Construct (copy) the object.
+ * 
+ *  @throw std::bad_alloc
+ *      Raised if the allocator failed to allocate memory.
+ *  @param data
+ *      The source data.
+ *  @param datalen
+ *      The length of source data.
+ *  @param allocator
+ *      The allocator of buffer storage (must outlive the buffer).
+ */
+Buffer::Buffer(
+    const uint8_t   *data, 
+    const size_t    datalen, 
+    BufferAllocator &allocator
+) {
+    this->prepare(
+        buffer_allocate_space(datalen, BUFFER_DEFAULT_ALIGNMENT, allocator), 
+        0U, 
+        datalen
+    );
+    memcpy(this->m_bufferstart, data, datalen);
+    XAP_CORE_BUFFER_STATS_COPY(datalen);
 }
 
 /**
@@ -112,25 +671,31 @@ Buffer& Buffer::operator=(const Buffer &source) {
     if (this != &source) {
         this->m_buffer = source.m_buffer;
         this->m_bufferstart = source.m_bufferstart;
-        this->m_bufferend = source.m_bufferend;
+        this->m_storagelength = source.m_storagelength;
         this->m_bufferlength = source.m_bufferlength;
+        this->m_cow = source.m_cow;
     }
     return *this;
 }
 
 /**
- *  Operator '[]'. Get the buffer value of specified position.
+ *  Operator '=' (move).
  * 
- *  @throw BufferException
- *      Raised if offset is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
- *  @param offset
- *      The offset.
+ *  @param source
+ *      The source buffer (would be empty after moved).
  *  @return
- *      The value of buffer in specified position. 
+ *      The target buffer.
  */
-uint8_t& Buffer::operator[](const size_t offset) const {
-    this->check_access(offset, 1U);
-    return *(this->m_bufferstart + offset);
+Buffer& Buffer::operator=(Buffer &&source) noexcept {
+    if (this != &source) {
+        this->m_buffer = std::move(source.m_buffer);
+        this->m_bufferstart = source.m_bufferstart;
+        this->m_storagelength = source.m_storagelength;
+        this->m_bufferlength = source.m_bufferlength;
+        this->m_cow = source.m_cow;
+        source.prepare(buffer_empty_space(), 0U, 0U);
+    }
+    return *this;
 }
 
 /**
@@ -142,16 +707,7 @@ uint8_t& Buffer::operator[](const size_t offset) const {
  *      True if equal.
  */
 bool Buffer::operator==(const Buffer& other) const noexcept {
-    if (other.m_bufferlength != this->m_bufferlength) {
-        return false;
-    }
-
-    for (size_t i = 0; i < this->m_bufferlength; ++i) {
-        if (this->m_bufferstart[i] != other.m_bufferstart[i]) {
-            return false;
-        }
-    }
-    return true;
+    return this->is_equal(other.m_bufferstart, other.m_bufferlength);
 }
 
 /**
@@ -167,33 +723,128 @@ bool Buffer::operator!=(const Buffer& other) const noexcept {
 }
 
 /**
- *  Get the length of buffer.
+ *  Get whether the raw pointer of buffer is aligned.
+ * 
+ *  @param alignment
+ *      The alignment.
+ *  @return
+ *      True if so (always false if 'alignment' is 0).
+ */
+bool Buffer::is_aligned(const size_t alignment) const noexcept {
+    if (alignment == 0U) {
+        return false;
+    }
+    return reinterpret_cast<uintptr_t>(this->m_bufferstart) % alignment == 0U;
+}
+
+/**
+ *  Get whether the buffer is the only owner of its storage.
  * 
+ *  @note
+ *      The answer is based on the reference count of the storage, so it is
+ *      only reliable if no other thread copies or destroys the buffers 
+ *      sharing the storage meanwhile. A buffer wrapping unowned memory is 
+ *      never unique, an empty buffer is always unique.
  *  @return
- *      The length.
+ *      True if so.
  */
-size_t Buffer::get_length() const noexcept {
-    return this->m_bufferlength;
+bool Buffer::is_unique() const noexcept {
+    if (this->m_bufferlength == 0U) {
+        return true;
+    }
+    return this->m_buffer.use_count() == 1;
 }
 
 /**
- *  Get the raw pointer of buffer.
+ *  Get the length of the storage which the buffer keeps alive (e.g. the 
+ *  whole allocation a slice was taken from).
  * 
+ *  @note
+ *      A buffer wrapping unowned memory keeps nothing alive, the length of
+ *      the buffer is returned.
  *  @return
- *      The raw pointer.
+ *      The length (not less than the length of the buffer).
  */
-uint8_t* Buffer::get_pointer() noexcept {
-    return this->m_bufferstart;
+size_t Buffer::get_storage_length() const noexcept {
+    if (this->m_buffer.use_count() == 0) {
+        //  Unowned (or empty).
+        return this->m_bufferlength;
+    }
+    return this->m_storagelength;
 }
 
 /**
- *  Get the raw pointer of buffer.
+ *  Get whether the buffer shares its storage with another buffer (e.g. 
+ *  both are slices of the same buffer).
  * 
+ *  @note
+ *      Buffers wrapping unowned memory never share storage.
+ *  @param other
+ *      The other buffer.
  *  @return
- *      The raw pointer.
+ *      True if so.
  */
-const uint8_t* Buffer::get_pointer() const noexcept {
-    return this->m_bufferstart;
+bool Buffer::is_sharing_storage(const Buffer &other) const noexcept {
+    if (this->m_buffer.use_count() == 0) {
+        return false;
+    }
+    return !this->m_buffer.owner_before(other.m_buffer) && 
+        !other.m_buffer.owner_before(this->m_buffer);
+}
+
+/**
+ *  Make the buffer the only owner of its storage, copy the bytes into new
+ *  storage if the storage is shared (or unowned).
+ * 
+ *  @note
+ *      The new storage is allocated from the default allocator with the 
+ *      default alignment.
+ *  @throw std::bad_alloc
+ *      Raised if failed to allocate memory.
+ *  @return
+ *      True if the bytes were copied.
+ */
+bool Buffer::detach() {
+    if (this->is_unique()) {
+        return false;
+    }
+    const bool cow = this->m_cow;
+    std::shared_ptr<uint8_t> storage = buffer_allocate_space(
+        this->m_bufferlength, 
+        BUFFER_DEFAULT_ALIGNMENT, 
+        BufferAllocator::get_default()
+    );
+    memcpy(storage.get(), this->m_bufferstart, this->m_bufferlength);
+    XAP_CORE_BUFFER_STATS_COPY(this->m_bufferlength);
+    this->prepare(std::move(storage), 0U, this->m_bufferlength);
+    this->m_cow = cow;
+    return true;
+}
+
+/**
+ *  Set whether the buffer is in copy-on-write mode.
+ * 
+ *  @note
+ *      In copy-on-write mode, the write methods (write_*(), fill(), swap*() 
+ *      and copy() into the buffer) detach the buffer before writing if the 
+ *      storage is shared, so that the other buffers never see the change.
+ *      The raw accesses (get_pointer(), operator[] and access()) don't. The
+ *      mode is inherited by copies and slices of the buffer.
+ *  @param enabled
+ *      True if enable.
+ */
+void Buffer::set_copy_on_write(const bool enabled) noexcept {
+    this->m_cow = enabled;
+}
+
+/**
+ *  Get whether the buffer is in copy-on-write mode.
+ * 
+ *  @return
+ *      True if so.
+ */
+bool Buffer::is_copy_on_write() const noexcept {
+    return this->m_cow;
 }
 
 /**
@@ -227,11 +878,34 @@ Buffer Buffer::slice(const size_t offset) const {
  */
 Buffer Buffer::slice(const size_t offset, const size_t length) const {
     this->check_access(offset, length);
-    return Buffer(
+    Buffer sliced(
         this->m_buffer, 
         (this->m_bufferstart - this->m_buffer.get()) + offset, 
         length
     );
+    sliced.m_storagelength = this->m_storagelength;
+    sliced.m_cow = this->m_cow;
+    XAP_CORE_BUFFER_STATS_SLICE();
+    return sliced;
+}
+
+/**
+ *  Validate a range once and get an accessor whose typed reads and 
+ *  writes skip per-call range checks.
+ * 
+ *  @throw BufferException
+ *      Raised if 'offset' or 'length' is out of range 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset of the range.
+ *  @param length
+ *      The length of the range.
+ *  @return
+ *      The accessor (offsets are relative to the range start).
+ */
+BufferAccessor Buffer::access(const size_t offset, const size_t length) const {
+    this->check_access(offset, length);
+    return BufferAccessor(this->m_bufferstart + offset, length);
 }
 
 /**
@@ -242,13 +916,15 @@ Buffer Buffer::slice(const size_t offset, const size_t length) const {
  *  @return
  *      The number of bytes copied.
  */
-size_t Buffer::copy(Buffer &destination) const noexcept {
+size_t Buffer::copy(Buffer &destination) const {
+    destination.prepare_write();
     uint8_t *dst_ptr = destination.get_pointer();
     const uint8_t *src_ptr = this->get_pointer();
     size_t dst_len = destination.get_length();
     size_t src_len = this->get_length();
     size_t copy_len = std::min(src_len, dst_len);
     memcpy(dst_ptr, src_ptr, copy_len);
+    XAP_CORE_BUFFER_STATS_COPY(copy_len);
     return copy_len;
 }
 
@@ -276,10 +952,12 @@ size_t Buffer::copy(Buffer &destination, const size_t destination_offset) const{
         dst_len -= destination_offset;
     }
     size_t src_len = this->get_length();
+    destination.prepare_write();
     uint8_t *dst_ptr = destination.get_pointer() + destination_offset;
     const uint8_t *src_ptr = this->get_pointer();
     size_t copy_len = std::min(src_len, dst_len);
     memcpy(dst_ptr, src_ptr, copy_len);
+    XAP_CORE_BUFFER_STATS_COPY(copy_len);
     return copy_len;
 }
 
@@ -321,10 +999,12 @@ size_t Buffer::copy(
     } else {
         src_len -= src_offset;
     }
+    destination.prepare_write();
     uint8_t *dst_ptr = destination.get_pointer() + destination_offset;
     const uint8_t *src_ptr = this->get_pointer() + src_offset;
     size_t copy_len = std::min(src_len, dst_len);
     memcpy(dst_ptr, src_ptr, copy_len);
+    XAP_CORE_BUFFER_STATS_COPY(copy_len);
     return copy_len;
 }
 
@@ -334,7 +1014,8 @@ size_t Buffer::copy(
  *  @param value
  *      The value with which to fill buffer.
  */
-void Buffer::fill(const uint8_t value) noexcept {
+void Buffer::fill(const uint8_t value) {
+    this->prepare_write();
     memset(this->m_bufferstart, value, this->m_bufferlength);
 }
 
@@ -357,171 +1038,371 @@ void Buffer::fill(
     const size_t length
 ) {
     this->check_access(offset, length);
+    this->prepare_write();
     memset(this->m_bufferstart + offset, value, length);
 }
 
 /**
- *  Read an unsigned 8-bit integer.
+ *  Interpret buffer as an array of unsigned 16-bit integers and swap the
+ *  byte order in place.
  * 
  *  @throw BufferException
- *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
- *  @param offset
- *      The offset.
- *  @return
- *      The unsigned 8-bit integer value.
+ *      Raised if the length is not a multiple of 2 
+ *      (XAPCORE_BUF_ERROR_INVALID_SIZE).
  */
-uint8_t Buffer::read_uint8(const size_t offset) const {
-    this->check_access(offset, 1U);
-    return this->m_bufferstart[offset];
+void Buffer::swap16() {
+    if (this->m_bufferlength % 2U != 0U) {
+        throw BufferException(
+            "Buffer size must be a multiple of 16-bits.", 
+            XAPCORE_BUF_ERROR_INVALID_SIZE
+        );
+    }
+    this->prepare_write();
+    kernel_swap16(this->m_bufferstart, this->m_bufferlength / 2U);
 }
 
 /**
- *  Read an unsigned 16-bit integer with big-endian.
+ *  Interpret buffer as an array of unsigned 32-bit integers and swap the
+ *  byte order in place.
  * 
  *  @throw BufferException
- *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
- *  @param offset
- *      The offset.
- *  @return
- *      The unsigned 16-bit integer.
+ *      Raised if the length is not a multiple of 4 
+ *      (XAPCORE_BUF_ERROR_INVALID_SIZE).
  */
-uint16_t Buffer::read_uint16_be(const size_t offset) const {
-    this->check_access(offset, 2U);
-    return static_cast<uint16_t>(
-        (static_cast<uint16_t>(this->m_bufferstart[offset + 0U]) << 8U) |
-        (static_cast<uint16_t>(this->m_bufferstart[offset + 1U]))
-    );
+void Buffer::swap32() {
+    if (this->m_bufferlength % 4U != 0U) {
+        throw BufferException(
+            "Buffer size must be a multiple of 32-bits.", 
+            XAPCORE_BUF_ERROR_INVALID_SIZE
+        );
+    }
+    this->prepare_write();
+    kernel_swap32(this->m_bufferstart, this->m_bufferlength / 4U);
 }
 
 /**
- *  Read an unsigned 16-bit integer with little-endian.
+ *  Interpret buffer as an array of 64-bit integers and swap the byte 
+ *  order in place.
  * 
+ *  @throw BufferException
+ *      Raised if the length is not a multiple of 8 
+ *      (XAPCORE_BUF_ERROR_INVALID_SIZE).
+ */
+void Buffer::swap64() {
+    if (this->m_bufferlength % 8U != 0U) {
+        throw BufferException(
+            "Buffer size must be a multiple of 64-bits.", 
+            XAPCORE_BUF_ERROR_INVALID_SIZE
+        );
+    }
+    this->prepare_write();
+    kernel_swap64(this->m_bufferstart, this->m_bufferlength / 8U);
+}
+
+/**
+ *  Read an array of unsigned 16-bit integers with big-endian.
  * 
  *  @throw BufferException
- *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *      Raised if 'offset' or 'count' is out of range 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
  *  @param offset
  *      The offset.
- *  @return
- *      The unsigned 16-bit integer.
+ *  @param dst
+ *      The destination array.
+ *  @param count
+ *      The count of integers.
  */
-uint16_t Buffer::read_uint16_le(const size_t offset) const {
-    this->check_access(offset, 2U);
-    return static_cast<uint16_t>(
-        (static_cast<uint16_t>(this->m_bufferstart[offset + 1U]) << 8U) |
-        (static_cast<uint16_t>(this->m_bufferstart[offset + 0U]))
+void Buffer::read_uint16_be_array(
+    const size_t    offset, 
+    uint16_t        *dst, 
+    const size_t    count
+) const {
+    this->check_array_access(offset, count, 2U);
+    buffer_read_array<uint16_t, endian_read_uint16_be>(
+        this->m_bufferstart + offset, 
+        dst, 
+        count, 
+        BUFFER_HOST_BIG_ENDIAN
     );
 }
 
 /**
- *  Read a signed 16-bit integer with little-endian.
+ *  Read an array of unsigned 16-bit integers with little-endian.
  * 
  *  @throw BufferException
- *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *      Raised if 'offset' or 'count' is out of range 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
  *  @param offset
  *      The offset.
- *  @return
- *      The signed 16-bit integer.
+ *  @param dst
+ *      The destination array.
+ *  @param count
+ *      The count of integers.
  */
-int16_t Buffer::read_sint16_le(const size_t offset) const {
-    this->check_access(offset, 2U);
-    return static_cast<int16_t>(
-        (static_cast<int16_t>(this->m_bufferstart[offset + 1U]) << 8U) |
-        (static_cast<int16_t>(this->m_bufferstart[offset + 0U]))
+void Buffer::read_uint16_le_array(
+    const size_t    offset, 
+    uint16_t        *dst, 
+    const size_t    count
+) const {
+    this->check_array_access(offset, count, 2U);
+    buffer_read_array<uint16_t, endian_read_uint16_le>(
+        this->m_bufferstart + offset, 
+        dst, 
+        count, 
+        BUFFER_HOST_LITTLE_ENDIAN
     );
 }
 
 /**
- *  Read an unsigned 32-bit integer with big-endian.
+ *  Read an array of unsigned 32-bit integers with big-endian.
  * 
  *  @throw BufferException
- *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *      Raised if 'offset' or 'count' is out of range 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
  *  @param offset
  *      The offset.
- *  @return
- *      The unsigned 32-bit integer.
+ *  @param dst
+ *      The destination array.
+ *  @param count
+ *      The count of integers.
  */
-uint32_t Buffer::read_uint32_be(const size_t offset) const {
-    this->check_access(offset, 4U);
-    return static_cast<uint32_t>(
-        (static_cast<uint32_t>(this->m_bufferstart[offset + 0U]) << 24U) |
-        (static_cast<uint32_t>(this->m_bufferstart[offset + 1U]) << 16U) |
-        (static_cast<uint32_t>(this->m_bufferstart[offset + 2U]) <<  8U) |
-        (static_cast<uint32_t>(this->m_bufferstart[offset + 3U]))
+void Buffer::read_uint32_be_array(
+    const size_t    offset, 
+    uint32_t        *dst, 
+    const size_t    count
+) const {
+    this->check_array_access(offset, count, 4U);
+    buffer_read_array<uint32_t, endian_read_uint32_be>(
+        this->m_bufferstart + offset, 
+        dst, 
+        count, 
+        BUFFER_HOST_BIG_ENDIAN
     );
 }
 
 /**
- *  Read an unsigned 32-bit integer with little-endian.
+ *  Read an array of unsigned 32-bit integers with little-endian.
  * 
  *  @throw BufferException
- *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *      Raised if 'offset' or 'count' is out of range 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
  *  @param offset
  *      The offset.
- *  @return
- *      The unsigned 32-bit integer.
+ *  @param dst
+ *      The destination array.
+ *  @param count
+ *      The count of integers.
  */
-uint32_t Buffer::read_uint32_le(const size_t offset) const {
-    this->check_access(offset, 4U);
-    return static_cast<uint32_t>(
-        (static_cast<uint32_t>(this->m_bufferstart[offset + 3U]) << 24U) |
-        (static_cast<uint32_t>(this->m_bufferstart[offset + 2U]) << 16U) |
-        (static_cast<uint32_t>(this->m_bufferstart[offset + 1U]) <<  8U) |
-        (static_cast<uint32_t>(this->m_bufferstart[offset + 0U]))
+void Buffer::read_uint32_le_array(
+    const size_t    offset, 
+    uint32_t        *dst, 
+    const size_t    count
+) const {
+    this->check_array_access(offset, count, 4U);
+    buffer_read_array<uint32_t, endian_read_uint32_le>(
+        this->m_bufferstart + offset, 
+        dst, 
+        count, 
+        BUFFER_HOST_LITTLE_ENDIAN
     );
 }
 
 #if defined(UINT64_MAX)
 
 /**
- *  Read an unsigned 64-bit integer with big-endian.
+ *  Read an array of unsigned 64-bit integers with big-endian.
  * 
  *  @throw BufferException
- *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *      Raised if 'offset' or 'count' is out of range 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
  *  @param offset
  *      The offset.
- *  @return
- *      The unsigned 64-bit integer.
+ *  @param dst
+ *      The destination array.
+ *  @param count
+ *      The count of integers.
  */
-uint64_t Buffer::read_uint64_be(const size_t offset) const {
-    this->check_access(offset, 8U);
-    return static_cast<uint64_t>(
-        (static_cast<uint64_t>(this->m_bufferstart[offset + 0U]) << 56U) |
-        (static_cast<uint64_t>(this->m_bufferstart[offset + 1U]) << 48U) |
-        (static_cast<uint64_t>(this->m_bufferstart[offset + 2U]) << 40U) |
-        (static_cast<uint64_t>(this->m_bufferstart[offset + 3U]) << 32U) |
-        (static_cast<uint64_t>(this->m_bufferstart[offset + 4U]) << 24U) |
-        (static_cast<uint64_t>(this->m_bufferstart[offset + 5U]) << 16U) |
-        (static_cast<uint64_t>(this->m_bufferstart[offset + 6U]) <<  8U) |
-        (static_cast<uint64_t>(this->m_bufferstart[offset + 7U]))
+void Buffer::read_uint64_be_array(
+    const size_t    offset, 
+    uint64_t        *dst, 
+    const size_t    count
+) const {
+    this->check_array_access(offset, count, 8U);
+    buffer_read_array<uint64_t, endian_read_uint64_be>(
+        this->m_bufferstart + offset, 
+        dst, 
+        count, 
+        BUFFER_HOST_BIG_ENDIAN
     );
 }
 
 /**
- *  Read an unsigned 64-bit integer with little-endian.
+ *  Read an array of unsigned 64-bit integers with little-endian.
  * 
  *  @throw BufferException
- *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *      Raised if 'offset' or 'count' is out of range 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
  *  @param offset
  *      The offset.
- *  @return
- *      The unsigned 64-bit integer.
+ *  @param dst
+ *      The destination array.
+ *  @param count
+ *      The count of integers.
  */
-uint64_t Buffer::read_uint64_le(const size_t offset) const {
-    this->check_access(offset, 8U);
-    return static_cast<uint64_t>(
-        (static_cast<uint64_t>(this->m_bufferstart[offset + 7U]) << 56U) |
-        (static_cast<uint64_t>(this->m_bufferstart[offset + 6U]) << 48U) |
-        (static_cast<uint64_t>(this->m_bufferstart[offset + 5U]) << 40U) |
-        (static_cast<uint64_t>(this->m_bufferstart[offset + 4U]) << 32U) |
-        (static_cast<uint64_t>(this->m_bufferstart[offset + 3U]) << 24U) |
-        (static_cast<uint64_t>(this->m_bufferstart[offset + 2U]) << 16U) |
-        (static_cast<uint64_t>(this->m_bufferstart[offset + 1U]) <<  8U) |
-        (static_cast<uint64_t>(this->m_bufferstart[offset + 0U]))
+void Buffer::read_uint64_le_array(
+    const size_t    offset, 
+    uint64_t        *dst, 
+    const size_t    count
+) const {
+    this->check_array_access(offset, count, 8U);
+    buffer_read_array<uint64_t, endian_read_uint64_le>(
+        this->m_bufferstart + offset, 
+        dst, 
+        count, 
+        BUFFER_HOST_LITTLE_ENDIAN
     );
 }
 
 #endif  //  #if defined(UINT64_MAX)
 
+/**
+ *  Read an array of signed 16-bit samples with big-endian and convert 
+ *  them to float samples in [-1.0, 1.0).
+ * 
+ *  @throw BufferException
+ *      Raised if 'offset' or 'count' is out of range 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset.
+ *  @param dst
+ *      The destination array.
+ *  @param count
+ *      The count of samples.
+ */
+void Buffer::read_sint16_be_normalized(
+    const size_t    offset, 
+    float           *dst, 
+    const size_t    count
+) const {
+    this->check_array_access(offset, count, 2U);
+    kernel_sint16_to_float(this->m_bufferstart + offset, dst, count, false);
+}
+
+/**
+ *  Read an array of signed 16-bit samples with little-endian and convert 
+ *  them to float samples in [-1.0, 1.0).
+ * 
+ *  @throw BufferException
+ *      Raised if 'offset' or 'count' is out of range 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset.
+ *  @param dst
+ *      The destination array.
+ *  @param count
+ *      The count of samples.
+ */
+void Buffer::read_sint16_le_normalized(
+    const size_t    offset, 
+    float           *dst, 
+    const size_t    count
+) const {
+    this->check_array_access(offset, count, 2U);
+    kernel_sint16_to_float(this->m_bufferstart + offset, dst, count, true);
+}
+
+/**
+ *  Read an array of packed signed 24-bit samples with big-endian and 
+ *  convert them to float samples in [-1.0, 1.0).
+ * 
+ *  @throw BufferException
+ *      Raised if 'offset' or 'count' is out of range 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset.
+ *  @param dst
+ *      The destination array.
+ *  @param count
+ *      The count of samples.
+ */
+void Buffer::read_sint24_be_normalized(
+    const size_t    offset, 
+    float           *dst, 
+    const size_t    count
+) const {
+    this->check_array_access(offset, count, 3U);
+    kernel_sint24_to_float(this->m_bufferstart + offset, dst, count, false);
+}
+
+/**
+ *  Read an array of packed signed 24-bit samples with little-endian and 
+ *  convert them to float samples in [-1.0, 1.0).
+ * 
+ *  @throw BufferException
+ *      Raised if 'offset' or 'count' is out of range 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset.
+ *  @param dst
+ *      The destination array.
+ *  @param count
+ *      The count of samples.
+ */
+void Buffer::read_sint24_le_normalized(
+    const size_t    offset, 
+    float           *dst, 
+    const size_t    count
+) const {
+    this->check_array_access(offset, count, 3U);
+    kernel_sint24_to_float(this->m_bufferstart + offset, dst, count, true);
+}
+
+/**
+ *  Read an array of signed 32-bit samples with big-endian and convert 
+ *  them to float samples in [-1.0, 1.0].
+ * 
+ *  @throw BufferException
+ *      Raised if 'offset' or 'count' is out of range 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset.
+ *  @param dst
+ *      The destination array.
+ *  @param count
+ *      The count of samples.
+ */
+void Buffer::read_sint32_be_normalized(
+    const size_t    offset, 
+    float           *dst, 
+    const size_t    count
+) const {
+    this->check_array_access(offset, count, 4U);
+    kernel_sint32_to_float(this->m_bufferstart + offset, dst, count, false);
+}
+
+/**
+ *  Read an array of signed 32-bit samples with little-endian and convert 
+ *  them to float samples in [-1.0, 1.0].
+ * 
+ *  @throw BufferException
+ *      Raised if 'offset' or 'count' is out of range 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset.
+ *  @param dst
+ *      The destination array.
+ *  @param count
+ *      The count of samples.
+ */
+void Buffer::read_sint32_le_normalized(
+    const size_t    offset, 
+    float           *dst, 
+    const size_t    count
+) const {
+    this->check_array_access(offset, count, 4U);
+    kernel_sint32_to_float(this->m_bufferstart + offset, dst, count, true);
+}
+
 /**
  *  Read a signal-precision float-point value with big-endian.
  * 
@@ -579,199 +1460,226 @@ double Buffer::read_double_le(const size_t offset) const {
 }
 
 /**
- *  Write unsigned 8-bit integer at the specified offset.
+ *  Write an array of unsigned 16-bit integers with big-endian.
  * 
  *  @throw BufferException
- *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
- *  @param value
- *      The unsigned 8-bit integer.
+ *      Raised if 'offset' or 'count' is out of range 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
  *  @param offset
- *      The offset (default 0).
+ *      The offset.
+ *  @param src
+ *      The source array.
+ *  @param count
+ *      The count of integers.
  */
-void Buffer::write_uint8(const uint8_t value, const size_t offset) {
-    this->check_access(offset, 1U);
-    this->m_bufferstart[offset] = value;
+void Buffer::write_uint16_be_array(
+    const size_t    offset, 
+    const uint16_t  *src, 
+    const size_t    count
+) {
+    this->check_array_access(offset, count, 2U);
+    this->prepare_write();
+    buffer_write_array<uint16_t, endian_write_uint16_be>(
+        this->m_bufferstart + offset, 
+        src, 
+        count, 
+        BUFFER_HOST_BIG_ENDIAN
+    );
 }
 
 /**
- *  Write unsigned 16-bit integer with big-endian at the specified offset.
+ *  Write an array of unsigned 16-bit integers with little-endian.
  * 
  *  @throw BufferException
- *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
- *  @param value
- *      The unsigned 8-bit integer.
+ *      Raised if 'offset' or 'count' is out of range 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
  *  @param offset
- *      The offset (default 0).
+ *      The offset.
+ *  @param src
+ *      The source array.
+ *  @param count
+ *      The count of integers.
+ */
+void Buffer::write_uint16_le_array(
+    const size_t    offset, 
+    const uint16_t  *src, 
+    const size_t    count
+) {
+    this->check_array_access(offset, count, 2U);
+    this->prepare_write();
+    buffer_write_array<uint16_t, endian_write_uint16_le>(
+        this->m_bufferstart + offset, 
+        src, 
+        count, 
+        BUFFER_HOST_LITTLE_ENDIAN
+    );
+}
+
+/**
+ *  Write an array of unsigned 32-bit integers with big-endian.
+ * 
+ *  @throw BufferException
+ *      Raised if 'offset' or 'count' is out of range 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset.
+ *  @param src
+ *      The source array.
+ *  @param count
+ *      The count of integers.
  */
-void Buffer::write_uint16_be(const uint16_t value, const size_t offset) {
-    this->check_access(offset, 2U);
-    this->m_bufferstart[offset + 0U] = 
-        static_cast<uint8_t>((value & 0xFF00) >> 8U);
-    this->m_bufferstart[offset + 1U] = 
-        static_cast<uint8_t>(value & 0x00FF);
+void Buffer::write_uint32_be_array(
+    const size_t    offset, 
+    const uint32_t  *src, 
+    const size_t    count
+) {
+    this->check_array_access(offset, count, 4U);
+    this->prepare_write();
+    buffer_write_array<uint32_t, endian_write_uint32_be>(
+        this->m_bufferstart + offset, 
+        src, 
+        count, 
+        BUFFER_HOST_BIG_ENDIAN
+    );
 }
 
 /**
- *  Write unsigned 16-bit integer with little-endian at the specified 
- *  offset.
+ *  Write an array of unsigned 32-bit integers with little-endian.
  * 
  *  @throw BufferException
- *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
- *  @param value
- *      The unsigned 16-bit integer.
+ *      Raised if 'offset' or 'count' is out of range 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
  *  @param offset
- *      The offset (default 0).
+ *      The offset.
+ *  @param src
+ *      The source array.
+ *  @param count
+ *      The count of integers.
  */
-void Buffer::write_uint16_le(const uint16_t value, const size_t offset) {
-    this->check_access(offset, 2U);
-    this->m_bufferstart[offset + 1U] = 
-        static_cast<uint8_t>((value & static_cast<uint16_t>(0xFF00)) >> 8U);
-    this->m_bufferstart[offset + 0U] = 
-        static_cast<uint8_t>(value & static_cast<uint16_t>(0x00FF));
+void Buffer::write_uint32_le_array(
+    const size_t    offset, 
+    const uint32_t  *src, 
+    const size_t    count
+) {
+    this->check_array_access(offset, count, 4U);
+    this->prepare_write();
+    buffer_write_array<uint32_t, endian_write_uint32_le>(
+        this->m_bufferstart + offset, 
+        src, 
+        count, 
+        BUFFER_HOST_LITTLE_ENDIAN
+    );
 }
 
+#if defined(UINT64_MAX)
+
 /**
- *  Write unsigned 32-bit integer with big-endian at the specified 
- *  offset.
+ *  Write an array of unsigned 64-bit integers with big-endian.
  * 
  *  @throw BufferException
- *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
- *  @param value
- *      The unsigned 32-bit integer.
+ *      Raised if 'offset' or 'count' is out of range 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
  *  @param offset
- *      The offset (default 0).
+ *      The offset.
+ *  @param src
+ *      The source array.
+ *  @param count
+ *      The count of integers.
  */
-void Buffer::write_uint32_be(const uint32_t value, const size_t offset) {
-    this->check_access(offset, 4U);
-    this->m_bufferstart[offset + 0U] = 
-        static_cast<uint8_t>((value & static_cast<uint32_t>(0xFF000000)) >>24U);
-    this->m_bufferstart[offset + 1U] = 
-        static_cast<uint8_t>((value & static_cast<uint32_t>(0x00FF0000)) >>16U);
-    this->m_bufferstart[offset + 2U] = 
-        static_cast<uint8_t>((value & static_cast<uint32_t>(0x0000FF00)) >> 8U);
-    this->m_bufferstart[offset + 3U] = 
-        static_cast<uint8_t>(value & static_cast<uint32_t>(0x000000FF));
+void Buffer::write_uint64_be_array(
+    const size_t    offset, 
+    const uint64_t  *src, 
+    const size_t    count
+) {
+    this->check_array_access(offset, count, 8U);
+    this->prepare_write();
+    buffer_write_array<uint64_t, endian_write_uint64_be>(
+        this->m_bufferstart + offset, 
+        src, 
+        count, 
+        BUFFER_HOST_BIG_ENDIAN
+    );
 }
 
 /**
- *  Write unsigned 32-bit integer with little-endian at the specified 
- *  offset.
+ *  Write an array of unsigned 64-bit integers with little-endian.
  * 
  *  @throw BufferException
- *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
- *  @param value
- *      The unsigned 32-bit integer.
+ *      Raised if 'offset' or 'count' is out of range 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
  *  @param offset
- *      The offset (default 0).
+ *      The offset.
+ *  @param src
+ *      The source array.
+ *  @param count
+ *      The count of integers.
  */
-void Buffer::write_uint32_le(const uint32_t value, const size_t offset) {
-    this->check_access(offset, 4U);
-    this->m_bufferstart[offset + 3U] = 
-        static_cast<uint8_t>((value & static_cast<uint32_t>(0xFF000000)) >>24U);
-    this->m_bufferstart[offset + 2U] = 
-        static_cast<uint8_t>((value & static_cast<uint32_t>(0x00FF0000)) >>16U);
-    this->m_bufferstart[offset + 1U] = 
-        static_cast<uint8_t>((value & static_cast<uint32_t>(0x0000FF00)) >> 8U);
-    this->m_bufferstart[offset + 0U] = 
-        static_cast<uint8_t>(value & static_cast<uint32_t>(0x000000FF));
+void Buffer::write_uint64_le_array(
+    const size_t    offset, 
+    const uint64_t  *src, 
+    const size_t    count
+) {
+    this->check_array_access(offset, count, 8U);
+    this->prepare_write();
+    buffer_write_array<uint64_t, endian_write_uint64_le>(
+        this->m_bufferstart + offset, 
+        src, 
+        count, 
+        BUFFER_HOST_LITTLE_ENDIAN
+    );
 }
 
-#if defined(UINT64_MAX)
+#endif  //  #if defined(UINT64_MAX)
 
 /**
- *  Write unsigned 64-bit integer with big-endian at the specified 
- *  offset.
+ *  Convert an array of float samples in [-1.0, 1.0] to signed 16-bit 
+ *  samples (rounded to nearest and saturated) and write them with 
+ *  big-endian.
  * 
  *  @throw BufferException
- *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
- *  @param value
- *      The unsigned 64-bit integer.
+ *      Raised if 'offset' or 'count' is out of range 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
  *  @param offset
- *      The offset (default 0).
+ *      The offset.
+ *  @param src
+ *      The source array.
+ *  @param count
+ *      The count of samples.
  */
-void Buffer::write_uint64_be(const uint64_t value, const size_t offset) {
-    this->check_access(offset, 8U);
-    this->m_bufferstart[offset + 0U] = 
-        static_cast<uint8_t>(
-            (value & static_cast<uint64_t>(0xFF00000000000000)) >> 56U
-        );
-    this->m_bufferstart[offset + 1U] = 
-        static_cast<uint8_t>(
-            (value & static_cast<uint64_t>(0x00FF000000000000)) >> 48U
-        );
-    this->m_bufferstart[offset + 2U] = 
-        static_cast<uint8_t>(
-            (value & static_cast<uint64_t>(0x0000FF0000000000)
-        ) >> 40U);
-    this->m_bufferstart[offset + 3U] = 
-        static_cast<uint8_t>(
-            (value & static_cast<uint64_t>(0x000000FF00000000)) >> 32U
-        );
-    this->m_bufferstart[offset + 4U] = 
-        static_cast<uint8_t>(
-            (value & static_cast<uint64_t>(0x00000000FF000000)) >> 24U
-        );
-    this->m_bufferstart[offset + 5U] = 
-        static_cast<uint8_t>(
-            (value & static_cast<uint64_t>(0x0000000000FF0000)) >> 16U
-        );
-    this->m_bufferstart[offset + 6U] = 
-        static_cast<uint8_t>(
-            (value & static_cast<uint64_t>(0x000000000000FF00)) >>  8U
-        );
-    this->m_bufferstart[offset + 7U] = 
-        static_cast<uint8_t>(
-            value & static_cast<uint64_t>(0x00000000000000FF)
-        );
+void Buffer::write_sint16_be_normalized(
+    const size_t    offset, 
+    const float     *src, 
+    const size_t    count
+) {
+    this->check_array_access(offset, count, 2U);
+    this->prepare_write();
+    kernel_float_to_sint16(src, this->m_bufferstart + offset, count, false);
 }
 
 /**
- *  Write unsigned 64-bit integer with little-endian at the specified 
- *  offset.
+ *  Convert an array of float samples in [-1.0, 1.0] to signed 16-bit 
+ *  samples (rounded to nearest and saturated) and write them with 
+ *  little-endian.
  * 
  *  @throw BufferException
- *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
- *  @param value
- *      The unsigned 64-bit integer.
+ *      Raised if 'offset' or 'count' is out of range 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
  *  @param offset
- *      The offset (default 0).
+ *      The offset.
+ *  @param src
+ *      The source array.
+ *  @param count
+ *      The count of samples.
  */
-void Buffer::write_uint64_le(const uint64_t value, const size_t offset) {
-    this->check_access(offset, 8U);
-    this->m_bufferstart[offset + 7U] = 
-        static_cast<uint8_t>(
-            (value & static_cast<uint64_t>(0xFF00000000000000)) >> 56U
-        );
-    this->m_bufferstart[offset + 6U] = 
-        static_cast<uint8_t>(
-            (value & static_cast<uint64_t>(0x00FF000000000000)) >> 48U
-        );
-    this->m_bufferstart[offset + 5U] = 
-        static_cast<uint8_t>(
-            (value & static_cast<uint64_t>(0x0000FF0000000000)
-        ) >> 40U);
-    this->m_bufferstart[offset + 4U] = 
-        static_cast<uint8_t>(
-            (value & static_cast<uint64_t>(0x000000FF00000000)) >> 32U
-        );
-    this->m_bufferstart[offset + 3U] = 
-        static_cast<uint8_t>(
-            (value & static_cast<uint64_t>(0x00000000FF000000)) >> 24U
-        );
-    this->m_bufferstart[offset + 2U] = 
-        static_cast<uint8_t>(
-            (value & static_cast<uint64_t>(0x0000000000FF0000)) >> 16U
-        );
-    this->m_bufferstart[offset + 1U] = 
-        static_cast<uint8_t>(
-            (value & static_cast<uint64_t>(0x000000000000FF00)) >>  8U
-        );
-    this->m_bufferstart[offset + 0U] = 
-        static_cast<uint8_t>(
-            value & static_cast<uint64_t>(0x00000000000000FF)
-        );
+void Buffer::write_sint16_le_normalized(
+    const size_t    offset, 
+    const float     *src, 
+    const size_t    count
+) {
+    this->check_array_access(offset, count, 2U);
+    this->prepare_write();
+    kernel_float_to_sint16(src, this->m_bufferstart + offset, count, true);
 }
-#endif  //  #if defined(UINT64_MAX)
 
 /**
  *  Write signal-precision float-point with big-endian at the 
@@ -850,13 +1758,125 @@ bool Buffer::is_equal(
     if (other_len != this->m_bufferlength) {
         return false;
     }
+    if (other == this->m_bufferstart || other_len == 0U) {
+        return true;
+    }
+    return memcmp(this->m_bufferstart, other, other_len) == 0;
+}
 
-    for (size_t i = 0; i < other_len; ++i) {
-        if (other[i] != this->m_bufferstart[i]) {
-            return false;
+/**
+ *  Compare self with another buffer (byte-wise, like memcmp(), shorter 
+ *  buffer goes first if one is a prefix of the other).
+ * 
+ *  @param other
+ *      The other buffer.
+ *  @return
+ *      Negative if self goes first, positive if 'other' goes first, or
+ *      0 if equal.
+ */
+int Buffer::compare(const Buffer &other) const noexcept {
+    const size_t common = std::min(this->m_bufferlength, other.m_bufferlength);
+    if (common != 0U && this->m_bufferstart != other.m_bufferstart) {
+        const int result = memcmp(
+            this->m_bufferstart, 
+            other.m_bufferstart, 
+            common
+        );
+        if (result != 0) {
+            return result;
         }
     }
-    return true;
+    if (this->m_bufferlength < other.m_bufferlength) {
+        return -1;
+    }
+    if (this->m_bufferlength > other.m_bufferlength) {
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ *  Find the first occurrence of a byte.
+ * 
+ *  @param value
+ *      The byte.
+ *  @param from
+ *      The offset where to begin searching.
+ *  @return
+ *      The offset of the occurrence (NPOS if not found).
+ */
+size_t Buffer::index_of(const uint8_t value, const size_t from) const noexcept {
+    if (from >= this->m_bufferlength) {
+        return Buffer::NPOS;
+    }
+
+    //  memchr() is vectorized by the C library.
+    const uint8_t *found = static_cast<const uint8_t*>(
+        memchr(this->m_bufferstart + from, value, this->m_bufferlength - from)
+    );
+    if (found == nullptr) {
+        return Buffer::NPOS;
+    }
+    return static_cast<size_t>(found - this->m_bufferstart);
+}
+
+/**
+ *  Find the first occurrence of a byte sequence.
+ * 
+ *  @param needle
+ *      The byte sequence (an empty one is found at 'from').
+ *  @param from
+ *      The offset where to begin searching.
+ *  @return
+ *      The offset of the occurrence (NPOS if not found).
+ */
+size_t Buffer::index_of(
+    const Buffer    &needle, 
+    const size_t    from
+) const noexcept {
+    return this->index_of(needle.m_bufferstart, needle.m_bufferlength, from);
+}
+
+/**
+ *  Find the first occurrence of a byte sequence.
+ * 
+ *  @param needle
+ *      The byte sequence (an empty one is found at 'from').
+ *  @param needle_len
+ *      The length of the byte sequence.
+ *  @param from
+ *      The offset where to begin searching.
+ *  @return
+ *      The offset of the occurrence (NPOS if not found).
+ */
+size_t Buffer::index_of(
+    const uint8_t   *needle, 
+    const size_t    needle_len, 
+    const size_t    from
+) const noexcept {
+    if (from > this->m_bufferlength) {
+        return Buffer::NPOS;
+    }
+    if (needle_len == 0U) {
+        return from;
+    }
+    if (needle_len == 1U) {
+        return this->index_of(needle[0U], from);
+    }
+    if (needle_len > this->m_bufferlength - from) {
+        return Buffer::NPOS;
+    }
+
+    const size_t found = kernel_find(
+        this->m_bufferstart + from, 
+        this->m_bufferlength - from, 
+        needle, 
+        needle_len
+    );
+    if (found == SIZE_MAX) {
+        return Buffer::NPOS;
+    }
+    return from + found;
 }
 
 //
@@ -867,6 +1887,9 @@ bool Buffer::is_equal(
  *  Return a new buffer which is the result of concatenating all buffer 
  *  instances in array together.
  * 
+ *  @throw BufferException
+ *      Raised if the total length overflowed 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
  *  @param buffers
  *      The buffer instances to concatenate.
  *  @param count
@@ -877,6 +1900,12 @@ bool Buffer::is_equal(
 Buffer Buffer::concat(const Buffer buffers[], const size_t count) {
     size_t datalen = 0U;
     for (size_t i = 0U; i < count; ++i) {
+        if (buffers[i].get_length() > SIZE_MAX - datalen) {
+            throw BufferException(
+                "Length overflowed.", 
+                XAPCORE_BUF_ERROR_OVERFLOW
+            );
+        }
         datalen += buffers[i].get_length();
     }
     
@@ -889,6 +1918,78 @@ Buffer Buffer::concat(const Buffer buffers[], const size_t count) {
     return rst;
 }
 
+/**
+ *  Adopt external memory as a new buffer (without copying).
+ * 
+ *  @note
+ *      The buffer (and its slices) references the memory directly. 
+ *      The release callback is called once the last reference is 
+ *      destroyed (or immediately if 'datalen' is 0, or if failed to 
+ *      allocate the reference counter, before std::bad_alloc is 
+ *      raised).
+ *  @throw std::bad_alloc
+ *      Raised if failed to allocate memory.
+ *  @param data
+ *      The memory (must not be nullptr unless 'datalen' is 0).
+ *  @param datalen
+ *      The length of the memory.
+ *  @param release
+ *      The release callback (nullptr if nothing to release).
+ *  @param context
+ *      The context passed to the release callback.
+ *  @return
+ *      The new buffer.
+ */
+Buffer Buffer::wrap(
+    uint8_t                 *data, 
+    const size_t            datalen, 
+    BufferReleaseCallback   release, 
+    void                    *context
+) {
+    if (release == nullptr) {
+        return Buffer::wrap_unowned(data, datalen);
+    }
+    if (datalen == 0U) {
+        release(data, datalen, context);
+        return Buffer(buffer_empty_space(), 0U);
+    }
+
+    //  The deleter is called if the control block can't be allocated.
+    return Buffer(
+        std::shared_ptr<uint8_t>(
+            data, 
+            BufferReleaseDeleter{release, datalen, context}
+        ), 
+        datalen
+    );
+}
+
+/**
+ *  Reference external memory as a new buffer (without copying or 
+ *  owning it).
+ * 
+ *  @note
+ *      The caller must guarantee that the memory outlives the buffer 
+ *      and all buffers (and slices) that share it.
+ *  @param data
+ *      The memory (must not be nullptr unless 'datalen' is 0).
+ *  @param datalen
+ *      The length of the memory.
+ *  @return
+ *      The new buffer.
+ */
+Buffer Buffer::wrap_unowned(uint8_t *data, const size_t datalen) {
+    if (datalen == 0U) {
+        return Buffer(buffer_empty_space(), 0U);
+    }
+
+    //  Share no ownership, but point to the memory.
+    return Buffer(
+        std::shared_ptr<uint8_t>(std::shared_ptr<uint8_t>(), data), 
+        datalen
+    );
+}
+
 //
 //  Private methods.
 //
@@ -902,7 +2003,7 @@ Buffer Buffer::concat(const Buffer buffers[], const size_t count) {
  *      The length of buffer.
  */
 Buffer::Buffer(std::shared_ptr<uint8_t> buffer, const size_t length) {
-    this->prepare(buffer, 0, length);
+    this->prepare(std::move(buffer), 0, length);
 }
 
 /**
@@ -920,30 +2021,42 @@ Buffer::Buffer(
     const size_t offset,
     const size_t length
 ) {
-    this->prepare(buffer, offset, length);
+    this->prepare(std::move(buffer), offset, length);
+}
+
+/**
+ *  Raise the out-of-range error of check_access() (kept out of line, so 
+ *  that the inlined checks stay small).
+ * 
+ *  @throw BufferException
+ *      Always (XAPCORE_BUF_ERROR_OVERFLOW).
+ */
+void Buffer::raise_overflow() {
+    throw BufferException("Offset overflowed.", XAPCORE_BUF_ERROR_OVERFLOW);
 }
 
 /**
- *  Check if 'offset' or 'length is out of range.
+ *  Check if an array access at 'offset' is out of range.
  * 
  *  @throw BufferException
- *      Raisd if 'offset' or 'length is out of range 
+ *      Raised if 'offset' or 'count' is out of range 
  *      (XAPCORE_BUF_ERROR_OVERFLOW).
  *  @param offset
  *      The offset.
- *  @param length
- *      The length.
+ *  @param count
+ *      The count of elements.
+ *  @param width
+ *      The width of each element.
  */
-void Buffer::check_access(const size_t offset, const size_t length) const {
-    if (length == 0) {
-        return;
-    }
-    if (offset >= this->m_bufferlength) {
-        throw BufferException("Offset overflowed.", XAPCORE_BUF_ERROR_OVERFLOW);
-    }
-    if (offset + length > this->m_bufferlength) {
-        throw BufferException("Offset overflowd.", XAPCORE_BUF_ERROR_OVERFLOW);
+void Buffer::check_array_access(
+    const size_t offset,
+    const size_t count,
+    const size_t width
+) const {
+    if (count > this->m_bufferlength / width) {
+        throw BufferException("Count overflowed.", XAPCORE_BUF_ERROR_OVERFLOW);
     }
+    this->check_access(offset, count * width);
 }
 
 /**
@@ -960,11 +2073,12 @@ void Buffer::prepare(
     std::shared_ptr<uint8_t> buffer,
     const size_t offset,
     const size_t length
-) {
-    this->m_buffer = buffer;
+) noexcept {
     this->m_bufferstart = buffer.get() + offset;
-    this->m_bufferend = this->m_bufferstart + length;
+    this->m_storagelength = offset + length;
     this->m_bufferlength = length;
+    this->m_buffer = std::move(buffer);
+    this->m_cow = false;
 }
 
 /**
@@ -983,6 +2097,18 @@ float Buffer::read_ieee_754_float(
 ) const {
     //  Check access.
     this->check_access(offset, 4U);
+
+#if defined(XAP_CORE_BUFFER_IEEE_754)
+
+    //  Fast path: bit cast from the integer representation.
+    const uint32_t bits = isle ? 
+        endian_read_uint32_le(this->m_bufferstart + offset) : 
+        endian_read_uint32_be(this->m_bufferstart + offset);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+
+#else
     
     static const size_t bytes = 4U;
     static const size_t mantissa_length = 23U;
@@ -1051,6 +2177,8 @@ float Buffer::read_ieee_754_float(
     }
 
     return static_cast<float>(s * m * std::pow(2, e - mantissa_length));
+
+#endif  //  #if defined(XAP_CORE_BUFFER_IEEE_754)
 }
 
 /**
@@ -1070,6 +2198,18 @@ double Buffer::read_ieee_754_double(
     //  Check access.
     this->check_access(offset, 8U);
 
+#if defined(XAP_CORE_BUFFER_IEEE_754)
+
+    //  Fast path: bit cast from the integer representation.
+    const uint64_t bits = isle ? 
+        endian_read_uint64_le(this->m_bufferstart + offset) : 
+        endian_read_uint64_be(this->m_bufferstart + offset);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+
+#else
+
     static const size_t bytes = 8U;
     static const size_t mantissa_length = 52U;
     static const size_t exponent_length = 11U;
@@ -1162,6 +2302,8 @@ double Buffer::read_ieee_754_double(
     }
 
     return s * m * std::pow(2, e - mantissa_length);
+
+#endif  //  #if defined(XAP_CORE_BUFFER_IEEE_754)
 }
 
 /**
@@ -1181,6 +2323,20 @@ void Buffer::write_ieee_754_float(
 ) {
     //  Check access.
     this->check_access(offset, 4U);
+    this->prepare_write();
+
+#if defined(XAP_CORE_BUFFER_IEEE_754)
+
+    //  Fast path: bit cast to the integer representation.
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    if (isle) {
+        endian_write_uint32_le(this->m_bufferstart + offset, bits);
+    } else {
+        endian_write_uint32_be(this->m_bufferstart + offset, bits);
+    }
+
+#else
 
     static const size_t bytes = 4U;
     static const size_t mantissa_length = 23U;
@@ -1267,6 +2423,8 @@ void Buffer::write_ieee_754_float(
         this->m_bufferstart[offset + 0U] |= 
             (s_bits << 7U);
     }
+
+#endif  //  #if defined(XAP_CORE_BUFFER_IEEE_754)
 }
 
 /**
@@ -1286,6 +2444,20 @@ void Buffer::write_ieee_754_double(
 ) {
     //  Check access.
     this->check_access(offset, 8U);
+    this->prepare_write();
+
+#if defined(XAP_CORE_BUFFER_IEEE_754)
+
+    //  Fast path: bit cast to the integer representation.
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    if (isle) {
+        endian_write_uint64_le(this->m_bufferstart + offset, bits);
+    } else {
+        endian_write_uint64_be(this->m_bufferstart + offset, bits);
+    }
+
+#else
 
     static const size_t bytes = 8U;
     static const size_t mantissa_length = 52U;
@@ -1383,20 +2555,229 @@ void Buffer::write_ieee_754_double(
         this->m_bufferstart[offset + 0U] |= 
             (s_bits << 7U);
     }
+
+#endif  //  #if defined(XAP_CORE_BUFFER_IEEE_754)
+}
+
+#if !defined(XAP_CORE_BUFFER_IEEE_754)
+
+//
+//  BufferAccessor private functions.
+//
+//  The portable codec of Buffer is run over an unowned buffer (which never
+//  allocates, detaches or fails the range check).
+//
+
+/**
+ *  Read IEEE 754 single-precision float-point value.
+ * 
+ *  @param pointer
+ *      The pointer to the first byte.
+ *  @param isle
+ *      True if with little-endian.
+ *  @return
+ *      The single-precision float-point value.
+ */
+float BufferAccessor::portable_read_float(
+    const uint8_t   *pointer, 
+    const bool      isle
+) noexcept {
+    const Buffer buffer = 
+        Buffer::wrap_unowned(const_cast<uint8_t*>(pointer), 4U);
+    return isle ? buffer.read_float_le(0U) : buffer.read_float_be(0U);
+}
+
+/**
+ *  Read IEEE 754 double-precision float-point value.
+ * 
+ *  @param pointer
+ *      The pointer to the first byte.
+ *  @param isle
+ *      True if with little-endian.
+ *  @return
+ *      The double-precision float-point value.
+ */
+double BufferAccessor::portable_read_double(
+    const uint8_t   *pointer, 
+    const bool      isle
+) noexcept {
+    const Buffer buffer = 
+        Buffer::wrap_unowned(const_cast<uint8_t*>(pointer), 8U);
+    return isle ? buffer.read_double_le(0U) : buffer.read_double_be(0U);
+}
+
+/**
+ *  Write IEEE 754 single-precision float-point value.
+ * 
+ *  @param pointer
+ *      The pointer to the first byte.
+ *  @param value
+ *      The single-precision float-point value.
+ *  @param isle
+ *      True if with little-endian.
+ */
+void BufferAccessor::portable_write_float(
+    uint8_t         *pointer, 
+    const float     value, 
+    const bool      isle
+) noexcept {
+    Buffer buffer = Buffer::wrap_unowned(pointer, 4U);
+    if (isle) {
+        buffer.write_float_le(value, 0U);
+    } else {
+        buffer.write_float_be(value, 0U);
+    }
+}
+
+/**
+ *  Write IEEE 754 double-precision float-point value.
+ * 
+ *  @param pointer
+ *      The pointer to the first byte.
+ *  @param value
+ *      The double-precision float-point value.
+ *  @param isle
+ *      True if with little-endian.
+ */
+void BufferAccessor::portable_write_double(
+    uint8_t         *pointer, 
+    const double    value, 
+    const bool      isle
+) noexcept {
+    Buffer buffer = Buffer::wrap_unowned(pointer, 8U);
+    if (isle) {
+        buffer.write_double_le(value, 0U);
+    } else {
+        buffer.write_double_be(value, 0U);
+    }
 }
 
+#endif  //  #if !defined(XAP_CORE_BUFFER_IEEE_754)
+
 //
 //  Private functions.
 //
 
 /**
- *  Free buffer space.
+ *  Allocate buffer space.
+ * 
+ *  @throw std::bad_alloc
+ *      Raised if failed to allocate memory.
+ *  @param length
+ *      The length of buffer space.
+ *  @param alignment
+ *      The alignment of buffer space.
+ *  @param allocator
+ *      The allocator.
+ *  @return
+ *      The shared pointer to buffer space.
+ */
+static std::shared_ptr<uint8_t> buffer_allocate_space(
+    const size_t        length,
+    const size_t        alignment,
+    BufferAllocator     &allocator
+) {
+    if (length == 0U) {
+        return buffer_empty_space();
+    }
+
+    BufferAllocator *control = allocator.get_control_allocator();
+    if (control != nullptr) {
+        //  Request the storage with its exact size, the deleter is called 
+        //  if the control block can't be allocated.
+        uint8_t *storage = static_cast<uint8_t*>(
+            allocator.allocate(length, alignment)
+        );
+        XAP_CORE_BUFFER_STATS_ALLOCATE(length);
+        return std::shared_ptr<uint8_t>(
+            storage,
+            BufferStorageDeleter{&allocator, length, alignment},
+            BufferControlAllocator<uint8_t>(control)
+        );
+    }
+
+    uint8_t *storage = nullptr;
+    std::shared_ptr<uint8_t> owner = std::allocate_shared<uint8_t>(
+        BufferStorageAllocator<uint8_t>(&allocator, length, alignment, &storage)
+    );
+
+    //  Share the ownership of the control block, but point to the storage.
+    return std::shared_ptr<uint8_t>(owner, storage);
+}
+
+/**
+ *  Get the buffer space shared by all empty buffers.
+ * 
+ *  @return
+ *      The shared pointer to buffer space (owns nothing).
+ */
+static inline std::shared_ptr<uint8_t> buffer_empty_space() noexcept {
+    return std::shared_ptr<uint8_t>(
+        std::shared_ptr<uint8_t>(), 
+        g_buffer_empty_storage
+    );
+}
+
+/**
+ *  Read an array of integers.
+ * 
+ *  @param src
+ *      The source memory.
+ *  @param dst
+ *      The destination array.
+ *  @param count
+ *      The count of integers.
+ *  @param native
+ *      True if the source byte order matches the host.
+ */
+template<typename T, T (*READER)(const uint8_t*)>
+static void buffer_read_array(
+    const uint8_t   *src,
+    T               *dst,
+    const size_t    count,
+    const bool      native
+) noexcept {
+    if (count == 0U) {
+        return;
+    }
+    if (native) {
+        memcpy(dst, src, count * sizeof(T));
+        return;
+    }
+    for (size_t i = 0U; i < count; ++i) {
+        dst[i] = READER(src + i * sizeof(T));
+    }
+}
+
+/**
+ *  Write an array of integers.
  * 
- *  @param ptr
- *      The pointer to buffer which would be free.
+ *  @param dst
+ *      The destination memory.
+ *  @param src
+ *      The source array.
+ *  @param count
+ *      The count of integers.
+ *  @param native
+ *      True if the destination byte order matches the host.
  */
-static void buffer_free_space(uint8_t *ptr) noexcept {
-    delete[] ptr;
+template<typename T, void (*WRITER)(uint8_t*, const T)>
+static void buffer_write_array(
+    uint8_t         *dst,
+    const T         *src,
+    const size_t    count,
+    const bool      native
+) noexcept {
+    if (count == 0U) {
+        return;
+    }
+    if (native) {
+        memcpy(dst, src, count * sizeof(T));
+        return;
+    }
+    for (size_t i = 0U; i < count; ++i) {
+        WRITER(dst + i * sizeof(T), src[i]);
+    }
 }
 
 }  //  namespace buffer
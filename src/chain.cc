@@ -0,0 +1,730 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+//
+//  Imports.
+//
+#include <xap/core/buffer/chain.h>
+#include <xap/core/buffer/endian.h>
+#include <algorithm>
+#include <string.h>
+#include <utility>
+#include "instrument.h"
+
+namespace xap {
+namespace core {
+namespace buffer {
+
+//
+//  BufferChain constructor.
+//
+
+/**
+ *  Construct an empty chain.
+ */
+BufferChain::BufferChain() noexcept :
+    m_segments(),
+    m_length(0U)
+{
+    //  Do nothing.
+}
+
+/**
+ *  Construct a chain with one buffer.
+ *
+ *  @param buffer
+ *      The buffer.
+ */
+BufferChain::BufferChain(const Buffer &buffer) :
+    m_segments(),
+    m_length(0U)
+{
+    this->append(buffer);
+}
+
+//
+//  BufferChain public methods.
+//
+
+/**
+ *  Append a buffer to the chain back (without copying).
+ *
+ *  @throw BufferException
+ *      Raised if the chain length overflowed (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param buffer
+ *      The buffer.
+ */
+void BufferChain::append(const Buffer &buffer) {
+    this->append(Buffer(buffer));
+}
+
+/**
+ *  Append a buffer to the chain back (without copying).
+ *
+ *  @throw BufferException
+ *      Raised if the chain length overflowed (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param buffer
+ *      The buffer (would be moved into chain).
+ */
+void BufferChain::append(Buffer &&buffer) {
+    const size_t length = buffer.get_length();
+    if (length == 0U) {
+        return;
+    }
+    if (length > SIZE_MAX - this->m_length) {
+        throw BufferException("Length overflowed.", XAPCORE_BUF_ERROR_OVERFLOW);
+    }
+
+    this->m_segments.push_back(std::move(buffer));
+    this->m_length += length;
+}
+
+/**
+ *  Append all segments of another chain to the chain back (without
+ *  copying).
+ *
+ *  @throw BufferException
+ *      Raised if the chain length overflowed (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param chain
+ *      The chain.
+ */
+void BufferChain::append(const BufferChain &chain) {
+    if (&chain == this) {
+        //  Appending to itself, iterate over a snapshot.
+        const BufferChain copied(chain);
+        this->append(copied);
+        return;
+    }
+
+    //  The length is updated per segment, so that it stays consistent if
+    //  failed partway.
+    for (const Buffer &segment: chain.m_segments) {
+        this->append(segment);
+    }
+}
+
+/**
+ *  Prepend a buffer to the chain front (without copying).
+ *
+ *  @throw BufferException
+ *      Raised if the chain length overflowed (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param buffer
+ *      The buffer.
+ */
+void BufferChain::prepend(const Buffer &buffer) {
+    this->prepend(Buffer(buffer));
+}
+
+/**
+ *  Prepend a buffer to the chain front (without copying).
+ *
+ *  @throw BufferException
+ *      Raised if the chain length overflowed (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param buffer
+ *      The buffer (would be moved into chain).
+ */
+void BufferChain::prepend(Buffer &&buffer) {
+    const size_t length = buffer.get_length();
+    if (length == 0U) {
+        return;
+    }
+    if (length > SIZE_MAX - this->m_length) {
+        throw BufferException("Length overflowed.", XAPCORE_BUF_ERROR_OVERFLOW);
+    }
+
+    this->m_segments.push_front(std::move(buffer));
+    this->m_length += length;
+}
+
+/**
+ *  Remove all segments.
+ */
+void BufferChain::clear() noexcept {
+    this->m_segments.clear();
+    this->m_length = 0U;
+}
+
+/**
+ *  Get the total length of all segments.
+ *
+ *  @return
+ *      The length.
+ */
+size_t BufferChain::get_length() const noexcept {
+    return this->m_length;
+}
+
+/**
+ *  Get the count of segments.
+ *
+ *  @return
+ *      The count.
+ */
+size_t BufferChain::get_segment_count() const noexcept {
+    return this->m_segments.size();
+}
+
+/**
+ *  Get a segment.
+ *
+ *  @throw BufferException
+ *      Raised if 'index' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param index
+ *      The position of the segment.
+ *  @return
+ *      The segment.
+ */
+const Buffer& BufferChain::get_segment(const size_t index) const {
+    if (index >= this->m_segments.size()) {
+        throw BufferException("Out of range.", XAPCORE_BUF_ERROR_OVERFLOW);
+    }
+    return this->m_segments[index];
+}
+
+/**
+ *  Get the segments (for vectored I/O, without copying).
+ *
+ *  @note
+ *      The segments are valid until the chain is modified.
+ *  @param segments
+ *      The segments array to fill.
+ *  @param max_segments
+ *      The capacity of segments array.
+ *  @return
+ *      The count of segments filled.
+ */
+size_t BufferChain::get_segments(
+    BufferSegment   segments[],
+    const size_t    max_segments
+) const noexcept {
+    const size_t count = std::min(max_segments, this->m_segments.size());
+    for (size_t i = 0U; i < count; ++i) {
+        segments[i].pointer = this->m_segments[i].get_pointer();
+        segments[i].length = this->m_segments[i].get_length();
+    }
+    return count;
+}
+
+/**
+ *  Return a new chain that references a range of the chain (without
+ *  copying).
+ *
+ *  @throw BufferException
+ *      Raised if 'offset' or 'length' is out of range
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset.
+ *  @param length
+ *      The length.
+ *  @return
+ *      The new chain.
+ */
+BufferChain BufferChain::slice(const size_t offset, const size_t length) const {
+    if (offset > this->m_length || length > this->m_length - offset) {
+        throw BufferException("Out of range.", XAPCORE_BUF_ERROR_OVERFLOW);
+    }
+
+    BufferChain out;
+    if (length == 0U) {
+        return out;
+    }
+
+    size_t inner;
+    size_t index = this->locate(offset, &inner);
+    size_t needed = length;
+    while (needed != 0U) {
+        const Buffer &segment = this->m_segments[index];
+        const size_t take = std::min(segment.get_length() - inner, needed);
+        out.append(segment.slice(inner, take));
+        needed -= take;
+        inner = 0U;
+        ++index;
+    }
+    return out;
+}
+
+/**
+ *  Coalesce all segments into one buffer.
+ *
+ *  @note
+ *      No byte is copied if the chain has at most one segment.
+ *  @return
+ *      The buffer.
+ */
+Buffer BufferChain::flatten() const {
+    if (this->m_segments.empty()) {
+        return Buffer(0U);
+    }
+    if (this->m_segments.size() == 1U) {
+        return this->m_segments.front();
+    }
+
+    Buffer out(this->m_length, true);
+    this->copy(out);
+    return out;
+}
+
+/**
+ *  Copy bytes of the chain to a buffer.
+ *
+ *  @throw BufferException
+ *      Raised if the offset of destination buffer is out of range
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param destination
+ *      The buffer to copy into.
+ *  @param destination_offset
+ *      The offset of destination buffer.
+ *  @return
+ *      The number of bytes copied.
+ */
+size_t BufferChain::copy(
+    Buffer          &destination,
+    const size_t    destination_offset
+) const {
+    const size_t dst_len = destination.get_length();
+    if (destination_offset > dst_len) {
+        throw BufferException(
+            "Invalid destination offset.",
+            XAPCORE_BUF_ERROR_OVERFLOW
+        );
+    }
+
+    uint8_t *dst_ptr = destination.get_pointer() + destination_offset;
+    const size_t total = std::min(this->m_length, dst_len - destination_offset);
+    size_t copied = 0U;
+    for (size_t i = 0U; copied < total; ++i) {
+        const Buffer &segment = this->m_segments[i];
+        const size_t copy_len = std::min(segment.get_length(), total - copied);
+        memcpy(dst_ptr + copied, segment.get_pointer(), copy_len);
+        copied += copy_len;
+    }
+    XAP_CORE_BUFFER_STATS_COPY(copied);
+    return copied;
+}
+
+/**
+ *  Read an unsigned 8-bit integer.
+ *
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset.
+ *  @return
+ *      The unsigned 8-bit integer.
+ */
+uint8_t BufferChain::read_uint8(const size_t offset) const {
+    uint8_t scratch[1U];
+    return *(this->peek_bytes(offset, 1U, scratch));
+}
+
+/**
+ *  Read an unsigned 16-bit integer with big-endian.
+ *
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset.
+ *  @return
+ *      The unsigned 16-bit integer.
+ */
+uint16_t BufferChain::read_uint16_be(const size_t offset) const {
+    uint8_t scratch[2U];
+    return endian_read_uint16_be(this->peek_bytes(offset, 2U, scratch));
+}
+
+/**
+ *  Read an unsigned 16-bit integer with little-endian.
+ *
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset.
+ *  @return
+ *      The unsigned 16-bit integer.
+ */
+uint16_t BufferChain::read_uint16_le(const size_t offset) const {
+    uint8_t scratch[2U];
+    return endian_read_uint16_le(this->peek_bytes(offset, 2U, scratch));
+}
+
+/**
+ *  Read an unsigned 32-bit integer with big-endian.
+ *
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset.
+ *  @return
+ *      The unsigned 32-bit integer.
+ */
+uint32_t BufferChain::read_uint32_be(const size_t offset) const {
+    uint8_t scratch[4U];
+    return endian_read_uint32_be(this->peek_bytes(offset, 4U, scratch));
+}
+
+/**
+ *  Read an unsigned 32-bit integer with little-endian.
+ *
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset.
+ *  @return
+ *      The unsigned 32-bit integer.
+ */
+uint32_t BufferChain::read_uint32_le(const size_t offset) const {
+    uint8_t scratch[4U];
+    return endian_read_uint32_le(this->peek_bytes(offset, 4U, scratch));
+}
+
+#if defined(UINT64_MAX)
+
+/**
+ *  Read an unsigned 64-bit integer with big-endian.
+ *
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset.
+ *  @return
+ *      The unsigned 64-bit integer.
+ */
+uint64_t BufferChain::read_uint64_be(const size_t offset) const {
+    uint8_t scratch[8U];
+    return endian_read_uint64_be(this->peek_bytes(offset, 8U, scratch));
+}
+
+/**
+ *  Read an unsigned 64-bit integer with little-endian.
+ *
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset.
+ *  @return
+ *      The unsigned 64-bit integer.
+ */
+uint64_t BufferChain::read_uint64_le(const size_t offset) const {
+    uint8_t scratch[8U];
+    return endian_read_uint64_le(this->peek_bytes(offset, 8U, scratch));
+}
+
+#endif  //  #if defined(UINT64_MAX)
+
+//
+//  BufferChain private methods.
+//
+
+/**
+ *  Locate the segment which contains a byte.
+ *
+ *  @param offset
+ *      The offset of the byte (must be less than the length).
+ *  @param inner
+ *      The pointer to receive the offset inside the segment.
+ *  @return
+ *      The position of the segment.
+ */
+size_t BufferChain::locate(const size_t offset, size_t *inner) const noexcept {
+    size_t index = 0U;
+    size_t skip = offset;
+    while (skip >= this->m_segments[index].get_length()) {
+        skip -= this->m_segments[index].get_length();
+        ++index;
+    }
+    *inner = skip;
+    return index;
+}
+
+/**
+ *  Get the pointer to bytes in chain.
+ *
+ *  @throw BufferException
+ *      Raised if 'offset' or 'size' is out of range
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset.
+ *  @param size
+ *      The count of bytes (must not be 0).
+ *  @param scratch
+ *      The memory (at least 'size' bytes) where to copy the bytes if
+ *      they span multiple segments.
+ *  @return
+ *      The pointer to the bytes (either inside a segment or 'scratch').
+ */
+const uint8_t* BufferChain::peek_bytes(
+    const size_t    offset,
+    const size_t    size,
+    uint8_t         *scratch
+) const {
+    if (offset >= this->m_length || size > this->m_length - offset) {
+        throw BufferException("Out of range.", XAPCORE_BUF_ERROR_OVERFLOW);
+    }
+
+    size_t inner;
+    size_t index = this->locate(offset, &inner);
+    if (this->m_segments[index].get_length() - inner >= size) {
+        //  Contiguous.
+        return this->m_segments[index].get_pointer() + inner;
+    }
+
+    //  Spans multiple segments, copy them to the scratch.
+    size_t copied = 0U;
+    while (copied < size) {
+        const Buffer &segment = this->m_segments[index];
+        const size_t copy_len = std::min(
+            segment.get_length() - inner,
+            size - copied
+        );
+        memcpy(scratch + copied, segment.get_pointer() + inner, copy_len);
+        copied += copy_len;
+        inner = 0U;
+        ++index;
+    }
+    return scratch;
+}
+
+//
+//  BufferChainFetcher constructor.
+//
+
+/**
+ *  Construct the object.
+ *
+ *  @param chain
+ *      The chain which would be fetched (must outlive the fetcher, and must 
+ *      not be changed while being fetched).
+ */
+BufferChainFetcher::BufferChainFetcher(const BufferChain &chain) noexcept :
+    m_chain(&chain),
+    m_index(0U),
+    m_inner(0U),
+    m_position(0U)
+{
+    //  Do nothing.
+}
+
+//
+//  BufferChainFetcher public methods.
+//
+
+/**
+ *  Check whether the fetcher is ended.
+ *
+ *  @return
+ *      True if so.
+ */
+bool BufferChainFetcher::is_end() const noexcept {
+    return this->m_position == this->m_chain->m_length;
+}
+
+/**
+ *  Reset the fetcher. Move the cursor to the begin position.
+ */
+void BufferChainFetcher::reset() noexcept {
+    this->m_index = 0U;
+    this->m_inner = 0U;
+    this->m_position = 0U;
+}
+
+/**
+ *  Fetch one byte.
+ *
+ *  @throw BufferException
+ *      Raised if the fetcher was ended (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The byte.
+ */
+uint8_t BufferChainFetcher::fetch() {
+    if (this->is_end()) {
+        throw BufferException(
+            "Reached the end of the buffer.",
+            XAPCORE_BUF_ERROR_OVERFLOW
+        );
+    }
+
+    const uint8_t value =
+        this->m_chain->m_segments[this->m_index].get_pointer()[this->m_inner];
+    this->advance(1U);
+    return value;
+}
+
+/**
+ *  Fetch bytes to buffer.
+ *
+ *  @note
+ *      Nothing would be done if destination size is zero.
+ *  @throw BufferException
+ *      Raised if the fetcher was ended (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param destination
+ *      The destination buffer.
+ *  @return
+ *      The number of bytes fetched.
+ */
+size_t BufferChainFetcher::fetch_to(Buffer &destination) {
+    return this->fetch_to(destination, 0U);
+}
+
+/**
+ *  Fetch bytes to buffer.
+ *
+ *  @note
+ *      Nothing would be done if destination size is zero.
+ *  @throw BufferException
+ *      Raised if the fetcher was ended, or the offset of destination
+ *      buffer is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param destination
+ *      The destination buffer.
+ *  @param destination_offset
+ *      The offset of destination buffer.
+ *  @return
+ *      The number of bytes fetched.
+ */
+size_t BufferChainFetcher::fetch_to(
+    Buffer          &destination,
+    const size_t    destination_offset
+) {
+    const size_t dst_len = destination.get_length();
+    if (dst_len == 0U) {
+        return 0U;
+    }
+    if (this->is_end()) {
+        throw BufferException(
+            "Reached the end of the buffer.",
+            XAPCORE_BUF_ERROR_OVERFLOW
+        );
+    }
+    if (destination_offset > dst_len) {
+        throw BufferException(
+            "Invalid destination offset.",
+            XAPCORE_BUF_ERROR_OVERFLOW
+        );
+    }
+
+    uint8_t *dst_ptr = destination.get_pointer() + destination_offset;
+    const size_t total = std::min(
+        this->get_remaining_size(),
+        dst_len - destination_offset
+    );
+    size_t copied = 0U;
+    while (copied < total) {
+        const Buffer &segment = this->m_chain->m_segments[this->m_index];
+        const size_t copy_len = std::min(
+            segment.get_length() - this->m_inner,
+            total - copied
+        );
+        memcpy(
+            dst_ptr + copied,
+            segment.get_pointer() + this->m_inner,
+            copy_len
+        );
+        copied += copy_len;
+        this->advance(copy_len);
+    }
+    XAP_CORE_BUFFER_STATS_COPY(copied);
+    return copied;
+}
+
+/**
+ *  Fetch all bytes in chain.
+ *
+ *  @note
+ *      Return zero-size buffer if fetcher is ended.
+ *  @return
+ *      The destination buffer.
+ */
+Buffer BufferChainFetcher::fetch_all() {
+    return this->fetch_bytes(this->get_remaining_size());
+}
+
+/**
+ *  Fetch bytes in chain.
+ *
+ *  @note
+ *      No byte is copied if the bytes are inside one segment.
+ *  @throw BufferException
+ *      Parameter 'count' was out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param count
+ *      The count of bytes would be fetched.
+ *  @return
+ *      The destination buffer.
+ */
+Buffer BufferChainFetcher::fetch_bytes(const size_t count) {
+    if (count == 0U) {
+        return Buffer(0U);
+    }
+    if (count > this->get_remaining_size()) {
+        throw BufferException("Out of range.", XAPCORE_BUF_ERROR_OVERFLOW);
+    }
+
+    const Buffer &segment = this->m_chain->m_segments[this->m_index];
+    if (segment.get_length() - this->m_inner >= count) {
+        Buffer out = segment.slice(this->m_inner, count);
+        this->advance(count);
+        return out;
+    }
+
+    //  Spans multiple segments, coalesce them.
+    Buffer out(count, true);
+    this->fetch_to(out);
+    return out;
+}
+
+/**
+ *  Skip bytes.
+ *
+ *  @throw BufferException
+ *      Raised if parameter 'count' was out of range
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param count
+ *      The count of bytes would be skiped.
+ */
+void BufferChainFetcher::skip(const size_t count) {
+    if (count > this->get_remaining_size()) {
+        throw BufferException("Out of range.", XAPCORE_BUF_ERROR_OVERFLOW);
+    }
+    this->advance(count);
+}
+
+/**
+ *  Get the remaining size.
+ *
+ *  @return
+ *      The remaining size.
+ */
+size_t BufferChainFetcher::get_remaining_size() const noexcept {
+    return this->m_chain->m_length - this->m_position;
+}
+
+//
+//  BufferChainFetcher private methods.
+//
+
+/**
+ *  Move the cursor forward (inside the remaining bytes).
+ *
+ *  @param count
+ *      The count of bytes.
+ */
+void BufferChainFetcher::advance(size_t count) noexcept {
+    this->m_position += count;
+    while (count != 0U) {
+        const size_t segment_remaining =
+            this->m_chain->m_segments[this->m_index].get_length() -
+            this->m_inner;
+        if (count < segment_remaining) {
+            this->m_inner += count;
+            return;
+        }
+        count -= segment_remaining;
+        ++this->m_index;
+        this->m_inner = 0U;
+    }
+}
+
+}  //  namespace buffer
+}  //  namespace core
+}  //  namespace xap
@@ -0,0 +1,877 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+//
+//  Imports.
+//
+#include <xap/core/buffer/build.h>
+#include <xap/core/buffer/checksum.h>
+#include <xap/core/buffer/endian.h>
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+#if defined(XAP_CORE_BUFFER_SIMD_SSE42)
+#include <nmmintrin.h>
+#endif
+#if defined(XAP_CORE_BUFFER_SIMD_ARM_CRC32)
+#include <arm_acle.h>
+#endif
+
+namespace xap {
+namespace core {
+namespace buffer {
+
+//
+//  Constants.
+//
+
+//  The count of queue segments exported without heap allocation.
+static const size_t CHECKSUM_LOCAL_SEGMENTS = 16U;
+
+//  The modulus of Adler-32.
+static const uint32_t CHECKSUM_ADLER_MOD = 65521U;
+
+//  The maximum count of bytes before the Adler-32 sums must be reduced (so
+//  that the sums never overflow 32 bits).
+static const size_t CHECKSUM_ADLER_NMAX = 5552U;
+
+#if defined(UINT64_MAX)
+
+//  The primes of XXH64.
+static const uint64_t CHECKSUM_XXH64_PRIME1 = 11400714785074694791ULL;
+static const uint64_t CHECKSUM_XXH64_PRIME2 = 14029467366897019727ULL;
+static const uint64_t CHECKSUM_XXH64_PRIME3 = 1609587929392839161ULL;
+static const uint64_t CHECKSUM_XXH64_PRIME4 = 9650029242287828579ULL;
+static const uint64_t CHECKSUM_XXH64_PRIME5 = 2870177450012600261ULL;
+
+#endif  //  #if defined(UINT64_MAX)
+
+//
+//  Private structures.
+//
+
+//
+//  Slicing-by-8 lookup table of a (reflected) CRC-32 polynomial.
+//
+struct ChecksumCrcTable {
+    uint32_t        entries[8][256];
+};
+
+//
+//  Private functions.
+//
+
+/**
+ *  Build the slicing-by-8 lookup table of a (reflected) CRC-32 polynomial.
+ *
+ *  @param polynomial
+ *      The reflected polynomial.
+ *  @return
+ *      The table.
+ */
+static constexpr ChecksumCrcTable checksum_make_crc_table(
+    const uint32_t polynomial
+) noexcept {
+    ChecksumCrcTable table = {};
+    for (uint32_t i = 0U; i < 256U; ++i) {
+        uint32_t crc = i;
+        for (size_t bit = 0U; bit < 8U; ++bit) {
+            crc = (crc & 1U) != 0U ? (crc >> 1U) ^ polynomial : (crc >> 1U);
+        }
+        table.entries[0][i] = crc;
+    }
+    for (size_t k = 1U; k < 8U; ++k) {
+        for (size_t i = 0U; i < 256U; ++i) {
+            const uint32_t previous = table.entries[k - 1U][i];
+            table.entries[k][i] =
+                (previous >> 8U) ^ table.entries[0][previous & 0xFFU];
+        }
+    }
+    return table;
+}
+
+#if !defined(XAP_CORE_BUFFER_SIMD_ARM_CRC32)
+
+//  The lookup table of CRC-32 (ISO-HDLC).
+static constexpr ChecksumCrcTable CHECKSUM_CRC32_TABLE =
+    checksum_make_crc_table(0xEDB88320U);
+
+#endif
+
+#if !defined(XAP_CORE_BUFFER_SIMD_SSE42) && \
+    !defined(XAP_CORE_BUFFER_SIMD_ARM_CRC32)
+
+//  The lookup table of CRC-32C (Castagnoli).
+static constexpr ChecksumCrcTable CHECKSUM_CRC32C_TABLE =
+    checksum_make_crc_table(0x82F63B78U);
+
+#endif
+
+/**
+ *  Update a (reflected, not inverted) CRC-32 register with the
+ *  slicing-by-8 table.
+ *
+ *  @param table
+ *      The lookup table of the polynomial.
+ *  @param crc
+ *      The register.
+ *  @param data
+ *      The bytes.
+ *  @param datalen
+ *      The count of bytes.
+ *  @return
+ *      The updated register.
+ */
+static inline uint32_t checksum_crc_update_table(
+    const ChecksumCrcTable  &table,
+    uint32_t                crc,
+    const uint8_t           *data,
+    size_t                  datalen
+) noexcept {
+    while (datalen >= 8U) {
+        const uint32_t low = crc ^ endian_read_uint32_le(data);
+        const uint32_t high = endian_read_uint32_le(data + 4U);
+        crc = table.entries[7][low & 0xFFU] ^
+              table.entries[6][(low >> 8U) & 0xFFU] ^
+              table.entries[5][(low >> 16U) & 0xFFU] ^
+              table.entries[4][low >> 24U] ^
+              table.entries[3][high & 0xFFU] ^
+              table.entries[2][(high >> 8U) & 0xFFU] ^
+              table.entries[1][(high >> 16U) & 0xFFU] ^
+              table.entries[0][high >> 24U];
+        data += 8U;
+        datalen -= 8U;
+    }
+    while (datalen != 0U) {
+        crc = table.entries[0][(crc ^ *data) & 0xFFU] ^ (crc >> 8U);
+        ++data;
+        --datalen;
+    }
+    return crc;
+}
+
+/**
+ *  Update a (reflected, not inverted) CRC-32 register.
+ *
+ *  @param crc
+ *      The register.
+ *  @param data
+ *      The bytes.
+ *  @param datalen
+ *      The count of bytes.
+ *  @return
+ *      The updated register.
+ */
+static uint32_t checksum_crc32_update(
+    uint32_t        crc,
+    const uint8_t   *data,
+    size_t          datalen
+) noexcept {
+#if defined(XAP_CORE_BUFFER_SIMD_ARM_CRC32)
+    while (datalen >= 8U) {
+        crc = __crc32d(crc, endian_read_uint64_le(data));
+        data += 8U;
+        datalen -= 8U;
+    }
+    while (datalen != 0U) {
+        crc = __crc32b(crc, *data);
+        ++data;
+        --datalen;
+    }
+    return crc;
+#else
+    return checksum_crc_update_table(CHECKSUM_CRC32_TABLE, crc, data, datalen);
+#endif
+}
+
+/**
+ *  Update a (reflected, not inverted) CRC-32C register.
+ *
+ *  @param crc
+ *      The register.
+ *  @param data
+ *      The bytes.
+ *  @param datalen
+ *      The count of bytes.
+ *  @return
+ *      The updated register.
+ */
+static uint32_t checksum_crc32c_update(
+    uint32_t        crc,
+    const uint8_t   *data,
+    size_t          datalen
+) noexcept {
+#if defined(XAP_CORE_BUFFER_SIMD_SSE42)
+#if ARCH_CPU_64_BITS
+    uint64_t crc64 = crc;
+    while (datalen >= 8U) {
+        uint64_t word;
+        memcpy(&word, data, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+        data += 8U;
+        datalen -= 8U;
+    }
+    crc = static_cast<uint32_t>(crc64);
+#endif
+    while (datalen >= 4U) {
+        uint32_t word;
+        memcpy(&word, data, sizeof(word));
+        crc = _mm_crc32_u32(crc, word);
+        data += 4U;
+        datalen -= 4U;
+    }
+    while (datalen != 0U) {
+        crc = _mm_crc32_u8(crc, *data);
+        ++data;
+        --datalen;
+    }
+    return crc;
+#elif defined(XAP_CORE_BUFFER_SIMD_ARM_CRC32)
+    while (datalen >= 8U) {
+        crc = __crc32cd(crc, endian_read_uint64_le(data));
+        data += 8U;
+        datalen -= 8U;
+    }
+    while (datalen != 0U) {
+        crc = __crc32cb(crc, *data);
+        ++data;
+        --datalen;
+    }
+    return crc;
+#else
+    return checksum_crc_update_table(
+        CHECKSUM_CRC32C_TABLE,
+        crc,
+        data,
+        datalen
+    );
+#endif
+}
+
+/**
+ *  Update a checksum with the bytes of a chain.
+ *
+ *  @param checksum
+ *      The checksum.
+ *  @param chain
+ *      The chain.
+ */
+template<class T>
+static void checksum_update_chain(
+    T                   &checksum,
+    const BufferChain   &chain
+) noexcept {
+    const size_t count = chain.get_segment_count();
+    for (size_t i = 0U; i < count; ++i) {
+        checksum.update(chain.get_segment(i));
+    }
+}
+
+/**
+ *  Update a checksum with the remaining bytes of a queue.
+ *
+ *  @throw std::bad_alloc
+ *      Raised if failed to allocate memory.
+ *  @param checksum
+ *      The checksum.
+ *  @param queue
+ *      The queue.
+ */
+template<class T>
+static void checksum_update_queue(T &checksum, const BufferQueue &queue) {
+    BufferSegment local[CHECKSUM_LOCAL_SEGMENTS];
+    std::vector<BufferSegment> allocated;
+    BufferSegment *segments = local;
+    size_t count = queue.get_segment_count();
+    if (count > CHECKSUM_LOCAL_SEGMENTS) {
+        allocated.resize(count);
+        segments = allocated.data();
+    }
+    count = queue.get_segments(segments, count);
+    for (size_t i = 0U; i < count; ++i) {
+        checksum.update(segments[i].pointer, segments[i].length);
+    }
+}
+
+#if defined(UINT64_MAX)
+
+/**
+ *  Rotate a 64-bit integer left.
+ *
+ *  @param value
+ *      The integer.
+ *  @param bits
+ *      The count of bits (1 to 63).
+ *  @return
+ *      The rotated integer.
+ */
+static inline uint64_t checksum_rotl64(
+    const uint64_t  value,
+    const unsigned  bits
+) noexcept {
+    return (value << bits) | (value >> (64U - bits));
+}
+
+/**
+ *  Mix a 64-bit lane into an XXH64 accumulator.
+ *
+ *  @param accumulator
+ *      The accumulator.
+ *  @param lane
+ *      The lane.
+ *  @return
+ *      The updated accumulator.
+ */
+static inline uint64_t checksum_xxh64_round(
+    uint64_t        accumulator,
+    const uint64_t  lane
+) noexcept {
+    accumulator += lane * CHECKSUM_XXH64_PRIME2;
+    accumulator = checksum_rotl64(accumulator, 31U);
+    return accumulator * CHECKSUM_XXH64_PRIME1;
+}
+
+/**
+ *  Merge an XXH64 accumulator into the hash.
+ *
+ *  @param hash
+ *      The hash.
+ *  @param accumulator
+ *      The accumulator.
+ *  @return
+ *      The updated hash.
+ */
+static inline uint64_t checksum_xxh64_merge(
+    uint64_t        hash,
+    const uint64_t  accumulator
+) noexcept {
+    hash ^= checksum_xxh64_round(0U, accumulator);
+    return hash * CHECKSUM_XXH64_PRIME1 + CHECKSUM_XXH64_PRIME4;
+}
+
+/**
+ *  Mix a 32-byte stripe into the XXH64 accumulators.
+ *
+ *  @param accumulators
+ *      The accumulators.
+ *  @param stripe
+ *      The stripe.
+ */
+static inline void checksum_xxh64_stripe(
+    uint64_t        accumulators[4],
+    const uint8_t   *stripe
+) noexcept {
+    for (size_t i = 0U; i < 4U; ++i) {
+        accumulators[i] = checksum_xxh64_round(
+            accumulators[i],
+            endian_read_uint64_le(stripe + i * 8U)
+        );
+    }
+}
+
+#endif  //  #if defined(UINT64_MAX)
+
+//
+//  BufferCrc32 constructor.
+//
+
+/**
+ *  Construct the object.
+ */
+BufferCrc32::BufferCrc32() noexcept : m_state(0xFFFFFFFFU) {}
+
+//
+//  BufferCrc32 public methods.
+//
+
+/**
+ *  Update the checksum with bytes.
+ *
+ *  @param data
+ *      The bytes.
+ *  @param datalen
+ *      The count of bytes.
+ */
+void BufferCrc32::update(const uint8_t *data, const size_t datalen) noexcept {
+    this->m_state = checksum_crc32_update(this->m_state, data, datalen);
+}
+
+/**
+ *  Update the checksum with the bytes of a buffer.
+ *
+ *  @param buffer
+ *      The buffer.
+ */
+void BufferCrc32::update(const Buffer &buffer) noexcept {
+    this->update(buffer.get_pointer(), buffer.get_length());
+}
+
+/**
+ *  Update the checksum with the bytes of a chain (without flattening).
+ *
+ *  @param chain
+ *      The chain.
+ */
+void BufferCrc32::update(const BufferChain &chain) noexcept {
+    checksum_update_chain(*this, chain);
+}
+
+/**
+ *  Update the checksum with the remaining bytes of a queue (without
+ *  coalescing or consuming).
+ *
+ *  @throw std::bad_alloc
+ *      Raised if failed to allocate memory.
+ *  @param queue
+ *      The queue.
+ */
+void BufferCrc32::update(const BufferQueue &queue) {
+    checksum_update_queue(*this, queue);
+}
+
+/**
+ *  Get the checksum of the bytes so far.
+ *
+ *  @return
+ *      The checksum.
+ */
+uint32_t BufferCrc32::get_value() const noexcept {
+    return ~(this->m_state);
+}
+
+/**
+ *  Reset the checksum (as if no byte was updated).
+ */
+void BufferCrc32::reset() noexcept {
+    this->m_state = 0xFFFFFFFFU;
+}
+
+//
+//  BufferCrc32 public functions.
+//
+
+/**
+ *  Compute the checksum of the bytes of a buffer.
+ *
+ *  @param buffer
+ *      The buffer.
+ *  @return
+ *      The checksum.
+ */
+uint32_t BufferCrc32::compute(const Buffer &buffer) noexcept {
+    BufferCrc32 checksum;
+    checksum.update(buffer);
+    return checksum.get_value();
+}
+
+//
+//  BufferCrc32c constructor.
+//
+
+/**
+ *  Construct the object.
+ */
+BufferCrc32c::BufferCrc32c() noexcept : m_state(0xFFFFFFFFU) {}
+
+//
+//  BufferCrc32c public methods.
+//
+
+/**
+ *  Update the checksum with bytes.
+ *
+ *  @param data
+ *      The bytes.
+ *  @param datalen
+ *      The count of bytes.
+ */
+void BufferCrc32c::update(
+    const uint8_t   *data,
+    const size_t    datalen
+) noexcept {
+    this->m_state = checksum_crc32c_update(this->m_state, data, datalen);
+}
+
+/**
+ *  Update the checksum with the bytes of a buffer.
+ *
+ *  @param buffer
+ *      The buffer.
+ */
+void BufferCrc32c::update(const Buffer &buffer) noexcept {
+    this->update(buffer.get_pointer(), buffer.get_length());
+}
+
+/**
+ *  Update the checksum with the bytes of a chain (without flattening).
+ *
+ *  @param chain
+ *      The chain.
+ */
+void BufferCrc32c::update(const BufferChain &chain) noexcept {
+    checksum_update_chain(*this, chain);
+}
+
+/**
+ *  Update the checksum with the remaining bytes of a queue (without
+ *  coalescing or consuming).
+ *
+ *  @throw std::bad_alloc
+ *      Raised if failed to allocate memory.
+ *  @param queue
+ *      The queue.
+ */
+void BufferCrc32c::update(const BufferQueue &queue) {
+    checksum_update_queue(*this, queue);
+}
+
+/**
+ *  Get the checksum of the bytes so far.
+ *
+ *  @return
+ *      The checksum.
+ */
+uint32_t BufferCrc32c::get_value() const noexcept {
+    return ~(this->m_state);
+}
+
+/**
+ *  Reset the checksum (as if no byte was updated).
+ */
+void BufferCrc32c::reset() noexcept {
+    this->m_state = 0xFFFFFFFFU;
+}
+
+//
+//  BufferCrc32c public functions.
+//
+
+/**
+ *  Compute the checksum of the bytes of a buffer.
+ *
+ *  @param buffer
+ *      The buffer.
+ *  @return
+ *      The checksum.
+ */
+uint32_t BufferCrc32c::compute(const Buffer &buffer) noexcept {
+    BufferCrc32c checksum;
+    checksum.update(buffer);
+    return checksum.get_value();
+}
+
+//
+//  BufferAdler32 constructor.
+//
+
+/**
+ *  Construct the object.
+ */
+BufferAdler32::BufferAdler32() noexcept : m_a(1U), m_b(0U) {}
+
+//
+//  BufferAdler32 public methods.
+//
+
+/**
+ *  Update the checksum with bytes.
+ *
+ *  @param data
+ *      The bytes.
+ *  @param datalen
+ *      The count of bytes.
+ */
+void BufferAdler32::update(
+    const uint8_t   *data,
+    const size_t    datalen
+) noexcept {
+    uint32_t a = this->m_a;
+    uint32_t b = this->m_b;
+    size_t remaining = datalen;
+    while (remaining != 0U) {
+        const size_t block = std::min(remaining, CHECKSUM_ADLER_NMAX);
+        for (size_t i = 0U; i < block; ++i) {
+            a += data[i];
+            b += a;
+        }
+        a %= CHECKSUM_ADLER_MOD;
+        b %= CHECKSUM_ADLER_MOD;
+        data += block;
+        remaining -= block;
+    }
+    this->m_a = a;
+    this->m_b = b;
+}
+
+/**
+ *  Update the checksum with the bytes of a buffer.
+ *
+ *  @param buffer
+ *      The buffer.
+ */
+void BufferAdler32::update(const Buffer &buffer) noexcept {
+    this->update(buffer.get_pointer(), buffer.get_length());
+}
+
+/**
+ *  Update the checksum with the bytes of a chain (without flattening).
+ *
+ *  @param chain
+ *      The chain.
+ */
+void BufferAdler32::update(const BufferChain &chain) noexcept {
+    checksum_update_chain(*this, chain);
+}
+
+/**
+ *  Update the checksum with the remaining bytes of a queue (without
+ *  coalescing or consuming).
+ *
+ *  @throw std::bad_alloc
+ *      Raised if failed to allocate memory.
+ *  @param queue
+ *      The queue.
+ */
+void BufferAdler32::update(const BufferQueue &queue) {
+    checksum_update_queue(*this, queue);
+}
+
+/**
+ *  Get the checksum of the bytes so far.
+ *
+ *  @return
+ *      The checksum.
+ */
+uint32_t BufferAdler32::get_value() const noexcept {
+    return (this->m_b << 16U) | this->m_a;
+}
+
+/**
+ *  Reset the checksum (as if no byte was updated).
+ */
+void BufferAdler32::reset() noexcept {
+    this->m_a = 1U;
+    this->m_b = 0U;
+}
+
+//
+//  BufferAdler32 public functions.
+//
+
+/**
+ *  Compute the checksum of the bytes of a buffer.
+ *
+ *  @param buffer
+ *      The buffer.
+ *  @return
+ *      The checksum.
+ */
+uint32_t BufferAdler32::compute(const Buffer &buffer) noexcept {
+    BufferAdler32 checksum;
+    checksum.update(buffer);
+    return checksum.get_value();
+}
+
+#if defined(UINT64_MAX)
+
+//
+//  BufferXxh64 constructor.
+//
+
+/**
+ *  Construct the object.
+ *
+ *  @param seed
+ *      The seed (default 0).
+ */
+BufferXxh64::BufferXxh64(const uint64_t seed) noexcept :
+    m_seed(seed),
+    m_pending()
+{
+    this->reset();
+}
+
+//
+//  BufferXxh64 public methods.
+//
+
+/**
+ *  Update the hash with bytes.
+ *
+ *  @param data
+ *      The bytes.
+ *  @param datalen
+ *      The count of bytes.
+ */
+void BufferXxh64::update(const uint8_t *data, const size_t datalen) noexcept {
+    if (datalen == 0U) {
+        return;
+    }
+    this->m_total += datalen;
+
+    size_t remaining = datalen;
+    if (this->m_pending_length + remaining < sizeof(this->m_pending)) {
+        memcpy(this->m_pending + this->m_pending_length, data, remaining);
+        this->m_pending_length += remaining;
+        return;
+    }
+
+    //  Complete the pending stripe.
+    if (this->m_pending_length != 0U) {
+        const size_t fill = sizeof(this->m_pending) - this->m_pending_length;
+        memcpy(this->m_pending + this->m_pending_length, data, fill);
+        checksum_xxh64_stripe(this->m_accumulators, this->m_pending);
+        data += fill;
+        remaining -= fill;
+        this->m_pending_length = 0U;
+    }
+
+    //  Mix the stripes directly from the input.
+    while (remaining >= sizeof(this->m_pending)) {
+        checksum_xxh64_stripe(this->m_accumulators, data);
+        data += sizeof(this->m_pending);
+        remaining -= sizeof(this->m_pending);
+    }
+
+    //  Keep the tail for the next update.
+    if (remaining != 0U) {
+        memcpy(this->m_pending, data, remaining);
+        this->m_pending_length = remaining;
+    }
+}
+
+/**
+ *  Update the hash with the bytes of a buffer.
+ *
+ *  @param buffer
+ *      The buffer.
+ */
+void BufferXxh64::update(const Buffer &buffer) noexcept {
+    this->update(buffer.get_pointer(), buffer.get_length());
+}
+
+/**
+ *  Update the hash with the bytes of a chain (without flattening).
+ *
+ *  @param chain
+ *      The chain.
+ */
+void BufferXxh64::update(const BufferChain &chain) noexcept {
+    checksum_update_chain(*this, chain);
+}
+
+/**
+ *  Update the hash with the remaining bytes of a queue (without
+ *  coalescing or consuming).
+ *
+ *  @throw std::bad_alloc
+ *      Raised if failed to allocate memory.
+ *  @param queue
+ *      The queue.
+ */
+void BufferXxh64::update(const BufferQueue &queue) {
+    checksum_update_queue(*this, queue);
+}
+
+/**
+ *  Get the hash of the bytes so far.
+ *
+ *  @return
+ *      The hash.
+ */
+uint64_t BufferXxh64::get_value() const noexcept {
+    const uint64_t *accumulators = this->m_accumulators;
+    uint64_t hash;
+    if (this->m_total >= sizeof(this->m_pending)) {
+        hash = checksum_rotl64(accumulators[0], 1U) +
+               checksum_rotl64(accumulators[1], 7U) +
+               checksum_rotl64(accumulators[2], 12U) +
+               checksum_rotl64(accumulators[3], 18U);
+        for (size_t i = 0U; i < 4U; ++i) {
+            hash = checksum_xxh64_merge(hash, accumulators[i]);
+        }
+    } else {
+        hash = this->m_seed + CHECKSUM_XXH64_PRIME5;
+    }
+    hash += this->m_total;
+
+    //  Mix the pending bytes.
+    const uint8_t *tail = this->m_pending;
+    size_t remaining = this->m_pending_length;
+    while (remaining >= 8U) {
+        hash ^= checksum_xxh64_round(0U, endian_read_uint64_le(tail));
+        hash = checksum_rotl64(hash, 27U) * CHECKSUM_XXH64_PRIME1 +
+               CHECKSUM_XXH64_PRIME4;
+        tail += 8U;
+        remaining -= 8U;
+    }
+    if (remaining >= 4U) {
+        hash ^= static_cast<uint64_t>(endian_read_uint32_le(tail)) *
+                CHECKSUM_XXH64_PRIME1;
+        hash = checksum_rotl64(hash, 23U) * CHECKSUM_XXH64_PRIME2 +
+               CHECKSUM_XXH64_PRIME3;
+        tail += 4U;
+        remaining -= 4U;
+    }
+    while (remaining != 0U) {
+        hash ^= static_cast<uint64_t>(*tail) * CHECKSUM_XXH64_PRIME5;
+        hash = checksum_rotl64(hash, 11U) * CHECKSUM_XXH64_PRIME1;
+        ++tail;
+        --remaining;
+    }
+
+    //  Avalanche.
+    hash ^= hash >> 33U;
+    hash *= CHECKSUM_XXH64_PRIME2;
+    hash ^= hash >> 29U;
+    hash *= CHECKSUM_XXH64_PRIME3;
+    hash ^= hash >> 32U;
+    return hash;
+}
+
+/**
+ *  Reset the hash (as if no byte was updated, the seed is kept).
+ */
+void BufferXxh64::reset() noexcept {
+    const uint64_t seed = this->m_seed;
+    this->m_total = 0U;
+    this->m_accumulators[0] =
+        seed + CHECKSUM_XXH64_PRIME1 + CHECKSUM_XXH64_PRIME2;
+    this->m_accumulators[1] = seed + CHECKSUM_XXH64_PRIME2;
+    this->m_accumulators[2] = seed;
+    this->m_accumulators[3] = seed - CHECKSUM_XXH64_PRIME1;
+    this->m_pending_length = 0U;
+}
+
+//
+//  BufferXxh64 public functions.
+//
+
+/**
+ *  Compute the hash of the bytes of a buffer.
+ *
+ *  @param buffer
+ *      The buffer.
+ *  @param seed
+ *      The seed (default 0).
+ *  @return
+ *      The hash.
+ */
+uint64_t BufferXxh64::compute(
+    const Buffer    &buffer,
+    const uint64_t  seed
+) noexcept {
+    BufferXxh64 hash(seed);
+    hash.update(buffer);
+    return hash.get_value();
+}
+
+#endif  //  #if defined(UINT64_MAX)
+
+}  //  namespace buffer
+}  //  namespace core
+}  //  namespace xap
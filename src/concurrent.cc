@@ -0,0 +1,330 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+//
+//  Imports.
+//
+#include <algorithm>
+#include <chrono>
+#include <string.h>
+#include <utility>
+#include <xap/core/buffer/concurrent.h>
+
+namespace xap {
+namespace core {
+namespace buffer {
+
+//
+//  Constants.
+//
+
+//  The count of chunk slots in each segment.
+static const size_t CONCURRENT_SEGMENT_SLOTS = 64U;
+
+//  The maximum count of spare segments kept for the producer.
+static const size_t CONCURRENT_SPARE_SEGMENTS = 16U;
+
+//
+//  Private structures.
+//
+
+//
+//  Segment of chunk slots.
+//
+//  Slots are filled by the producer only. A slot is published by storing
+//  the new count to 'published' and then adding its length to the queue
+//  remaining size (release), which is what the consumer checks (acquire)
+//  before it touches the slot. While a segment is spare, 'next' links the
+//  free list instead.
+//
+struct ConcurrentBufferQueue::Segment {
+    //  The chunk slots.
+    Buffer                  slots[CONCURRENT_SEGMENT_SLOTS];
+
+    //  The count of published slots.
+    std::atomic<size_t>     published;
+
+    //  The next segment (or the next spare segment).
+    std::atomic<Segment*>   next;
+
+    /**
+     *  Construct the object.
+     */
+    Segment() noexcept :
+        published(0U),
+        next(nullptr)
+    {}
+};
+
+//
+//  Constructor & destructor.
+//
+
+/**
+ *  Construct the object.
+ */
+ConcurrentBufferQueue::ConcurrentBufferQueue() :
+    m_remaining(0U),
+    m_tail(nullptr),
+    m_head(nullptr),
+    m_head_index(0U),
+    m_front(),
+    m_front_cursor(0U),
+    m_spare(nullptr),
+    m_spare_count(0U),
+    m_waiting(false)
+{
+    this->m_head = new Segment();
+    this->m_tail = this->m_head;
+}
+
+/**
+ *  Destruct the object.
+ */
+ConcurrentBufferQueue::~ConcurrentBufferQueue() noexcept {
+    Segment *lists[2] = {
+        this->m_head, 
+        this->m_spare.load(std::memory_order_acquire)
+    };
+    for (Segment *segment : lists) {
+        while (segment != nullptr) {
+            Segment *next = segment->next.load(std::memory_order_relaxed);
+            delete segment;
+            segment = next;
+        }
+    }
+}
+
+//
+//  Public methods.
+//
+
+/**
+ *  Push buffer to queue (producer only).
+ *
+ *  @param data
+ *      The data.
+ */
+void ConcurrentBufferQueue::push(const Buffer &data) {
+    this->push(Buffer(data));
+}
+
+/**
+ *  Push buffer to queue (producer only).
+ *
+ *  @param data
+ *      The data (would be moved into queue).
+ */
+void ConcurrentBufferQueue::push(Buffer &&data) {
+    const size_t datalen = data.get_length();
+    if (datalen == 0U) {
+        return;
+    }
+
+    Segment *tail = this->m_tail;
+    const size_t index = tail->published.load(std::memory_order_relaxed);
+    if (index == CONCURRENT_SEGMENT_SLOTS) {
+        //  The segment is full, link an empty one.
+        Segment *segment = this->acquire_segment();
+        segment->slots[0U] = std::move(data);
+        segment->published.store(1U, std::memory_order_relaxed);
+        tail->next.store(segment, std::memory_order_release);
+        this->m_tail = segment;
+    } else {
+        tail->slots[index] = std::move(data);
+        tail->published.store(index + 1U, std::memory_order_release);
+    }
+
+    //  Publish the bytes, then wake the consumer if it is waiting (both
+    //  sequentially consistent, pairs with wait()).
+    this->m_remaining.fetch_add(datalen, std::memory_order_seq_cst);
+    if (this->m_waiting.load(std::memory_order_seq_cst)) {
+        std::lock_guard<std::mutex> lock(this->m_wait_lock);
+        this->m_wait_condition.notify_one();
+    }
+}
+
+/**
+ *  Pop buffer from queue (consumer only).
+ *
+ *  @throw BufferException
+ *      Raised if parameter 'size' was out of range
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param size
+ *      The size of buffer.
+ *  @return
+ *      The buffer.
+ */
+Buffer ConcurrentBufferQueue::pop(const size_t size) {
+    if (size > this->m_remaining.load(std::memory_order_acquire)) {
+        throw BufferException("Out of range.", XAPCORE_BUF_ERROR_OVERFLOW);
+    }
+
+    Buffer buffer(size, true);
+    uint8_t *destination = buffer.get_pointer();
+    size_t cursor = 0U;
+    while (cursor < size) {
+        if (this->m_front_cursor == this->m_front.get_length()) {
+            this->take_chunk();
+        }
+        const size_t copy_len = std::min(
+            this->m_front.get_length() - this->m_front_cursor,
+            size - cursor
+        );
+        memcpy(
+            destination + cursor,
+            this->m_front.get_pointer() + this->m_front_cursor,
+            copy_len
+        );
+        cursor += copy_len;
+        this->m_front_cursor += copy_len;
+    }
+    if (this->m_front_cursor == this->m_front.get_length()) {
+        //  Release the chunk early.
+        this->m_front = Buffer();
+        this->m_front_cursor = 0U;
+    }
+
+    this->m_remaining.fetch_sub(size, std::memory_order_release);
+    return buffer;
+}
+
+/**
+ *  Pop all data from queue (consumer only).
+ *
+ *  @return
+ *      The buffer.
+ */
+Buffer ConcurrentBufferQueue::pop_all() {
+    return this->pop(this->m_remaining.load(std::memory_order_acquire));
+}
+
+/**
+ *  Wait until the queue holds at least specified count of bytes
+ *  (consumer only).
+ *
+ *  @param size
+ *      The count of bytes.
+ *  @param timeout_ms
+ *      The timeout in milliseconds.
+ *  @return
+ *      True if the bytes are available, false if timed out.
+ */
+bool ConcurrentBufferQueue::wait(const size_t size, const uint32_t timeout_ms) {
+    if (this->m_remaining.load(std::memory_order_acquire) >= size) {
+        return true;
+    }
+
+    std::unique_lock<std::mutex> lock(this->m_wait_lock);
+    this->m_waiting.store(true, std::memory_order_seq_cst);
+    const bool ready = this->m_wait_condition.wait_for(
+        lock,
+        std::chrono::milliseconds(timeout_ms),
+        [this, size]() {
+            return this->m_remaining.load(std::memory_order_seq_cst) >= size;
+        }
+    );
+    this->m_waiting.store(false, std::memory_order_relaxed);
+    return ready;
+}
+
+/**
+ *  Get the remaining size.
+ *
+ *  @return
+ *      The size of remaining bytes.
+ */
+size_t ConcurrentBufferQueue::get_remaining_size() const noexcept {
+    return this->m_remaining.load(std::memory_order_acquire);
+}
+
+//
+//  Private methods.
+//
+
+/**
+ *  Take the next chunk into the front chunk (consumer only).
+ *
+ *  @note
+ *      The caller must guarantee that a chunk was published.
+ */
+void ConcurrentBufferQueue::take_chunk() noexcept {
+    if (this->m_head_index == CONCURRENT_SEGMENT_SLOTS) {
+        //  The producer linked the next segment before publishing its
+        //  bytes, and never touches this segment again (until recycled).
+        Segment *next = this->m_head->next.load(std::memory_order_acquire);
+        this->recycle_segment(this->m_head);
+        this->m_head = next;
+        this->m_head_index = 0U;
+    }
+
+    this->m_front = std::move(this->m_head->slots[this->m_head_index]);
+    this->m_front_cursor = 0U;
+    ++this->m_head_index;
+}
+
+/**
+ *  Get an empty segment, recycled if possible (producer only).
+ *
+ *  @throw std::bad_alloc
+ *      Raised if failed to allocate memory.
+ *  @return
+ *      The segment.
+ */
+ConcurrentBufferQueue::Segment* ConcurrentBufferQueue::acquire_segment() {
+    //  The producer is the only thread which pops the free list, so the
+    //  popped segment can't be popped (and pushed back) meanwhile (no ABA).
+    Segment *segment = this->m_spare.load(std::memory_order_acquire);
+    while (segment != nullptr && !this->m_spare.compare_exchange_weak(
+        segment,
+        segment->next.load(std::memory_order_relaxed),
+        std::memory_order_acquire,
+        std::memory_order_acquire
+    )) {
+        //  Retry (the consumer pushed a segment meanwhile).
+    }
+    if (segment == nullptr) {
+        return new Segment();
+    }
+
+    this->m_spare_count.fetch_sub(1U, std::memory_order_relaxed);
+    segment->next.store(nullptr, std::memory_order_relaxed);
+    return segment;
+}
+
+/**
+ *  Hand a drained segment back to the producer, or delete it if enough
+ *  segments are spare (consumer only).
+ *
+ *  @param segment
+ *      The segment.
+ */
+void ConcurrentBufferQueue::recycle_segment(Segment *segment) noexcept {
+    //  Counted before pushed, so that the producer never decreases the 
+    //  count below zero.
+    if (this->m_spare_count.fetch_add(1U, std::memory_order_relaxed) >= 
+        CONCURRENT_SPARE_SEGMENTS) {
+        this->m_spare_count.fetch_sub(1U, std::memory_order_relaxed);
+        delete segment;
+        return;
+    }
+
+    //  The slots were moved into the front chunk (they are empty already).
+    segment->published.store(0U, std::memory_order_relaxed);
+    Segment *top = this->m_spare.load(std::memory_order_relaxed);
+    do {
+        segment->next.store(top, std::memory_order_relaxed);
+    } while (!this->m_spare.compare_exchange_weak(
+        top,
+        segment,
+        std::memory_order_release,
+        std::memory_order_relaxed
+    ));
+}
+
+}  //  namespace buffer
+}  //  namespace core
+}  //  namespace xap
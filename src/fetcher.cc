@@ -7,8 +7,11 @@
 //
 //  Imports.
 //
+#include <xap/core/buffer/endian.h>
 #include <xap/core/buffer/error.h>
 #include <xap/core/buffer/fetcher.h>
+#include <utility>
+#include "kernel.h"
 
 namespace xap {
 namespace core {
@@ -20,12 +23,22 @@ namespace buffer {
  *  @param buffer
  *      The buffer which would be fetched.
  */
-BufferFetcher::BufferFetcher(const Buffer &buffer) {
-    Buffer *copied_buffer = new Buffer(buffer);
-    this->m_buffer_shared_pointer = std::shared_ptr<Buffer>(copied_buffer);
-    this->m_buffer = copied_buffer;
-    this->m_buffer_length = copied_buffer->get_length();
-    this->m_cursor = 0;
+BufferFetcher::BufferFetcher(const Buffer &buffer) :
+    m_buffer(buffer)
+{
+    this->prepare();
+}
+
+/**
+ *  Cosntruct the object.
+ * 
+ *  @param buffer
+ *      The buffer which would be fetched (would be moved into fetcher).
+ */
+BufferFetcher::BufferFetcher(Buffer &&buffer) :
+    m_buffer(std::move(buffer))
+{
+    this->prepare();
 }
 
 /**
@@ -34,21 +47,35 @@ BufferFetcher::BufferFetcher(const Buffer &buffer) {
  *  @param src
  *      The source fetcher.
  */
-BufferFetcher::BufferFetcher(const BufferFetcher &src) noexcept {
-    this->m_buffer_shared_pointer = src.m_buffer_shared_pointer;
-    this->m_buffer = src.m_buffer;
-    this->m_buffer_length = src.m_buffer_length;
-    this->m_cursor = src.m_cursor;
+BufferFetcher::BufferFetcher(const BufferFetcher &src) noexcept :
+    m_buffer(src.m_buffer),
+    m_begin(src.m_begin),
+    m_cursor(src.m_cursor),
+    m_end(src.m_end)
+{
+    //  Do nothing.
+}
+
+/**
+ *  Construct (Move) the object.
+ * 
+ *  @param src
+ *      The source fetcher (would be empty after moved).
+ */
+BufferFetcher::BufferFetcher(BufferFetcher &&src) noexcept :
+    m_buffer(std::move(src.m_buffer)),
+    m_begin(src.m_begin),
+    m_cursor(src.m_cursor),
+    m_end(src.m_end)
+{
+    src.prepare();
 }
 
 /**
  *  Destruct the object.
  */
 BufferFetcher::~BufferFetcher() noexcept {
-    this->m_buffer_shared_pointer.reset();
-    this->m_buffer = nullptr;
-    this->m_buffer_length = 0;
-    this->m_cursor = 0;
+    //  Do nothing.
 }
 
 //
@@ -65,46 +92,42 @@ BufferFetcher::~BufferFetcher() noexcept {
  */
 BufferFetcher& BufferFetcher::operator=(const BufferFetcher& src) noexcept {
     if (this != &src) {
-        this->m_buffer_shared_pointer = src.m_buffer_shared_pointer;
         this->m_buffer = src.m_buffer;
-        this->m_buffer_length = src.m_buffer_length;
+        this->m_begin = src.m_begin;
         this->m_cursor = src.m_cursor;
+        this->m_end = src.m_end;
     }
     return *this;
 }
 
-//
-//  Public methods.
-//
-
 /**
- *  Check whether the fetcher is ended.
+ *  Operator '=' (move).
  * 
+ *  @param src
+ *      The source fetcher (would be empty after moved).
  *  @return
- *      True if so.
+ *      The destination fetcher.
  */
-bool BufferFetcher::is_end() const noexcept {
-    return this->m_cursor == this->m_buffer_length;
+BufferFetcher& BufferFetcher::operator=(BufferFetcher&& src) noexcept {
+    if (this != &src) {
+        this->m_buffer = std::move(src.m_buffer);
+        this->m_begin = src.m_begin;
+        this->m_cursor = src.m_cursor;
+        this->m_end = src.m_end;
+        src.prepare();
+    }
+    return *this;
 }
 
+//
+//  Public methods.
+//
+
 /**
  *  Reset the fetcher. Move the cursor to the begin position.
  */
 void BufferFetcher::reset() noexcept {
-    this->m_cursor = 0U;
-}
-
-/**
- *  Fetch one byte.
- * 
- *  @throw BufferException
- *      Raised if the buffer fetcher was ended (XAPCORE_BUF_ERROR_OVERFLOW).
- *  @return
- *      The byte.
- */
-uint8_t BufferFetcher::fetch() {
-    this->assert_not_eof();
-    return this->m_buffer->read_uint8(this->m_cursor++);
+    this->m_cursor = this->m_begin;
 }
 
 /**
@@ -147,10 +170,10 @@ size_t BufferFetcher::fetch_to(
 
     this->assert_not_eof();
 
-    size_t copy_len = this->m_buffer->copy(
+    size_t copy_len = this->m_buffer.copy(
         destination, 
         destination_offset, 
-        this->m_cursor
+        static_cast<size_t>(this->m_cursor - this->m_begin)
     );
     this->m_cursor += copy_len;
     return copy_len;
@@ -169,8 +192,10 @@ Buffer BufferFetcher::fetch_all() {
         return Buffer(0U);
     }
     
-    Buffer out = this->m_buffer->slice(this->m_cursor);
-    this->m_cursor += out.get_length();
+    Buffer out = this->m_buffer.slice(
+        static_cast<size_t>(this->m_cursor - this->m_begin)
+    );
+    this->m_cursor = this->m_end;
     return out;
 }
 
@@ -197,11 +222,120 @@ Buffer BufferFetcher::fetch_bytes(const size_t count) {
         );
     }
 
-    Buffer out = this->m_buffer->slice(this->m_cursor, count);
+    Buffer out = this->m_buffer.slice(
+        static_cast<size_t>(this->m_cursor - this->m_begin), 
+        count
+    );
     this->m_cursor += count;
     return out;
 }
 
+#if defined(UINT64_MAX)
+
+/**
+ *  Fetch an unsigned integer with variable-length (LEB128) encoding.
+ * 
+ *  @throw BufferException
+ *      Raised if the encoding is truncated or longer than 64 bits, the
+ *      cursor is not moved (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The unsigned integer.
+ */
+uint64_t BufferFetcher::fetch_varint() {
+    uint64_t value = 0U;
+    const size_t count = kernel_decode_varint(
+        this->m_cursor, 
+        this->get_remaining_size(), 
+        &value
+    );
+    if (count == 0U) {
+        throw BufferException(
+            "Invalid or truncated varint.", 
+            XAPCORE_BUF_ERROR_OVERFLOW
+        );
+    }
+    this->m_cursor += count;
+    return value;
+}
+
+/**
+ *  Fetch a signed integer with zigzag and variable-length (LEB128) 
+ *  encoding.
+ * 
+ *  @throw BufferException
+ *      Raised if the encoding is truncated or longer than 64 bits, the
+ *      cursor is not moved (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The signed integer.
+ */
+int64_t BufferFetcher::fetch_varint_signed() {
+    const uint64_t value = this->fetch_varint();
+    const uint64_t magnitude = value >> 1U;
+    return static_cast<int64_t>((value & 1U) != 0U ? ~magnitude : magnitude);
+}
+
+#endif  //  #if defined(UINT64_MAX)
+
+/**
+ *  Fetch a single-precision float-point with big-endian.
+ * 
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The single-precision float-point value.
+ */
+float BufferFetcher::fetch_float_be() {
+    const size_t offset = this->get_offset();
+    this->take(4U);
+    return this->m_buffer.read_float_be(offset);
+}
+
+/**
+ *  Fetch a single-precision float-point with little-endian.
+ * 
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The single-precision float-point value.
+ */
+float BufferFetcher::fetch_float_le() {
+    const size_t offset = this->get_offset();
+    this->take(4U);
+    return this->m_buffer.read_float_le(offset);
+}
+
+/**
+ *  Fetch a double-precision float-point with big-endian.
+ * 
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The double-precision float-point value.
+ */
+double BufferFetcher::fetch_double_be() {
+    const size_t offset = this->get_offset();
+    this->take(8U);
+    return this->m_buffer.read_double_be(offset);
+}
+
+/**
+ *  Fetch a double-precision float-point with little-endian.
+ * 
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The double-precision float-point value.
+ */
+double BufferFetcher::fetch_double_le() {
+    const size_t offset = this->get_offset();
+    this->take(8U);
+    return this->m_buffer.read_double_le(offset);
+}
+
 /**
  *  Skip bytes.
  * 
@@ -232,13 +366,31 @@ void BufferFetcher::skip(const size_t count) {
 }
 
 /**
- *  Get the remaining size.
+ *  Find the first occurrence of a byte in the remaining bytes.
  * 
+ *  @param value
+ *      The byte.
  *  @return
- *      The remaining size.
+ *      The offset relative to the cursor (Buffer::NPOS if not found).
  */
-size_t BufferFetcher::get_remaining_size() const noexcept {
-    return this->m_buffer_length - this->m_cursor;
+size_t BufferFetcher::index_of(const uint8_t value) const noexcept {
+    const size_t offset = static_cast<size_t>(this->m_cursor - this->m_begin);
+    const size_t found = this->m_buffer.index_of(value, offset);
+    return found == Buffer::NPOS ? Buffer::NPOS : found - offset;
+}
+
+/**
+ *  Find the first occurrence of a byte sequence in the remaining bytes.
+ * 
+ *  @param needle
+ *      The byte sequence.
+ *  @return
+ *      The offset relative to the cursor (Buffer::NPOS if not found).
+ */
+size_t BufferFetcher::index_of(const Buffer &needle) const noexcept {
+    const size_t offset = static_cast<size_t>(this->m_cursor - this->m_begin);
+    const size_t found = this->m_buffer.index_of(needle, offset);
+    return found == Buffer::NPOS ? Buffer::NPOS : found - offset;
 }
 
 /**
@@ -248,17 +400,39 @@ size_t BufferFetcher::get_remaining_size() const noexcept {
  *      The buffer.
  */
 void BufferFetcher::replace(const Buffer &new_buffer) {
-    Buffer *copied_buffer = new Buffer(new_buffer);
-    this->m_buffer_shared_pointer = std::shared_ptr<Buffer>(copied_buffer);
-    this->m_buffer = copied_buffer;
-    this->m_buffer_length = copied_buffer->get_length();
-    this->m_cursor = 0U;
+    this->m_buffer = new_buffer;
+    this->prepare();
+}
+
+/**
+ *  Replace (reset) the fetch with another new buffer.
+ * 
+ *  @param new_buffer
+ *      The buffer (would be moved into fetcher).
+ */
+void BufferFetcher::replace(Buffer &&new_buffer) {
+    this->m_buffer = std::move(new_buffer);
+    this->prepare();
 }
 
 //
 //  Private methods.
 //
 
+/**
+ *  Raise the end-of-buffer error (kept out of line, so that the inlined 
+ *  fetches stay small).
+ * 
+ *  @throw BufferException
+ *      Always (XAPCORE_BUF_ERROR_OVERFLOW).
+ */
+void BufferFetcher::raise_eof() {
+    throw BufferException(
+        "Reached the end of the buffer.", 
+        XAPCORE_BUF_ERROR_OVERFLOW
+    );
+}
+
 /**
  *  Expected fetcher was not ended.
  * 
@@ -267,13 +441,21 @@ void BufferFetcher::replace(const Buffer &new_buffer) {
  */
 void BufferFetcher::assert_not_eof() {
     if (this->is_end()) {
-        throw BufferException(
-            "Reached the end of the buffer.", 
-            XAPCORE_BUF_ERROR_OVERFLOW
-        );
+        raise_eof();
     }
 }
 
+/**
+ *  Prepare the cached pointers (, and move the cursor to the begin 
+ *  position).
+ */
+void BufferFetcher::prepare() noexcept {
+    const Buffer &buffer = this->m_buffer;
+    this->m_begin = buffer.get_pointer();
+    this->m_cursor = this->m_begin;
+    this->m_end = this->m_begin + buffer.get_length();
+}
+
 }  //  namespace buffer
 }  //  namespace core
 }  //  namespace xap
\ No newline at end of file
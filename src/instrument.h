@@ -0,0 +1,83 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+#ifndef XAP_CORE_BUFFER_INSTRUMENT_H__
+#define XAP_CORE_BUFFER_INSTRUMENT_H__
+
+//
+//  Imports.
+//
+#include <stddef.h>
+
+//
+//  Macros.
+//
+//  The instrumentation points expand to nothing unless the library is 
+//  compiled with XAP_CORE_BUFFER_STATS defined.
+//
+#if defined(XAP_CORE_BUFFER_STATS)
+# define XAP_CORE_BUFFER_STATS_ALLOCATE(length) \
+    ::xap::core::buffer::stats_record_allocate(length)
+# define XAP_CORE_BUFFER_STATS_FREE(length) \
+    ::xap::core::buffer::stats_record_free(length)
+# define XAP_CORE_BUFFER_STATS_COPY(length) \
+    ::xap::core::buffer::stats_record_copy(length)
+# define XAP_CORE_BUFFER_STATS_SLICE() \
+    ::xap::core::buffer::stats_record_slice()
+#else
+# define XAP_CORE_BUFFER_STATS_ALLOCATE(length) ((void)0)
+# define XAP_CORE_BUFFER_STATS_FREE(length) ((void)0)
+# define XAP_CORE_BUFFER_STATS_COPY(length) ((void)0)
+# define XAP_CORE_BUFFER_STATS_SLICE() ((void)0)
+#endif
+
+#if defined(XAP_CORE_BUFFER_STATS)
+
+namespace xap {
+namespace core {
+namespace buffer {
+
+//
+//  Private functions.
+//
+
+/**
+ *  Record a buffer storage allocation.
+ *
+ *  @param length
+ *      The length of the storage.
+ */
+void stats_record_allocate(const size_t length) noexcept;
+
+/**
+ *  Record a buffer storage release.
+ *
+ *  @param length
+ *      The length of the storage.
+ */
+void stats_record_free(const size_t length) noexcept;
+
+/**
+ *  Record a copy.
+ *
+ *  @param length
+ *      The count of bytes copied.
+ */
+void stats_record_copy(const size_t length) noexcept;
+
+/**
+ *  Record a slice creation.
+ */
+void stats_record_slice() noexcept;
+
+}  //  namespace buffer
+}  //  namespace core
+}  //  namespace xap
+
+#endif  //  #if defined(XAP_CORE_BUFFER_STATS)
+
+
+#endif  //  #ifndef XAP_CORE_BUFFER_INSTRUMENT_H__
@@ -0,0 +1,308 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+//
+//  Imports.
+//
+#include <xap/core/buffer/build.h>
+#include <xap/core/buffer/error.h>
+#include <xap/core/buffer/io.h>
+
+#if defined(XAP_CORE_BUFFER_OS_POSIX)
+# include <errno.h>
+# include <sys/types.h>
+# include <sys/uio.h>
+# include <unistd.h>
+#endif
+
+namespace xap {
+namespace core {
+namespace buffer {
+
+//
+//  Private constants.
+//
+
+//  The maximum count of chunks filled by one read (the I/O vectors are on
+//  the stack, and IOV_MAX is at least 16 on POSIX systems).
+static const size_t IO_BATCH_MAX = 64U;
+
+//
+//  Private functions.
+//
+
+/**
+ *  Get the count of bytes which can be pushed into a queue.
+ *
+ *  @param queue
+ *      The queue.
+ *  @return
+ *      The count.
+ */
+static size_t io_get_queue_space(const BufferQueue &queue) noexcept {
+    const size_t max_size = queue.get_max_size();
+    const size_t remaining = queue.get_remaining_size();
+    return remaining < max_size ? max_size - remaining : 0U;
+}
+
+//
+//  BufferReader constructor & destructor.
+//
+
+/**
+ *  Construct the object.
+ *
+ *  @throw BufferException
+ *      Raised if 'chunk_size' or 'batch' is 0
+ *      (XAPCORE_BUF_ERROR_INVALID_SIZE).
+ *  @param queue
+ *      The queue to fill (must outlive the reader).
+ *  @param chunk_size
+ *      The size of chunks (default 16 KiB, a pool class size).
+ *  @param batch
+ *      The maximum count of chunks filled by one read (default 4, at most
+ *      64).
+ *  @param allocator
+ *      The allocator of chunk storage (must outlive the chunks).
+ */
+BufferReader::BufferReader(
+    BufferQueue     &queue,
+    const size_t    chunk_size,
+    const size_t    batch,
+    BufferAllocator &allocator
+):
+    m_queue(&queue),
+    m_chunk_size(chunk_size),
+    m_batch(batch > IO_BATCH_MAX ? IO_BATCH_MAX : batch),
+    m_allocator(&allocator),
+    m_chunks(),
+    m_offset(0U),
+    m_total_read(0U),
+    m_read_calls(0U) {
+    if (chunk_size == 0U || batch == 0U) {
+        throw BufferException(
+            "Invalid chunk size or batch.",
+            XAPCORE_BUF_ERROR_INVALID_SIZE
+        );
+    }
+}
+
+/**
+ *  Destruct the object.
+ */
+BufferReader::~BufferReader() noexcept {
+    //  Nothing.
+}
+
+//
+//  BufferReader public methods.
+//
+
+/**
+ *  Read once from a file descriptor (one system call, retried if
+ *  interrupted by a signal).
+ *
+ *  @note
+ *      The read is limited by the free space of the queue if its maximum
+ *      size was set.
+ *  @throw BufferException
+ *      Raised if failed to read (XAPCORE_BUF_ERROR_IO).
+ *  @throw std::bad_alloc
+ *      Raised if failed to allocate memory.
+ *  @param fd
+ *      The file descriptor.
+ *  @return
+ *      The status.
+ */
+BufferReadStatus BufferReader::read_some(const int fd) {
+    return this->read_once(fd, SIZE_MAX);
+}
+
+/**
+ *  Read from a file descriptor until no byte is available, the end of
+ *  file, the queue being full, or 'max_size' bytes were read.
+ *
+ *  @note
+ *      Use with non-blocking descriptors (a blocking descriptor would block
+ *      once the available bytes were read).
+ *  @throw BufferException
+ *      Raised if failed to read (XAPCORE_BUF_ERROR_IO).
+ *  @throw std::bad_alloc
+ *      Raised if failed to allocate memory.
+ *  @param fd
+ *      The file descriptor.
+ *  @param max_size
+ *      The maximum count of bytes to read (default no limit).
+ *  @return
+ *      The status of the last read (BUFFER_READ_DATA if stopped by
+ *      'max_size').
+ */
+BufferReadStatus BufferReader::read_available(
+    const int       fd,
+    const size_t    max_size
+) {
+    const uint64_t start = this->m_total_read;
+    while (this->m_total_read - start < max_size) {
+        //  Trim the last read to the bytes left under 'max_size'.
+        const BufferReadStatus status = this->read_once(
+            fd,
+            max_size - static_cast<size_t>(this->m_total_read - start)
+        );
+        if (status != BUFFER_READ_DATA) {
+            return status;
+        }
+    }
+    return BUFFER_READ_DATA;
+}
+
+/**
+ *  Get the count of bytes read so far.
+ *
+ *  @return
+ *      The count.
+ */
+uint64_t BufferReader::get_total_read() const noexcept {
+    return this->m_total_read;
+}
+
+/**
+ *  Get the count of read system calls so far.
+ *
+ *  @return
+ *      The count.
+ */
+uint64_t BufferReader::get_read_calls() const noexcept {
+    return this->m_read_calls;
+}
+
+//
+//  BufferReader private methods.
+//
+
+/**
+ *  Read once from a file descriptor (see read_some()), but not more than
+ *  'limit' bytes.
+ *
+ *  @throw BufferException
+ *      Raised if failed to read (XAPCORE_BUF_ERROR_IO).
+ *  @throw std::bad_alloc
+ *      Raised if failed to allocate memory.
+ *  @param fd
+ *      The file descriptor.
+ *  @param limit
+ *      The maximum count of bytes to read (must not be 0).
+ *  @return
+ *      The status.
+ */
+BufferReadStatus BufferReader::read_once(const int fd, const size_t limit) {
+#if defined(XAP_CORE_BUFFER_OS_POSIX)
+    size_t space = io_get_queue_space(*(this->m_queue));
+    if (space == 0U) {
+        return BUFFER_READ_FULL;
+    }
+    if (space > limit) {
+        space = limit;
+    }
+
+    this->prepare_chunks();
+
+    //  Build the I/O vectors (the first chunk may be partially filled).
+    struct iovec vectors[IO_BATCH_MAX];
+    int count = 0;
+    for (size_t i = 0U; i < this->m_chunks.size() && space != 0U; ++i) {
+        const size_t begin = (i == 0U ? this->m_offset : 0U);
+        size_t length = this->m_chunk_size - begin;
+        if (length > space) {
+            length = space;
+        }
+        vectors[count].iov_base = this->m_chunks[i].get_pointer() + begin;
+        vectors[count].iov_len = length;
+        ++count;
+        space -= length;
+    }
+
+    ssize_t rc;
+    do {
+        rc = ::readv(fd, vectors, count);
+        ++(this->m_read_calls);
+    } while (rc < 0 && errno == EINTR);
+
+    if (rc < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return BUFFER_READ_AGAIN;
+        }
+        throw BufferException("Failed to read.", XAPCORE_BUF_ERROR_IO);
+    }
+    if (rc == 0) {
+        return BUFFER_READ_END;
+    }
+
+    this->push_read(static_cast<size_t>(rc));
+    return BUFFER_READ_DATA;
+#else
+    (void)fd;
+    (void)limit;
+    throw BufferException("Not supported.", XAPCORE_BUF_ERROR_IO);
+#endif
+}
+
+/**
+ *  Allocate the chunks of the next read.
+ *
+ *  @throw std::bad_alloc
+ *      Raised if failed to allocate memory.
+ */
+void BufferReader::prepare_chunks() {
+    while (this->m_chunks.size() < this->m_batch) {
+        //  The bytes are always written by readv() before being pushed, so
+        //  the chunks don't need to be zeroed.
+        this->m_chunks.emplace_back(
+            this->m_chunk_size,
+            true,
+            *(this->m_allocator)
+        );
+    }
+}
+
+/**
+ *  Push the bytes read into the queue.
+ *
+ *  @param size
+ *      The count of bytes read.
+ */
+void BufferReader::push_read(size_t size) {
+    this->m_total_read += size;
+
+    size_t filled = 0U;
+    while (size != 0U) {
+        Buffer &chunk = this->m_chunks[filled];
+        size_t length = this->m_chunk_size - this->m_offset;
+        if (length > size) {
+            length = size;
+        }
+        this->m_queue->push(chunk.slice(this->m_offset, length));
+        this->m_offset += length;
+        size -= length;
+
+        if (this->m_offset == this->m_chunk_size) {
+            //  The chunk is full, the queue holds the only references now.
+            ++filled;
+            this->m_offset = 0U;
+        }
+    }
+
+    //  Drop the full chunks (the partially filled one becomes the first).
+    if (filled != 0U) {
+        this->m_chunks.erase(
+            this->m_chunks.begin(),
+            this->m_chunks.begin() + static_cast<ptrdiff_t>(filled)
+        );
+    }
+}
+
+}  //  namespace buffer
+}  //  namespace core
+}  //  namespace xap
@@ -0,0 +1,761 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+//
+//  Imports.
+//
+#include <cmath>
+#include <algorithm>
+#include <string.h>
+#include <xap/core/buffer/build.h>
+#include <xap/core/buffer/endian.h>
+#include "kernel.h"
+
+#if defined(XAP_CORE_BUFFER_SIMD_SSE2)
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+#if defined(XAP_CORE_BUFFER_SIMD_AVX2)
+#include <immintrin.h>
+#endif
+#if defined(XAP_CORE_BUFFER_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace xap {
+namespace core {
+namespace buffer {
+
+//
+//  Constants.
+//
+
+//  Scales which map signed samples into [-1.0, 1.0).
+static const float KERNEL_SCALE_SINT16 = 1.0f / 32768.0f;
+static const float KERNEL_SCALE_SINT24 = 1.0f / 8388608.0f;
+static const float KERNEL_SCALE_SINT32 = 1.0f / 2147483648.0f;
+
+//  Saturation bounds of signed 16-bit samples.
+static const float KERNEL_SINT16_MIN = -32768.0f;
+static const float KERNEL_SINT16_MAX = 32767.0f;
+
+//
+//  Private functions.
+//
+
+#if defined(XAP_CORE_BUFFER_SIMD_SSE2)
+
+/**
+ *  Reverse the byte order of 16-bit lanes.
+ *
+ *  @param value
+ *      The vector.
+ *  @return
+ *      The swapped vector.
+ */
+static inline __m128i kernel_sse2_swap16(const __m128i value) noexcept {
+    return _mm_or_si128(_mm_slli_epi16(value, 8), _mm_srli_epi16(value, 8));
+}
+
+/**
+ *  Reverse the byte order of 32-bit lanes.
+ *
+ *  @param value
+ *      The vector.
+ *  @return
+ *      The swapped vector.
+ */
+static inline __m128i kernel_sse2_swap32(const __m128i value) noexcept {
+    const __m128i swapped = kernel_sse2_swap16(value);
+    return _mm_shufflehi_epi16(
+        _mm_shufflelo_epi16(swapped, _MM_SHUFFLE(2, 3, 0, 1)),
+        _MM_SHUFFLE(2, 3, 0, 1)
+    );
+}
+
+/**
+ *  Reverse the byte order of 64-bit lanes.
+ *
+ *  @param value
+ *      The vector.
+ *  @return
+ *      The swapped vector.
+ */
+static inline __m128i kernel_sse2_swap64(const __m128i value) noexcept {
+    const __m128i swapped = kernel_sse2_swap16(value);
+    return _mm_shufflehi_epi16(
+        _mm_shufflelo_epi16(swapped, _MM_SHUFFLE(0, 1, 2, 3)),
+        _MM_SHUFFLE(0, 1, 2, 3)
+    );
+}
+
+/**
+ *  Count the trailing zero bits.
+ *
+ *  @param value
+ *      The value (must not be 0).
+ *  @return
+ *      The count of trailing zero bits.
+ */
+static inline unsigned int kernel_ctz(const unsigned int value) noexcept {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return static_cast<unsigned int>(index);
+#else
+    return static_cast<unsigned int>(__builtin_ctz(value));
+#endif
+}
+
+#endif  //  #if defined(XAP_CORE_BUFFER_SIMD_SSE2)
+
+#if defined(XAP_CORE_BUFFER_SIMD_AVX2)
+
+/**
+ *  Get the byte shuffle mask which reverses the bytes of 'width'-byte lanes.
+ *
+ *  @param width
+ *      The width of lanes (2, 4 or 8).
+ *  @return
+ *      The shuffle mask.
+ */
+static inline __m256i kernel_avx2_swap_mask(const int width) noexcept {
+    char mask[32];
+    for (int i = 0; i < 32; ++i) {
+        //  Shuffle indices are relative to each 128-bit half.
+        const int base = (i & 15) - ((i & 15) % width);
+        mask[i] = static_cast<char>(base + (width - 1) - ((i & 15) % width));
+    }
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mask));
+}
+
+#endif  //  #if defined(XAP_CORE_BUFFER_SIMD_AVX2)
+
+//
+//  Public functions.
+//
+
+/**
+ *  Reverse the byte order of 16-bit words in place.
+ *
+ *  @param data
+ *      The memory.
+ *  @param count
+ *      The count of words.
+ */
+void kernel_swap16(uint8_t *data, const size_t count) noexcept {
+    size_t i = 0U;
+#if defined(XAP_CORE_BUFFER_SIMD_AVX2)
+    const __m256i mask = kernel_avx2_swap_mask(2);
+    for (; i + 16U <= count; i += 16U) {
+        __m256i *cursor = reinterpret_cast<__m256i*>(data + i * 2U);
+        _mm256_storeu_si256(
+            cursor,
+            _mm256_shuffle_epi8(_mm256_loadu_si256(cursor), mask)
+        );
+    }
+#endif
+#if defined(XAP_CORE_BUFFER_SIMD_SSE2)
+    for (; i + 8U <= count; i += 8U) {
+        __m128i *cursor = reinterpret_cast<__m128i*>(data + i * 2U);
+        _mm_storeu_si128(cursor, kernel_sse2_swap16(_mm_loadu_si128(cursor)));
+    }
+#elif defined(XAP_CORE_BUFFER_SIMD_NEON)
+    for (; i + 8U <= count; i += 8U) {
+        uint8_t *cursor = data + i * 2U;
+        vst1q_u8(cursor, vrev16q_u8(vld1q_u8(cursor)));
+    }
+#endif
+    for (; i < count; ++i) {
+        uint8_t *cursor = data + i * 2U;
+        endian_write_uint16_be(cursor, endian_read_uint16_le(cursor));
+    }
+}
+
+/**
+ *  Reverse the byte order of 32-bit words in place.
+ *
+ *  @param data
+ *      The memory.
+ *  @param count
+ *      The count of words.
+ */
+void kernel_swap32(uint8_t *data, const size_t count) noexcept {
+    size_t i = 0U;
+#if defined(XAP_CORE_BUFFER_SIMD_AVX2)
+    const __m256i mask = kernel_avx2_swap_mask(4);
+    for (; i + 8U <= count; i += 8U) {
+        __m256i *cursor = reinterpret_cast<__m256i*>(data + i * 4U);
+        _mm256_storeu_si256(
+            cursor,
+            _mm256_shuffle_epi8(_mm256_loadu_si256(cursor), mask)
+        );
+    }
+#endif
+#if defined(XAP_CORE_BUFFER_SIMD_SSE2)
+    for (; i + 4U <= count; i += 4U) {
+        __m128i *cursor = reinterpret_cast<__m128i*>(data + i * 4U);
+        _mm_storeu_si128(cursor, kernel_sse2_swap32(_mm_loadu_si128(cursor)));
+    }
+#elif defined(XAP_CORE_BUFFER_SIMD_NEON)
+    for (; i + 4U <= count; i += 4U) {
+        uint8_t *cursor = data + i * 4U;
+        vst1q_u8(cursor, vrev32q_u8(vld1q_u8(cursor)));
+    }
+#endif
+    for (; i < count; ++i) {
+        uint8_t *cursor = data + i * 4U;
+        endian_write_uint32_be(cursor, endian_read_uint32_le(cursor));
+    }
+}
+
+/**
+ *  Reverse the byte order of 64-bit words in place.
+ *
+ *  @param data
+ *      The memory.
+ *  @param count
+ *      The count of words.
+ */
+void kernel_swap64(uint8_t *data, const size_t count) noexcept {
+    size_t i = 0U;
+#if defined(XAP_CORE_BUFFER_SIMD_AVX2)
+    const __m256i mask = kernel_avx2_swap_mask(8);
+    for (; i + 4U <= count; i += 4U) {
+        __m256i *cursor = reinterpret_cast<__m256i*>(data + i * 8U);
+        _mm256_storeu_si256(
+            cursor,
+            _mm256_shuffle_epi8(_mm256_loadu_si256(cursor), mask)
+        );
+    }
+#endif
+#if defined(XAP_CORE_BUFFER_SIMD_SSE2)
+    for (; i + 2U <= count; i += 2U) {
+        __m128i *cursor = reinterpret_cast<__m128i*>(data + i * 8U);
+        _mm_storeu_si128(cursor, kernel_sse2_swap64(_mm_loadu_si128(cursor)));
+    }
+#elif defined(XAP_CORE_BUFFER_SIMD_NEON)
+    for (; i + 2U <= count; i += 2U) {
+        uint8_t *cursor = data + i * 8U;
+        vst1q_u8(cursor, vrev64q_u8(vld1q_u8(cursor)));
+    }
+#endif
+    for (; i < count; ++i) {
+        uint8_t *cursor = data + i * 8U;
+        const uint32_t first = endian_read_uint32_le(cursor);
+        const uint32_t second = endian_read_uint32_le(cursor + 4U);
+        endian_write_uint32_be(cursor, second);
+        endian_write_uint32_be(cursor + 4U, first);
+    }
+}
+
+/**
+ *  Convert signed 16-bit samples to float samples in [-1.0, 1.0).
+ *
+ *  @param src
+ *      The samples.
+ *  @param dst
+ *      The float samples.
+ *  @param count
+ *      The count of samples.
+ *  @param isle
+ *      True if the samples are with little-endian.
+ */
+void kernel_sint16_to_float(
+    const uint8_t   *src,
+    float           *dst,
+    const size_t    count,
+    const bool      isle
+) noexcept {
+    size_t i = 0U;
+#if defined(XAP_CORE_BUFFER_SIMD_AVX2)
+    {
+        const __m256i mask = kernel_avx2_swap_mask(2);
+        const __m256 scale = _mm256_set1_ps(KERNEL_SCALE_SINT16);
+        for (; i + 16U <= count; i += 16U) {
+            __m256i value = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(src + i * 2U)
+            );
+            if (!isle) {
+                value = _mm256_shuffle_epi8(value, mask);
+            }
+            const __m256i low = _mm256_cvtepi16_epi32(
+                _mm256_castsi256_si128(value)
+            );
+            const __m256i high = _mm256_cvtepi16_epi32(
+                _mm256_extracti128_si256(value, 1)
+            );
+            _mm256_storeu_ps(
+                dst + i,
+                _mm256_mul_ps(_mm256_cvtepi32_ps(low), scale)
+            );
+            _mm256_storeu_ps(
+                dst + i + 8U,
+                _mm256_mul_ps(_mm256_cvtepi32_ps(high), scale)
+            );
+        }
+    }
+#endif
+#if defined(XAP_CORE_BUFFER_SIMD_SSE2)
+    {
+        const __m128 scale = _mm_set1_ps(KERNEL_SCALE_SINT16);
+        for (; i + 8U <= count; i += 8U) {
+            __m128i value = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(src + i * 2U)
+            );
+            if (!isle) {
+                value = kernel_sse2_swap16(value);
+            }
+
+            //  Sign-extend by placing each sample in the upper half of a
+            //  32-bit lane and shifting it back arithmetically.
+            const __m128i low = _mm_srai_epi32(
+                _mm_unpacklo_epi16(value, value),
+                16
+            );
+            const __m128i high = _mm_srai_epi32(
+                _mm_unpackhi_epi16(value, value),
+                16
+            );
+            _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+            _mm_storeu_ps(
+                dst + i + 4U,
+                _mm_mul_ps(_mm_cvtepi32_ps(high), scale)
+            );
+        }
+    }
+#elif defined(XAP_CORE_BUFFER_SIMD_NEON)
+    for (; i + 8U <= count; i += 8U) {
+        uint8x16_t bytes = vld1q_u8(src + i * 2U);
+        if (!isle) {
+            bytes = vrev16q_u8(bytes);
+        }
+        const int16x8_t value = vreinterpretq_s16_u8(bytes);
+        const int32x4_t low = vmovl_s16(vget_low_s16(value));
+        const int32x4_t high = vmovl_s16(vget_high_s16(value));
+        vst1q_f32(
+            dst + i,
+            vmulq_n_f32(vcvtq_f32_s32(low), KERNEL_SCALE_SINT16)
+        );
+        vst1q_f32(
+            dst + i + 4U,
+            vmulq_n_f32(vcvtq_f32_s32(high), KERNEL_SCALE_SINT16)
+        );
+    }
+#endif
+    for (; i < count; ++i) {
+        const uint8_t *cursor = src + i * 2U;
+        const int16_t value = static_cast<int16_t>(
+            isle ? endian_read_uint16_le(cursor) : endian_read_uint16_be(cursor)
+        );
+        dst[i] = static_cast<float>(value) * KERNEL_SCALE_SINT16;
+    }
+}
+
+/**
+ *  Convert signed 24-bit samples to float samples in [-1.0, 1.0).
+ *
+ *  @param src
+ *      The samples.
+ *  @param dst
+ *      The float samples.
+ *  @param count
+ *      The count of samples.
+ *  @param isle
+ *      True if the samples are with little-endian.
+ */
+void kernel_sint24_to_float(
+    const uint8_t   *src,
+    float           *dst,
+    const size_t    count,
+    const bool      isle
+) noexcept {
+    //  Packed 24-bit samples need a byte shuffle (not available in SSE2),
+    //  so this loop is left to the auto-vectorizer.
+    for (size_t i = 0U; i < count; ++i) {
+        const uint8_t *cursor = src + i * 3U;
+        uint32_t value;
+        if (isle) {
+            value = (static_cast<uint32_t>(cursor[2U]) << 24U) |
+                    (static_cast<uint32_t>(cursor[1U]) << 16U) |
+                    (static_cast<uint32_t>(cursor[0U]) <<  8U);
+        } else {
+            value = (static_cast<uint32_t>(cursor[0U]) << 24U) |
+                    (static_cast<uint32_t>(cursor[1U]) << 16U) |
+                    (static_cast<uint32_t>(cursor[2U]) <<  8U);
+        }
+
+        //  Sign-extend from bit 23 by the arithmetic shift.
+        dst[i] = static_cast<float>(static_cast<int32_t>(value) >> 8) *
+                 KERNEL_SCALE_SINT24;
+    }
+}
+
+/**
+ *  Convert signed 32-bit samples to float samples in [-1.0, 1.0].
+ *
+ *  @param src
+ *      The samples.
+ *  @param dst
+ *      The float samples.
+ *  @param count
+ *      The count of samples.
+ *  @param isle
+ *      True if the samples are with little-endian.
+ */
+void kernel_sint32_to_float(
+    const uint8_t   *src,
+    float           *dst,
+    const size_t    count,
+    const bool      isle
+) noexcept {
+    size_t i = 0U;
+#if defined(XAP_CORE_BUFFER_SIMD_AVX2)
+    {
+        const __m256i mask = kernel_avx2_swap_mask(4);
+        const __m256 scale = _mm256_set1_ps(KERNEL_SCALE_SINT32);
+        for (; i + 8U <= count; i += 8U) {
+            __m256i value = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(src + i * 4U)
+            );
+            if (!isle) {
+                value = _mm256_shuffle_epi8(value, mask);
+            }
+            _mm256_storeu_ps(
+                dst + i,
+                _mm256_mul_ps(_mm256_cvtepi32_ps(value), scale)
+            );
+        }
+    }
+#endif
+#if defined(XAP_CORE_BUFFER_SIMD_SSE2)
+    {
+        const __m128 scale = _mm_set1_ps(KERNEL_SCALE_SINT32);
+        for (; i + 4U <= count; i += 4U) {
+            __m128i value = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(src + i * 4U)
+            );
+            if (!isle) {
+                value = kernel_sse2_swap32(value);
+            }
+            _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(value), scale));
+        }
+    }
+#elif defined(XAP_CORE_BUFFER_SIMD_NEON)
+    for (; i + 4U <= count; i += 4U) {
+        uint8x16_t bytes = vld1q_u8(src + i * 4U);
+        if (!isle) {
+            bytes = vrev32q_u8(bytes);
+        }
+        vst1q_f32(
+            dst + i,
+            vmulq_n_f32(
+                vcvtq_f32_s32(vreinterpretq_s32_u8(bytes)),
+                KERNEL_SCALE_SINT32
+            )
+        );
+    }
+#endif
+    for (; i < count; ++i) {
+        const uint8_t *cursor = src + i * 4U;
+        const int32_t value = static_cast<int32_t>(
+            isle ? endian_read_uint32_le(cursor) : endian_read_uint32_be(cursor)
+        );
+        dst[i] = static_cast<float>(value) * KERNEL_SCALE_SINT32;
+    }
+}
+
+/**
+ *  Convert float samples to signed 16-bit samples (rounded to nearest and
+ *  saturated, NaN becomes -32768).
+ *
+ *  @param src
+ *      The float samples.
+ *  @param dst
+ *      The samples.
+ *  @param count
+ *      The count of samples.
+ *  @param isle
+ *      True if the samples are with little-endian.
+ */
+void kernel_float_to_sint16(
+    const float     *src,
+    uint8_t         *dst,
+    const size_t    count,
+    const bool      isle
+) noexcept {
+    size_t i = 0U;
+#if defined(XAP_CORE_BUFFER_SIMD_SSE2)
+    {
+        const __m128 scale = _mm_set1_ps(32768.0f);
+        const __m128 lower = _mm_set1_ps(KERNEL_SINT16_MIN);
+        const __m128 upper = _mm_set1_ps(KERNEL_SINT16_MAX);
+        for (; i + 8U <= count; i += 8U) {
+            //  _mm_max_ps() returns the second operand if either one is NaN.
+            __m128 low = _mm_mul_ps(_mm_loadu_ps(src + i), scale);
+            __m128 high = _mm_mul_ps(_mm_loadu_ps(src + i + 4U), scale);
+            low = _mm_min_ps(_mm_max_ps(low, lower), upper);
+            high = _mm_min_ps(_mm_max_ps(high, lower), upper);
+            __m128i value = _mm_packs_epi32(
+                _mm_cvtps_epi32(low),
+                _mm_cvtps_epi32(high)
+            );
+            if (!isle) {
+                value = kernel_sse2_swap16(value);
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2U), value);
+        }
+    }
+#elif defined(XAP_CORE_BUFFER_SIMD_NEON) && \
+      (defined(__aarch64__) || defined(_M_ARM64))
+    {
+        const float32x4_t lower = vdupq_n_f32(KERNEL_SINT16_MIN);
+        const float32x4_t upper = vdupq_n_f32(KERNEL_SINT16_MAX);
+        for (; i + 8U <= count; i += 8U) {
+            //  vmaxnmq_f32() returns the number if either one is NaN.
+            float32x4_t low = vmulq_n_f32(vld1q_f32(src + i), 32768.0f);
+            float32x4_t high = vmulq_n_f32(vld1q_f32(src + i + 4U), 32768.0f);
+            low = vminnmq_f32(vmaxnmq_f32(low, lower), upper);
+            high = vminnmq_f32(vmaxnmq_f32(high, lower), upper);
+            const int16x8_t value = vcombine_s16(
+                vqmovn_s32(vcvtnq_s32_f32(low)),
+                vqmovn_s32(vcvtnq_s32_f32(high))
+            );
+            uint8x16_t bytes = vreinterpretq_u8_s16(value);
+            if (!isle) {
+                bytes = vrev16q_u8(bytes);
+            }
+            vst1q_u8(dst + i * 2U, bytes);
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        float value = src[i] * 32768.0f;
+        if (!(value >= KERNEL_SINT16_MIN)) {
+            value = KERNEL_SINT16_MIN;
+        } else if (value > KERNEL_SINT16_MAX) {
+            value = KERNEL_SINT16_MAX;
+        }
+        const uint16_t sample = static_cast<uint16_t>(
+            static_cast<int16_t>(std::lrint(value))
+        );
+        if (isle) {
+            endian_write_uint16_le(dst + i * 2U, sample);
+        } else {
+            endian_write_uint16_be(dst + i * 2U, sample);
+        }
+    }
+}
+
+/**
+ *  Find the first occurrence of a byte sequence.
+ *
+ *  @param haystack
+ *      The memory to search.
+ *  @param haystack_len
+ *      The length of the memory.
+ *  @param needle
+ *      The byte sequence.
+ *  @param needle_len
+ *      The length of the byte sequence (must be at least 2 and not greater
+ *      than 'haystack_len').
+ *  @return
+ *      The offset of the occurrence (SIZE_MAX if not found).
+ */
+size_t kernel_find(
+    const uint8_t   *haystack,
+    const size_t    haystack_len,
+    const uint8_t   *needle,
+    const size_t    needle_len
+) noexcept {
+    //  Candidates must match both the first and the last byte of the needle,
+    //  only those are verified with memcmp().
+    const size_t last = needle_len - 1U;
+    const size_t limit = haystack_len - last;
+    size_t i = 0U;
+#if defined(XAP_CORE_BUFFER_SIMD_SSE2)
+    {
+        const __m128i first_byte = _mm_set1_epi8(
+            static_cast<char>(needle[0U])
+        );
+        const __m128i last_byte = _mm_set1_epi8(
+            static_cast<char>(needle[last])
+        );
+        for (; i + 16U <= limit; i += 16U) {
+            const __m128i head = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(haystack + i)
+            );
+            const __m128i tail = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(haystack + i + last)
+            );
+            unsigned int mask = static_cast<unsigned int>(
+                _mm_movemask_epi8(
+                    _mm_and_si128(
+                        _mm_cmpeq_epi8(head, first_byte),
+                        _mm_cmpeq_epi8(tail, last_byte)
+                    )
+                )
+            );
+            while (mask != 0U) {
+                const size_t position = i + kernel_ctz(mask);
+                if (memcmp(
+                    haystack + position + 1U, 
+                    needle + 1U, 
+                    needle_len - 2U
+                ) == 0) {
+                    return position;
+                }
+                mask &= mask - 1U;
+            }
+        }
+    }
+#endif
+    while (i < limit) {
+        const uint8_t *found = static_cast<const uint8_t*>(
+            memchr(haystack + i, needle[0U], limit - i)
+        );
+        if (found == nullptr) {
+            break;
+        }
+        i = static_cast<size_t>(found - haystack);
+        if (haystack[i + last] == needle[last] && 
+            memcmp(haystack + i + 1U, needle + 1U, needle_len - 2U) == 0) {
+            return i;
+        }
+        ++i;
+    }
+    return SIZE_MAX;
+}
+
+/**
+ *  Copy memory with non-temporal stores (bypassing the caches, falls back
+ *  to memcpy() if not supported by the target).
+ *
+ *  @note
+ *      The stores are fenced before return, so that they are ordered like
+ *      regular stores for the other threads.
+ *  @param dst
+ *      The destination memory (must not overlap 'src').
+ *  @param src
+ *      The source memory.
+ *  @param length
+ *      The count of bytes.
+ */
+void kernel_copy_stream(
+    uint8_t         *dst,
+    const uint8_t   *src,
+    const size_t    length
+) noexcept {
+    size_t i = 0U;
+#if defined(XAP_CORE_BUFFER_SIMD_SSE2)
+    //  Align the destination (the streaming stores need 16-byte alignment).
+    size_t head = (16U - (reinterpret_cast<uintptr_t>(dst) & 15U)) & 15U;
+    if (head > length) {
+        head = length;
+    }
+    memcpy(dst, src, head);
+    i = head;
+    for (; i + 64U <= length; i += 64U) {
+        const __m128i *from = reinterpret_cast<const __m128i*>(src + i);
+        __m128i *to = reinterpret_cast<__m128i*>(dst + i);
+        const __m128i v0 = _mm_loadu_si128(from);
+        const __m128i v1 = _mm_loadu_si128(from + 1);
+        const __m128i v2 = _mm_loadu_si128(from + 2);
+        const __m128i v3 = _mm_loadu_si128(from + 3);
+        _mm_stream_si128(to, v0);
+        _mm_stream_si128(to + 1, v1);
+        _mm_stream_si128(to + 2, v2);
+        _mm_stream_si128(to + 3, v3);
+    }
+    _mm_sfence();
+#endif
+    memcpy(dst + i, src + i, length - i);
+}
+
+/**
+ *  Fill memory with non-temporal stores (bypassing the caches, falls back
+ *  to memset() if not supported by the target).
+ *
+ *  @note
+ *      The stores are fenced before return, so that they are ordered like
+ *      regular stores for the other threads.
+ *  @param dst
+ *      The memory.
+ *  @param value
+ *      The value.
+ *  @param length
+ *      The count of bytes.
+ */
+void kernel_fill_stream(
+    uint8_t         *dst,
+    const uint8_t   value,
+    const size_t    length
+) noexcept {
+    size_t i = 0U;
+#if defined(XAP_CORE_BUFFER_SIMD_SSE2)
+    size_t head = (16U - (reinterpret_cast<uintptr_t>(dst) & 15U)) & 15U;
+    if (head > length) {
+        head = length;
+    }
+    memset(dst, value, head);
+    i = head;
+    const __m128i pattern = _mm_set1_epi8(static_cast<char>(value));
+    for (; i + 64U <= length; i += 64U) {
+        __m128i *to = reinterpret_cast<__m128i*>(dst + i);
+        _mm_stream_si128(to, pattern);
+        _mm_stream_si128(to + 1, pattern);
+        _mm_stream_si128(to + 2, pattern);
+        _mm_stream_si128(to + 3, pattern);
+    }
+    _mm_sfence();
+#endif
+    memset(dst + i, value, length - i);
+}
+
+#if defined(UINT64_MAX)
+
+/**
+ *  Decode an unsigned integer with variable-length (LEB128) encoding.
+ *
+ *  @param data
+ *      The memory.
+ *  @param datalen
+ *      The length of the memory.
+ *  @param value
+ *      The pointer to receive the integer.
+ *  @return
+ *      The count of bytes decoded (0 if the encoding is truncated or 
+ *      longer than 64 bits).
+ */
+size_t kernel_decode_varint(
+    const uint8_t   *data,
+    const size_t    datalen,
+    uint64_t        *value
+) noexcept {
+    uint64_t decoded = 0U;
+    const size_t limit = std::min<size_t>(datalen, 10U);
+    for (size_t i = 0U; i < limit; ++i) {
+        const uint8_t byte = data[i];
+        if (i == 9U && byte > 0x01U) {
+            //  More than 64 bits.
+            return 0U;
+        }
+        decoded |= static_cast<uint64_t>(byte & 0x7FU) << (7U * i);
+        if ((byte & 0x80U) == 0U) {
+            *value = decoded;
+            return i + 1U;
+        }
+    }
+    return 0U;
+}
+
+#endif  //  #if defined(UINT64_MAX)
+
+}  //  namespace buffer
+}  //  namespace core
+}  //  namespace xap
@@ -0,0 +1,224 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+#ifndef XAP_CORE_BUFFER_KERNEL_H__
+#define XAP_CORE_BUFFER_KERNEL_H__
+
+//
+//  Imports.
+//
+#include <stddef.h>
+#include <stdint.h>
+
+namespace xap {
+namespace core {
+namespace buffer {
+
+//
+//  Private functions (bulk kernels, vectorized when the target supports it).
+//
+//  These functions don't check the memory range, the caller must guarantee
+//  that the bytes are accessible.
+//
+
+/**
+ *  Reverse the byte order of 16-bit words in place.
+ *
+ *  @param data
+ *      The memory.
+ *  @param count
+ *      The count of words.
+ */
+void kernel_swap16(uint8_t *data, const size_t count) noexcept;
+
+/**
+ *  Reverse the byte order of 32-bit words in place.
+ *
+ *  @param data
+ *      The memory.
+ *  @param count
+ *      The count of words.
+ */
+void kernel_swap32(uint8_t *data, const size_t count) noexcept;
+
+/**
+ *  Reverse the byte order of 64-bit words in place.
+ *
+ *  @param data
+ *      The memory.
+ *  @param count
+ *      The count of words.
+ */
+void kernel_swap64(uint8_t *data, const size_t count) noexcept;
+
+/**
+ *  Convert signed 16-bit samples to float samples in [-1.0, 1.0).
+ *
+ *  @param src
+ *      The samples.
+ *  @param dst
+ *      The float samples.
+ *  @param count
+ *      The count of samples.
+ *  @param isle
+ *      True if the samples are with little-endian.
+ */
+void kernel_sint16_to_float(
+    const uint8_t   *src,
+    float           *dst,
+    const size_t    count,
+    const bool      isle
+) noexcept;
+
+/**
+ *  Convert signed 24-bit samples to float samples in [-1.0, 1.0).
+ *
+ *  @param src
+ *      The samples.
+ *  @param dst
+ *      The float samples.
+ *  @param count
+ *      The count of samples.
+ *  @param isle
+ *      True if the samples are with little-endian.
+ */
+void kernel_sint24_to_float(
+    const uint8_t   *src,
+    float           *dst,
+    const size_t    count,
+    const bool      isle
+) noexcept;
+
+/**
+ *  Convert signed 32-bit samples to float samples in [-1.0, 1.0].
+ *
+ *  @param src
+ *      The samples.
+ *  @param dst
+ *      The float samples.
+ *  @param count
+ *      The count of samples.
+ *  @param isle
+ *      True if the samples are with little-endian.
+ */
+void kernel_sint32_to_float(
+    const uint8_t   *src,
+    float           *dst,
+    const size_t    count,
+    const bool      isle
+) noexcept;
+
+/**
+ *  Convert float samples to signed 16-bit samples (rounded to nearest and
+ *  saturated, NaN becomes -32768).
+ *
+ *  @param src
+ *      The float samples.
+ *  @param dst
+ *      The samples.
+ *  @param count
+ *      The count of samples.
+ *  @param isle
+ *      True if the samples are with little-endian.
+ */
+void kernel_float_to_sint16(
+    const float     *src,
+    uint8_t         *dst,
+    const size_t    count,
+    const bool      isle
+) noexcept;
+
+/**
+ *  Find the first occurrence of a byte sequence.
+ *
+ *  @param haystack
+ *      The memory to search.
+ *  @param haystack_len
+ *      The length of the memory.
+ *  @param needle
+ *      The byte sequence.
+ *  @param needle_len
+ *      The length of the byte sequence (must be at least 2 and not greater
+ *      than 'haystack_len').
+ *  @return
+ *      The offset of the occurrence (SIZE_MAX if not found).
+ */
+size_t kernel_find(
+    const uint8_t   *haystack,
+    const size_t    haystack_len,
+    const uint8_t   *needle,
+    const size_t    needle_len
+) noexcept;
+
+/**
+ *  Copy memory with non-temporal stores (bypassing the caches, falls back
+ *  to memcpy() if not supported by the target).
+ *
+ *  @note
+ *      The stores are fenced before return, so that they are ordered like
+ *      regular stores for the other threads.
+ *  @param dst
+ *      The destination memory (must not overlap 'src').
+ *  @param src
+ *      The source memory.
+ *  @param length
+ *      The count of bytes.
+ */
+void kernel_copy_stream(
+    uint8_t         *dst,
+    const uint8_t   *src,
+    const size_t    length
+) noexcept;
+
+/**
+ *  Fill memory with non-temporal stores (bypassing the caches, falls back
+ *  to memset() if not supported by the target).
+ *
+ *  @note
+ *      The stores are fenced before return, so that they are ordered like
+ *      regular stores for the other threads.
+ *  @param dst
+ *      The memory.
+ *  @param value
+ *      The value.
+ *  @param length
+ *      The count of bytes.
+ */
+void kernel_fill_stream(
+    uint8_t         *dst,
+    const uint8_t   value,
+    const size_t    length
+) noexcept;
+
+#if defined(UINT64_MAX)
+
+/**
+ *  Decode an unsigned integer with variable-length (LEB128) encoding.
+ *
+ *  @param data
+ *      The memory.
+ *  @param datalen
+ *      The length of the memory.
+ *  @param value
+ *      The pointer to receive the integer.
+ *  @return
+ *      The count of bytes decoded (0 if the encoding is truncated or 
+ *      longer than 64 bits).
+ */
+size_t kernel_decode_varint(
+    const uint8_t   *data,
+    const size_t    datalen,
+    uint64_t        *value
+) noexcept;
+
+#endif  //  #if defined(UINT64_MAX)
+
+}  //  namespace buffer
+}  //  namespace core
+}  //  namespace xap
+
+
+#endif  //  #ifndef XAP_CORE_BUFFER_KERNEL_H__
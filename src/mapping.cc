@@ -0,0 +1,333 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+//
+//  Imports.
+//
+#include <xap/core/buffer/build.h>
+#include <xap/core/buffer/buffer.h>
+#include <xap/core/buffer/error.h>
+#include <memory>
+#include <utility>
+
+#if defined(XAP_CORE_BUFFER_OS_WIN)
+# include <windows.h>
+#elif defined(XAP_CORE_BUFFER_OS_POSIX)
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <sys/types.h>
+# include <unistd.h>
+#endif
+
+namespace xap {
+namespace core {
+namespace buffer {
+
+//
+//  Private structures.
+//
+
+//
+//  Deleter which releases a file mapping (used by std::shared_ptr).
+//
+struct BufferFileUnmapper {
+    //  The length of the mapping (from the page-aligned base).
+    size_t  length;
+
+    /**
+     *  Release the mapping.
+     *
+     *  @param base
+     *      The page-aligned base of the mapping.
+     */
+    void operator()(uint8_t *base) const noexcept {
+#if defined(XAP_CORE_BUFFER_OS_WIN)
+        (void)this->length;
+        UnmapViewOfFile(base);
+#elif defined(XAP_CORE_BUFFER_OS_POSIX)
+        munmap(base, this->length);
+#else
+        (void)base;
+#endif
+    }
+};
+
+//
+//  Private functions declare.
+//
+
+/**
+ *  Get the length of the range to map.
+ *
+ *  @throw BufferException
+ *      Raised if 'offset' or 'length' is out of the file
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param file_size
+ *      The size of the file.
+ *  @param offset
+ *      The offset of the range in the file.
+ *  @param length
+ *      The length of the range (Buffer::NPOS until the end of the file).
+ *  @return
+ *      The length of the range.
+ */
+static size_t mapping_get_range_length(
+    const uint64_t  file_size,
+    const uint64_t  offset,
+    const size_t    length
+);
+
+//
+//  Static functions.
+//
+
+/**
+ *  Map a range of a file into a new buffer (without copying it onto the
+ *  heap).
+ *
+ *  @note
+ *      The mapping is private (copy-on-write): the buffer may be
+ *      written, but the changes are never written back to the file.
+ *      The mapping is released when the last buffer (or slice) which
+ *      references it is destroyed. The file must not be truncated
+ *      while it is mapped.
+ *  @throw BufferException
+ *      Raised if 'offset' or 'length' is out of the file
+ *      (XAPCORE_BUF_ERROR_OVERFLOW), or failed to open or map the file
+ *      (XAPCORE_BUF_ERROR_IO).
+ *  @param path
+ *      The path of the file.
+ *  @param offset
+ *      The offset of the range in the file.
+ *  @param length
+ *      The length of the range (NPOS to map until the end of the file).
+ *  @param hint
+ *      The access pattern hint.
+ *  @return
+ *      The new buffer.
+ */
+Buffer Buffer::map_file(
+    const char          *path,
+    const uint64_t      offset,
+    const size_t        length,
+    const BufferMapHint hint
+) {
+#if defined(XAP_CORE_BUFFER_OS_WIN)
+
+    DWORD flags = FILE_ATTRIBUTE_NORMAL;
+    if (hint == BUFFER_MAP_SEQUENTIAL) {
+        flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+    } else if (hint == BUFFER_MAP_RANDOM) {
+        flags |= FILE_FLAG_RANDOM_ACCESS;
+    }
+    HANDLE file = CreateFileA(
+        path,
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        flags,
+        nullptr
+    );
+    if (file == INVALID_HANDLE_VALUE) {
+        throw BufferException("Failed to open file.", XAPCORE_BUF_ERROR_IO);
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size)) {
+        CloseHandle(file);
+        throw BufferException("Failed to open file.", XAPCORE_BUF_ERROR_IO);
+    }
+    size_t range_len;
+    try {
+        range_len = mapping_get_range_length(
+            static_cast<uint64_t>(file_size.QuadPart),
+            offset,
+            length
+        );
+    } catch (...) {
+        CloseHandle(file);
+        throw;
+    }
+    if (range_len == 0U) {
+        CloseHandle(file);
+        return Buffer(0U);
+    }
+
+    //  Views must begin at the allocation granularity.
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    const uint64_t granularity = info.dwAllocationGranularity;
+    const uint64_t base_offset = offset & ~(granularity - 1U);
+    const size_t delta = static_cast<size_t>(offset - base_offset);
+    if (range_len > SIZE_MAX - delta) {
+        CloseHandle(file);
+        throw BufferException("Length overflowed.", XAPCORE_BUF_ERROR_OVERFLOW);
+    }
+
+    HANDLE mapping = CreateFileMappingA(
+        file,
+        nullptr,
+        PAGE_WRITECOPY,
+        0,
+        0,
+        nullptr
+    );
+    CloseHandle(file);
+    if (mapping == nullptr) {
+        throw BufferException("Failed to map file.", XAPCORE_BUF_ERROR_IO);
+    }
+    void *base = MapViewOfFile(
+        mapping,
+        FILE_MAP_COPY,
+        static_cast<DWORD>(base_offset >> 32U),
+        static_cast<DWORD>(base_offset & 0xFFFFFFFFU),
+        range_len + delta
+    );
+    CloseHandle(mapping);
+    if (base == nullptr) {
+        throw BufferException("Failed to map file.", XAPCORE_BUF_ERROR_IO);
+    }
+    const size_t mapping_len = range_len + delta;
+
+#elif defined(XAP_CORE_BUFFER_OS_POSIX)
+
+    int flags = O_RDONLY;
+#if defined(O_CLOEXEC)
+    flags |= O_CLOEXEC;
+#endif
+    const int fd = open(path, flags);
+    if (fd < 0) {
+        throw BufferException("Failed to open file.", XAPCORE_BUF_ERROR_IO);
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0) {
+        close(fd);
+        throw BufferException("Failed to open file.", XAPCORE_BUF_ERROR_IO);
+    }
+    size_t range_len;
+    try {
+        range_len = mapping_get_range_length(
+            static_cast<uint64_t>(file_stat.st_size),
+            offset,
+            length
+        );
+    } catch (...) {
+        close(fd);
+        throw;
+    }
+    if (range_len == 0U) {
+        close(fd);
+        return Buffer(0U);
+    }
+
+    //  Mappings must begin at the page boundary.
+    const uint64_t page_size = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    const uint64_t base_offset = offset & ~(page_size - 1U);
+    const size_t delta = static_cast<size_t>(offset - base_offset);
+    if (range_len > SIZE_MAX - delta) {
+        close(fd);
+        throw BufferException("Length overflowed.", XAPCORE_BUF_ERROR_OVERFLOW);
+    }
+    const size_t mapping_len = range_len + delta;
+
+    void *base = mmap(
+        nullptr,
+        mapping_len,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE,
+        fd,
+        static_cast<off_t>(base_offset)
+    );
+    close(fd);
+    if (base == MAP_FAILED) {
+        throw BufferException("Failed to map file.", XAPCORE_BUF_ERROR_IO);
+    }
+
+    //  The hint is advisory, ignore the failure.
+    if (hint == BUFFER_MAP_SEQUENTIAL) {
+        posix_madvise(base, mapping_len, POSIX_MADV_SEQUENTIAL);
+    } else if (hint == BUFFER_MAP_RANDOM) {
+        posix_madvise(base, mapping_len, POSIX_MADV_RANDOM);
+    }
+
+#else
+
+    (void)path;
+    (void)offset;
+    (void)length;
+    (void)hint;
+    throw BufferException(
+        "File mapping is not supported.",
+        XAPCORE_BUF_ERROR_IO
+    );
+
+#endif
+
+#if defined(XAP_CORE_BUFFER_OS_WIN) || defined(XAP_CORE_BUFFER_OS_POSIX)
+    //  The deleter is called if the control block can't be allocated.
+    std::shared_ptr<uint8_t> owner(
+        static_cast<uint8_t*>(base),
+        BufferFileUnmapper{mapping_len}
+    );
+
+    //  Share the ownership of the mapping, but point to the range.
+    return Buffer(
+        std::shared_ptr<uint8_t>(owner, static_cast<uint8_t*>(base) + delta),
+        range_len
+    );
+#endif
+}
+
+//
+//  Private functions.
+//
+
+/**
+ *  Get the length of the range to map.
+ *
+ *  @throw BufferException
+ *      Raised if 'offset' or 'length' is out of the file
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param file_size
+ *      The size of the file.
+ *  @param offset
+ *      The offset of the range in the file.
+ *  @param length
+ *      The length of the range (Buffer::NPOS until the end of the file).
+ *  @return
+ *      The length of the range.
+ */
+static size_t mapping_get_range_length(
+    const uint64_t  file_size,
+    const uint64_t  offset,
+    const size_t    length
+) {
+    if (offset > file_size) {
+        throw BufferException("Offset overflowed.", XAPCORE_BUF_ERROR_OVERFLOW);
+    }
+
+    const uint64_t available = file_size - offset;
+    if (length == Buffer::NPOS) {
+        if (available > static_cast<uint64_t>(SIZE_MAX)) {
+            throw BufferException(
+                "Length overflowed.",
+                XAPCORE_BUF_ERROR_OVERFLOW
+            );
+        }
+        return static_cast<size_t>(available);
+    }
+    if (static_cast<uint64_t>(length) > available) {
+        throw BufferException("Length overflowed.", XAPCORE_BUF_ERROR_OVERFLOW);
+    }
+    return length;
+}
+
+}  //  namespace buffer
+}  //  namespace core
+}  //  namespace xap
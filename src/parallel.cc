@@ -0,0 +1,569 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+//
+//  Imports.
+//
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <string.h>
+#include <xap/core/buffer/error.h>
+#include <xap/core/buffer/parallel.h>
+#include "instrument.h"
+#include "kernel.h"
+
+namespace xap {
+namespace core {
+namespace buffer {
+
+//
+//  Private structures.
+//
+
+//
+//  Job of a thread pool (one run() call).
+//
+struct BufferThreadPool::Job {
+    //  The task callback and its context.
+    BufferTask              task;
+    void                   *context;
+
+    //  The count of tasks.
+    size_t                  count;
+
+    //  The index of the next task to claim.
+    std::atomic<size_t>     next;
+
+    //  The first exception thrown by the tasks (guarded by the pool lock).
+    std::exception_ptr      error;
+};
+
+//
+//  Range of bytes processed by one task.
+//
+struct ParallelPiece {
+    //  The destination (or the first buffer).
+    uint8_t                *dst;
+
+    //  The source (or the second buffer, nullptr for fills).
+    const uint8_t          *src;
+
+    //  The count of bytes.
+    size_t                  length;
+};
+
+//
+//  Context of parallel operations.
+//
+struct ParallelContext {
+    //  The pieces.
+    std::vector<ParallelPiece>  pieces;
+
+    //  Whether to use non-temporal stores.
+    bool                        stream;
+
+    //  The fill value.
+    uint8_t                     value;
+
+    //  Whether a difference was found (compare only).
+    std::atomic<bool>           different;
+
+    /**
+     *  Construct the object.
+     */
+    ParallelContext():
+        pieces(),
+        stream(false),
+        value(0U),
+        different(false)
+    {}
+};
+
+//
+//  Private functions.
+//
+
+/**
+ *  Split a range into pieces of BUFFER_PARALLEL_BLOCK_SIZE bytes.
+ *
+ *  @param context
+ *      The context which receives the pieces.
+ *  @param dst
+ *      The destination (or the first buffer).
+ *  @param src
+ *      The source (or the second buffer, nullptr for fills).
+ *  @param length
+ *      The count of bytes.
+ */
+static void parallel_split(
+    ParallelContext &context,
+    uint8_t         *dst,
+    const uint8_t   *src,
+    const size_t    length
+) {
+    for (size_t offset = 0U; offset < length;) {
+        const size_t block = std::min(
+            BUFFER_PARALLEL_BLOCK_SIZE,
+            length - offset
+        );
+        ParallelPiece piece;
+        piece.dst = dst + offset;
+        piece.src = (src != nullptr ? src + offset : nullptr);
+        piece.length = block;
+        context.pieces.push_back(piece);
+        offset += block;
+    }
+}
+
+/**
+ *  Copy one piece (task callback).
+ *
+ *  @param index
+ *      The index of the piece.
+ *  @param context
+ *      The context (ParallelContext).
+ */
+static void parallel_copy_task(const size_t index, void *context) {
+    const ParallelContext *ctx = static_cast<ParallelContext*>(context);
+    const ParallelPiece &piece = ctx->pieces[index];
+    if (ctx->stream) {
+        kernel_copy_stream(piece.dst, piece.src, piece.length);
+    } else {
+        memcpy(piece.dst, piece.src, piece.length);
+    }
+}
+
+/**
+ *  Fill one piece (task callback).
+ *
+ *  @param index
+ *      The index of the piece.
+ *  @param context
+ *      The context (ParallelContext).
+ */
+static void parallel_fill_task(const size_t index, void *context) {
+    const ParallelContext *ctx = static_cast<ParallelContext*>(context);
+    const ParallelPiece &piece = ctx->pieces[index];
+    if (ctx->stream) {
+        kernel_fill_stream(piece.dst, ctx->value, piece.length);
+    } else {
+        memset(piece.dst, ctx->value, piece.length);
+    }
+}
+
+/**
+ *  Compare one piece (task callback).
+ *
+ *  @param index
+ *      The index of the piece.
+ *  @param context
+ *      The context (ParallelContext).
+ */
+static void parallel_compare_task(const size_t index, void *context) {
+    ParallelContext *ctx = static_cast<ParallelContext*>(context);
+    if (ctx->different.load(std::memory_order_relaxed)) {
+        //  A difference was already found by another task.
+        return;
+    }
+    const ParallelPiece &piece = ctx->pieces[index];
+    if (memcmp(piece.dst, piece.src, piece.length) != 0) {
+        ctx->different.store(true, std::memory_order_relaxed);
+    }
+}
+
+/**
+ *  Detach a buffer before writing if it is in copy-on-write mode and its
+ *  storage is shared (like the Buffer write methods).
+ *
+ *  @throw std::bad_alloc
+ *      Raised if failed to allocate memory.
+ *  @param buffer
+ *      The buffer.
+ */
+static void parallel_prepare_write(Buffer &buffer) {
+    if (buffer.is_copy_on_write() && !buffer.is_unique()) {
+        buffer.detach();
+    }
+}
+
+//
+//  BufferExecutor destructor.
+//
+
+/**
+ *  Destruct the object.
+ */
+BufferExecutor::~BufferExecutor() noexcept {
+    //  Nothing.
+}
+
+//
+//  BufferThreadPool constructor & destructor.
+//
+
+/**
+ *  Construct the object.
+ *
+ *  @throw std::system_error
+ *      Raised if failed to create the threads.
+ *  @param thread_count
+ *      The count of threads (SIZE_MAX to use the hardware concurrency minus
+ *      1, 0 to run all tasks on the calling thread).
+ */
+BufferThreadPool::BufferThreadPool(const size_t thread_count):
+    m_threads(),
+    m_run_lock(),
+    m_lock(),
+    m_wake(),
+    m_idle(),
+    m_job(nullptr),
+    m_generation(0U),
+    m_active(0U),
+    m_stop(false)
+{
+    size_t count = thread_count;
+    if (count == SIZE_MAX) {
+        const unsigned int hardware = std::thread::hardware_concurrency();
+        count = (hardware > 1U ? hardware - 1U : 0U);
+    }
+    try {
+        for (size_t i = 0U; i < count; ++i) {
+            this->m_threads.emplace_back(&BufferThreadPool::work, this);
+        }
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> guard(this->m_lock);
+            this->m_stop = true;
+        }
+        this->m_wake.notify_all();
+        for (std::thread &thread : this->m_threads) {
+            thread.join();
+        }
+        throw;
+    }
+}
+
+/**
+ *  Destruct the object (and join the threads).
+ */
+BufferThreadPool::~BufferThreadPool() noexcept {
+    {
+        std::lock_guard<std::mutex> guard(this->m_lock);
+        this->m_stop = true;
+    }
+    this->m_wake.notify_all();
+    for (std::thread &thread : this->m_threads) {
+        thread.join();
+    }
+}
+
+//
+//  BufferThreadPool public methods.
+//
+
+/**
+ *  Run tasks and wait for them to complete.
+ *
+ *  @note
+ *      If a task throws, the tasks not claimed yet are skipped, and the
+ *      first exception is rethrown once the running tasks completed.
+ *  @throw ...
+ *      Raised if a task threw (the first exception only).
+ *  @param task
+ *      The task callback (called once for each index in [0, count)).
+ *  @param context
+ *      The context passed to the task callback.
+ *  @param count
+ *      The count of tasks.
+ */
+void BufferThreadPool::run(
+    BufferTask      task,
+    void            *context,
+    const size_t    count
+) {
+    if (count <= 1U || this->m_threads.empty()) {
+        for (size_t i = 0U; i < count; ++i) {
+            task(i, context);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> run_guard(this->m_run_lock);
+    Job job;
+    job.task = task;
+    job.context = context;
+    job.count = count;
+    job.next.store(0U, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> guard(this->m_lock);
+        this->m_job = &job;
+        ++(this->m_generation);
+    }
+    this->m_wake.notify_all();
+
+    //  Claim tasks on the calling thread too.
+    this->run_tasks(&job);
+
+    //  All tasks are claimed, wait for the threads which claimed the last
+    //  ones (the threads waking up from now on no longer see the job).
+    std::unique_lock<std::mutex> lock(this->m_lock);
+    this->m_job = nullptr;
+    this->m_idle.wait(lock, [this]() {
+        return this->m_active == 0U;
+    });
+    if (job.error) {
+        lock.unlock();
+        std::rethrow_exception(job.error);
+    }
+}
+
+/**
+ *  Get the count of threads which run tasks.
+ *
+ *  @return
+ *      The count (the pool threads and the calling thread).
+ */
+size_t BufferThreadPool::get_concurrency() const noexcept {
+    return this->m_threads.size() + 1U;
+}
+
+//
+//  BufferThreadPool private methods.
+//
+
+/**
+ *  Claim and run the tasks of a job until all of them are claimed.
+ *
+ *  @note
+ *      The first exception thrown by the tasks is kept in the job (and the
+ *      tasks not claimed yet are skipped).
+ *  @param job
+ *      The job.
+ */
+void BufferThreadPool::run_tasks(Job *job) noexcept {
+    size_t index;
+    while ((index = job->next.fetch_add(1U)) < job->count) {
+        try {
+            job->task(index, job->context);
+        } catch (...) {
+            std::lock_guard<std::mutex> guard(this->m_lock);
+            if (!job->error) {
+                job->error = std::current_exception();
+            }
+            job->next.store(job->count);
+        }
+    }
+}
+
+/**
+ *  Main loop of pool threads.
+ */
+void BufferThreadPool::work() noexcept {
+    uint64_t seen = 0U;
+    std::unique_lock<std::mutex> lock(this->m_lock);
+    while (true) {
+        this->m_wake.wait(lock, [this, &seen]() {
+            return this->m_stop ||
+                (this->m_job != nullptr && this->m_generation != seen);
+        });
+        if (this->m_stop) {
+            return;
+        }
+        seen = this->m_generation;
+        Job *job = this->m_job;
+        ++(this->m_active);
+        lock.unlock();
+
+        this->run_tasks(job);
+
+        lock.lock();
+        if (--(this->m_active) == 0U) {
+            this->m_idle.notify_all();
+        }
+    }
+}
+
+//
+//  Public functions.
+//
+
+/**
+ *  Return a new buffer which is the result of concatenating all buffer
+ *  instances in array together (see Buffer::concat()).
+ *
+ *  @throw BufferException
+ *      Raised if the total length overflowed (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @throw std::bad_alloc
+ *      Raised if failed to allocate memory.
+ *  @param buffers
+ *      The buffer instances to concatenate.
+ *  @param count
+ *      The count of buffer instances.
+ *  @param executor
+ *      The executor.
+ *  @return
+ *      The new buffer.
+ */
+Buffer buffer_parallel_concat(
+    const Buffer    buffers[],
+    const size_t    count,
+    BufferExecutor  &executor
+) {
+    size_t datalen = 0U;
+    for (size_t i = 0U; i < count; ++i) {
+        if (buffers[i].get_length() > SIZE_MAX - datalen) {
+            throw BufferException(
+                "Length overflowed.",
+                XAPCORE_BUF_ERROR_OVERFLOW
+            );
+        }
+        datalen += buffers[i].get_length();
+    }
+    if (datalen < BUFFER_PARALLEL_THRESHOLD) {
+        return Buffer::concat(buffers, count);
+    }
+
+    //  The destination offsets are known up front, so every input (split
+    //  into blocks) is copied independently.
+    Buffer rst(datalen, true);
+    ParallelContext context;
+    context.pieces.reserve(datalen / BUFFER_PARALLEL_BLOCK_SIZE + count);
+    context.stream = (datalen >= BUFFER_PARALLEL_STREAM_THRESHOLD);
+    size_t cursor = 0U;
+    for (size_t i = 0U; i < count; ++i) {
+        const size_t length = buffers[i].get_length();
+        parallel_split(
+            context,
+            rst.get_pointer() + cursor,
+            buffers[i].get_pointer(),
+            length
+        );
+        cursor += length;
+    }
+    executor.run(parallel_copy_task, &context, context.pieces.size());
+    XAP_CORE_BUFFER_STATS_COPY(datalen);
+    return rst;
+}
+
+/**
+ *  Copy data to destination (see Buffer::copy()).
+ *
+ *  @throw std::bad_alloc
+ *      Raised if failed to detach the destination (in copy-on-write mode).
+ *  @param source
+ *      The buffer to copy from.
+ *  @param destination
+ *      The buffer to copy into.
+ *  @param executor
+ *      The executor.
+ *  @return
+ *      The number of bytes copied.
+ */
+size_t buffer_parallel_copy(
+    const Buffer    &source,
+    Buffer          &destination,
+    BufferExecutor  &executor
+) {
+    const size_t copy_len = std::min(
+        source.get_length(),
+        destination.get_length()
+    );
+    if (copy_len < BUFFER_PARALLEL_THRESHOLD) {
+        return source.copy(destination);
+    }
+
+    parallel_prepare_write(destination);
+    ParallelContext context;
+    context.pieces.reserve(copy_len / BUFFER_PARALLEL_BLOCK_SIZE + 1U);
+    context.stream = (copy_len >= BUFFER_PARALLEL_STREAM_THRESHOLD);
+    parallel_split(
+        context,
+        destination.get_pointer(),
+        source.get_pointer(),
+        copy_len
+    );
+    executor.run(parallel_copy_task, &context, context.pieces.size());
+    XAP_CORE_BUFFER_STATS_COPY(copy_len);
+    return copy_len;
+}
+
+/**
+ *  Fill buffer with the specified value (see Buffer::fill()).
+ *
+ *  @throw std::bad_alloc
+ *      Raised if failed to detach the buffer (in copy-on-write mode).
+ *  @param buffer
+ *      The buffer.
+ *  @param value
+ *      The value with which to fill buffer.
+ *  @param executor
+ *      The executor.
+ */
+void buffer_parallel_fill(
+    Buffer          &buffer,
+    const uint8_t   value,
+    BufferExecutor  &executor
+) {
+    const size_t length = buffer.get_length();
+    if (length < BUFFER_PARALLEL_THRESHOLD) {
+        buffer.fill(value);
+        return;
+    }
+
+    parallel_prepare_write(buffer);
+    ParallelContext context;
+    context.pieces.reserve(length / BUFFER_PARALLEL_BLOCK_SIZE + 1U);
+    context.stream = (length >= BUFFER_PARALLEL_STREAM_THRESHOLD);
+    context.value = value;
+    parallel_split(context, buffer.get_pointer(), nullptr, length);
+    executor.run(parallel_fill_task, &context, context.pieces.size());
+}
+
+/**
+ *  Get whether two buffers are equal (see Buffer::operator==()).
+ *
+ *  @throw std::bad_alloc
+ *      Raised if failed to allocate memory.
+ *  @param first
+ *      The first buffer.
+ *  @param second
+ *      The second buffer.
+ *  @param executor
+ *      The executor.
+ *  @return
+ *      True if equal.
+ */
+bool buffer_parallel_is_equal(
+    const Buffer    &first,
+    const Buffer    &second,
+    BufferExecutor  &executor
+) {
+    const size_t length = first.get_length();
+    if (length != second.get_length()) {
+        return false;
+    }
+    if (length < BUFFER_PARALLEL_THRESHOLD ||
+        first.get_pointer() == second.get_pointer()) {
+        return first == second;
+    }
+
+    //  The first buffer is never written (only read by the compare task).
+    ParallelContext context;
+    context.pieces.reserve(length / BUFFER_PARALLEL_BLOCK_SIZE + 1U);
+    parallel_split(
+        context,
+        const_cast<uint8_t*>(first.get_pointer()),
+        second.get_pointer(),
+        length
+    );
+    executor.run(parallel_compare_task, &context, context.pieces.size());
+    return !context.different.load(std::memory_order_relaxed);
+}
+
+}  //  namespace buffer
+}  //  namespace core
+}  //  namespace xap
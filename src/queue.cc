@@ -7,18 +7,136 @@
 //
 //  Imports.
 //
+#include <xap/core/buffer/build.h>
+#include <xap/core/buffer/endian.h>
 #include <xap/core/buffer/queue.h>
+#include <algorithm>
+#include <new>
+#include <stddef.h>
+#include <string.h>
+#include <utility>
+#include "instrument.h"
+#include "kernel.h"
+
+#if defined(XAP_CORE_BUFFER_OS_POSIX)
+# include <sys/uio.h>
+#endif
 
 namespace xap {
 namespace core {
 namespace buffer {
 
+//
+//  Constants.
+//
+
+//  The count of chunks allocated for the ring at the first push.
+static const size_t QUEUE_RING_INITIAL_CAPACITY = 8U;
+
+//
+//  Layout checks.
+//
+
+#if defined(XAP_CORE_BUFFER_OS_POSIX)
+
+//  BufferSegment arrays are passed to writev() / sendmsg() as is.
+static_assert(
+    sizeof(BufferSegment) == sizeof(struct iovec),
+    "BufferSegment size mismatches 'struct iovec'."
+);
+static_assert(
+    offsetof(BufferSegment, pointer) == offsetof(struct iovec, iov_base),
+    "BufferSegment::pointer offset mismatches 'iovec::iov_base'."
+);
+static_assert(
+    offsetof(BufferSegment, length) == offsetof(struct iovec, iov_len),
+    "BufferSegment::length offset mismatches 'iovec::iov_len'."
+);
+
+#endif  //  #if defined(XAP_CORE_BUFFER_OS_POSIX)
+
+//
+//  Private functions.
+//
+
+/**
+ *  Convert the IEEE 754 representation to single-precision float-point.
+ *
+ *  @param bits
+ *      The representation.
+ *  @return
+ *      The single-precision float-point value.
+ */
+static float queue_bits_to_float(const uint32_t bits) {
+#if defined(XAP_CORE_BUFFER_IEEE_754)
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+#else
+    uint8_t scratch[4U];
+    endian_write_uint32_be(scratch, bits);
+    return Buffer::wrap_unowned(scratch, sizeof(scratch)).read_float_be(0U);
+#endif
+}
+
+#if defined(UINT64_MAX)
+
+/**
+ *  Convert the IEEE 754 representation to double-precision float-point.
+ *
+ *  @param bits
+ *      The representation.
+ *  @return
+ *      The double-precision float-point value.
+ */
+static double queue_bits_to_double(const uint64_t bits) {
+#if defined(XAP_CORE_BUFFER_IEEE_754)
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+#else
+    uint8_t scratch[8U];
+    endian_write_uint64_be(scratch, bits);
+    return Buffer::wrap_unowned(scratch, sizeof(scratch)).read_double_be(0U);
+#endif
+}
+
+#endif  //  #if defined(UINT64_MAX)
+
+//
+//  BufferQueueListener constructor & destructor.
+//
+
+/**
+ *  Destruct the object.
+ */
+BufferQueueListener::~BufferQueueListener() noexcept {}
+
+//
+//  BufferQueue constructor & destructor.
+//
+
 /**
  *  Construct the object.
  */
 BufferQueue::BufferQueue() noexcept :
     m_remaining(0U),
-    m_queue()
+    m_chunks(nullptr),
+    m_capacity(0U),
+    m_head(0U),
+    m_count(0U),
+    m_max_size(SIZE_MAX),
+    m_high_watermark(SIZE_MAX),
+    m_low_watermark(0U),
+    m_listener(nullptr),
+    m_high(false),
+    m_compaction_percent(0U),
+    m_compaction_min_storage(65536U),
+    m_compaction_allocator(&(BufferAllocator::get_default())),
+    m_scan_delimiter(),
+    m_scan_offset(0U),
+    m_scan_index(0U),
+    m_scan_base(0U)
 {
     //  Do nothing.
 }
@@ -30,17 +148,75 @@ BufferQueue::BufferQueue() noexcept :
  *      The source object.
  */
 BufferQueue::BufferQueue(const BufferQueue &src) :
+    m_remaining(0U),
+    m_chunks(nullptr),
+    m_capacity(0U),
+    m_head(0U),
+    m_count(0U),
+    m_max_size(src.m_max_size),
+    m_high_watermark(src.m_high_watermark),
+    m_low_watermark(src.m_low_watermark),
+    m_listener(src.m_listener),
+    m_high(src.m_high),
+    m_compaction_percent(src.m_compaction_percent),
+    m_compaction_min_storage(src.m_compaction_min_storage),
+    m_compaction_allocator(src.m_compaction_allocator),
+    m_scan_delimiter(src.m_scan_delimiter),
+    m_scan_offset(src.m_scan_offset),
+    m_scan_index(src.m_scan_index),
+    m_scan_base(src.m_scan_base)
+{
+    for (size_t i = 0U; i < src.m_count; ++i) {
+        const Chunk &chunk = src.get_chunk(i);
+        this->push_chunk(Buffer(chunk.buffer));
+        this->get_chunk(i).cursor = chunk.cursor;
+    }
+    this->m_remaining = src.m_remaining;
+}
+
+/**
+ *  Construct (Move) the object.
+ * 
+ *  @param src
+ *      The source object (would be empty after moved).
+ */
+BufferQueue::BufferQueue(BufferQueue &&src) noexcept :
     m_remaining(src.m_remaining),
-    m_queue(src.m_queue)
+    m_chunks(src.m_chunks),
+    m_capacity(src.m_capacity),
+    m_head(src.m_head),
+    m_count(src.m_count),
+    m_max_size(src.m_max_size),
+    m_high_watermark(src.m_high_watermark),
+    m_low_watermark(src.m_low_watermark),
+    m_listener(src.m_listener),
+    m_high(src.m_high),
+    m_compaction_percent(src.m_compaction_percent),
+    m_compaction_min_storage(src.m_compaction_min_storage),
+    m_compaction_allocator(src.m_compaction_allocator),
+    m_scan_delimiter(std::move(src.m_scan_delimiter)),
+    m_scan_offset(src.m_scan_offset),
+    m_scan_index(src.m_scan_index),
+    m_scan_base(src.m_scan_base)
 {
-    //  Do nothing.
+    src.reset_scan();
+    src.m_remaining = 0U;
+    src.m_chunks = nullptr;
+    src.m_capacity = 0U;
+    src.m_head = 0U;
+    src.m_count = 0U;
+    src.m_max_size = SIZE_MAX;
+    src.m_high_watermark = SIZE_MAX;
+    src.m_low_watermark = 0U;
+    src.m_listener = nullptr;
+    src.m_high = false;
 }
 
 /**
  *  Destructor the object.
  */
 BufferQueue::~BufferQueue() {
-    //  Do nothing.
+    this->release();
 }
 
 //
@@ -57,8 +233,52 @@ BufferQueue::~BufferQueue() {
  */
 BufferQueue& BufferQueue::operator=(const BufferQueue &src) {
     if (this != &src) {
-        this->m_queue = src.m_queue;
+        BufferQueue copied(src);
+        *this = std::move(copied);
+    }
+
+    return *this;
+}
+
+/**
+ *  Operator '=' (move).
+ * 
+ *  @param src
+ *      The source (would be empty after moved).
+ *  @return
+ *      The destination.
+ */
+BufferQueue& BufferQueue::operator=(BufferQueue &&src) noexcept {
+    if (this != &src) {
+        this->release();
         this->m_remaining = src.m_remaining;
+        this->m_chunks = src.m_chunks;
+        this->m_capacity = src.m_capacity;
+        this->m_head = src.m_head;
+        this->m_count = src.m_count;
+        this->m_max_size = src.m_max_size;
+        this->m_high_watermark = src.m_high_watermark;
+        this->m_low_watermark = src.m_low_watermark;
+        this->m_listener = src.m_listener;
+        this->m_high = src.m_high;
+        this->m_compaction_percent = src.m_compaction_percent;
+        this->m_compaction_min_storage = src.m_compaction_min_storage;
+        this->m_compaction_allocator = src.m_compaction_allocator;
+        this->m_scan_delimiter = std::move(src.m_scan_delimiter);
+        this->m_scan_offset = src.m_scan_offset;
+        this->m_scan_index = src.m_scan_index;
+        this->m_scan_base = src.m_scan_base;
+        src.reset_scan();
+        src.m_remaining = 0U;
+        src.m_chunks = nullptr;
+        src.m_capacity = 0U;
+        src.m_head = 0U;
+        src.m_count = 0U;
+        src.m_max_size = SIZE_MAX;
+        src.m_high_watermark = SIZE_MAX;
+        src.m_low_watermark = 0U;
+        src.m_listener = nullptr;
+        src.m_high = false;
     }
 
     return *this;
@@ -67,17 +287,85 @@ BufferQueue& BufferQueue::operator=(const BufferQueue &src) {
 /**
  *  Push buffer to queue.
  * 
+ *  @throw BufferException
+ *      Raised if the maximum size would be exceeded 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
  *  @param data
  *      The data.
  */
 void BufferQueue::push(const Buffer &data) {
+    if (!this->try_push(data)) {
+        throw BufferException(
+            "Maximum size exceeded.", 
+            XAPCORE_BUF_ERROR_OVERFLOW
+        );
+    }
+}
+
+/**
+ *  Push buffer to queue.
+ * 
+ *  @throw BufferException
+ *      Raised if the maximum size would be exceeded 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param data
+ *      The data (would be moved into queue).
+ */
+void BufferQueue::push(Buffer &&data) {
+    if (!this->try_push(std::move(data))) {
+        throw BufferException(
+            "Maximum size exceeded.", 
+            XAPCORE_BUF_ERROR_OVERFLOW
+        );
+    }
+}
+
+/**
+ *  Push buffer to queue if the maximum size wouldn't be exceeded.
+ * 
+ *  @param data
+ *      The data.
+ *  @return
+ *      True if pushed, false if the maximum size would be exceeded 
+ *      (nothing is pushed).
+ */
+bool BufferQueue::try_push(const Buffer &data) {
+    size_t datalen = data.get_length();
+    if (datalen == 0U) {
+        return true;
+    }
+    if (!this->is_within_budget(datalen)) {
+        return false;
+    }
+
+    this->push_chunk(Buffer(data));
+    this->m_remaining += datalen;
+    this->check_high_watermark();
+    return true;
+}
+
+/**
+ *  Push buffer to queue if the maximum size wouldn't be exceeded.
+ * 
+ *  @param data
+ *      The data (would be moved into queue only if pushed).
+ *  @return
+ *      True if pushed, false if the maximum size would be exceeded 
+ *      (nothing is pushed).
+ */
+bool BufferQueue::try_push(Buffer &&data) {
     size_t datalen = data.get_length();
     if (datalen == 0U) {
-        return;
+        return true;
+    }
+    if (!this->is_within_budget(datalen)) {
+        return false;
     }
 
-    this->m_queue.push_back(BufferFetcher(data));
-    this->m_remaining += data.get_length();
+    this->push_chunk(std::move(data));
+    this->m_remaining += datalen;
+    this->check_high_watermark();
+    return true;
 }
 
 /**
@@ -96,28 +384,77 @@ Buffer BufferQueue::pop(const size_t size) {
         throw BufferException("Out of range.", XAPCORE_BUF_ERROR_OVERFLOW);
     }
 
-    Buffer buffer(size);
+    Buffer buffer(size, true);
+    XAP_CORE_BUFFER_STATS_COPY(size);
+    uint8_t *destination = buffer.get_pointer();
     size_t cursor = 0U;
     while (cursor < size) {
-        size_t needed = size - cursor;
-        auto fetcher = this->m_queue.begin();
-        size_t fetcher_remaining = fetcher->get_remaining_size();
-        if (fetcher_remaining <= needed) {
-            fetcher->fetch_all().copy(buffer, cursor);
-            cursor += fetcher_remaining;
-            this->m_queue.pop_front();
-            continue;
-        } else {
-            fetcher->fetch_bytes(needed).copy(buffer, cursor);
-            cursor += needed;
-            continue;
+        Chunk &chunk = this->get_chunk(0U);
+        size_t copy_len = std::min(
+            chunk.buffer.get_length() - chunk.cursor, 
+            size - cursor
+        );
+        memcpy(
+            destination + cursor, 
+            chunk.buffer.get_pointer() + chunk.cursor, 
+            copy_len
+        );
+        cursor += copy_len;
+        chunk.cursor += copy_len;
+        if (chunk.cursor == chunk.buffer.get_length()) {
+            this->pop_chunk();
         }
     }
 
     this->m_remaining -= size;
+    this->reset_scan();
+    this->compact_front();
+    this->check_low_watermark();
     return buffer;
 }
 
+/**
+ *  Pop buffer from queue without copying if possible.
+ * 
+ *  @note
+ *      If the requested bytes are contiguous in the front chunk, the 
+ *      returned buffer references the same memory as the pushed buffer 
+ *      (like Buffer::slice()). Otherwise, the bytes are coalesced into a 
+ *      new buffer (like pop()).
+ *  @throw BufferException
+ *      Raised if parameter 'size' was out of range 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param size
+ *      The size of buffer.
+ *  @return
+ *      The buffer.
+ */
+Buffer BufferQueue::pop_view(const size_t size) {
+    if (size > this->m_remaining) {
+        throw BufferException("Out of range.", XAPCORE_BUF_ERROR_OVERFLOW);
+    }
+    if (size == 0U) {
+        return Buffer(0U);
+    }
+
+    Chunk &chunk = this->get_chunk(0U);
+    if (chunk.buffer.get_length() - chunk.cursor < size) {
+        //  Spans multiple chunks, coalesce them.
+        return this->pop(size);
+    }
+
+    Buffer out = chunk.buffer.slice(chunk.cursor, size);
+    chunk.cursor += size;
+    if (chunk.cursor == chunk.buffer.get_length()) {
+        this->pop_chunk();
+    }
+    this->m_remaining -= size;
+    this->reset_scan();
+    this->compact_front();
+    this->check_low_watermark();
+    return out;
+}
+
 /**
  *  Pop all data from queue.
  * 
@@ -125,29 +462,1679 @@ Buffer BufferQueue::pop(const size_t size) {
  *      The buffer.
  */
 Buffer BufferQueue::pop_all() {
-    Buffer out(this->m_remaining);
+    return this->pop(this->m_remaining);
+}
 
-    size_t cursor = 0U;
-    while (!this->m_queue.empty()) {
-        auto fetcher = this->m_queue.begin();
-        size_t fetcher_remaining = fetcher->get_remaining_size();
-        fetcher->fetch_all().copy(out, cursor);
-        cursor += fetcher_remaining;
-        this->m_queue.pop_front();
+/**
+ *  Get the segments of front bytes in queue (without copying or 
+ *  consuming).
+ * 
+ *  @note
+ *      The segments are valid until the queue is modified. Call 
+ *      consume() to drop the bytes after they were used.
+ *  @param segments
+ *      The segments array to fill.
+ *  @param max_segments
+ *      The capacity of segments array.
+ *  @param size
+ *      The maximum count of bytes to export (default all).
+ *  @return
+ *      The count of segments filled.
+ */
+size_t BufferQueue::get_segments(
+    BufferSegment   segments[],
+    const size_t    max_segments,
+    const size_t    size
+) const noexcept {
+    size_t count = 0U;
+    size_t needed = size;
+    while (count < this->m_count && count < max_segments && needed != 0U) {
+        const Chunk &chunk = this->get_chunk(count);
+        size_t length = std::min(
+            chunk.buffer.get_length() - chunk.cursor, 
+            needed
+        );
+        segments[count].pointer = chunk.buffer.get_pointer() + chunk.cursor;
+        segments[count].length = length;
+        needed -= length;
+        ++count;
     }
+    return count;
+}
 
-    this->m_remaining = 0U;
-    return out;
+/**
+ *  Get the count of segments needed to export all bytes in queue (see 
+ *  get_segments()).
+ * 
+ *  @return
+ *      The count.
+ */
+size_t BufferQueue::get_segment_count() const noexcept {
+    return this->m_count;
 }
 
 /**
- *  Get the remaining size.
+ *  Drop bytes from the front of queue.
+ * 
+ *  @throw BufferException
+ *      Raised if parameter 'size' was out of range 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param size
+ *      The count of bytes to drop.
+ */
+void BufferQueue::consume(const size_t size) {
+    if (size > this->m_remaining) {
+        throw BufferException("Out of range.", XAPCORE_BUF_ERROR_OVERFLOW);
+    }
+
+    size_t needed = size;
+    while (needed != 0U) {
+        Chunk &chunk = this->get_chunk(0U);
+        size_t chunk_remaining = chunk.buffer.get_length() - chunk.cursor;
+        if (chunk_remaining <= needed) {
+            needed -= chunk_remaining;
+            this->pop_chunk();
+        } else {
+            chunk.cursor += needed;
+            needed = 0U;
+        }
+    }
+
+    this->m_remaining -= size;
+    this->reset_scan();
+    this->compact_front();
+    this->check_low_watermark();
+}
+
+/**
+ *  Peek an unsigned 8-bit integer (without consuming).
  * 
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset (relative to the queue front).
  *  @return
- *      The size of remaining bytes.
+ *      The unsigned 8-bit integer.
  */
-size_t BufferQueue::get_remaining_size() const noexcept {
-    return this->m_remaining;
+uint8_t BufferQueue::peek_uint8(const size_t offset) const {
+    uint8_t scratch[1];
+    return *(this->peek_bytes(offset, 1U, scratch));
+}
+
+/**
+ *  Peek an unsigned 16-bit integer with big-endian (without consuming).
+ * 
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset (relative to the queue front).
+ *  @return
+ *      The unsigned 16-bit integer.
+ */
+uint16_t BufferQueue::peek_uint16_be(const size_t offset) const {
+    uint8_t scratch[2U];
+    return endian_read_uint16_be(this->peek_bytes(offset, 2U, scratch));
+}
+
+/**
+ *  Peek an unsigned 16-bit integer with little-endian (without 
+ *  consuming).
+ * 
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset (relative to the queue front).
+ *  @return
+ *      The unsigned 16-bit integer.
+ */
+uint16_t BufferQueue::peek_uint16_le(const size_t offset) const {
+    uint8_t scratch[2U];
+    return endian_read_uint16_le(this->peek_bytes(offset, 2U, scratch));
+}
+
+/**
+ *  Peek an unsigned 32-bit integer with big-endian (without consuming).
+ * 
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset (relative to the queue front).
+ *  @return
+ *      The unsigned 32-bit integer.
+ */
+uint32_t BufferQueue::peek_uint32_be(const size_t offset) const {
+    uint8_t scratch[4U];
+    return endian_read_uint32_be(this->peek_bytes(offset, 4U, scratch));
+}
+
+/**
+ *  Peek an unsigned 32-bit integer with little-endian (without 
+ *  consuming).
+ * 
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset (relative to the queue front).
+ *  @return
+ *      The unsigned 32-bit integer.
+ */
+uint32_t BufferQueue::peek_uint32_le(const size_t offset) const {
+    uint8_t scratch[4U];
+    return endian_read_uint32_le(this->peek_bytes(offset, 4U, scratch));
+}
+
+#if defined(UINT64_MAX)
+
+/**
+ *  Peek an unsigned 64-bit integer with big-endian (without consuming).
+ * 
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset (relative to the queue front).
+ *  @return
+ *      The unsigned 64-bit integer.
+ */
+uint64_t BufferQueue::peek_uint64_be(const size_t offset) const {
+    uint8_t scratch[8U];
+    return endian_read_uint64_be(this->peek_bytes(offset, 8U, scratch));
+}
+
+/**
+ *  Peek an unsigned 64-bit integer with little-endian (without 
+ *  consuming).
+ * 
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset (relative to the queue front).
+ *  @return
+ *      The unsigned 64-bit integer.
+ */
+uint64_t BufferQueue::peek_uint64_le(const size_t offset) const {
+    uint8_t scratch[8U];
+    return endian_read_uint64_le(this->peek_bytes(offset, 8U, scratch));
+}
+
+#endif  //  #if defined(UINT64_MAX)
+
+/**
+ *  Pop an unsigned 8-bit integer.
+ * 
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The unsigned 8-bit integer.
+ */
+uint8_t BufferQueue::pop_uint8() {
+    const uint8_t value = this->peek_uint8();
+    this->consume(1U);
+    return value;
+}
+
+/**
+ *  Pop an unsigned 16-bit integer with big-endian.
+ * 
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The unsigned 16-bit integer.
+ */
+uint16_t BufferQueue::pop_uint16_be() {
+    const uint16_t value = this->peek_uint16_be();
+    this->consume(2U);
+    return value;
+}
+
+/**
+ *  Pop an unsigned 16-bit integer with little-endian.
+ * 
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The unsigned 16-bit integer.
+ */
+uint16_t BufferQueue::pop_uint16_le() {
+    const uint16_t value = this->peek_uint16_le();
+    this->consume(2U);
+    return value;
+}
+
+/**
+ *  Pop a signed 16-bit integer with little-endian.
+ * 
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The signed 16-bit integer.
+ */
+int16_t BufferQueue::pop_sint16_le() {
+    const int16_t value = static_cast<int16_t>(this->peek_uint16_le());
+    this->consume(2U);
+    return value;
+}
+
+/**
+ *  Pop an unsigned 32-bit integer with big-endian.
+ * 
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The unsigned 32-bit integer.
+ */
+uint32_t BufferQueue::pop_uint32_be() {
+    const uint32_t value = this->peek_uint32_be();
+    this->consume(4U);
+    return value;
+}
+
+/**
+ *  Pop an unsigned 32-bit integer with little-endian.
+ * 
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The unsigned 32-bit integer.
+ */
+uint32_t BufferQueue::pop_uint32_le() {
+    const uint32_t value = this->peek_uint32_le();
+    this->consume(4U);
+    return value;
+}
+
+/**
+ *  Pop a single-precision float-point with big-endian.
+ * 
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The single-precision float-point value.
+ */
+float BufferQueue::pop_float_be() {
+    const uint32_t bits = this->peek_uint32_be();
+    this->consume(4U);
+    return queue_bits_to_float(bits);
+}
+
+/**
+ *  Pop a single-precision float-point with little-endian.
+ * 
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The single-precision float-point value.
+ */
+float BufferQueue::pop_float_le() {
+    const uint32_t bits = this->peek_uint32_le();
+    this->consume(4U);
+    return queue_bits_to_float(bits);
+}
+
+#if defined(UINT64_MAX)
+
+/**
+ *  Pop an unsigned 64-bit integer with big-endian.
+ * 
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The unsigned 64-bit integer.
+ */
+uint64_t BufferQueue::pop_uint64_be() {
+    const uint64_t value = this->peek_uint64_be();
+    this->consume(8U);
+    return value;
+}
+
+/**
+ *  Pop an unsigned 64-bit integer with little-endian.
+ * 
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The unsigned 64-bit integer.
+ */
+uint64_t BufferQueue::pop_uint64_le() {
+    const uint64_t value = this->peek_uint64_le();
+    this->consume(8U);
+    return value;
+}
+
+/**
+ *  Pop a double-precision float-point with big-endian.
+ * 
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The double-precision float-point value.
+ */
+double BufferQueue::pop_double_be() {
+    const uint64_t bits = this->peek_uint64_be();
+    this->consume(8U);
+    return queue_bits_to_double(bits);
+}
+
+/**
+ *  Pop a double-precision float-point with little-endian.
+ * 
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The double-precision float-point value.
+ */
+double BufferQueue::pop_double_le() {
+    const uint64_t bits = this->peek_uint64_le();
+    this->consume(8U);
+    return queue_bits_to_double(bits);
+}
+
+/**
+ *  Pop an unsigned integer with variable-length (LEB128) encoding.
+ * 
+ *  @throw BufferException
+ *      Raised if the encoding is truncated or longer than 64 bits, 
+ *      nothing is popped (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The unsigned integer.
+ */
+uint64_t BufferQueue::pop_varint() {
+    //  At most 10 bytes are decoded (, and copied if they span chunks).
+    uint8_t scratch[10U];
+    const size_t available = std::min<size_t>(this->m_remaining, 10U);
+    uint64_t value = 0U;
+    size_t count = 0U;
+    if (available != 0U) {
+        count = kernel_decode_varint(
+            this->peek_bytes(0U, available, scratch), 
+            available, 
+            &value
+        );
+    }
+    if (count == 0U) {
+        throw BufferException(
+            "Invalid or truncated varint.", 
+            XAPCORE_BUF_ERROR_OVERFLOW
+        );
+    }
+    this->consume(count);
+    return value;
+}
+
+/**
+ *  Pop a signed integer with zigzag and variable-length (LEB128) 
+ *  encoding.
+ * 
+ *  @throw BufferException
+ *      Raised if the encoding is truncated or longer than 64 bits, 
+ *      nothing is popped (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The signed integer.
+ */
+int64_t BufferQueue::pop_varint_signed() {
+    const uint64_t value = this->pop_varint();
+    const uint64_t magnitude = value >> 1U;
+    return static_cast<int64_t>((value & 1U) != 0U ? ~magnitude : magnitude);
+}
+
+#endif  //  #if defined(UINT64_MAX)
+
+/**
+ *  Find the first occurrence of a byte sequence (across chunks, without
+ *  coalescing them).
+ * 
+ *  @param needle
+ *      The byte sequence (an empty one is found at 'from').
+ *  @param from
+ *      The offset (relative to the queue front) where to begin searching.
+ *  @return
+ *      The offset relative to the queue front (Buffer::NPOS if not 
+ *      found).
+ */
+size_t BufferQueue::index_of(
+    const Buffer    &needle,
+    const size_t    from
+) const noexcept {
+    if (from > this->m_remaining) {
+        return Buffer::NPOS;
+    }
+    if (needle.get_length() == 0U) {
+        return from;
+    }
+    return this->search(needle, 0U, 0U, from);
+}
+
+/**
+ *  Pop a frame which is prefixed with its length if it was completely 
+ *  received.
+ * 
+ *  @note
+ *      The length header is dropped and the frame is popped like 
+ *      pop_view() (zero-copy if it is contiguous in one chunk).
+ *  @throw BufferException
+ *      Raised if 'header_width' is not 1, 2, 4 or 8 
+ *      (XAPCORE_BUF_ERROR_INVALID_SIZE), or the frame length can't be 
+ *      represented with size_t (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param header_width
+ *      The width of the length header.
+ *  @param isle
+ *      True if the length header is with little-endian.
+ *  @param frame
+ *      The buffer to receive the frame.
+ *  @return
+ *      True if popped, false if more bytes are needed (nothing is 
+ *      consumed).
+ */
+bool BufferQueue::try_pop_frame_length_prefixed(
+    const size_t    header_width,
+    const bool      isle,
+    Buffer          &frame
+) {
+    if (header_width != 1U && header_width != 2U && 
+        header_width != 4U && header_width != 8U) {
+        throw BufferException(
+            "Invalid header width.", 
+            XAPCORE_BUF_ERROR_INVALID_SIZE
+        );
+    }
+    if (this->m_remaining < header_width) {
+        return false;
+    }
+
+    uint8_t scratch[8];
+    const uint8_t *header = this->peek_bytes(0U, header_width, scratch);
+    uint64_t length;
+    switch (header_width) {
+    case 1U:
+        length = header[0U];
+        break;
+    case 2U:
+        length = isle ? 
+            endian_read_uint16_le(header) : 
+            endian_read_uint16_be(header);
+        break;
+    case 4U:
+        length = isle ? 
+            endian_read_uint32_le(header) : 
+            endian_read_uint32_be(header);
+        break;
+    default:
+        length = isle ? 
+            endian_read_uint64_le(header) : 
+            endian_read_uint64_be(header);
+        break;
+    }
+    if (length > static_cast<uint64_t>(SIZE_MAX - header_width)) {
+        throw BufferException(
+            "Frame length overflowed.", 
+            XAPCORE_BUF_ERROR_OVERFLOW
+        );
+    }
+    if (this->m_remaining - header_width < static_cast<size_t>(length)) {
+        return false;
+    }
+
+    this->consume(header_width);
+    frame = this->pop_view(static_cast<size_t>(length));
+    return true;
+}
+
+/**
+ *  Pop the bytes before the first occurrence of a delimiter if it was 
+ *  received.
+ * 
+ *  @note
+ *      The delimiter is dropped and the frame is popped like pop_view() 
+ *      (zero-copy if it is contiguous in one chunk).
+ *  @param delimiter
+ *      The delimiter (must not be empty).
+ *  @param frame
+ *      The buffer to receive the frame (without the delimiter).
+ *  @return
+ *      True if popped, false if the delimiter was not found (nothing is 
+ *      consumed).
+ */
+bool BufferQueue::try_pop_until(const Buffer &delimiter, Buffer &frame) {
+    if (delimiter.get_length() == 0U) {
+        return false;
+    }
+
+    //  Resume the search of the previous call (with the same delimiter).
+    if (this->m_scan_delimiter != delimiter) {
+        this->m_scan_delimiter = Buffer(
+            delimiter.get_pointer(), 
+            delimiter.get_length()
+        );
+        this->reset_scan();
+    }
+    const size_t found = this->search(
+        delimiter, 
+        this->m_scan_index, 
+        this->m_scan_base, 
+        this->m_scan_offset
+    );
+    if (found == Buffer::NPOS) {
+        //  No occurrence begins before the last (length - 1) bytes, find 
+        //  the chunk of the first of them (walking back from the tail).
+        const size_t delimiter_len = delimiter.get_length();
+        if (this->m_remaining >= delimiter_len) {
+            this->m_scan_offset = this->m_remaining - delimiter_len + 1U;
+            size_t index = this->m_count;
+            size_t base = this->m_remaining;
+            while (base > this->m_scan_offset) {
+                --index;
+                const Chunk &chunk = this->get_chunk(index);
+                base -= chunk.buffer.get_length() - chunk.cursor;
+            }
+            this->m_scan_index = index;
+            this->m_scan_base = base;
+        }
+        return false;
+    }
+
+    frame = this->pop_view(found);
+    this->consume(delimiter.get_length());
+    return true;
+}
+
+/**
+ *  Get the remaining size.
+ * 
+ *  @return
+ *      The size of remaining bytes.
+ */
+size_t BufferQueue::get_remaining_size() const noexcept {
+    return this->m_remaining;
+}
+
+/**
+ *  Set the maximum size (the byte budget of queued data).
+ * 
+ *  @note
+ *      Lowering the maximum size below the remaining size drops 
+ *      nothing, but further pushes fail until the queue was drained.
+ *  @param max_size
+ *      The maximum size (SIZE_MAX if unbounded, which is the default).
+ */
+void BufferQueue::set_max_size(const size_t max_size) noexcept {
+    this->m_max_size = max_size;
+}
+
+/**
+ *  Get the maximum size.
+ * 
+ *  @return
+ *      The maximum size (SIZE_MAX if unbounded).
+ */
+size_t BufferQueue::get_max_size() const noexcept {
+    return this->m_max_size;
+}
+
+/**
+ *  Set the watermarks and the listener to be notified.
+ * 
+ *  @note
+ *      The remaining size is checked against the new watermarks 
+ *      immediately (, and the listener may be notified).
+ *  @throw BufferException
+ *      Raised if 'low_watermark' is greater than 'high_watermark' 
+ *      (XAPCORE_BUF_ERROR_INVALID_SIZE).
+ *  @param high_watermark
+ *      The high watermark.
+ *  @param low_watermark
+ *      The low watermark.
+ *  @param listener
+ *      The listener (nullptr to disable notifications, it must outlive 
+ *      the queue otherwise).
+ */
+void BufferQueue::set_watermarks(
+    const size_t        high_watermark,
+    const size_t        low_watermark,
+    BufferQueueListener *listener
+) {
+    if (low_watermark > high_watermark) {
+        throw BufferException(
+            "Low watermark is greater than high watermark.", 
+            XAPCORE_BUF_ERROR_INVALID_SIZE
+        );
+    }
+
+    this->m_high_watermark = high_watermark;
+    this->m_low_watermark = low_watermark;
+    this->m_listener = listener;
+    if (this->m_high) {
+        this->check_low_watermark();
+    } else {
+        this->check_high_watermark();
+    }
+}
+
+/**
+ *  Get whether the remaining size is above the low watermark since it 
+ *  reached the high watermark.
+ * 
+ *  @return
+ *      True if so.
+ */
+bool BufferQueue::is_high() const noexcept {
+    return this->m_high;
+}
+
+/**
+ *  Set the compaction policy.
+ * 
+ *  @note
+ *      A chunk is compacted if its storage (see 
+ *      Buffer::get_storage_length()) is at least 'min_storage' bytes and 
+ *      its remaining bytes are less than 'live_percent' percent of the 
+ *      storage: the remaining bytes are copied into a new buffer from 
+ *      'allocator', and the queue releases its reference to the original 
+ *      storage. Consecutive chunks sharing the same storage are checked 
+ *      (and compacted) together. The front chunk is checked after bytes 
+ *      were popped or consumed from it, compact() checks all chunks.
+ *  @throw BufferException
+ *      Raised if 'live_percent' is greater than 100 
+ *      (XAPCORE_BUF_ERROR_INVALID_SIZE).
+ *  @param live_percent
+ *      The threshold of live bytes in percent (0 to disable compaction, 
+ *      which is the default).
+ *  @param min_storage
+ *      The minimum length of storage to compact (default 64 KiB).
+ *  @param allocator
+ *      The allocator of the compacted chunks (must outlive the chunks, e.g.
+ *      a BufferPoolAllocator).
+ */
+void BufferQueue::set_compaction(
+    const size_t    live_percent,
+    const size_t    min_storage,
+    BufferAllocator &allocator
+) {
+    if (live_percent > 100U) {
+        throw BufferException(
+            "Live percent is greater than 100.", 
+            XAPCORE_BUF_ERROR_INVALID_SIZE
+        );
+    }
+
+    this->m_compaction_percent = live_percent;
+    this->m_compaction_min_storage = min_storage;
+    this->m_compaction_allocator = &allocator;
+}
+
+/**
+ *  Compact all chunks which match the compaction policy (see 
+ *  set_compaction()).
+ * 
+ *  @note
+ *      Nothing is done if compaction is disabled. If failed to allocate 
+ *      memory, the chunk is kept as is.
+ *  @return
+ *      The count of chunks compacted.
+ */
+size_t BufferQueue::compact() noexcept {
+    size_t compacted = 0U;
+    if (this->m_compaction_percent == 0U) {
+        return compacted;
+    }
+    size_t index = 0U;
+    while (index < this->m_count) {
+        size_t run_compacted;
+        index += this->compact_run(index, &run_compacted);
+        compacted += run_compacted;
+    }
+    return compacted;
+}
+
+/**
+ *  Get the count of bytes of storage kept alive by the queue.
+ * 
+ *  @note
+ *      The storage shared by consecutive chunks is counted once. The 
+ *      storage may also be kept alive by buffers outside the queue. Compare
+ *      with get_remaining_size() (the live bytes) to decide whether to 
+ *      compact().
+ *  @return
+ *      The count of bytes.
+ */
+size_t BufferQueue::get_retained_size() const noexcept {
+    size_t retained = 0U;
+    for (size_t i = 0U; i < this->m_count; ++i) {
+        const Buffer &buffer = this->get_chunk(i).buffer;
+        if (i != 0U && 
+            buffer.is_sharing_storage(this->get_chunk(i - 1U).buffer)) {
+            continue;
+        }
+        retained += buffer.get_storage_length();
+    }
+    return retained;
+}
+
+//
+//  Private methods.
+//
+
+/**
+ *  Get the chunk at specified position (relative to the queue front).
+ * 
+ *  @param index
+ *      The position.
+ *  @return
+ *      The chunk.
+ */
+BufferQueue::Chunk& BufferQueue::get_chunk(const size_t index) const noexcept {
+    //  The capacity is always a power of 2.
+    return this->m_chunks[(this->m_head + index) & (this->m_capacity - 1U)];
+}
+
+/**
+ *  Get the pointer to bytes in queue (without consuming).
+ * 
+ *  @throw BufferException
+ *      Raised if 'offset' or 'size' is out of range 
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset (relative to the queue front).
+ *  @param size
+ *      The count of bytes (must not be 0).
+ *  @param scratch
+ *      The memory (at least 'size' bytes) where to copy the bytes if 
+ *      they span multiple chunks.
+ *  @return
+ *      The pointer to the bytes (either inside a chunk or 'scratch').
+ */
+const uint8_t* BufferQueue::peek_bytes(
+    const size_t    offset,
+    const size_t    size,
+    uint8_t         *scratch
+) const {
+    if (offset >= this->m_remaining || size > this->m_remaining - offset) {
+        throw BufferException("Out of range.", XAPCORE_BUF_ERROR_OVERFLOW);
+    }
+
+    //  Locate the chunk which contains the first byte.
+    size_t index = 0U;
+    size_t skip = offset;
+    while (true) {
+        const Chunk &chunk = this->get_chunk(index);
+        const size_t chunk_remaining = 
+            chunk.buffer.get_length() - chunk.cursor;
+        if (skip < chunk_remaining) {
+            if (chunk_remaining - skip >= size) {
+                //  Contiguous.
+                return chunk.buffer.get_pointer() + chunk.cursor + skip;
+            }
+            break;
+        }
+        skip -= chunk_remaining;
+        ++index;
+    }
+
+    //  Spans multiple chunks, copy them to the scratch.
+    size_t copied = 0U;
+    while (copied < size) {
+        const Chunk &chunk = this->get_chunk(index);
+        const size_t copy_len = std::min(
+            chunk.buffer.get_length() - chunk.cursor - skip, 
+            size - copied
+        );
+        memcpy(
+            scratch + copied, 
+            chunk.buffer.get_pointer() + chunk.cursor + skip, 
+            copy_len
+        );
+        copied += copy_len;
+        skip = 0U;
+        ++index;
+    }
+    return scratch;
+}
+
+/**
+ *  Find the first occurrence of a byte sequence, beginning at a chunk.
+ * 
+ *  @param needle
+ *      The byte sequence (must not be empty).
+ *  @param index
+ *      The position of the first chunk to search.
+ *  @param base
+ *      The offset of that chunk (relative to the queue front, not greater 
+ *      than 'from').
+ *  @param from
+ *      The offset (relative to the queue front) where to begin searching.
+ *  @return
+ *      The offset relative to the queue front (Buffer::NPOS if not 
+ *      found).
+ */
+size_t BufferQueue::search(
+    const Buffer    &needle,
+    size_t          index,
+    size_t          base,
+    const size_t    from
+) const noexcept {
+    const uint8_t *needle_ptr = needle.get_pointer();
+    const size_t needle_len = needle.get_length();
+    if (from > this->m_remaining || needle_len > this->m_remaining - from) {
+        return Buffer::NPOS;
+    }
+
+    for (; index < this->m_count; ++index) {
+        const Chunk &chunk = this->get_chunk(index);
+        const size_t chunk_remaining = 
+            chunk.buffer.get_length() - chunk.cursor;
+        if (base + chunk_remaining <= from) {
+            base += chunk_remaining;
+            continue;
+        }
+        const size_t skip = (from > base) ? (from - base) : 0U;
+
+        //  Occurrences inside the chunk go first.
+        const size_t found = 
+            chunk.buffer.index_of(needle, chunk.cursor + skip);
+        if (found != Buffer::NPOS) {
+            return base + (found - chunk.cursor);
+        }
+
+        //  Then the ones which begin in the chunk but end in next chunks.
+        if (index + 1U < this->m_count) {
+            size_t straddle_begin = (chunk_remaining >= needle_len) ? 
+                (chunk_remaining - needle_len + 1U) : 
+                0U;
+            if (straddle_begin < skip) {
+                straddle_begin = skip;
+            }
+            for (size_t j = straddle_begin; j < chunk_remaining; ++j) {
+                if (this->is_match(index, j, needle_ptr, needle_len)) {
+                    return base + j;
+                }
+            }
+        }
+
+        base += chunk_remaining;
+    }
+    return Buffer::NPOS;
+}
+
+/**
+ *  Forget the search position of try_pop_until() (bytes were removed from 
+ *  the queue front).
+ */
+void BufferQueue::reset_scan() noexcept {
+    this->m_scan_offset = 0U;
+    this->m_scan_index = 0U;
+    this->m_scan_base = 0U;
+}
+
+/**
+ *  Check whether a byte sequence occurs at specified position.
+ * 
+ *  @param index
+ *      The position of the chunk where the occurrence begins.
+ *  @param offset
+ *      The offset inside the chunk (from the chunk cursor).
+ *  @param needle
+ *      The byte sequence.
+ *  @param needle_len
+ *      The length of the byte sequence.
+ *  @return
+ *      True if occurs.
+ */
+bool BufferQueue::is_match(
+    size_t          index,
+    size_t          offset,
+    const uint8_t   *needle,
+    const size_t    needle_len
+) const noexcept {
+    size_t matched = 0U;
+    while (matched < needle_len) {
+        if (index >= this->m_count) {
+            return false;
+        }
+        const Chunk &chunk = this->get_chunk(index);
+        const size_t compare_len = std::min(
+            chunk.buffer.get_length() - chunk.cursor - offset, 
+            needle_len - matched
+        );
+        if (memcmp(
+            chunk.buffer.get_pointer() + chunk.cursor + offset, 
+            needle + matched, 
+            compare_len
+        ) != 0) {
+            return false;
+        }
+        matched += compare_len;
+        offset = 0U;
+        ++index;
+    }
+    return true;
+}
+
+/**
+ *  Append a chunk to the queue back (, and grow the ring if it is full).
+ * 
+ *  @param data
+ *      The data (would be moved into the chunk).
+ */
+void BufferQueue::push_chunk(Buffer &&data) {
+    if (this->m_count == this->m_capacity) {
+        size_t capacity = (this->m_capacity == 0U) ? 
+            QUEUE_RING_INITIAL_CAPACITY : 
+            (this->m_capacity << 1U);
+        Chunk *chunks = static_cast<Chunk*>(
+            ::operator new(capacity * sizeof(Chunk))
+        );
+        for (size_t i = 0U; i < this->m_count; ++i) {
+            Chunk &chunk = this->get_chunk(i);
+            new (&chunks[i]) Chunk{std::move(chunk.buffer), chunk.cursor};
+            chunk.~Chunk();
+        }
+        ::operator delete(this->m_chunks);
+        this->m_chunks = chunks;
+        this->m_capacity = capacity;
+        this->m_head = 0U;
+    }
+
+    new (&(this->get_chunk(this->m_count))) Chunk{std::move(data), 0U};
+    ++this->m_count;
+}
+
+/**
+ *  Remove the chunk at the queue front.
+ */
+void BufferQueue::pop_chunk() noexcept {
+    this->get_chunk(0U).~Chunk();
+    this->m_head = (this->m_head + 1U) & (this->m_capacity - 1U);
+    --this->m_count;
+}
+
+/**
+ *  Compact the run of chunks (which share the same storage) at specified 
+ *  position if it matches the compaction policy (if failed to allocate 
+ *  memory, the remaining chunks of the run are kept as is).
+ * 
+ *  @param index
+ *      The position of the first chunk of the run.
+ *  @param compacted
+ *      The pointer to receive the count of chunks compacted.
+ *  @return
+ *      The count of chunks in the run.
+ */
+size_t BufferQueue::compact_run(
+    const size_t    index,
+    size_t          *compacted
+) noexcept {
+    *compacted = 0U;
+    const Buffer &first = this->get_chunk(index).buffer;
+    size_t live = 0U;
+    size_t end = index;
+    while (end < this->m_count && (end == index || 
+        this->get_chunk(end).buffer.is_sharing_storage(first))) {
+        const Chunk &chunk = this->get_chunk(end);
+        live += chunk.buffer.get_length() - chunk.cursor;
+        ++end;
+    }
+
+    //  Compacted if live < storage * percent / 100 (without overflowing).
+    const size_t storage = first.get_storage_length();
+    const size_t percent = this->m_compaction_percent;
+    if (storage < this->m_compaction_min_storage || 
+        live >= storage / 100U * percent + storage % 100U * percent / 100U) {
+        return end - index;
+    }
+
+    for (size_t i = index; i < end; ++i) {
+        Chunk &chunk = this->get_chunk(i);
+        const size_t length = chunk.buffer.get_length() - chunk.cursor;
+        try {
+            Buffer copied(length, true, *(this->m_compaction_allocator));
+            memcpy(
+                copied.get_pointer(), 
+                chunk.buffer.get_pointer() + chunk.cursor, 
+                length
+            );
+            XAP_CORE_BUFFER_STATS_COPY(length);
+            copied.set_copy_on_write(chunk.buffer.is_copy_on_write());
+            chunk.buffer = std::move(copied);
+            chunk.cursor = 0U;
+        } catch (const std::bad_alloc&) {
+            //  Keep the remaining chunks as is.
+            break;
+        }
+        ++(*compacted);
+    }
+    return end - index;
+}
+
+/**
+ *  Compact the chunks sharing the storage of the front chunk if it was 
+ *  partially consumed and they match the compaction policy.
+ */
+void BufferQueue::compact_front() noexcept {
+    if (this->m_compaction_percent != 0U && this->m_count != 0U && 
+        this->get_chunk(0U).cursor != 0U) {
+        size_t compacted;
+        this->compact_run(0U, &compacted);
+    }
+}
+
+/**
+ *  Check whether bytes can be pushed within the maximum size.
+ * 
+ *  @param size
+ *      The count of bytes.
+ *  @return
+ *      True if so.
+ */
+bool BufferQueue::is_within_budget(const size_t size) const noexcept {
+    return this->m_remaining <= this->m_max_size && 
+        size <= this->m_max_size - this->m_remaining;
+}
+
+/**
+ *  Notify the listener if the remaining size grew to the high watermark.
+ */
+void BufferQueue::check_high_watermark() {
+    if (!this->m_high && this->m_remaining >= this->m_high_watermark) {
+        this->m_high = true;
+        if (this->m_listener != nullptr) {
+            this->m_listener->on_high_watermark(*this);
+        }
+    }
+}
+
+/**
+ *  Notify the listener if the remaining size fell to the low watermark.
+ */
+void BufferQueue::check_low_watermark() {
+    if (this->m_high && this->m_remaining <= this->m_low_watermark) {
+        this->m_high = false;
+        if (this->m_listener != nullptr) {
+            this->m_listener->on_low_watermark(*this);
+        }
+    }
+}
+
+/**
+ *  Destroy all chunks and release the ring.
+ */
+void BufferQueue::release() noexcept {
+    while (this->m_count != 0U) {
+        this->pop_chunk();
+    }
+    ::operator delete(this->m_chunks);
+    this->m_chunks = nullptr;
+    this->m_capacity = 0U;
+    this->m_head = 0U;
+    this->m_remaining = 0U;
+    this->reset_scan();
+}
+
+//
+//  BufferQueueFetcher constructor.
+//
+
+/**
+ *  Construct the object (the cursor and the mark are at the queue front).
+ *
+ *  @param queue
+ *      The queue which would be fetched.
+ */
+BufferQueueFetcher::BufferQueueFetcher(BufferQueue &queue) noexcept :
+    m_queue(&queue),
+    m_index(0U),
+    m_inner(0U),
+    m_position(0U),
+    m_mark_index(0U),
+    m_mark_inner(0U),
+    m_mark_position(0U)
+{
+    //  Do nothing.
+}
+
+//
+//  BufferQueueFetcher public methods.
+//
+
+/**
+ *  Check whether the fetcher is ended (all queued bytes were fetched).
+ *
+ *  @return
+ *      True if so.
+ */
+bool BufferQueueFetcher::is_end() const noexcept {
+    return this->m_position == this->m_queue->m_remaining;
+}
+
+/**
+ *  Reset the fetcher. Move the cursor and the mark to the queue front.
+ */
+void BufferQueueFetcher::reset() noexcept {
+    this->m_index = 0U;
+    this->m_inner = 0U;
+    this->m_position = 0U;
+    this->mark();
+}
+
+/**
+ *  Remember the cursor position (see rewind()).
+ */
+void BufferQueueFetcher::mark() noexcept {
+    this->m_mark_index = this->m_index;
+    this->m_mark_inner = this->m_inner;
+    this->m_mark_position = this->m_position;
+}
+
+/**
+ *  Move the cursor back to the position of the last mark() (or to the
+ *  queue front if not marked since the last commit() or reset()).
+ */
+void BufferQueueFetcher::rewind() noexcept {
+    this->m_index = this->m_mark_index;
+    this->m_inner = this->m_mark_inner;
+    this->m_position = this->m_mark_position;
+}
+
+/**
+ *  Consume the bytes before the cursor from the queue. Then the cursor and
+ *  the mark are at the (new) queue front.
+ */
+void BufferQueueFetcher::commit() {
+    this->m_queue->consume(this->m_position);
+    this->reset();
+}
+
+/**
+ *  Fetch one byte.
+ *
+ *  @throw BufferException
+ *      Raised if the fetcher was ended (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The byte.
+ */
+uint8_t BufferQueueFetcher::fetch() {
+    if (this->is_end()) {
+        throw BufferException(
+            "Reached the end of the buffer.",
+            XAPCORE_BUF_ERROR_OVERFLOW
+        );
+    }
+
+    const BufferQueue::Chunk &chunk = this->m_queue->get_chunk(this->m_index);
+    const uint8_t value =
+        chunk.buffer.get_pointer()[chunk.cursor + this->m_inner];
+    this->advance(1U);
+    return value;
+}
+
+/**
+ *  Fetch an unsigned 8-bit integer (the same as fetch()).
+ *
+ *  @throw BufferException
+ *      Raised if the fetcher was ended (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The unsigned 8-bit integer.
+ */
+uint8_t BufferQueueFetcher::fetch_uint8() {
+    return this->fetch();
+}
+
+/**
+ *  Fetch an unsigned 16-bit integer with big-endian.
+ *
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The unsigned 16-bit integer.
+ */
+uint16_t BufferQueueFetcher::fetch_uint16_be() {
+    uint8_t scratch[2];
+    return endian_read_uint16_be(this->fetch_pointer(2U, scratch));
+}
+
+/**
+ *  Fetch an unsigned 16-bit integer with little-endian.
+ *
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The unsigned 16-bit integer.
+ */
+uint16_t BufferQueueFetcher::fetch_uint16_le() {
+    uint8_t scratch[2];
+    return endian_read_uint16_le(this->fetch_pointer(2U, scratch));
+}
+
+/**
+ *  Fetch a signed 16-bit integer with little-endian.
+ *
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The signed 16-bit integer.
+ */
+int16_t BufferQueueFetcher::fetch_sint16_le() {
+    return static_cast<int16_t>(this->fetch_uint16_le());
+}
+
+/**
+ *  Fetch an unsigned 32-bit integer with big-endian.
+ *
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The unsigned 32-bit integer.
+ */
+uint32_t BufferQueueFetcher::fetch_uint32_be() {
+    uint8_t scratch[4];
+    return endian_read_uint32_be(this->fetch_pointer(4U, scratch));
+}
+
+/**
+ *  Fetch an unsigned 32-bit integer with little-endian.
+ *
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The unsigned 32-bit integer.
+ */
+uint32_t BufferQueueFetcher::fetch_uint32_le() {
+    uint8_t scratch[4];
+    return endian_read_uint32_le(this->fetch_pointer(4U, scratch));
+}
+
+/**
+ *  Fetch a single-precision float-point with big-endian.
+ *
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The single-precision float-point value.
+ */
+float BufferQueueFetcher::fetch_float_be() {
+    return queue_bits_to_float(this->fetch_uint32_be());
+}
+
+/**
+ *  Fetch a single-precision float-point with little-endian.
+ *
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The single-precision float-point value.
+ */
+float BufferQueueFetcher::fetch_float_le() {
+    return queue_bits_to_float(this->fetch_uint32_le());
+}
+
+#if defined(UINT64_MAX)
+
+/**
+ *  Fetch an unsigned 64-bit integer with big-endian.
+ *
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The unsigned 64-bit integer.
+ */
+uint64_t BufferQueueFetcher::fetch_uint64_be() {
+    uint8_t scratch[8];
+    return endian_read_uint64_be(this->fetch_pointer(8U, scratch));
+}
+
+/**
+ *  Fetch an unsigned 64-bit integer with little-endian.
+ *
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The unsigned 64-bit integer.
+ */
+uint64_t BufferQueueFetcher::fetch_uint64_le() {
+    uint8_t scratch[8];
+    return endian_read_uint64_le(this->fetch_pointer(8U, scratch));
+}
+
+/**
+ *  Fetch a double-precision float-point with big-endian.
+ *
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The double-precision float-point value.
+ */
+double BufferQueueFetcher::fetch_double_be() {
+    return queue_bits_to_double(this->fetch_uint64_be());
+}
+
+/**
+ *  Fetch a double-precision float-point with little-endian.
+ *
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The double-precision float-point value.
+ */
+double BufferQueueFetcher::fetch_double_le() {
+    return queue_bits_to_double(this->fetch_uint64_le());
+}
+
+/**
+ *  Fetch an unsigned integer with variable-length (LEB128) encoding.
+ *
+ *  @throw BufferException
+ *      Raised if the encoding is truncated or longer than 64 bits, the
+ *      cursor is not moved (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The unsigned integer.
+ */
+uint64_t BufferQueueFetcher::fetch_varint() {
+    //  At most 10 bytes are decoded (, and copied if they span chunks).
+    uint8_t scratch[10U];
+    const size_t available = std::min<size_t>(this->get_remaining_size(), 10U);
+    const size_t index = this->m_index;
+    const size_t inner = this->m_inner;
+    const size_t position = this->m_position;
+    uint64_t value = 0U;
+    size_t count = 0U;
+    if (available != 0U) {
+        count = kernel_decode_varint(
+            this->fetch_pointer(available, scratch),
+            available,
+            &value
+        );
+    }
+
+    //  Move the cursor back, then over the decoded bytes only.
+    this->m_index = index;
+    this->m_inner = inner;
+    this->m_position = position;
+    if (count == 0U) {
+        throw BufferException(
+            "Invalid or truncated varint.",
+            XAPCORE_BUF_ERROR_OVERFLOW
+        );
+    }
+    this->advance(count);
+    return value;
+}
+
+/**
+ *  Fetch a signed integer with zigzag and variable-length (LEB128)
+ *  encoding.
+ *
+ *  @throw BufferException
+ *      Raised if the encoding is truncated or longer than 64 bits, the
+ *      cursor is not moved (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @return
+ *      The signed integer.
+ */
+int64_t BufferQueueFetcher::fetch_varint_signed() {
+    const uint64_t value = this->fetch_varint();
+    const uint64_t magnitude = value >> 1U;
+    return static_cast<int64_t>((value & 1U) != 0U ? ~magnitude : magnitude);
+}
+
+#endif  //  #if defined(UINT64_MAX)
+
+/**
+ *  Fetch bytes to buffer.
+ *
+ *  @note
+ *      Nothing would be done if destination size is zero.
+ *  @throw BufferException
+ *      Raised if the fetcher was ended (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param destination
+ *      The destination buffer.
+ *  @return
+ *      The number of bytes fetched.
+ */
+size_t BufferQueueFetcher::fetch_to(Buffer &destination) {
+    return this->fetch_to(destination, 0U);
+}
+
+/**
+ *  Fetch bytes to buffer.
+ *
+ *  @note
+ *      Nothing would be done if destination size is zero.
+ *  @throw BufferException
+ *      Raised if the fetcher was ended, or the offset of destination
+ *      buffer is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param destination
+ *      The destination buffer.
+ *  @param destination_offset
+ *      The offset of destination buffer.
+ *  @return
+ *      The number of bytes fetched.
+ */
+size_t BufferQueueFetcher::fetch_to(
+    Buffer          &destination,
+    const size_t    destination_offset
+) {
+    const size_t dst_len = destination.get_length();
+    if (dst_len == 0U) {
+        return 0U;
+    }
+    if (this->is_end()) {
+        throw BufferException(
+            "Reached the end of the buffer.",
+            XAPCORE_BUF_ERROR_OVERFLOW
+        );
+    }
+    if (destination_offset > dst_len) {
+        throw BufferException(
+            "Invalid destination offset.",
+            XAPCORE_BUF_ERROR_OVERFLOW
+        );
+    }
+
+    uint8_t *dst_ptr = destination.get_pointer() + destination_offset;
+    const size_t total = std::min(
+        this->get_remaining_size(),
+        dst_len - destination_offset
+    );
+    size_t copied = 0U;
+    while (copied < total) {
+        const BufferQueue::Chunk &chunk =
+            this->m_queue->get_chunk(this->m_index);
+        const size_t copy_len = std::min(
+            chunk.buffer.get_length() - chunk.cursor - this->m_inner,
+            total - copied
+        );
+        memcpy(
+            dst_ptr + copied,
+            chunk.buffer.get_pointer() + chunk.cursor + this->m_inner,
+            copy_len
+        );
+        copied += copy_len;
+        this->advance(copy_len);
+    }
+    XAP_CORE_BUFFER_STATS_COPY(copied);
+    return copied;
+}
+
+/**
+ *  Fetch all remaining bytes in queue.
+ *
+ *  @note
+ *      Return zero-size buffer if fetcher is ended.
+ *  @return
+ *      The destination buffer.
+ */
+Buffer BufferQueueFetcher::fetch_all() {
+    return this->fetch_bytes(this->get_remaining_size());
+}
+
+/**
+ *  Fetch bytes in queue.
+ *
+ *  @note
+ *      No byte is copied if the bytes are inside one chunk.
+ *  @throw BufferException
+ *      Parameter 'count' was out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param count
+ *      The count of bytes would be fetched.
+ *  @return
+ *      The destination buffer.
+ */
+Buffer BufferQueueFetcher::fetch_bytes(const size_t count) {
+    if (count == 0U) {
+        return Buffer(0U);
+    }
+    if (count > this->get_remaining_size()) {
+        throw BufferException("Out of range.", XAPCORE_BUF_ERROR_OVERFLOW);
+    }
+
+    const BufferQueue::Chunk &chunk = this->m_queue->get_chunk(this->m_index);
+    const size_t begin = chunk.cursor + this->m_inner;
+    if (chunk.buffer.get_length() - begin >= count) {
+        Buffer out = chunk.buffer.slice(begin, count);
+        this->advance(count);
+        return out;
+    }
+
+    //  Spans multiple chunks, coalesce them.
+    Buffer out(count, true);
+    this->fetch_to(out);
+    return out;
+}
+
+/**
+ *  Skip bytes.
+ *
+ *  @throw BufferException
+ *      Raised if parameter 'count' was out of range
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param count
+ *      The count of bytes would be skiped.
+ */
+void BufferQueueFetcher::skip(const size_t count) {
+    if (count > this->get_remaining_size()) {
+        throw BufferException("Out of range.", XAPCORE_BUF_ERROR_OVERFLOW);
+    }
+    this->advance(count);
+}
+
+/**
+ *  Get the count of bytes fetched since the last commit() (or reset()).
+ *
+ *  @return
+ *      The count.
+ */
+size_t BufferQueueFetcher::get_position() const noexcept {
+    return this->m_position;
+}
+
+/**
+ *  Get the remaining size (the queued bytes after the cursor).
+ *
+ *  @return
+ *      The remaining size.
+ */
+size_t BufferQueueFetcher::get_remaining_size() const noexcept {
+    return this->m_queue->m_remaining - this->m_position;
+}
+
+//
+//  BufferQueueFetcher private methods.
+//
+
+/**
+ *  Fetch bytes (without copying if they are inside one chunk).
+ *
+ *  @throw BufferException
+ *      Raised if the remaining bytes are not enough
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param size
+ *      The count of bytes.
+ *  @param scratch
+ *      The memory (at least 'size' bytes) where to copy the bytes if they
+ *      span multiple chunks.
+ *  @return
+ *      The pointer to the bytes (either inside a chunk or 'scratch').
+ */
+const uint8_t* BufferQueueFetcher::fetch_pointer(
+    const size_t    size,
+    uint8_t         *scratch
+) {
+    if (size > this->get_remaining_size()) {
+        throw BufferException(
+            "Reached the end of the buffer.",
+            XAPCORE_BUF_ERROR_OVERFLOW
+        );
+    }
+
+    const BufferQueue::Chunk &chunk = this->m_queue->get_chunk(this->m_index);
+    const size_t begin = chunk.cursor + this->m_inner;
+    if (chunk.buffer.get_length() - begin >= size) {
+        //  Contiguous.
+        const uint8_t *pointer = chunk.buffer.get_pointer() + begin;
+        this->advance(size);
+        return pointer;
+    }
+
+    //  Spans multiple chunks, copy them to the scratch.
+    size_t copied = 0U;
+    while (copied < size) {
+        const BufferQueue::Chunk &current =
+            this->m_queue->get_chunk(this->m_index);
+        const size_t copy_len = std::min(
+            current.buffer.get_length() - current.cursor - this->m_inner,
+            size - copied
+        );
+        memcpy(
+            scratch + copied,
+            current.buffer.get_pointer() + current.cursor + this->m_inner,
+            copy_len
+        );
+        copied += copy_len;
+        this->advance(copy_len);
+    }
+    return scratch;
+}
+
+/**
+ *  Move the cursor forward (inside the remaining bytes).
+ *
+ *  @param count
+ *      The count of bytes.
+ */
+void BufferQueueFetcher::advance(size_t count) noexcept {
+    this->m_position += count;
+    while (count != 0U) {
+        const BufferQueue::Chunk &chunk =
+            this->m_queue->get_chunk(this->m_index);
+        const size_t chunk_remaining =
+            chunk.buffer.get_length() - chunk.cursor - this->m_inner;
+        if (count < chunk_remaining) {
+            this->m_inner += count;
+            return;
+        }
+        count -= chunk_remaining;
+        ++this->m_index;
+        this->m_inner = 0U;
+    }
 }
 
 }  //  namespace buffer
@@ -0,0 +1,240 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+//
+//  Imports.
+//
+#include <xap/core/buffer/stats.h>
+#include "instrument.h"
+
+#if defined(XAP_CORE_BUFFER_STATS)
+# include <atomic>
+# include <mutex>
+#endif
+
+namespace xap {
+namespace core {
+namespace buffer {
+
+#if defined(XAP_CORE_BUFFER_STATS)
+
+//
+//  Private structures.
+//
+
+//
+//  Flusher of the counters of a thread (at the thread exit).
+//
+struct StatsThreadFlusher {
+    /**
+     *  Destruct the object.
+     */
+    ~StatsThreadFlusher() noexcept;
+};
+
+//
+//  Private variables.
+//
+
+//  The counters of the current thread (trivially destructible, so that
+//  they stay usable by the buffers released after the flusher).
+static thread_local BufferStats g_stats_thread_counters;
+static thread_local bool g_stats_thread_exited = false;
+static thread_local StatsThreadFlusher g_stats_thread_flusher;
+
+//  The process-wide live bytes and its maximum.
+static std::atomic<uint64_t> g_stats_live_bytes(0U);
+static std::atomic<uint64_t> g_stats_peak_live_bytes(0U);
+
+//  The export hook (guarded by the lock).
+static std::mutex g_stats_hook_lock;
+static BufferStatsHook g_stats_hook = nullptr;
+static void *g_stats_hook_context = nullptr;
+
+//
+//  Private functions.
+//
+
+/**
+ *  Destruct the object.
+ */
+StatsThreadFlusher::~StatsThreadFlusher() noexcept {
+    g_stats_thread_exited = true;
+    buffer_stats_flush();
+}
+
+/**
+ *  Get the counters of the current thread.
+ *
+ *  @return
+ *      The counters.
+ */
+static BufferStats& stats_get_thread_counters() noexcept {
+    if (!g_stats_thread_exited) {
+        //  Make sure that the flusher is registered in this thread.
+        (void)&g_stats_thread_flusher;
+    }
+    return g_stats_thread_counters;
+}
+
+/**
+ *  Record a buffer storage allocation.
+ *
+ *  @param length
+ *      The length of the storage.
+ */
+void stats_record_allocate(const size_t length) noexcept {
+    BufferStats &counters = stats_get_thread_counters();
+    ++counters.allocations;
+    counters.allocated_bytes += length;
+
+    const uint64_t live = g_stats_live_bytes.fetch_add(
+        length,
+        std::memory_order_relaxed
+    ) + length;
+    uint64_t peak = g_stats_peak_live_bytes.load(std::memory_order_relaxed);
+    while (peak < live && !g_stats_peak_live_bytes.compare_exchange_weak(
+        peak,
+        live,
+        std::memory_order_relaxed
+    )) {
+        //  Retry (the peak was reloaded).
+    }
+}
+
+/**
+ *  Record a buffer storage release.
+ *
+ *  @param length
+ *      The length of the storage.
+ */
+void stats_record_free(const size_t length) noexcept {
+    ++(stats_get_thread_counters().frees);
+    g_stats_live_bytes.fetch_sub(length, std::memory_order_relaxed);
+}
+
+/**
+ *  Record a copy.
+ *
+ *  @param length
+ *      The count of bytes copied.
+ */
+void stats_record_copy(const size_t length) noexcept {
+    stats_get_thread_counters().copied_bytes += length;
+}
+
+/**
+ *  Record a slice creation.
+ */
+void stats_record_slice() noexcept {
+    ++(stats_get_thread_counters().slices);
+}
+
+#endif  //  #if defined(XAP_CORE_BUFFER_STATS)
+
+//
+//  Public functions.
+//
+
+/**
+ *  Check whether the instrumentation is compiled in.
+ *
+ *  @return
+ *      True if so.
+ */
+bool buffer_stats_is_enabled() noexcept {
+#if defined(XAP_CORE_BUFFER_STATS)
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ *  Get the counters of the calling thread.
+ *
+ *  @note
+ *      The counters (except 'live_bytes' and 'peak_live_bytes', which are
+ *      process-wide) only include the operations done by the calling
+ *      thread since it started (or since its last flush / reset).
+ *  @return
+ *      The counters.
+ */
+BufferStats buffer_stats_get_snapshot() noexcept {
+    BufferStats snapshot = BufferStats();
+#if defined(XAP_CORE_BUFFER_STATS)
+    snapshot = stats_get_thread_counters();
+    snapshot.live_bytes = g_stats_live_bytes.load(std::memory_order_relaxed);
+    snapshot.peak_live_bytes =
+        g_stats_peak_live_bytes.load(std::memory_order_relaxed);
+#endif
+    return snapshot;
+}
+
+/**
+ *  Reset the counters of the calling thread (and the peak live bytes to
+ *  the current live bytes).
+ */
+void buffer_stats_reset() noexcept {
+#if defined(XAP_CORE_BUFFER_STATS)
+    stats_get_thread_counters() = BufferStats();
+    g_stats_peak_live_bytes.store(
+        g_stats_live_bytes.load(std::memory_order_relaxed),
+        std::memory_order_relaxed
+    );
+#endif
+}
+
+/**
+ *  Pass the counters of the calling thread to the hook (if any), then
+ *  reset them.
+ *
+ *  @note
+ *      The counters of a thread are also flushed when the thread exits.
+ */
+void buffer_stats_flush() noexcept {
+#if defined(XAP_CORE_BUFFER_STATS)
+    const BufferStats snapshot = buffer_stats_get_snapshot();
+    g_stats_thread_counters = BufferStats();
+
+    BufferStatsHook hook;
+    void *context;
+    {
+        std::lock_guard<std::mutex> guard(g_stats_hook_lock);
+        hook = g_stats_hook;
+        context = g_stats_hook_context;
+    }
+    if (hook != nullptr) {
+        hook(snapshot, context);
+    }
+#endif
+}
+
+/**
+ *  Set the hook which exports the counters.
+ *
+ *  @note
+ *      The hook may be called from any thread (concurrently), and must
+ *      not throw.
+ *  @param hook
+ *      The hook (nullptr to remove).
+ *  @param context
+ *      The context passed to the hook.
+ */
+void buffer_stats_set_hook(BufferStatsHook hook, void *context) noexcept {
+#if defined(XAP_CORE_BUFFER_STATS)
+    std::lock_guard<std::mutex> guard(g_stats_hook_lock);
+    g_stats_hook = hook;
+    g_stats_hook_context = context;
+#else
+    (void)hook;
+    (void)context;
+#endif
+}
+
+}  //  namespace buffer
+}  //  namespace core
+}  //  namespace xap
@@ -0,0 +1,589 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+//
+//  Imports.
+//
+#include <xap/core/buffer/writer.h>
+#include <xap/core/buffer/endian.h>
+#include <algorithm>
+#include <string.h>
+#include <utility>
+#include "instrument.h"
+
+namespace xap {
+namespace core {
+namespace buffer {
+
+//
+//  Constants.
+//
+
+//  The capacity of the first storage (if not reserved).
+static const size_t WRITER_MIN_CAPACITY = 64U;
+
+//
+//  Constructor & destructor.
+//
+
+/**
+ *  Construct the object.
+ *
+ *  @param capacity
+ *      The initial capacity.
+ */
+BufferWriter::BufferWriter(const size_t capacity) :
+    BufferWriter(capacity, BufferAllocator::get_default())
+{
+    //  Do nothing.
+}
+
+/**
+ *  Construct the object.
+ *
+ *  @param capacity
+ *      The initial capacity.
+ *  @param allocator
+ *      The allocator of storage (must outlive the writer and the
+ *      finished buffers).
+ */
+BufferWriter::BufferWriter(
+    const size_t    capacity,
+    BufferAllocator &allocator
+) :
+    m_storage(),
+    m_length(0U),
+    m_allocator(&allocator)
+{
+    this->reserve(capacity);
+}
+
+/**
+ *  Construct (copy) the object.
+ *
+ *  @param src
+ *      The source writer (the written bytes are copied).
+ */
+BufferWriter::BufferWriter(const BufferWriter &src) :
+    m_storage(),
+    m_length(0U),
+    m_allocator(src.m_allocator)
+{
+    this->reserve(src.get_capacity());
+    memcpy(
+        this->append(src.m_length),
+        src.m_storage.get_pointer(),
+        src.m_length
+    );
+}
+
+/**
+ *  Construct (move) the object.
+ *
+ *  @param src
+ *      The source writer (would be empty after moved).
+ */
+BufferWriter::BufferWriter(BufferWriter &&src) noexcept :
+    m_storage(std::move(src.m_storage)),
+    m_length(src.m_length),
+    m_allocator(src.m_allocator)
+{
+    src.m_length = 0U;
+}
+
+/**
+ *  Destruct the object.
+ */
+BufferWriter::~BufferWriter() noexcept {}
+
+//
+//  Public operators.
+//
+
+/**
+ *  Operator '='.
+ *
+ *  @param src
+ *      The source writer (the written bytes are copied).
+ *  @return
+ *      The destination writer.
+ */
+BufferWriter& BufferWriter::operator=(const BufferWriter &src) {
+    if (this != &src) {
+        this->m_allocator = src.m_allocator;
+        this->m_storage = Buffer();
+        this->m_length = 0U;
+        this->reserve(src.get_capacity());
+        memcpy(
+            this->append(src.m_length),
+            src.m_storage.get_pointer(),
+            src.m_length
+        );
+    }
+    return *this;
+}
+
+/**
+ *  Operator '=' (move).
+ *
+ *  @param src
+ *      The source writer (would be empty after moved).
+ *  @return
+ *      The destination writer.
+ */
+BufferWriter& BufferWriter::operator=(BufferWriter &&src) noexcept {
+    if (this != &src) {
+        this->m_storage = std::move(src.m_storage);
+        this->m_length = src.m_length;
+        this->m_allocator = src.m_allocator;
+        src.m_length = 0U;
+    }
+    return *this;
+}
+
+//
+//  Public methods.
+//
+
+/**
+ *  Get the count of written bytes.
+ *
+ *  @return
+ *      The length.
+ */
+size_t BufferWriter::get_length() const noexcept {
+    return this->m_length;
+}
+
+/**
+ *  Get the count of bytes which can be written without growing.
+ *
+ *  @return
+ *      The capacity.
+ */
+size_t BufferWriter::get_capacity() const noexcept {
+    return this->m_storage.get_length();
+}
+
+/**
+ *  Make sure that at least 'capacity' bytes can be held without
+ *  growing.
+ *
+ *  @param capacity
+ *      The capacity.
+ */
+void BufferWriter::reserve(const size_t capacity) {
+    if (capacity > this->get_capacity()) {
+        this->grow(capacity);
+    }
+}
+
+/**
+ *  Discard all written bytes (the storage is kept).
+ */
+void BufferWriter::clear() noexcept {
+    this->m_length = 0U;
+}
+
+/**
+ *  Append raw bytes.
+ *
+ *  @throw BufferException
+ *      Raised if the length overflowed (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param data
+ *      The bytes.
+ *  @param datalen
+ *      The count of bytes.
+ */
+void BufferWriter::write_bytes(const uint8_t *data, const size_t datalen) {
+    if (datalen != 0U) {
+        memcpy(this->append(datalen), data, datalen);
+    }
+}
+
+/**
+ *  Append the bytes of a buffer.
+ *
+ *  @throw BufferException
+ *      Raised if the length overflowed (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param data
+ *      The buffer.
+ */
+void BufferWriter::write_bytes(const Buffer &data) {
+    this->write_bytes(data.get_pointer(), data.get_length());
+}
+
+/**
+ *  Append zero bytes (e.g. a placeholder to patch later).
+ *
+ *  @throw BufferException
+ *      Raised if the length overflowed (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param count
+ *      The count of bytes.
+ *  @return
+ *      The offset of the first appended byte.
+ */
+size_t BufferWriter::skip(const size_t count) {
+    const size_t offset = this->m_length;
+    if (count != 0U) {
+        memset(this->append(count), 0, count);
+    }
+    return offset;
+}
+
+/**
+ *  Append an unsigned 8-bit integer.
+ *
+ *  @param value
+ *      The unsigned 8-bit integer.
+ */
+void BufferWriter::write_uint8(const uint8_t value) {
+    *(this->append(1U)) = value;
+}
+
+/**
+ *  Append an unsigned 16-bit integer with big-endian.
+ *
+ *  @param value
+ *      The unsigned 16-bit integer.
+ */
+void BufferWriter::write_uint16_be(const uint16_t value) {
+    endian_write_uint16_be(this->append(2U), value);
+}
+
+/**
+ *  Append an unsigned 16-bit integer with little-endian.
+ *
+ *  @param value
+ *      The unsigned 16-bit integer.
+ */
+void BufferWriter::write_uint16_le(const uint16_t value) {
+    endian_write_uint16_le(this->append(2U), value);
+}
+
+/**
+ *  Append an unsigned 32-bit integer with big-endian.
+ *
+ *  @param value
+ *      The unsigned 32-bit integer.
+ */
+void BufferWriter::write_uint32_be(const uint32_t value) {
+    endian_write_uint32_be(this->append(4U), value);
+}
+
+/**
+ *  Append an unsigned 32-bit integer with little-endian.
+ *
+ *  @param value
+ *      The unsigned 32-bit integer.
+ */
+void BufferWriter::write_uint32_le(const uint32_t value) {
+    endian_write_uint32_le(this->append(4U), value);
+}
+
+#if defined(UINT64_MAX)
+
+/**
+ *  Append an unsigned 64-bit integer with big-endian.
+ *
+ *  @param value
+ *      The unsigned 64-bit integer.
+ */
+void BufferWriter::write_uint64_be(const uint64_t value) {
+    endian_write_uint64_be(this->append(8U), value);
+}
+
+/**
+ *  Append an unsigned 64-bit integer with little-endian.
+ *
+ *  @param value
+ *      The unsigned 64-bit integer.
+ */
+void BufferWriter::write_uint64_le(const uint64_t value) {
+    endian_write_uint64_le(this->append(8U), value);
+}
+
+/**
+ *  Append an unsigned integer with variable-length (LEB128) encoding.
+ *
+ *  @param value
+ *      The unsigned integer (1 to 10 bytes are appended).
+ */
+void BufferWriter::write_varint(const uint64_t value) {
+    uint8_t encoded[10U];
+    size_t count = 0U;
+    uint64_t remaining = value;
+    while (remaining >= 0x80U) {
+        encoded[count++] = static_cast<uint8_t>((remaining & 0x7FU) | 0x80U);
+        remaining >>= 7U;
+    }
+    encoded[count++] = static_cast<uint8_t>(remaining);
+    memcpy(this->append(count), encoded, count);
+}
+
+/**
+ *  Append a signed integer with zigzag and variable-length (LEB128)
+ *  encoding.
+ *
+ *  @param value
+ *      The signed integer (1 to 10 bytes are appended).
+ */
+void BufferWriter::write_varint_signed(const int64_t value) {
+    const uint64_t shifted = static_cast<uint64_t>(value) << 1U;
+    this->write_varint(value < 0 ? ~shifted : shifted);
+}
+
+#endif  //  #if defined(UINT64_MAX)
+
+/**
+ *  Append a single-precision float-point with big-endian.
+ *
+ *  @param value
+ *      The single-precision float-point value.
+ */
+void BufferWriter::write_float_be(const float value) {
+    const size_t offset = this->m_length;
+    this->append(4U);
+    this->m_storage.write_float_be(value, offset);
+}
+
+/**
+ *  Append a single-precision float-point with little-endian.
+ *
+ *  @param value
+ *      The single-precision float-point value.
+ */
+void BufferWriter::write_float_le(const float value) {
+    const size_t offset = this->m_length;
+    this->append(4U);
+    this->m_storage.write_float_le(value, offset);
+}
+
+/**
+ *  Append a double-precision float-point with big-endian.
+ *
+ *  @param value
+ *      The double-precision float-point value.
+ */
+void BufferWriter::write_double_be(const double value) {
+    const size_t offset = this->m_length;
+    this->append(8U);
+    this->m_storage.write_double_be(value, offset);
+}
+
+/**
+ *  Append a double-precision float-point with little-endian.
+ *
+ *  @param value
+ *      The double-precision float-point value.
+ */
+void BufferWriter::write_double_le(const double value) {
+    const size_t offset = this->m_length;
+    this->append(8U);
+    this->m_storage.write_double_le(value, offset);
+}
+
+/**
+ *  Overwrite an unsigned 8-bit integer in the written bytes.
+ *
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param value
+ *      The unsigned 8-bit integer.
+ *  @param offset
+ *      The offset.
+ */
+void BufferWriter::patch_uint8(const uint8_t value, const size_t offset) {
+    *(this->check_patch(offset, 1U)) = value;
+}
+
+/**
+ *  Overwrite an unsigned 16-bit integer with big-endian in the written
+ *  bytes.
+ *
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param value
+ *      The unsigned 16-bit integer.
+ *  @param offset
+ *      The offset.
+ */
+void BufferWriter::patch_uint16_be(const uint16_t value, const size_t offset) {
+    endian_write_uint16_be(this->check_patch(offset, 2U), value);
+}
+
+/**
+ *  Overwrite an unsigned 16-bit integer with little-endian in the
+ *  written bytes.
+ *
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param value
+ *      The unsigned 16-bit integer.
+ *  @param offset
+ *      The offset.
+ */
+void BufferWriter::patch_uint16_le(const uint16_t value, const size_t offset) {
+    endian_write_uint16_le(this->check_patch(offset, 2U), value);
+}
+
+/**
+ *  Overwrite an unsigned 32-bit integer with big-endian in the written
+ *  bytes.
+ *
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param value
+ *      The unsigned 32-bit integer.
+ *  @param offset
+ *      The offset.
+ */
+void BufferWriter::patch_uint32_be(const uint32_t value, const size_t offset) {
+    endian_write_uint32_be(this->check_patch(offset, 4U), value);
+}
+
+/**
+ *  Overwrite an unsigned 32-bit integer with little-endian in the
+ *  written bytes.
+ *
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param value
+ *      The unsigned 32-bit integer.
+ *  @param offset
+ *      The offset.
+ */
+void BufferWriter::patch_uint32_le(const uint32_t value, const size_t offset) {
+    endian_write_uint32_le(this->check_patch(offset, 4U), value);
+}
+
+#if defined(UINT64_MAX)
+
+/**
+ *  Overwrite an unsigned 64-bit integer with big-endian in the written
+ *  bytes.
+ *
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param value
+ *      The unsigned 64-bit integer.
+ *  @param offset
+ *      The offset.
+ */
+void BufferWriter::patch_uint64_be(const uint64_t value, const size_t offset) {
+    endian_write_uint64_be(this->check_patch(offset, 8U), value);
+}
+
+/**
+ *  Overwrite an unsigned 64-bit integer with little-endian in the
+ *  written bytes.
+ *
+ *  @throw BufferException
+ *      Raised if 'offset' is out of range (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param value
+ *      The unsigned 64-bit integer.
+ *  @param offset
+ *      The offset.
+ */
+void BufferWriter::patch_uint64_le(const uint64_t value, const size_t offset) {
+    endian_write_uint64_le(this->check_patch(offset, 8U), value);
+}
+
+#endif  //  #if defined(UINT64_MAX)
+
+/**
+ *  Finish writing, get the written bytes (without copying).
+ *
+ *  @note
+ *      The writer is empty (with no storage) after finished.
+ *  @return
+ *      The buffer.
+ */
+Buffer BufferWriter::finish() {
+    Buffer written = this->m_storage.slice(0U, this->m_length);
+    this->m_storage = Buffer();
+    this->m_length = 0U;
+    return written;
+}
+
+//
+//  Private methods.
+//
+
+/**
+ *  Make room for appending bytes.
+ *
+ *  @throw BufferException
+ *      Raised if the length overflowed (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param count
+ *      The count of bytes would be appended.
+ *  @return
+ *      The pointer to the first appended byte (the written length is
+ *      increased by 'count').
+ */
+uint8_t* BufferWriter::append(const size_t count) {
+    const size_t capacity = this->get_capacity();
+    if (count > capacity - this->m_length) {
+        if (count > SIZE_MAX - this->m_length) {
+            throw BufferException(
+                "Length overflowed.",
+                XAPCORE_BUF_ERROR_OVERFLOW
+            );
+        }
+
+        //  Grow geometrically to keep appending amortized O(1).
+        const size_t required = this->m_length + count;
+        size_t grown = capacity > SIZE_MAX / 2U ? SIZE_MAX : capacity * 2U;
+        grown = std::max(grown, WRITER_MIN_CAPACITY);
+        this->grow(std::max(grown, required));
+    }
+    uint8_t *pointer = this->m_storage.get_pointer() + this->m_length;
+    this->m_length += count;
+    return pointer;
+}
+
+/**
+ *  Check if a patch at 'offset' is out of the written bytes.
+ *
+ *  @throw BufferException
+ *      Raised if 'offset' or 'size' is out of range
+ *      (XAPCORE_BUF_ERROR_OVERFLOW).
+ *  @param offset
+ *      The offset.
+ *  @param size
+ *      The size of the patch.
+ *  @return
+ *      The pointer to the patched bytes.
+ */
+uint8_t* BufferWriter::check_patch(const size_t offset, const size_t size) {
+    if (offset > this->m_length || size > this->m_length - offset) {
+        throw BufferException("Offset overflowed.", XAPCORE_BUF_ERROR_OVERFLOW);
+    }
+    return this->m_storage.get_pointer() + offset;
+}
+
+/**
+ *  Replace the storage with a bigger one.
+ *
+ *  @param capacity
+ *      The new capacity (must not be less than the written length).
+ */
+void BufferWriter::grow(const size_t capacity) {
+    Buffer storage(capacity, true, *(this->m_allocator));
+    if (this->m_length != 0U) {
+        memcpy(
+            storage.get_pointer(),
+            this->m_storage.get_pointer(),
+            this->m_length
+        );
+        XAP_CORE_BUFFER_STATS_COPY(this->m_length);
+    }
+    this->m_storage = std::move(storage);
+}
+
+}  //  namespace buffer
+}  //  namespace core
+}  //  namespace xap
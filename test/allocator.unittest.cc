@@ -0,0 +1,496 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+//
+//  Imports.
+//
+#include "common.h"
+
+#include <xap/core/buffer/allocator.h>
+#include <xap/core/buffer/buffer.h>
+#include <new>
+#include <stdint.h>
+
+//
+//  Classes.
+//
+
+//
+//  Allocator which counts requests (and forwards them to the heap).
+//
+class CountingAllocator: public xap::core::buffer::BufferAllocator {
+public:
+    CountingAllocator() noexcept :
+        allocations(0U),
+        deallocations(0U),
+        live_bytes(0U)
+    {}
+
+    virtual void* allocate(const size_t size, const size_t alignment) {
+        ++this->allocations;
+        this->live_bytes += size;
+        return xap::core::buffer::BufferAllocator::get_heap().allocate(
+            size,
+            alignment
+        );
+    }
+
+    virtual void deallocate(
+        void            *pointer,
+        const size_t    size,
+        const size_t    alignment
+    ) noexcept {
+        ++this->deallocations;
+        this->live_bytes -= size;
+        xap::core::buffer::BufferAllocator::get_heap().deallocate(
+            pointer,
+            size,
+            alignment
+        );
+    }
+
+    size_t allocations;
+    size_t deallocations;
+    size_t live_bytes;
+};
+
+//
+//  Page allocator which records the size of the last request.
+//
+class RecordingPageAllocator: public xap::core::buffer::BufferPageAllocator {
+public:
+    explicit RecordingPageAllocator(
+        const xap::core::buffer::BufferHugePageMode mode
+    ) noexcept :
+        xap::core::buffer::BufferPageAllocator(mode),
+        last_size(0U)
+    {}
+
+    virtual void* allocate(const size_t size, const size_t alignment) {
+        this->last_size = size;
+        return xap::core::buffer::BufferPageAllocator::allocate(
+            size,
+            alignment
+        );
+    }
+
+    size_t last_size;
+};
+
+//
+//  Entry.
+//
+int main() {
+    //
+    //  Case 1: Buffer storage and control block share one allocation.
+    //
+    {
+        CountingAllocator counting;
+        {
+            xap::core::buffer::Buffer buf(100U, false, counting);
+            xap::test::assert_equal<size_t>(
+                counting.allocations,
+                1U,
+                "Case 1: counting.allocations != 1U"
+            );
+            xap::test::assert_ok(
+                counting.live_bytes >= 100U,
+                "Case 1: counting.live_bytes < 100U"
+            );
+            xap::test::assert_ok(
+                reinterpret_cast<uintptr_t>(buf.get_pointer()) %
+                    alignof(max_align_t) == 0U,
+                "Case 1: buffer storage is not aligned."
+            );
+            buf.write_uint32_be(0x01020304U, 96U);
+
+            xap::core::buffer::Buffer slice = buf.slice(96U);
+            xap::core::buffer::Buffer copied(slice);
+            xap::test::assert_equal<uint32_t>(
+                copied.read_uint32_be(0U),
+                0x01020304U,
+                "Case 1: copied.read_uint32_be(0U) != 0x01020304U"
+            );
+            xap::test::assert_equal<size_t>(
+                counting.allocations,
+                1U,
+                "Case 1: slice() allocated memory."
+            );
+        }
+        xap::test::assert_equal<size_t>(
+            counting.deallocations,
+            1U,
+            "Case 1: counting.deallocations != 1U"
+        );
+        xap::test::assert_equal<size_t>(
+            counting.live_bytes,
+            0U,
+            "Case 1: counting.live_bytes != 0U"
+        );
+
+        const uint8_t data[] = {0x01, 0x02, 0x03};
+        xap::core::buffer::Buffer buf(data, sizeof(data), counting);
+        xap::test::assert_ok(
+            buf.is_equal(data, sizeof(data)),
+            "Case 1: !buf.is_equal(data, sizeof(data))"
+        );
+    }
+
+    //
+    //  Case 2: Default allocator of current thread.
+    //
+    {
+        CountingAllocator counting;
+        xap::core::buffer::BufferAllocator::set_default(&counting);
+        xap::test::assert_ok(
+            &(xap::core::buffer::BufferAllocator::get_default()) == &counting,
+            "Case 2: get_default() != &counting"
+        );
+        {
+            xap::core::buffer::Buffer buf1(16U);
+            xap::core::buffer::Buffer buf2(16U, true);
+            xap::test::assert_equal<size_t>(
+                counting.allocations,
+                2U,
+                "Case 2: counting.allocations != 2U"
+            );
+        }
+        xap::core::buffer::BufferAllocator::set_default(nullptr);
+        xap::test::assert_ok(
+            &(xap::core::buffer::BufferAllocator::get_default()) ==
+                &(xap::core::buffer::BufferAllocator::get_heap()),
+            "Case 2: get_default() != &get_heap()"
+        );
+        xap::test::assert_equal<size_t>(
+            counting.deallocations,
+            2U,
+            "Case 2: counting.deallocations != 2U"
+        );
+    }
+
+    //
+    //  Case 3: Pool allocator.
+    //
+    {
+        xap::core::buffer::BufferPoolAllocator pool(4096U);
+        void *block1 = pool.allocate(1000U, 16U);
+        void *block2 = pool.allocate(1000U, 16U);
+        xap::test::assert_ok(
+            block1 != block2,
+            "Case 3: block1 == block2"
+        );
+        xap::test::assert_ok(
+            reinterpret_cast<uintptr_t>(block1) % 64U == 0U,
+            "Case 3: block1 is not aligned."
+        );
+        pool.deallocate(block1, 1000U, 16U);
+        void *block3 = pool.allocate(1000U, 16U);
+        xap::test::assert_ok(
+            block1 == block3,
+            "Case 3: block1 was not recycled."
+        );
+        pool.deallocate(block2, 1000U, 16U);
+        pool.deallocate(block3, 1000U, 16U);
+
+        //  Requests bigger than the biggest class go to the heap.
+        void *large = pool.allocate(8192U, 16U);
+        pool.deallocate(large, 8192U, 16U);
+
+        const uint8_t *previous = nullptr;
+        for (size_t i = 0U; i < 4U; ++i) {
+            xap::core::buffer::Buffer buf(2048U, false, pool);
+            buf.fill(static_cast<uint8_t>(i));
+            xap::test::assert_equal<uint8_t>(
+                buf.read_uint8(2047U),
+                static_cast<uint8_t>(i),
+                "Case 3: buf.read_uint8(2047U) != i"
+            );
+            if (previous != nullptr) {
+                xap::test::assert_ok(
+                    previous == buf.get_pointer(),
+                    "Case 3: buffer storage was not recycled."
+                );
+            }
+            previous = buf.get_pointer();
+        }
+    }
+
+    //
+    //  Case 4: Arena allocator.
+    //
+    {
+        xap::core::buffer::BufferArenaAllocator arena(1024U);
+        {
+            xap::core::buffer::Buffer buf1(100U, false, arena);
+            xap::core::buffer::Buffer buf2(100U, false, arena);
+            xap::core::buffer::Buffer buf3(4096U, false, arena);
+            buf3.write_uint8(0xAB, 4095U);
+            xap::test::assert_equal<uint8_t>(
+                buf3.read_uint8(4095U),
+                0xAB,
+                "Case 4: buf3.read_uint8(4095U) != 0xAB"
+            );
+            xap::test::assert_ok(
+                arena.get_used_size() >= 4296U,
+                "Case 4: arena.get_used_size() < 4296U"
+            );
+        }
+        arena.reset();
+        xap::test::assert_equal<size_t>(
+            arena.get_used_size(),
+            0U,
+            "Case 4: arena.get_used_size() != 0U"
+        );
+
+        void *block1 = arena.allocate(10U, 64U);
+        xap::test::assert_ok(
+            reinterpret_cast<uintptr_t>(block1) % 64U == 0U,
+            "Case 4: block1 is not aligned."
+        );
+    }
+
+    //
+    //  Case 5: Over-aligned heap allocation.
+    //
+    {
+        xap::core::buffer::BufferAllocator &heap =
+            xap::core::buffer::BufferAllocator::get_heap();
+        void *block = heap.allocate(100U, 256U);
+        xap::test::assert_ok(
+            reinterpret_cast<uintptr_t>(block) % 256U == 0U,
+            "Case 5: block is not aligned."
+        );
+        heap.deallocate(block, 100U, 256U);
+    }
+
+    //
+    //  Case 6: Empty buffers don't allocate.
+    //
+    {
+        CountingAllocator counting;
+        xap::core::buffer::BufferAllocator::set_default(&counting);
+        {
+            xap::core::buffer::Buffer buf1(0U);
+            xap::core::buffer::Buffer buf2(0U, true);
+            xap::core::buffer::Buffer buf3(0U, false, counting);
+            xap::core::buffer::Buffer buf4;
+            xap::core::buffer::Buffer buf5 = buf1.slice(0U);
+            xap::test::assert_ok(
+                buf1 == buf2 && buf3 == buf4 && buf5.get_length() == 0U,
+                "Case 6: empty buffers are not equal."
+            );
+            xap::test::assert_ok(
+                buf1.get_pointer() != nullptr,
+                "Case 6: buf1.get_pointer() == nullptr"
+            );
+        }
+        xap::core::buffer::BufferAllocator::set_default(nullptr);
+        xap::test::assert_equal<size_t>(
+            counting.allocations,
+            0U,
+            "Case 6: counting.allocations != 0U"
+        );
+    }
+
+    //
+    //  Case 7: Aligned buffers and page allocator.
+    //
+    {
+        xap::core::buffer::Buffer buf1(
+            100U, 
+            false, 
+            xap::core::buffer::Buffer::CACHE_LINE_ALIGNMENT
+        );
+        xap::test::assert_ok(
+            buf1.is_aligned(64U) && buf1.read_uint8(99U) == 0U,
+            "Case 7: buf1 is not aligned."
+        );
+        xap::test::assert_ok(
+            !buf1.slice(1U).is_aligned(2U) && !buf1.is_aligned(0U),
+            "Case 7: misaligned slice was reported as aligned."
+        );
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                xap::core::buffer::Buffer(16U, true, 24U);
+            },
+            "Case 7: alignment 24 was accepted."
+        );
+
+        const xap::core::buffer::BufferHugePageMode modes[] = {
+            xap::core::buffer::BUFFER_HUGE_PAGE_NONE,
+            xap::core::buffer::BUFFER_HUGE_PAGE_TRANSPARENT,
+            xap::core::buffer::BUFFER_HUGE_PAGE_EXPLICIT
+        };
+        for (const xap::core::buffer::BufferHugePageMode mode: modes) {
+            xap::core::buffer::BufferPageAllocator pages(mode);
+            xap::test::assert_ok(
+                pages.get_mode() == mode,
+                "Case 7: pages.get_mode() mismatch."
+            );
+            void *block = pages.allocate(3U << 20U, 64U);
+            xap::test::assert_ok(
+                reinterpret_cast<uintptr_t>(block) % 
+                    xap::core::buffer::BufferPageAllocator::get_page_size() 
+                    == 0U,
+                "Case 7: block is not page-aligned."
+            );
+            static_cast<uint8_t*>(block)[(3U << 20U) - 1U] = 0xA5U;
+            pages.deallocate(block, 3U << 20U, 64U);
+
+            //  Only large requests are rounded up to huge pages.
+            const size_t page_size = 
+                xap::core::buffer::BufferPageAllocator::get_page_size();
+            xap::test::assert_ok(
+                pages.get_mapping_length(64U) == page_size && 
+                    pages.get_mapping_length(3U << 20U) == (
+                        mode == xap::core::buffer::BUFFER_HUGE_PAGE_NONE ? 
+                            (3U << 20U) : 
+                            (4U << 20U)
+                    ),
+                "Case 7: pages.get_mapping_length() mismatch."
+            );
+            void *small = pages.allocate(64U, 64U);
+            static_cast<uint8_t*>(small)[63U] = 0x5AU;
+            pages.deallocate(small, 64U, 64U);
+
+            xap::core::buffer::Buffer buf2(
+                8192U, 
+                false, 
+                xap::core::buffer::Buffer::PAGE_ALIGNMENT, 
+                pages
+            );
+            buf2.write_uint32_be(0xDEADBEEFU, 8188U);
+            xap::test::assert_ok(
+                buf2.is_aligned(4096U) && 
+                    buf2.read_uint32_be(8188U) == 0xDEADBEEFU,
+                "Case 7: page-aligned buffer mismatch."
+            );
+        }
+    }
+
+    //
+    //  Case 8: Near-SIZE_MAX lengths are rejected before the size wraps.
+    //
+    {
+        CountingAllocator counting;
+        xap::test::assert_throw<std::bad_alloc>(
+            [&]() {
+                xap::core::buffer::Buffer(SIZE_MAX - 8U, true, counting);
+            },
+            "Case 8: Buffer(SIZE_MAX - 8U) did not throw std::bad_alloc."
+        );
+        xap::test::assert_throw<std::bad_alloc>(
+            [&]() {
+                xap::core::buffer::Buffer(SIZE_MAX - 8U, true, 64U);
+            },
+            "Case 8: aligned Buffer(SIZE_MAX - 8U) did not throw."
+        );
+        xap::test::assert_equal<size_t>(
+            counting.allocations,
+            0U,
+            "Case 8: counting.allocations != 0U"
+        );
+        xap::test::assert_throw<std::bad_alloc>(
+            [&]() {
+                xap::core::buffer::BufferAllocator::get_heap().allocate(
+                    SIZE_MAX - 8U, 
+                    256U
+                );
+            },
+            "Case 8: heap.allocate(SIZE_MAX - 8U, 256U) did not throw."
+        );
+        xap::core::buffer::BufferArenaAllocator arena(1024U);
+        xap::test::assert_throw<std::bad_alloc>(
+            [&]() {
+                arena.allocate(SIZE_MAX - 8U, 16U);
+            },
+            "Case 8: arena.allocate(SIZE_MAX - 8U, 16U) did not throw."
+        );
+    }
+
+    //
+    //  Case 9: Power-of-2 buffers fit their pool class exactly.
+    //
+    {
+        const size_t sizes[] = {1024U, 4096U, 16384U};
+        for (const size_t size: sizes) {
+            //  The biggest class is 'size', so a request bigger than 'size'
+            //  would be served by the heap.
+            xap::core::buffer::BufferPoolAllocator pool(size);
+            void *block = pool.allocate(size, 16U);
+            pool.deallocate(block, size, 16U);
+            {
+                xap::core::buffer::Buffer buf(size, false, pool);
+                xap::test::assert_ok(
+                    buf.get_pointer() == block,
+                    "Case 9: buffer storage was not served by its class."
+                );
+                buf.write_uint8(0x5AU, size - 1U);
+            }
+            void *recycled = pool.allocate(size, 16U);
+            xap::test::assert_ok(
+                recycled == block,
+                "Case 9: buffer storage was not returned to its class."
+            );
+            pool.deallocate(recycled, size, 16U);
+        }
+    }
+
+    //
+    //  Case 10: Page allocator maps buffer storage at the mapping base.
+    //
+    {
+        const size_t page_size = 
+            xap::core::buffer::BufferPageAllocator::get_page_size();
+        const size_t huge_size = 2U << 20U;
+        const xap::core::buffer::BufferHugePageMode modes[] = {
+            xap::core::buffer::BUFFER_HUGE_PAGE_NONE,
+            xap::core::buffer::BUFFER_HUGE_PAGE_TRANSPARENT,
+            xap::core::buffer::BUFFER_HUGE_PAGE_EXPLICIT
+        };
+        for (const xap::core::buffer::BufferHugePageMode mode: modes) {
+            RecordingPageAllocator pages(mode);
+            const bool huge = 
+                (mode != xap::core::buffer::BUFFER_HUGE_PAGE_NONE);
+
+            xap::core::buffer::Buffer small(
+                2U * page_size, 
+                false, 
+                xap::core::buffer::Buffer::PAGE_ALIGNMENT, 
+                pages
+            );
+            xap::test::assert_ok(
+                pages.last_size == 2U * page_size &&
+                    pages.get_mapping_length(pages.last_size) == 
+                        2U * page_size,
+                "Case 10: small mapping is bigger than the buffer."
+            );
+            xap::test::assert_ok(
+                small.is_aligned(page_size),
+                "Case 10: small buffer is not page-aligned."
+            );
+
+            xap::core::buffer::Buffer large(
+                huge_size, 
+                false, 
+                xap::core::buffer::Buffer::PAGE_ALIGNMENT, 
+                pages
+            );
+            xap::test::assert_ok(
+                pages.last_size == huge_size &&
+                    pages.get_mapping_length(pages.last_size) == huge_size,
+                "Case 10: large mapping is bigger than the buffer."
+            );
+            xap::test::assert_ok(
+                large.is_aligned(huge ? huge_size : page_size),
+                "Case 10: large buffer is not (huge) page-aligned."
+            );
+            large.write_uint8(0xA5U, huge_size - 1U);
+        }
+    }
+
+    return 0;
+}
@@ -7,6 +7,7 @@
 //
 //  Imports.
 //
+#include "build.h"
 #include "common.h"
 
 #include "xap/core/buffer/buffer.h"
@@ -14,6 +15,7 @@
 #include <cmath>
 #include <limits>
 #include <stdio.h>
+#include <utility>
 
 //
 //  Functions.
@@ -196,6 +198,22 @@ void xap_assert_buffer_equal_double_le(
     );
 }
 
+/**
+ *  Release the memory adopted by Buffer::wrap() (counts the calls).
+ * 
+ *  @param data
+ *      The memory.
+ *  @param datalen
+ *      The length of the memory.
+ *  @param context
+ *      The counter.
+ */
+void xap_release_wrapped(uint8_t *data, const size_t datalen, void *context) {
+    (void)datalen;
+    delete[] data;
+    ++*static_cast<size_t*>(context);
+}
+
 //
 //  Entry.
 //
@@ -621,5 +639,719 @@ int main() {
         );
     }
 
+    //
+    //  Case 14: move semantics.
+    //
+    {
+        const uint8_t expected[] = {0x01, 0x02, 0x03, 0x04};
+        xap::core::buffer::Buffer src(expected, sizeof(expected));
+        const uint8_t *pointer = src.get_pointer();
+
+        xap::core::buffer::Buffer moved(std::move(src));
+        xap::test::assert_ok(
+            moved.get_pointer() == pointer,
+            "Case 14: moved.get_pointer() != pointer"
+        );
+        xap::test::assert_ok(
+            moved.is_equal(expected, sizeof(expected)),
+            "Case 14: !moved.is_equal(expected, sizeof(expected))"
+        );
+        xap::test::assert_equal<size_t>(
+            src.get_length(),
+            0U,
+            "Case 14: src.get_length() != 0U"
+        );
+        xap::test::assert_ok(
+            src.slice(0U) == xap::core::buffer::Buffer(0U),
+            "Case 14: src.slice(0U) != Buffer(0U)"
+        );
+
+        xap::core::buffer::Buffer assigned(8U);
+        assigned = std::move(moved);
+        xap::test::assert_ok(
+            assigned.get_pointer() == pointer,
+            "Case 14: assigned.get_pointer() != pointer"
+        );
+        xap::test::assert_equal<size_t>(
+            moved.get_length(),
+            0U,
+            "Case 14: moved.get_length() != 0U"
+        );
+    }
+
+    //
+    //  Case 15: Validated-range accessor and bulk accessors.
+    //
+    {
+        const uint8_t data[] = {
+            0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09
+        };
+        xap::core::buffer::Buffer buf(data, sizeof(data));
+        xap::core::buffer::BufferAccessor accessor = buf.access(1U, 8U);
+        xap::test::assert_equal<size_t>(
+            accessor.get_length(),
+            8U,
+            "Case 15: accessor.get_length() != 8U"
+        );
+        xap::test::assert_equal<uint16_t>(
+            accessor.read_uint16_be(0U),
+            0x0203U,
+            "Case 15: accessor.read_uint16_be(0U) != 0x0203U"
+        );
+        xap::test::assert_equal<uint32_t>(
+            accessor.read_uint32_le(4U),
+            0x09080706U,
+            "Case 15: accessor.read_uint32_le(4U) != 0x09080706U"
+        );
+        xap::test::assert_equal<uint64_t>(
+            accessor.read_uint64_be(0U),
+            buf.read_uint64_be(1U),
+            "Case 15: accessor.read_uint64_be(0U) != buf.read_uint64_be(1U)"
+        );
+        accessor.write_uint32_be(0xAABBCCDDU, 2U);
+        xap::test::assert_equal<uint32_t>(
+            buf.read_uint32_be(3U),
+            0xAABBCCDDU,
+            "Case 15: buf.read_uint32_be(3U) != 0xAABBCCDDU"
+        );
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                buf.access(2U, 8U);
+            },
+            "Case 15: buf.access(2U, 8U) didn't throw."
+        );
+
+        //  Float-point values (same encoding as the checked accessors).
+        xap::core::buffer::Buffer floats(24U);
+        xap::core::buffer::Buffer expected(24U);
+        xap::core::buffer::BufferAccessor float_accessor =
+            floats.access(0U, 24U);
+        float_accessor.write_float_be(-1.5F, 0U);
+        float_accessor.write_float_le(3.25F, 4U);
+        float_accessor.write_double_be(-0.1, 8U);
+        float_accessor.write_double_le(1.0e300, 16U);
+        expected.write_float_be(-1.5F, 0U);
+        expected.write_float_le(3.25F, 4U);
+        expected.write_double_be(-0.1, 8U);
+        expected.write_double_le(1.0e300, 16U);
+        xap::test::assert_ok(
+            floats == expected && floats.read_uint32_be(0U) == 0xBFC00000U,
+            "Case 15: accessor float-point writes mismatch."
+        );
+        xap::test::assert_ok(
+            float_accessor.read_float_be(0U) == -1.5F &&
+                float_accessor.read_float_le(4U) == 3.25F &&
+                float_accessor.read_double_be(8U) ==
+                    expected.read_double_be(8U) &&
+                float_accessor.read_double_le(16U) ==
+                    expected.read_double_le(16U),
+            "Case 15: accessor float-point reads mismatch."
+        );
+
+        const uint16_t values16[] = {0x0102U, 0x0304U, 0x0506U};
+        xap::core::buffer::Buffer buf16(6U);
+        buf16.write_uint16_le_array(0U, values16, 3U);
+        xap::test::assert_equal<uint16_t>(
+            buf16.read_uint16_le(4U),
+            0x0506U,
+            "Case 15: buf16.read_uint16_le(4U) != 0x0506U"
+        );
+        buf16.write_uint16_be_array(2U, values16, 2U);
+        uint16_t decoded16[3];
+        buf16.read_uint16_be_array(0U, decoded16, 3U);
+        xap::test::assert_ok(
+            decoded16[0] == 0x0201U && 
+                decoded16[1] == 0x0102U && 
+                decoded16[2] == 0x0304U,
+            "Case 15: decoded16 mismatch."
+        );
+
+        const uint32_t values32[] = {0x01020304U, 0x05060708U};
+        xap::core::buffer::Buffer buf32(8U);
+        buf32.write_uint32_be_array(0U, values32, 2U);
+        uint32_t decoded32[2];
+        buf32.read_uint32_le_array(0U, decoded32, 2U);
+        xap::test::assert_ok(
+            decoded32[0] == 0x04030201U && decoded32[1] == 0x08070605U,
+            "Case 15: decoded32 mismatch."
+        );
+
+        const uint64_t values64[] = {
+            0x0102030405060708ULL, 
+            0x1112131415161718ULL
+        };
+        xap::core::buffer::Buffer buf64(16U);
+        buf64.write_uint64_le_array(0U, values64, 2U);
+        uint64_t decoded64[2];
+        buf64.read_uint64_le_array(0U, decoded64, 2U);
+        xap::test::assert_ok(
+            decoded64[0] == values64[0] && decoded64[1] == values64[1],
+            "Case 15: decoded64 mismatch."
+        );
+        xap::test::assert_equal<uint64_t>(
+            buf64.read_uint64_be(8U),
+            0x1817161514131211ULL,
+            "Case 15: buf64.read_uint64_be(8U) != 0x1817161514131211ULL"
+        );
+
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                buf32.read_uint32_be_array(4U, decoded32, 2U);
+            },
+            "Case 15: read_uint32_be_array(4U, 2U) didn't throw."
+        );
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                buf64.read_uint64_be_array(0U, decoded64, SIZE_MAX / 4U);
+            },
+            "Case 15: read_uint64_be_array(SIZE_MAX / 4U) didn't throw."
+        );
+        buf64.read_uint64_be_array(16U, decoded64, 0U);
+    }
+
+    //
+    //  Case 16: Byte swapping and PCM sample conversion.
+    //
+    {
+        //  37 is not a multiple of any vector width, so both the vector 
+        //  and the scalar tail loops are exercised.
+        const size_t count = 37U;
+
+        xap::core::buffer::Buffer buf(count * 8U);
+        for (size_t i = 0U; i < buf.get_length(); ++i) {
+            buf.write_uint8(static_cast<uint8_t>(i), i);
+        }
+        xap::core::buffer::Buffer original(buf.get_pointer(), buf.get_length());
+        buf.swap16();
+        xap::test::assert_equal<uint16_t>(
+            buf.read_uint16_le(70U),
+            original.read_uint16_be(70U),
+            "Case 16: swap16() mismatch."
+        );
+        buf.swap16();
+        buf.swap32();
+        xap::test::assert_equal<uint32_t>(
+            buf.read_uint32_le(136U),
+            original.read_uint32_be(136U),
+            "Case 16: swap32() mismatch."
+        );
+        buf.swap32();
+        buf.swap64();
+        for (size_t i = 0U; i < count; ++i) {
+            xap::test::assert_equal<uint64_t>(
+                buf.read_uint64_le(i * 8U),
+                original.read_uint64_be(i * 8U),
+                "Case 16: swap64() mismatch."
+            );
+        }
+        buf.swap64();
+        xap::test::assert_ok(
+            buf == original,
+            "Case 16: buf != original"
+        );
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                xap::core::buffer::Buffer(6U).swap64();
+            },
+            "Case 16: swap64() on 6 bytes didn't throw."
+        );
+
+        float samples[count];
+        buf.read_sint16_be_normalized(2U, samples, count);
+        for (size_t i = 0U; i < count; ++i) {
+            xap::test::assert_ok(
+                samples[i] == 
+                    static_cast<float>(
+                        static_cast<int16_t>(buf.read_uint16_be(2U + i * 2U))
+                    ) / 32768.0f,
+                "Case 16: read_sint16_be_normalized() mismatch."
+            );
+        }
+        buf.read_sint16_le_normalized(1U, samples, count);
+        for (size_t i = 0U; i < count; ++i) {
+            xap::test::assert_ok(
+                samples[i] == 
+                    static_cast<float>(buf.read_sint16_le(1U + i * 2U)) / 
+                        32768.0f,
+                "Case 16: read_sint16_le_normalized() mismatch."
+            );
+        }
+        buf.read_sint32_be_normalized(4U, samples, count - 1U);
+        for (size_t i = 0U; i < count - 1U; ++i) {
+            xap::test::assert_ok(
+                samples[i] == 
+                    static_cast<float>(
+                        static_cast<int32_t>(buf.read_uint32_be(4U + i * 4U))
+                    ) / 2147483648.0f,
+                "Case 16: read_sint32_be_normalized() mismatch."
+            );
+        }
+
+        const uint8_t pcm24[] = {
+            0xFF, 0xFF, 0x7F,   //  8388607
+            0x00, 0x00, 0x80,   //  -8388608
+            0xFF, 0xFF, 0xFF,   //  -1
+            0x00, 0x00, 0x40    //  4194304
+        };
+        xap::core::buffer::Buffer buf24(pcm24, sizeof(pcm24));
+        buf24.read_sint24_le_normalized(0U, samples, 4U);
+        xap::test::assert_ok(
+            samples[0] == 8388607.0f / 8388608.0f && 
+                samples[1] == -1.0f && 
+                samples[2] == -1.0f / 8388608.0f && 
+                samples[3] == 0.5f,
+            "Case 16: read_sint24_le_normalized() mismatch."
+        );
+        buf24.read_sint24_be_normalized(9U, samples, 1U);
+        xap::test::assert_ok(
+            samples[0] == 1.0f / 8388608.0f * 0x40,
+            "Case 16: read_sint24_be_normalized() mismatch."
+        );
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                buf24.read_sint24_le_normalized(3U, samples, 4U);
+            },
+            "Case 16: read_sint24_le_normalized(3U, 4U) didn't throw."
+        );
+
+        float source[count];
+        for (size_t i = 0U; i < count; ++i) {
+            source[i] = static_cast<float>(i) / 16.0f - 1.0f;
+        }
+        source[3] = 2.0f;
+        source[4] = -2.0f;
+        source[5] = 0.5f / 32768.0f;
+        source[6] = 1.5f / 32768.0f;
+        xap::core::buffer::Buffer buf16(count * 2U);
+        buf16.write_sint16_be_normalized(0U, source, count);
+        xap::test::assert_equal<uint16_t>(
+            buf16.read_uint16_be(0U),
+            0x8000U,
+            "Case 16: -1.0 != -32768"
+        );
+        xap::test::assert_equal<uint16_t>(
+            buf16.read_uint16_be(6U),
+            0x7FFFU,
+            "Case 16: 2.0 didn't saturate."
+        );
+        xap::test::assert_equal<uint16_t>(
+            buf16.read_uint16_be(8U),
+            0x8000U,
+            "Case 16: -2.0 didn't saturate."
+        );
+        xap::test::assert_equal<uint16_t>(
+            buf16.read_uint16_be(10U),
+            0U,
+            "Case 16: 0.5 LSB didn't round to even."
+        );
+        xap::test::assert_equal<uint16_t>(
+            buf16.read_uint16_be(12U),
+            2U,
+            "Case 16: 1.5 LSB didn't round to even."
+        );
+        xap::test::assert_equal<uint16_t>(
+            buf16.read_uint16_be(48U),
+            0x4000U,
+            "Case 16: 0.5 != 16384"
+        );
+        xap::test::assert_equal<uint16_t>(
+            buf16.read_uint16_be(72U),
+            0x7FFFU,
+            "Case 16: 1.25 didn't saturate."
+        );
+        xap::core::buffer::Buffer buf16le(count * 2U);
+        buf16le.write_sint16_le_normalized(0U, source, count);
+        buf16le.swap16();
+        xap::test::assert_ok(
+            buf16le == buf16,
+            "Case 16: write_sint16_le_normalized() mismatch."
+        );
+    }
+
+#if defined(XAP_CORE_BUFFER_IEEE_754)
+    //
+    //  Case 17: Float-point values round trip exactly (bit cast codec).
+    //
+    {
+        const double doubles[] = {
+            0.1, 
+            -874.978924, 
+            1.0 / 3.0, 
+            std::numeric_limits<double>::max(), 
+            std::numeric_limits<double>::min(), 
+            std::numeric_limits<double>::denorm_min(), 
+            -std::numeric_limits<double>::epsilon()
+        };
+        xap::core::buffer::Buffer buf(9U);
+        for (size_t i = 0U; i < sizeof(doubles) / sizeof(doubles[0]); ++i) {
+            buf.write_double_be(doubles[i], 1U);
+            xap::test::assert_ok(
+                buf.read_double_be(1U) == doubles[i],
+                "Case 17: read_double_be() != write_double_be()"
+            );
+            buf.write_double_le(doubles[i], 0U);
+            xap::test::assert_ok(
+                buf.read_double_le(0U) == doubles[i],
+                "Case 17: read_double_le() != write_double_le()"
+            );
+        }
+
+        const float floats[] = {
+            0.1f, 
+            std::numeric_limits<float>::max(), 
+            std::numeric_limits<float>::denorm_min()
+        };
+        for (size_t i = 0U; i < sizeof(floats) / sizeof(floats[0]); ++i) {
+            buf.write_float_be(floats[i], 5U);
+            xap::test::assert_ok(
+                buf.read_float_be(5U) == floats[i],
+                "Case 17: read_float_be() != write_float_be()"
+            );
+            buf.write_float_le(floats[i], 2U);
+            xap::test::assert_ok(
+                buf.read_float_le(2U) == floats[i],
+                "Case 17: read_float_le() != write_float_le()"
+            );
+        }
+
+        const uint8_t dat1[] = {0x3F, 0xB9, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9A};
+        xap::core::buffer::Buffer buf1(dat1, sizeof(dat1));
+        xap::test::assert_ok(
+            buf1.read_double_be(0U) == 0.1,
+            "Case 17: buf1.read_double_be(0U) != 0.1"
+        );
+    }
+#endif  //  #if defined(XAP_CORE_BUFFER_IEEE_754)
+
+    //
+    //  Case 18: Equality, ordering and search.
+    //
+    {
+        const uint8_t dat1[] = {0x01, 0x02, 0x03};
+        const uint8_t dat2[] = {0x01, 0x02, 0x04};
+        xap::core::buffer::Buffer buf1(dat1, sizeof(dat1));
+        xap::core::buffer::Buffer buf2(dat2, sizeof(dat2));
+        xap::core::buffer::Buffer buf3 = buf1.slice(0U, 2U);
+        xap::test::assert_ok(
+            buf1.compare(buf2) < 0 && buf2.compare(buf1) > 0,
+            "Case 18: buf1.compare(buf2) mismatch."
+        );
+        xap::test::assert_ok(
+            buf3.compare(buf1) < 0 && buf1.compare(buf3) > 0,
+            "Case 18: prefix ordering mismatch."
+        );
+        xap::test::assert_ok(
+            buf1.compare(xap::core::buffer::Buffer(dat1, sizeof(dat1))) == 0,
+            "Case 18: buf1.compare(copy) != 0"
+        );
+        xap::test::assert_ok(
+            xap::core::buffer::Buffer().compare(xap::core::buffer::Buffer(0U)) 
+                == 0,
+            "Case 18: empty buffers are not equal."
+        );
+
+        //  A haystack long enough for the vector loop, with near misses.
+        xap::core::buffer::Buffer haystack(100U);
+        haystack.fill(0x00);
+        haystack.write_uint8(0xAA, 10U);
+        haystack.write_uint8(0xAA, 40U);
+        haystack.write_uint8(0xCC, 43U);
+        haystack.write_uint32_be(0xAABBCCDDU, 70U);
+        haystack.write_uint32_be(0xAABBCCDDU, 96U);
+        const uint8_t sync[] = {0xAA, 0xBB, 0xCC, 0xDD};
+        xap::core::buffer::Buffer needle(sync, sizeof(sync));
+
+        xap::test::assert_equal<size_t>(
+            haystack.index_of(static_cast<uint8_t>(0xAA)),
+            10U,
+            "Case 18: haystack.index_of(0xAA) != 10U"
+        );
+        xap::test::assert_equal<size_t>(
+            haystack.index_of(static_cast<uint8_t>(0xAA), 11U),
+            40U,
+            "Case 18: haystack.index_of(0xAA, 11U) != 40U"
+        );
+        xap::test::assert_equal<size_t>(
+            haystack.index_of(static_cast<uint8_t>(0xEE)),
+            xap::core::buffer::Buffer::NPOS,
+            "Case 18: haystack.index_of(0xEE) != NPOS"
+        );
+        xap::test::assert_equal<size_t>(
+            haystack.index_of(needle),
+            70U,
+            "Case 18: haystack.index_of(needle) != 70U"
+        );
+        xap::test::assert_equal<size_t>(
+            haystack.index_of(needle, 71U),
+            96U,
+            "Case 18: haystack.index_of(needle, 71U) != 96U"
+        );
+        xap::test::assert_equal<size_t>(
+            haystack.index_of(needle, 97U),
+            xap::core::buffer::Buffer::NPOS,
+            "Case 18: haystack.index_of(needle, 97U) != NPOS"
+        );
+        xap::test::assert_equal<size_t>(
+            haystack.index_of(sync, 2U, 0U),
+            70U,
+            "Case 18: haystack.index_of(sync, 2U) != 70U"
+        );
+        xap::test::assert_equal<size_t>(
+            haystack.index_of(xap::core::buffer::Buffer(), 5U),
+            5U,
+            "Case 18: empty needle is not found at 'from'."
+        );
+        xap::test::assert_equal<size_t>(
+            haystack.index_of(needle, 200U),
+            xap::core::buffer::Buffer::NPOS,
+            "Case 18: haystack.index_of(needle, 200U) != NPOS"
+        );
+        xap::test::assert_equal<size_t>(
+            needle.index_of(haystack),
+            xap::core::buffer::Buffer::NPOS,
+            "Case 18: needle.index_of(haystack) != NPOS"
+        );
+    }
+
+    //
+    //  Case 19: File mapping.
+    //
+    {
+        const char *path = "buffer-unittest-mapping.bin";
+        const size_t file_len = 10000U;
+        xap::core::buffer::Buffer content(file_len, true);
+        for (size_t i = 0U; i < file_len; ++i) {
+            content[i] = static_cast<uint8_t>((i * 7U) & 0xFFU);
+        }
+        FILE *file = nullptr;
+#if defined(XAP_TEST_OS_WIN)
+        fopen_s(&file, path, "wb");
+#else
+        file = fopen(path, "wb");
+#endif
+        xap::test::assert_ok(file != nullptr, "Case 19: fopen() failed.");
+        xap::test::assert_equal<size_t>(
+            fwrite(content.get_pointer(), 1U, file_len, file),
+            file_len,
+            "Case 19: fwrite() failed."
+        );
+        fclose(file);
+
+        //  An offset which is not page-aligned.
+        xap::core::buffer::Buffer mapped = 
+            xap::core::buffer::Buffer::map_file(
+                path, 
+                4099U, 
+                xap::core::buffer::Buffer::NPOS,
+                xap::core::buffer::BUFFER_MAP_SEQUENTIAL
+            );
+        xap::test::assert_ok(
+            mapped == content.slice(4099U),
+            "Case 19: mapped range mismatch."
+        );
+        xap::core::buffer::Buffer part = 
+            xap::core::buffer::Buffer::map_file(
+                path, 
+                1U, 
+                16U, 
+                xap::core::buffer::BUFFER_MAP_RANDOM
+            );
+        xap::test::assert_ok(
+            part == content.slice(1U, 16U),
+            "Case 19: mapped part mismatch."
+        );
+
+        //  Private mapping, the slice outlives the mapped buffer.
+        xap::core::buffer::Buffer view = part.slice(8U);
+        part = xap::core::buffer::Buffer();
+        view[0U] = 0xFFU;
+        xap::test::assert_equal<uint8_t>(
+            view[0U],
+            0xFFU,
+            "Case 19: write to mapping failed."
+        );
+        xap::test::assert_ok(
+            xap::core::buffer::Buffer::map_file(path, 9U, 1U)[0U] == 
+                content[9U],
+            "Case 19: write to mapping reached the file."
+        );
+        xap::test::assert_equal<size_t>(
+            xap::core::buffer::Buffer::map_file(path, file_len).get_length(),
+            0U,
+            "Case 19: mapping at the end of file is not empty."
+        );
+
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                xap::core::buffer::Buffer::map_file(path, file_len + 1U);
+            },
+            "Case 19: offset out of the file was accepted."
+        );
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                xap::core::buffer::Buffer::map_file(path, 1U, file_len);
+            },
+            "Case 19: length out of the file was accepted."
+        );
+        remove(path);
+        try {
+            xap::core::buffer::Buffer::map_file(path);
+            xap::test::assert_ok(false, "Case 19: missing file was mapped.");
+        } catch (xap::core::buffer::BufferException &error) {
+            xap::test::assert_equal<uint16_t>(
+                error.get_code(),
+                xap::core::buffer::XAPCORE_BUF_ERROR_IO,
+                "Case 19: invalid error code."
+            );
+        }
+    }
+
+    //
+    //  Case 20: Adopt external memory.
+    //
+    {
+        size_t released = 0U;
+        uint8_t *memory = new uint8_t[8U]{1, 2, 3, 4, 5, 6, 7, 8};
+        xap::core::buffer::Buffer adopted = xap::core::buffer::Buffer::wrap(
+            memory, 
+            8U, 
+            xap_release_wrapped, 
+            &released
+        );
+        xap::test::assert_ok(
+            adopted.get_pointer() == memory,
+            "Case 20: wrapped memory was copied."
+        );
+        xap::core::buffer::Buffer tail = adopted.slice(4U);
+        adopted = xap::core::buffer::Buffer();
+        xap::test::assert_equal<size_t>(
+            released,
+            0U,
+            "Case 20: memory was released while sliced."
+        );
+        xap::test::assert_equal<uint8_t>(
+            tail[0U],
+            5U,
+            "Case 20: tail[0] != 5"
+        );
+        tail = xap::core::buffer::Buffer();
+        xap::test::assert_equal<size_t>(
+            released,
+            1U,
+            "Case 20: memory was not released once."
+        );
+
+        xap::core::buffer::Buffer::wrap(
+            new uint8_t[1U], 
+            0U, 
+            xap_release_wrapped, 
+            &released
+        );
+        xap::test::assert_equal<size_t>(
+            released,
+            2U,
+            "Case 20: empty memory was not released."
+        );
+
+        uint8_t stack[4U] = {0x0A, 0x0B, 0x0C, 0x0D};
+        {
+            xap::core::buffer::Buffer unowned = 
+                xap::core::buffer::Buffer::wrap_unowned(stack, sizeof(stack));
+            unowned.write_uint16_be(0x1122U, 2U);
+            xap::test::assert_ok(
+                unowned.get_pointer() == stack && stack[2U] == 0x11U,
+                "Case 20: unowned memory was copied."
+            );
+        }
+        xap::test::assert_equal<uint8_t>(
+            stack[0U],
+            0x0AU,
+            "Case 20: unowned memory was changed."
+        );
+    }
+
+    //
+    //  Case 21: uniqueness and copy-on-write.
+    //
+    {
+        const uint8_t data[] = {0x01, 0x02, 0x03, 0x04};
+        xap::core::buffer::Buffer origin(data, sizeof(data));
+        xap::test::assert_ok(origin.is_unique(), "Case 21: not unique.");
+        xap::test::assert_ok(!origin.detach(), "Case 21: unique detached.");
+
+        xap::core::buffer::Buffer alias = origin.slice(1U, 2U);
+        xap::test::assert_ok(
+            !origin.is_unique() && !alias.is_unique(), 
+            "Case 21: shared storage is unique."
+        );
+        xap::test::assert_ok(alias.detach(), "Case 21: shared not detached.");
+        alias.write_uint8(0xFFU, 0U);
+        xap::test::assert_ok(
+            origin.is_unique() && alias.is_unique() && origin[1U] == 0x02U,
+            "Case 21: detached buffer still shared."
+        );
+
+        //  Writes in copy-on-write mode never reach the other aliases.
+        origin.set_copy_on_write(true);
+        xap::core::buffer::Buffer copied = origin;
+        xap::test::assert_ok(
+            copied.is_copy_on_write(), 
+            "Case 21: mode not inherited."
+        );
+        copied.write_uint32_be(0xA1A2A3A4U, 0U);
+        xap::test::assert_ok(
+            origin == xap::core::buffer::Buffer(data, sizeof(data)) &&
+            copied.read_uint32_be(0U) == 0xA1A2A3A4U,
+            "Case 21: copy-on-write changed the origin."
+        );
+        const uint8_t *before = copied.get_pointer();
+        copied.fill(0x00U);
+        xap::test::assert_ok(
+            copied.get_pointer() == before, 
+            "Case 21: unique storage copied."
+        );
+        xap::core::buffer::Buffer swapped = origin.slice(0U, 4U);
+        swapped.swap16();
+        xap::test::assert_ok(
+            swapped.read_uint16_be(0U) == 0x0201U && 
+            origin.read_uint16_be(0U) == 0x0102U,
+            "Case 21: swap changed the origin."
+        );
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                origin.slice(0U).write_uint8(0x00U, 4U);
+            },
+            "Case 21: out of range write."
+        );
+
+        uint8_t stack[2U] = {0x0A, 0x0B};
+        xap::core::buffer::Buffer unowned = 
+            xap::core::buffer::Buffer::wrap_unowned(stack, sizeof(stack));
+        xap::test::assert_ok(!unowned.is_unique(), "Case 21: unowned unique.");
+        unowned.set_copy_on_write(true);
+        unowned.write_uint8(0x00U, 0U);
+        xap::test::assert_ok(
+            stack[0U] == 0x0AU && unowned.is_unique(),
+            "Case 21: unowned memory was changed."
+        );
+    }
+
+    //
+    //  Case 22: concat() rejects total lengths which overflow.
+    //
+    {
+        uint8_t stack[1U] = {0x00};
+        const xap::core::buffer::Buffer halves[2] = {
+            xap::core::buffer::Buffer::wrap_unowned(stack, SIZE_MAX / 2U + 1U),
+            xap::core::buffer::Buffer::wrap_unowned(stack, SIZE_MAX / 2U + 1U)
+        };
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                xap::core::buffer::Buffer::concat(halves, 2U);
+            },
+            "Case 22: overflowed concat() was accepted."
+        );
+    }
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,230 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+//
+//  Imports.
+//
+#include "common.h"
+
+#include <xap/core/buffer/chain.h>
+
+//
+//  Entry.
+//
+int main() {
+    const uint8_t header[] = {0x00, 0x01, 0x02};
+    const uint8_t payload[] = {0x10, 0x11, 0x12, 0x13, 0x14};
+    const uint8_t trailer[] = {0xF0, 0xF1};
+    const xap::core::buffer::Buffer header_buf(header, sizeof(header));
+    const xap::core::buffer::Buffer payload_buf(payload, sizeof(payload));
+    const xap::core::buffer::Buffer trailer_buf(trailer, sizeof(trailer));
+
+    //
+    //  Case 1: Build without copying.
+    //
+    {
+        xap::core::buffer::BufferChain chain(payload_buf);
+        chain.append(trailer_buf);
+        chain.prepend(header_buf);
+        chain.append(xap::core::buffer::Buffer());
+        xap::test::assert_equal<size_t>(
+            chain.get_length(),
+            10U,
+            "Case 1: chain.get_length() != 10U"
+        );
+        xap::test::assert_equal<size_t>(
+            chain.get_segment_count(),
+            3U,
+            "Case 1: chain.get_segment_count() != 3U"
+        );
+        xap::test::assert_ok(
+            chain.get_segment(1U).get_pointer() == payload_buf.get_pointer(),
+            "Case 1: payload was copied."
+        );
+
+        xap::core::buffer::BufferSegment segments[4];
+        xap::test::assert_equal<size_t>(
+            chain.get_segments(segments, 4U),
+            3U,
+            "Case 1: get_segments() != 3U"
+        );
+        xap::test::assert_ok(
+            segments[0].pointer == header_buf.get_pointer() && 
+                segments[2].length == 2U,
+            "Case 1: segments mismatch."
+        );
+
+        const uint8_t expect[] = {
+            0x00, 0x01, 0x02, 0x10, 0x11, 0x12, 0x13, 0x14, 0xF0, 0xF1
+        };
+        xap::test::assert_ok(
+            chain.flatten() == 
+                xap::core::buffer::Buffer(expect, sizeof(expect)),
+            "Case 1: chain.flatten() mismatch."
+        );
+        xap::test::assert_ok(
+            xap::core::buffer::BufferChain(payload_buf).flatten()
+                .get_pointer() == payload_buf.get_pointer(),
+            "Case 1: single segment was copied by flatten()."
+        );
+
+        xap::core::buffer::BufferChain doubled(chain);
+        doubled.append(doubled);
+        xap::test::assert_equal<size_t>(
+            doubled.get_length(),
+            20U,
+            "Case 1: self-append length mismatch."
+        );
+    }
+
+    //
+    //  Case 2: Reads across segment boundaries.
+    //
+    {
+        xap::core::buffer::BufferChain chain(header_buf);
+        chain.append(payload_buf);
+        chain.append(trailer_buf);
+        xap::test::assert_equal<uint8_t>(
+            chain.read_uint8(3U),
+            0x10U,
+            "Case 2: read_uint8(3U) != 0x10"
+        );
+        xap::test::assert_equal<uint16_t>(
+            chain.read_uint16_be(2U),
+            0x0210U,
+            "Case 2: read_uint16_be(2U) != 0x0210"
+        );
+        xap::test::assert_equal<uint32_t>(
+            chain.read_uint32_le(6U),
+            0xF1F01413U,
+            "Case 2: read_uint32_le(6U) != 0xF1F01413"
+        );
+        xap::test::assert_equal<uint64_t>(
+            chain.read_uint64_be(1U),
+            0x01021011121314F0ULL,
+            "Case 2: read_uint64_be(1U) mismatch."
+        );
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                chain.read_uint16_le(9U);
+            },
+            "Case 2: read across the end was accepted."
+        );
+
+        xap::core::buffer::BufferChain part = chain.slice(2U, 7U);
+        xap::test::assert_equal<size_t>(
+            part.get_segment_count(),
+            3U,
+            "Case 2: part.get_segment_count() != 3U"
+        );
+        xap::test::assert_equal<uint32_t>(
+            part.read_uint32_be(3U),
+            0x121314F0U,
+            "Case 2: part.read_uint32_be(3U) mismatch."
+        );
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                chain.slice(5U, 6U);
+            },
+            "Case 2: slice out of range was accepted."
+        );
+    }
+
+    //
+    //  Case 3: Fetcher.
+    //
+    {
+        xap::core::buffer::BufferChain chain(header_buf);
+        chain.append(payload_buf);
+        chain.append(trailer_buf);
+        xap::core::buffer::BufferChainFetcher fetcher(chain);
+        xap::test::assert_equal<uint8_t>(
+            fetcher.fetch(),
+            0x00U,
+            "Case 3: fetch() != 0x00"
+        );
+        xap::core::buffer::Buffer inside = fetcher.fetch_bytes(2U);
+        xap::test::assert_ok(
+            inside.get_pointer() == header_buf.get_pointer() + 1U,
+            "Case 3: fetch_bytes() inside a segment was copied."
+        );
+        fetcher.skip(4U);
+        xap::core::buffer::Buffer across = fetcher.fetch_bytes(2U);
+        const uint8_t expect[] = {0x14, 0xF0};
+        xap::test::assert_ok(
+            across == xap::core::buffer::Buffer(expect, sizeof(expect)),
+            "Case 3: fetch_bytes() across segments mismatch."
+        );
+        xap::test::assert_equal<size_t>(
+            fetcher.get_remaining_size(),
+            1U,
+            "Case 3: get_remaining_size() != 1U"
+        );
+        xap::test::assert_equal<size_t>(
+            fetcher.fetch_all().get_length(),
+            1U,
+            "Case 3: fetch_all() length != 1U"
+        );
+        xap::test::assert_ok(fetcher.is_end(), "Case 3: fetcher is not ended.");
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                fetcher.fetch();
+            },
+            "Case 3: fetch() after the end was accepted."
+        );
+
+        fetcher.reset();
+        xap::core::buffer::Buffer destination(12U);
+        xap::test::assert_equal<size_t>(
+            fetcher.fetch_to(destination, 2U),
+            10U,
+            "Case 3: fetch_to() != 10U"
+        );
+        xap::test::assert_equal<uint8_t>(
+            destination[11U],
+            0xF1U,
+            "Case 3: destination[11] != 0xF1"
+        );
+    }
+
+    //
+    //  Case 4: Lengths which overflow are rejected.
+    //
+    {
+        uint8_t stack[1U] = {0x00};
+        const xap::core::buffer::Buffer half = 
+            xap::core::buffer::Buffer::wrap_unowned(stack, SIZE_MAX / 2U + 1U);
+        xap::core::buffer::BufferChain chain(half);
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                chain.append(half);
+            },
+            "Case 4: overflowed append() was accepted."
+        );
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                chain.prepend(half);
+            },
+            "Case 4: overflowed prepend() was accepted."
+        );
+
+        xap::core::buffer::BufferChain parts(header_buf);
+        parts.append(half);
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                chain.append(parts);
+            },
+            "Case 4: overflowed append(chain) was accepted."
+        );
+        xap::test::assert_ok(
+            chain.get_segment_count() == 2U &&
+            chain.get_length() == SIZE_MAX / 2U + 1U + header_buf.get_length(),
+            "Case 4: chain length is inconsistent with its segments."
+        );
+    }
+
+    return 0;
+}
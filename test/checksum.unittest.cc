@@ -0,0 +1,166 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+//
+//  Imports.
+//
+#include "common.h"
+
+#include <xap/core/buffer/checksum.h>
+#include <algorithm>
+#include <string.h>
+
+//
+//  Entry.
+//
+int main() {
+    const char *check = "123456789";
+    const xap::core::buffer::Buffer check_buffer(
+        reinterpret_cast<const uint8_t*>(check),
+        strlen(check)
+    );
+
+    //
+    //  Case 1: check values.
+    //
+    {
+        xap::test::assert_equal<uint32_t>(
+            xap::core::buffer::BufferCrc32::compute(check_buffer),
+            0xCBF43926U,
+            "Case 1: invalid CRC-32."
+        );
+        xap::test::assert_equal<uint32_t>(
+            xap::core::buffer::BufferCrc32c::compute(check_buffer),
+            0xE3069283U,
+            "Case 1: invalid CRC-32C."
+        );
+        const char *wikipedia = "Wikipedia";
+        xap::test::assert_equal<uint32_t>(
+            xap::core::buffer::BufferAdler32::compute(
+                xap::core::buffer::Buffer(
+                    reinterpret_cast<const uint8_t*>(wikipedia),
+                    strlen(wikipedia)
+                )
+            ),
+            0x11E60398U,
+            "Case 1: invalid Adler-32."
+        );
+        xap::test::assert_equal<uint64_t>(
+            xap::core::buffer::BufferXxh64::compute(
+                xap::core::buffer::Buffer(0U)
+            ),
+            0xEF46DB3751D8E999ULL,
+            "Case 1: invalid XXH64 of empty input."
+        );
+        xap::test::assert_equal<uint64_t>(
+            xap::core::buffer::BufferXxh64::compute(
+                xap::core::buffer::Buffer(
+                    reinterpret_cast<const uint8_t*>("abc"),
+                    3U
+                )
+            ),
+            0x44BC2CF5AD770999ULL,
+            "Case 1: invalid XXH64."
+        );
+        xap::test::assert_equal<uint32_t>(
+            xap::core::buffer::BufferCrc32::compute(
+                xap::core::buffer::Buffer(0U)
+            ),
+            0U,
+            "Case 1: invalid CRC-32 of empty input."
+        );
+    }
+
+    //
+    //  Case 2: streaming updates equal to one-shot computation.
+    //
+    {
+        xap::core::buffer::Buffer data(10000U);
+        for (size_t i = 0U; i < data.get_length(); ++i) {
+            data.write_uint8(static_cast<uint8_t>((i * 131U) ^ (i >> 7U)), i);
+        }
+
+        xap::core::buffer::BufferCrc32 crc32;
+        xap::core::buffer::BufferCrc32c crc32c;
+        xap::core::buffer::BufferAdler32 adler32;
+        xap::core::buffer::BufferXxh64 xxh64(7U);
+        size_t offset = 0U;
+        size_t step = 1U;
+        while (offset < data.get_length()) {
+            const size_t length = std::min(step, data.get_length() - offset);
+            const xap::core::buffer::Buffer part = data.slice(offset, length);
+            crc32.update(part);
+            crc32c.update(part);
+            adler32.update(part);
+            xxh64.update(part);
+            offset += length;
+            step = step * 3U + 1U;
+        }
+        xap::test::assert_ok(
+            crc32.get_value() ==
+                xap::core::buffer::BufferCrc32::compute(data) &&
+            crc32c.get_value() ==
+                xap::core::buffer::BufferCrc32c::compute(data) &&
+            adler32.get_value() ==
+                xap::core::buffer::BufferAdler32::compute(data) &&
+            xxh64.get_value() ==
+                xap::core::buffer::BufferXxh64::compute(data, 7U),
+            "Case 2: streaming value mismatched."
+        );
+
+        crc32.reset();
+        crc32.update(check_buffer);
+        xap::test::assert_equal<uint32_t>(
+            crc32.get_value(),
+            0xCBF43926U,
+            "Case 2: invalid CRC-32 after reset."
+        );
+    }
+
+    //
+    //  Case 3: chains and queues (without coalescing).
+    //
+    {
+        xap::core::buffer::BufferChain chain;
+        xap::core::buffer::BufferQueue queue;
+        for (size_t i = 0U; i < 20U; ++i) {
+            const size_t begin = i * check_buffer.get_length() / 20U;
+            const size_t end = (i + 1U) * check_buffer.get_length() / 20U;
+            if (end != begin) {
+                chain.append(check_buffer.slice(begin, end - begin));
+                queue.push(check_buffer.slice(begin, end - begin));
+            }
+        }
+        queue.push(check_buffer);
+        queue.consume(check_buffer.get_length());
+
+        xap::core::buffer::BufferCrc32 crc32;
+        crc32.update(chain);
+        xap::core::buffer::BufferCrc32c crc32c;
+        crc32c.update(queue);
+        xap::test::assert_ok(
+            crc32.get_value() == 0xCBF43926U &&
+            crc32c.get_value() == 0xE3069283U,
+            "Case 3: invalid chain / queue checksum."
+        );
+
+        xap::core::buffer::BufferQueue many;
+        xap::core::buffer::BufferXxh64 expected;
+        for (size_t i = 0U; i < 40U; ++i) {
+            many.push(check_buffer);
+            expected.update(check_buffer);
+        }
+        xap::core::buffer::BufferXxh64 xxh64;
+        xxh64.update(many);
+        xap::test::assert_ok(
+            xxh64.get_value() == expected.get_value() &&
+            many.get_remaining_size() == 40U * check_buffer.get_length(),
+            "Case 3: invalid queue hash (many segments)."
+        );
+    }
+
+    return 0;
+}
@@ -0,0 +1,166 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+//
+//  Imports.
+//
+#include "build.h"
+#include "common.h"
+
+#include <xap/core/buffer/concurrent.h>
+#include <atomic>
+#include <new>
+#include <stdlib.h>
+#include <thread>
+
+//
+//  Count of allocations big enough to be queue segments (2 KiB or more).
+//
+static std::atomic<size_t> g_large_allocations(0U);
+
+//
+//  Global allocation functions (counting the large allocations).
+//
+void* operator new(size_t size) {
+    if (size >= 2048U) {
+        g_large_allocations.fetch_add(1U);
+    }
+    void *pointer = malloc(size != 0U ? size : 1U);
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void operator delete(void *pointer) noexcept {
+    free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+    free(pointer);
+}
+
+//
+//  Entry.
+//
+int main() {
+    //
+    //  Case 1: single thread.
+    //
+    {
+        const uint8_t data[] = {0x01, 0x02, 0x03, 0x04};
+        xap::core::buffer::ConcurrentBufferQueue queue;
+        for (size_t i = 0U; i < 200U; ++i) {
+            queue.push(xap::core::buffer::Buffer(data, sizeof(data)));
+        }
+        queue.push(xap::core::buffer::Buffer());
+        xap::test::assert_equal<size_t>(
+            queue.get_remaining_size(),
+            800U,
+            "Invalid remaining size."
+        );
+
+        xap::core::buffer::Buffer popped = queue.pop(6U);
+        const uint8_t expect[] = {0x01, 0x02, 0x03, 0x04, 0x01, 0x02};
+        xap::test::assert_ok(
+            popped == xap::core::buffer::Buffer(expect, sizeof(expect)),
+            "Invalid popped data."
+        );
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                queue.pop(795U);
+            },
+            "Popped out of range."
+        );
+        xap::test::assert_equal<size_t>(
+            queue.pop_all().get_length(),
+            794U,
+            "Invalid popped length."
+        );
+        xap::test::assert_equal<size_t>(
+            queue.get_remaining_size(),
+            0U,
+            "Invalid remaining size after pop_all()."
+        );
+        xap::test::assert_ok(
+            !queue.wait(1U, 10U),
+            "Wait didn't time out."
+        );
+        xap::test::assert_ok(
+            queue.wait(0U, 0U),
+            "Wait for nothing failed."
+        );
+    }
+
+    //
+    //  Case 2: producer thread and consumer thread.
+    //
+    {
+        const size_t count = 20000U;
+        xap::core::buffer::ConcurrentBufferQueue queue;
+        std::thread producer([&]() {
+            for (size_t i = 0U; i < count; ++i) {
+                xap::core::buffer::Buffer chunk(1U + (i % 7U), true);
+                chunk.fill(static_cast<uint8_t>(i & 0xFFU));
+                queue.push(std::move(chunk));
+            }
+        });
+
+        bool ok = true;
+        for (size_t i = 0U; i < count && ok; ++i) {
+            const size_t chunk_len = 1U + (i % 7U);
+            if (!queue.wait(chunk_len, 1000U)) {
+                ok = false;
+                break;
+            }
+            xap::core::buffer::Buffer chunk = queue.pop(chunk_len);
+            for (size_t j = 0U; j < chunk_len; ++j) {
+                if (chunk[j] != static_cast<uint8_t>(i & 0xFFU)) {
+                    ok = false;
+                    break;
+                }
+            }
+        }
+        producer.join();
+        xap::test::assert_ok(ok, "Invalid data order.");
+        xap::test::assert_equal<size_t>(
+            queue.get_remaining_size(),
+            0U,
+            "Invalid remaining size after consumption."
+        );
+    }
+
+    //
+    //  Case 3: drained segments are recycled (no allocation in steady 
+    //  state).
+    //
+    {
+        const uint8_t data[] = {0x01, 0x02, 0x03, 0x04};
+        xap::core::buffer::ConcurrentBufferQueue queue;
+        size_t allocations = 0U;
+        for (size_t round = 0U; round < 20U; ++round) {
+            for (size_t i = 0U; i < 256U; ++i) {
+                queue.push(xap::core::buffer::Buffer(data, sizeof(data)));
+            }
+            xap::test::assert_equal<size_t>(
+                queue.pop_all().get_length(),
+                1024U,
+                "Case 3: invalid popped length."
+            );
+            if (round == 1U) {
+                //  The first rounds grow the spare segments.
+                allocations = g_large_allocations.load();
+            }
+        }
+        xap::test::assert_equal<size_t>(
+            g_large_allocations.load(),
+            allocations,
+            "Case 3: segments were allocated in steady state."
+        );
+    }
+
+    return 0;
+}
@@ -7,6 +7,7 @@
 
 #include <xap/core/buffer/error.h>
 #include <xap/core/buffer/fetcher.h>
+#include <utility>
 
 //
 //  Entry.
@@ -94,5 +95,144 @@ int main() {
         "replace(): !fetcher.fetch_all().is_equal(data2, sizeof(data2))"
     );
 
+    //
+    //  Case 2: move semantics.
+    //
+    {
+        xap::core::buffer::BufferFetcher src(
+            xap::core::buffer::Buffer(data, sizeof(data))
+        );
+        src.skip(2U);
+
+        xap::core::buffer::BufferFetcher moved(std::move(src));
+        xap::test::assert_ok(
+            moved.get_remaining_size() == sizeof(data) - 2U,
+            "move: moved.get_remaining_size() != sizeof(data) - 2U"
+        );
+        xap::test::assert_ok(
+            src.is_end(),
+            "move: !src.is_end()"
+        );
+
+        xap::core::buffer::BufferFetcher assigned(buf);
+        assigned = std::move(moved);
+        xap::test::assert_ok(
+            assigned.fetch() == 0x03,
+            "move: assigned.fetch() != 0x03"
+        );
+        xap::test::assert_ok(
+            moved.is_end(),
+            "move: !moved.is_end()"
+        );
+    }
+
+    //
+    //  Case 3: search from the cursor.
+    //
+    {
+        const uint8_t line[] = {'a', 'b', '\r', '\n', 'c', '\r', '\n'};
+        const uint8_t crlf[] = {'\r', '\n'};
+        xap::core::buffer::BufferFetcher fetcher(
+            xap::core::buffer::Buffer(line, sizeof(line))
+        );
+        const xap::core::buffer::Buffer delimiter(crlf, sizeof(crlf));
+        xap::test::assert_ok(
+            fetcher.index_of(delimiter) == 2U,
+            "search: fetcher.index_of(delimiter) != 2U"
+        );
+        fetcher.skip(3U);
+        xap::test::assert_ok(
+            fetcher.index_of(delimiter) == 2U,
+            "search: fetcher.index_of(delimiter) != 2U (after skip)"
+        );
+        xap::test::assert_ok(
+            fetcher.index_of(static_cast<uint8_t>('c')) == 1U,
+            "search: fetcher.index_of('c') != 1U"
+        );
+        xap::test::assert_ok(
+            fetcher.index_of(static_cast<uint8_t>('a')) == 
+                xap::core::buffer::Buffer::NPOS,
+            "search: fetcher.index_of('a') != NPOS"
+        );
+        fetcher.skip(4U);
+        xap::test::assert_ok(
+            fetcher.index_of(delimiter) == xap::core::buffer::Buffer::NPOS,
+            "search: fetcher.index_of(delimiter) != NPOS (at end)"
+        );
+    }
+
+    //
+    //  Typed reads.
+    //
+    {
+        const uint8_t fields[] = {
+            0x01,
+            0x02, 0x03,
+            0x03, 0x02,
+            0xFE, 0xFF,
+            0x04, 0x05, 0x06, 0x07,
+            0x07, 0x06, 0x05, 0x04,
+            0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+            0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01,
+            0x3F, 0x80, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC0,
+            0xAC, 0x02,
+            0x7F,
+            0x80
+        };
+        xap::core::buffer::BufferFetcher fetcher(
+            xap::core::buffer::Buffer(fields, sizeof(fields))
+        );
+        xap::test::assert_ok(
+            fetcher.fetch_uint8() == 0x01U &&
+            fetcher.fetch_uint16_be() == 0x0203U &&
+            fetcher.fetch_uint16_le() == 0x0203U &&
+            fetcher.fetch_sint16_le() == -2 &&
+            fetcher.fetch_uint32_be() == 0x04050607U &&
+            fetcher.fetch_uint32_le() == 0x04050607U &&
+            fetcher.fetch_uint64_be() == 0x0102030405060708ULL &&
+            fetcher.fetch_uint64_le() == 0x0102030405060708ULL &&
+            fetcher.fetch_float_be() == 1.0F &&
+            fetcher.fetch_double_le() == -2.0 &&
+            fetcher.fetch_varint() == 300U &&
+            fetcher.fetch_varint_signed() == -64,
+            "typed: invalid fetched values."
+        );
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                fetcher.fetch_varint();
+            },
+            "typed: truncated varint was fetched."
+        );
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                fetcher.fetch_uint16_be();
+            },
+            "typed: fetched out of range."
+        );
+        xap::test::assert_equal<size_t>(
+            fetcher.get_remaining_size(),
+            1U,
+            "typed: cursor moved by failed fetch."
+        );
+    }
+
+    //
+    //  Case 4: shared storage.
+    //
+    {
+        xap::core::buffer::BufferFetcher shared(buf);
+        shared.skip(3U);
+        xap::test::assert_ok(
+            shared.get_pointer() == buf.get_pointer() + 3U,
+            "shared: shared.get_pointer() != buf.get_pointer() + 3U"
+        );
+        xap::core::buffer::BufferFetcher copied(shared);
+        xap::test::assert_ok(
+            copied.fetch() == 0x04 && shared.fetch() == 0x04,
+            "shared: copied.fetch() != 0x04"
+        );
+    }
+
     return 0;
 }
\ No newline at end of file
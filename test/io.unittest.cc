@@ -0,0 +1,311 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+//
+//  Imports.
+//
+#include "common.h"
+
+#include <xap/core/buffer/build.h>
+#include <xap/core/buffer/io.h>
+#include <string.h>
+
+#if defined(XAP_CORE_BUFFER_OS_POSIX)
+# include <fcntl.h>
+# include <unistd.h>
+#endif
+
+#if defined(XAP_CORE_BUFFER_OS_POSIX)
+
+//
+//  Allocator which counts the allocations (forwarded to a pool).
+//
+class CountingAllocator : public xap::core::buffer::BufferAllocator {
+public:
+    CountingAllocator(): m_pool(1024U), m_allocations(0U) {}
+
+    virtual void* allocate(const size_t size, const size_t alignment) {
+        ++m_allocations;
+        return m_pool.allocate(size, alignment);
+    }
+
+    virtual void deallocate(
+        void            *pointer,
+        const size_t    size,
+        const size_t    alignment
+    ) noexcept {
+        m_pool.deallocate(pointer, size, alignment);
+    }
+
+    size_t get_allocations() const noexcept {
+        return m_allocations;
+    }
+
+private:
+    xap::core::buffer::BufferPoolAllocator m_pool;
+    size_t m_allocations;
+};
+
+/**
+ *  Write all bytes into a file descriptor.
+ *
+ *  @param fd
+ *      The file descriptor.
+ *  @param data
+ *      The bytes.
+ */
+static void write_all(const int fd, const char *data) {
+    const size_t length = strlen(data);
+    xap::test::assert_ok(
+        ::write(fd, data, length) == static_cast<ssize_t>(length),
+        "Failed to write the pipe."
+    );
+}
+
+/**
+ *  Create a non-blocking pipe.
+ *
+ *  @param fds
+ *      The descriptors (read, write).
+ */
+static void make_pipe(int fds[2]) {
+    xap::test::assert_ok(::pipe(fds) == 0, "Failed to create a pipe.");
+    ::fcntl(fds[0], F_SETFL, ::fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+}
+
+#endif  //  #if defined(XAP_CORE_BUFFER_OS_POSIX)
+
+//
+//  Entry.
+//
+int main() {
+#if defined(XAP_CORE_BUFFER_OS_POSIX)
+    //
+    //  Case 1: chunk boundaries, again and end of file.
+    //
+    {
+        int fds[2];
+        make_pipe(fds);
+
+        xap::core::buffer::BufferQueue queue;
+        xap::core::buffer::BufferReader reader(queue, 8U, 2U);
+        xap::test::assert_equal<int>(
+            reader.read_some(fds[0]),
+            xap::core::buffer::BUFFER_READ_AGAIN,
+            "Case 1: read an empty pipe."
+        );
+
+        //  Fills 1.5 chunks, then the rest of the second and a third.
+        write_all(fds[1], "0123456789AB");
+        xap::test::assert_equal<int>(
+            reader.read_some(fds[0]),
+            xap::core::buffer::BUFFER_READ_DATA,
+            "Case 1: invalid status of first read."
+        );
+        xap::test::assert_ok(
+            queue.get_remaining_size() == 12U &&
+            queue.get_segment_count() == 2U,
+            "Case 1: invalid queue after first read."
+        );
+        write_all(fds[1], "CDEFGHIJKLMN");
+        xap::test::assert_equal<int>(
+            reader.read_available(fds[0]),
+            xap::core::buffer::BUFFER_READ_AGAIN,
+            "Case 1: invalid status of second read."
+        );
+        xap::test::assert_ok(
+            queue.get_remaining_size() == 24U &&
+            queue.get_segment_count() == 4U &&
+            reader.get_total_read() == 24U,
+            "Case 1: invalid queue after second read."
+        );
+
+        const xap::core::buffer::Buffer all = queue.pop_all();
+        xap::test::assert_ok(
+            memcmp(all.get_pointer(), "0123456789ABCDEFGHIJKLMN", 24U) == 0,
+            "Case 1: invalid bytes."
+        );
+
+        ::close(fds[1]);
+        xap::test::assert_equal<int>(
+            reader.read_some(fds[0]),
+            xap::core::buffer::BUFFER_READ_END,
+            "Case 1: read a closed pipe."
+        );
+        ::close(fds[0]);
+    }
+
+    //
+    //  Case 2: the queue maximum size.
+    //
+    {
+        int fds[2];
+        make_pipe(fds);
+
+        xap::core::buffer::BufferQueue queue;
+        queue.set_max_size(10U);
+        xap::core::buffer::BufferReader reader(queue, 4U, 4U);
+        write_all(fds[1], "0123456789ABCDEF");
+        xap::test::assert_equal<int>(
+            reader.read_available(fds[0]),
+            xap::core::buffer::BUFFER_READ_FULL,
+            "Case 2: invalid status of reading into a full queue."
+        );
+        xap::test::assert_equal<size_t>(
+            queue.get_remaining_size(),
+            10U,
+            "Case 2: invalid queue size."
+        );
+        queue.consume(10U);
+        xap::test::assert_equal<int>(
+            reader.read_available(fds[0]),
+            xap::core::buffer::BUFFER_READ_AGAIN,
+            "Case 2: invalid status of reading the rest."
+        );
+        xap::test::assert_ok(
+            queue.get_remaining_size() == 6U &&
+            queue.peek_uint8(0U) == 'A',
+            "Case 2: invalid rest."
+        );
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+
+    //
+    //  Case 3: chunks are allocated per chunk size (not per read).
+    //
+    {
+        int fds[2];
+        make_pipe(fds);
+
+        CountingAllocator allocator;
+        {
+            xap::core::buffer::BufferQueue queue;
+            xap::core::buffer::BufferReader reader(queue, 64U, 1U, allocator);
+            for (size_t i = 0U; i < 16U; ++i) {
+                write_all(fds[1], "0123");
+                xap::test::assert_equal<int>(
+                    reader.read_some(fds[0]),
+                    xap::core::buffer::BUFFER_READ_DATA,
+                    "Case 3: invalid status."
+                );
+            }
+            xap::test::assert_ok(
+                allocator.get_allocations() == 1U &&
+                queue.get_remaining_size() == 64U &&
+                reader.get_read_calls() == 16U,
+                "Case 3: invalid allocation count."
+            );
+            write_all(fds[1], "4");
+            reader.read_some(fds[0]);
+            xap::test::assert_equal<size_t>(
+                allocator.get_allocations(),
+                2U,
+                "Case 3: invalid allocation count of the next chunk."
+            );
+        }
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+
+    //
+    //  Case 4: invalid arguments.
+    //
+    {
+        xap::core::buffer::BufferQueue queue;
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                xap::core::buffer::BufferReader reader(queue, 0U);
+            },
+            "Case 4: zero chunk size."
+        );
+        xap::core::buffer::BufferReader reader(queue);
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                reader.read_some(-1);
+            },
+            "Case 4: invalid descriptor."
+        );
+    }
+
+    //
+    //  Case 5: read_available() stops at 'max_size' within a batch.
+    //
+    {
+        int fds[2];
+        make_pipe(fds);
+
+        xap::core::buffer::BufferQueue queue;
+        xap::core::buffer::BufferReader reader(queue, 8U, 4U);
+        write_all(fds[1], "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcd");
+        xap::test::assert_equal<int>(
+            reader.read_available(fds[0], 13U),
+            xap::core::buffer::BUFFER_READ_DATA,
+            "Case 5: invalid status of the limited read."
+        );
+        xap::test::assert_ok(
+            queue.get_remaining_size() == 13U &&
+            reader.get_total_read() == 13U &&
+            reader.get_read_calls() == 1U,
+            "Case 5: the limited read went past 'max_size'."
+        );
+        xap::test::assert_equal<int>(
+            reader.read_available(fds[0], 23U),
+            xap::core::buffer::BUFFER_READ_DATA,
+            "Case 5: invalid status of the second limited read."
+        );
+        xap::test::assert_equal<size_t>(
+            queue.get_remaining_size(),
+            36U,
+            "Case 5: the second limited read went past 'max_size'."
+        );
+        xap::test::assert_equal<int>(
+            reader.read_available(fds[0]),
+            xap::core::buffer::BUFFER_READ_AGAIN,
+            "Case 5: invalid status of reading the rest."
+        );
+        const xap::core::buffer::Buffer all = queue.pop_all();
+        xap::test::assert_ok(
+            all.get_length() == 40U &&
+            memcmp(
+                all.get_pointer(),
+                "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcd",
+                40U
+            ) == 0,
+            "Case 5: invalid bytes."
+        );
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+
+    //
+    //  Case 6: default chunks take exactly one 16 KiB pool block.
+    //
+    {
+        int fds[2];
+        make_pipe(fds);
+
+        xap::core::buffer::BufferPoolAllocator pool(16384U);
+        void *block = pool.allocate(16384U, 16U);
+        pool.deallocate(block, 16384U, 16U);
+        {
+            xap::core::buffer::BufferQueue queue;
+            xap::core::buffer::BufferReader reader(queue, 16384U, 1U, pool);
+            write_all(fds[1], "0123");
+            reader.read_some(fds[0]);
+            const xap::core::buffer::Buffer view = queue.pop_view(4U);
+            xap::test::assert_ok(
+                view.get_pointer() == block,
+                "Case 6: the chunk was not served by the 16 KiB class."
+            );
+        }
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+#endif  //  #if defined(XAP_CORE_BUFFER_OS_POSIX)
+
+    return 0;
+}
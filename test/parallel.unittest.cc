@@ -0,0 +1,339 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+//
+//  Imports.
+//
+#include "common.h"
+
+#include <xap/core/buffer/parallel.h>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+//
+//  Executor which runs the tasks serially (in reverse order) and counts
+//  them.
+//
+class CountingExecutor : public xap::core::buffer::BufferExecutor {
+public:
+    CountingExecutor(): m_tasks(0U) {}
+
+    virtual void run(
+        xap::core::buffer::BufferTask   task,
+        void                            *context,
+        const size_t                    count
+    ) {
+        for (size_t i = count; i != 0U; --i) {
+            task(i - 1U, context);
+        }
+        m_tasks += count;
+    }
+
+    virtual size_t get_concurrency() const noexcept {
+        return 1U;
+    }
+
+    size_t get_tasks() const noexcept {
+        return m_tasks;
+    }
+
+private:
+    size_t m_tasks;
+};
+
+/**
+ *  Create a buffer filled with a pattern.
+ *
+ *  @param length
+ *      The length.
+ *  @param seed
+ *      The seed of the pattern.
+ *  @return
+ *      The buffer.
+ */
+static xap::core::buffer::Buffer make_pattern(
+    const size_t    length,
+    const size_t    seed
+) {
+    xap::core::buffer::Buffer buffer(length, true);
+    for (size_t i = 0U; i < length; ++i) {
+        buffer[i] = static_cast<uint8_t>((i * 131U + seed) >> 3U);
+    }
+    return buffer;
+}
+
+/**
+ *  Count tasks (task callback).
+ *
+ *  @param index
+ *      The index of the task.
+ *  @param context
+ *      The context (array of counters).
+ */
+static void count_task(const size_t index, void *context) {
+    static_cast<std::atomic<size_t>*>(context)[index].fetch_add(1U);
+}
+
+//
+//  Context of throw_task().
+//
+struct ThrowContext {
+    //  The thread which calls run().
+    std::thread::id         caller;
+
+    //  Whether the tasks on the calling thread (or on pool threads) throw.
+    bool                    on_caller;
+};
+
+/**
+ *  Throw on the calling thread or on pool threads (task callback).
+ *
+ *  @param index
+ *      The index of the task.
+ *  @param context
+ *      The context (ThrowContext).
+ */
+static void throw_task(const size_t index, void *context) {
+    (void)index;
+    ThrowContext *ctx = static_cast<ThrowContext*>(context);
+    if ((std::this_thread::get_id() == ctx->caller) == ctx->on_caller) {
+        throw std::runtime_error("Task failed.");
+    }
+
+    //  Keep the task slow enough that every thread claims some.
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+//
+//  Entry.
+//
+int main() {
+    const size_t big = xap::core::buffer::BUFFER_PARALLEL_THRESHOLD + 12345U;
+    xap::core::buffer::BufferThreadPool pool(3U);
+
+    //
+    //  Case 1: every task runs exactly once.
+    //
+    {
+        xap::test::assert_equal<size_t>(
+            pool.get_concurrency(),
+            4U,
+            "Case 1: invalid concurrency."
+        );
+        for (size_t round = 0U; round < 50U; ++round) {
+            std::vector<std::atomic<size_t>> counters(257U);
+            pool.run(count_task, counters.data(), counters.size());
+            for (size_t i = 0U; i < counters.size(); ++i) {
+                xap::test::assert_equal<size_t>(
+                    counters[i].load(),
+                    1U,
+                    "Case 1: invalid count of task runs."
+                );
+            }
+        }
+        pool.run(count_task, nullptr, 0U);
+
+        xap::core::buffer::BufferThreadPool serial(0U);
+        std::vector<std::atomic<size_t>> counters(3U);
+        serial.run(count_task, counters.data(), counters.size());
+        xap::test::assert_ok(
+            serial.get_concurrency() == 1U && counters[2U].load() == 1U,
+            "Case 1: invalid serial pool."
+        );
+    }
+
+    //
+    //  Case 2: concat.
+    //
+    {
+        xap::core::buffer::Buffer parts[4] = {
+            make_pattern(big, 1U),
+            xap::core::buffer::Buffer(0U),
+            make_pattern(777U, 2U),
+            make_pattern(big / 2U, 3U)
+        };
+        const xap::core::buffer::Buffer expected =
+            xap::core::buffer::Buffer::concat(parts, 4U);
+        const xap::core::buffer::Buffer rst =
+            xap::core::buffer::buffer_parallel_concat(parts, 4U, pool);
+        xap::test::assert_ok(
+            rst.get_length() == expected.get_length() && rst == expected,
+            "Case 2: invalid concatenation."
+        );
+
+        CountingExecutor counting;
+        const xap::core::buffer::Buffer small =
+            xap::core::buffer::buffer_parallel_concat(parts + 2, 1U, counting);
+        xap::test::assert_ok(
+            small == parts[2] && counting.get_tasks() == 0U,
+            "Case 2: small concatenation was run by the executor."
+        );
+    }
+
+    //
+    //  Case 3: copy (with and without non-temporal stores).
+    //
+    {
+        const size_t sizes[2] = {
+            big,
+            xap::core::buffer::BUFFER_PARALLEL_STREAM_THRESHOLD + 33U
+        };
+        for (const size_t size : sizes) {
+            const xap::core::buffer::Buffer src = make_pattern(size, 4U);
+            //  Unaligned destination, longer than the source.
+            xap::core::buffer::Buffer storage(size + 100U);
+            xap::core::buffer::Buffer dst = storage.slice(3U);
+            xap::test::assert_equal<size_t>(
+                xap::core::buffer::buffer_parallel_copy(src, dst, pool),
+                size,
+                "Case 3: invalid count of bytes copied."
+            );
+            xap::test::assert_ok(
+                dst.slice(0U, size) == src &&
+                dst[size] == 0U &&
+                storage[2U] == 0U,
+                "Case 3: invalid copy."
+            );
+        }
+
+        //  Copy-on-write destinations are detached.
+        const xap::core::buffer::Buffer src = make_pattern(big, 5U);
+        xap::core::buffer::Buffer dst(big);
+        dst.set_copy_on_write(true);
+        const xap::core::buffer::Buffer shared = dst;
+        CountingExecutor counting;
+        xap::core::buffer::buffer_parallel_copy(src, dst, counting);
+        xap::test::assert_ok(
+            dst == src && shared[0U] == 0U && shared[big - 1U] == 0U &&
+            counting.get_tasks() != 0U,
+            "Case 3: invalid copy-on-write copy."
+        );
+    }
+
+    //
+    //  Case 4: fill.
+    //
+    {
+        const size_t sizes[2] = {
+            big,
+            xap::core::buffer::BUFFER_PARALLEL_STREAM_THRESHOLD + 7U
+        };
+        for (const size_t size : sizes) {
+            xap::core::buffer::Buffer storage(size + 2U);
+            xap::core::buffer::Buffer buffer = storage.slice(1U, size);
+            xap::core::buffer::buffer_parallel_fill(buffer, 0xA5U, pool);
+            xap::core::buffer::Buffer expected(size, true);
+            expected.fill(0xA5U);
+            xap::test::assert_ok(
+                buffer == expected &&
+                storage[0U] == 0U &&
+                storage[size + 1U] == 0U,
+                "Case 4: invalid fill."
+            );
+        }
+    }
+
+    //
+    //  Case 5: compare.
+    //
+    {
+        const xap::core::buffer::Buffer first = make_pattern(big, 6U);
+        xap::core::buffer::Buffer second = make_pattern(big, 6U);
+        xap::test::assert_ok(
+            xap::core::buffer::buffer_parallel_is_equal(first, second, pool),
+            "Case 5: equal buffers."
+        );
+        xap::test::assert_ok(
+            xap::core::buffer::buffer_parallel_is_equal(first, first, pool),
+            "Case 5: same buffer."
+        );
+
+        const size_t positions[3] = {0U, big / 2U, big - 1U};
+        for (const size_t position : positions) {
+            second[position] ^= 1U;
+            xap::test::assert_ok(
+                !xap::core::buffer::buffer_parallel_is_equal(
+                    first,
+                    second,
+                    pool
+                ),
+                "Case 5: different buffers."
+            );
+            second[position] ^= 1U;
+        }
+        xap::test::assert_ok(
+            !xap::core::buffer::buffer_parallel_is_equal(
+                first,
+                second.slice(1U),
+                pool
+            ),
+            "Case 5: different lengths."
+        );
+    }
+
+    //
+    //  Case 6: concat rejects total lengths which overflow.
+    //
+    {
+        uint8_t stack[1U] = {0x00};
+        const xap::core::buffer::Buffer halves[2] = {
+            xap::core::buffer::Buffer::wrap_unowned(stack, SIZE_MAX / 2U + 1U),
+            xap::core::buffer::Buffer::wrap_unowned(stack, SIZE_MAX / 2U + 1U)
+        };
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                xap::core::buffer::buffer_parallel_concat(halves, 2U, pool);
+            },
+            "Case 6: overflowed concat was accepted."
+        );
+    }
+
+    //
+    //  Case 7: exceptions of tasks are rethrown by run().
+    //
+    {
+        const bool sides[] = {false, true};
+        for (const bool on_caller : sides) {
+            ThrowContext context;
+            context.caller = std::this_thread::get_id();
+            context.on_caller = on_caller;
+            xap::test::assert_throw<std::runtime_error>(
+                [&]() {
+                    pool.run(throw_task, &context, 64U);
+                },
+                "Case 7: the exception of a task was not rethrown."
+            );
+        }
+
+        //  The pool keeps working.
+        std::vector<std::atomic<size_t>> counters(64U);
+        pool.run(count_task, counters.data(), counters.size());
+        for (size_t i = 0U; i < counters.size(); ++i) {
+            xap::test::assert_equal<size_t>(
+                counters[i].load(),
+                1U,
+                "Case 7: invalid count of task runs after an exception."
+            );
+        }
+
+        xap::core::buffer::BufferThreadPool serial(0U);
+        ThrowContext context;
+        context.caller = std::this_thread::get_id();
+        context.on_caller = true;
+        xap::test::assert_throw<std::runtime_error>(
+            [&]() {
+                serial.run(throw_task, &context, 4U);
+            },
+            "Case 7: the exception of a serial task was not rethrown."
+        );
+    }
+
+    return 0;
+}
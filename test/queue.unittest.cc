@@ -12,6 +12,8 @@
 
 #include <xap/core/buffer/queue.h>
 #include <string>
+#include <utility>
+#include <vector>
 
 void check_buffer_with_string(
     const xap::core::buffer::Buffer &buf, 
@@ -41,6 +43,25 @@ void check_buffer_with_string(
     );
 }
 
+//
+//  Watermark listener which counts the notifications.
+//
+class CountingListener: public xap::core::buffer::BufferQueueListener {
+public:
+    CountingListener() noexcept : high(0U), low(0U) {}
+
+    virtual void on_high_watermark(xap::core::buffer::BufferQueue&) {
+        ++this->high;
+    }
+
+    virtual void on_low_watermark(xap::core::buffer::BufferQueue&) {
+        ++this->low;
+    }
+
+    size_t high;
+    size_t low;
+};
+
 //
 //  Entry.
 //
@@ -104,5 +125,730 @@ int main() {
         "Invalid pop value 7."
     );
 
+    //
+    //  Zero-copy pop.
+    //
+    {
+        xap::core::buffer::BufferQueue view_queue;
+        view_queue.push(buffer1);
+        view_queue.push(buffer2);
+
+        xap::core::buffer::Buffer view1 = view_queue.pop_view(3U);
+        check_buffer_with_string(view1, "010203", "Invalid pop_view value 1.");
+        xap::test::assert_ok(
+            view1.get_pointer() == buffer1.get_pointer(),
+            "pop_view() copied contiguous bytes."
+        );
+
+        xap::core::buffer::Buffer view2 = view_queue.pop_view(2U);
+        check_buffer_with_string(view2, "04A1", "Invalid pop_view value 2.");
+
+        xap::core::buffer::Buffer view3 = view_queue.pop_view(3U);
+        check_buffer_with_string(view3, "B2C3D4", "Invalid pop_view value 3.");
+        xap::test::assert_ok(
+            view3.get_pointer() == buffer2.get_pointer() + 1U,
+            "pop_view() copied contiguous bytes."
+        );
+        xap::test::assert_equal<size_t>(
+            view_queue.get_remaining_size(),
+            0U,
+            "Invalid remaining size after pop_view()."
+        );
+        xap::test::assert_throw<xap::core::buffer::BufferException>([&] {
+            view_queue.pop_view(1U);
+        });
+    }
+
+    //
+    //  Scatter/gather segments.
+    //
+    {
+        xap::core::buffer::BufferQueue segment_queue;
+        segment_queue.push(buffer1);
+        segment_queue.push(buffer2);
+        segment_queue.push(buffer3);
+        segment_queue.consume(1U);
+
+        xap::core::buffer::BufferSegment segments[4];
+        size_t count = segment_queue.get_segments(segments, 4U);
+        xap::test::assert_equal<size_t>(count, 3U, "Invalid segment count 1.");
+        xap::test::assert_ok(
+            segments[0].pointer == buffer1.get_pointer() + 1U &&
+            segments[0].length == 3U &&
+            segments[1].pointer == buffer2.get_pointer() &&
+            segments[1].length == 4U &&
+            segments[2].pointer == buffer3.get_pointer() &&
+            segments[2].length == 3U,
+            "Invalid segments 1."
+        );
+
+        count = segment_queue.get_segments(segments, 4U, 5U);
+        xap::test::assert_ok(
+            count == 2U && 
+            segments[0].length == 3U && 
+            segments[1].length == 2U,
+            "Invalid segments 2."
+        );
+
+        count = segment_queue.get_segments(segments, 1U);
+        xap::test::assert_equal<size_t>(count, 1U, "Invalid segment count 3.");
+
+        segment_queue.consume(5U);
+        xap::test::assert_equal<size_t>(
+            segment_queue.get_remaining_size(),
+            5U,
+            "Invalid remaining size after consume()."
+        );
+        check_buffer_with_string(
+            segment_queue.pop_all(),
+            "C3D4818283",
+            "Invalid pop value after consume()."
+        );
+        xap::test::assert_throw<xap::core::buffer::BufferException>([&] {
+            segment_queue.consume(1U);
+        });
+    }
+
+    //
+    //  Ring growth and wrap-around.
+    //
+    {
+        xap::core::buffer::BufferQueue ring_queue;
+        uint8_t next_push = 0U;
+        uint8_t next_pop = 0U;
+        for (size_t round = 0U; round < 64U; ++round) {
+            for (size_t i = 0U; i < 5U; ++i) {
+                xap::core::buffer::Buffer chunk(3U);
+                for (size_t j = 0U; j < 3U; ++j) {
+                    chunk[j] = next_push++;
+                }
+                ring_queue.push(std::move(chunk));
+            }
+            xap::core::buffer::Buffer popped = ring_queue.pop(
+                (round % 2U == 0U) ? 7U : 11U
+            );
+            for (size_t j = 0U; j < popped.get_length(); ++j) {
+                xap::test::assert_equal<uint8_t>(
+                    popped[j],
+                    next_pop++,
+                    "Invalid pop value in ring."
+                );
+            }
+        }
+
+        xap::core::buffer::BufferQueue copied(ring_queue);
+        xap::core::buffer::Buffer rest = ring_queue.pop_all();
+        xap::test::assert_ok(
+            copied.pop_all() == rest,
+            "Invalid copied ring."
+        );
+        for (size_t j = 0U; j < rest.get_length(); ++j) {
+            xap::test::assert_equal<uint8_t>(
+                rest[j],
+                next_pop++,
+                "Invalid pop_all() value in ring."
+            );
+        }
+        xap::test::assert_equal<uint8_t>(
+            next_pop,
+            next_push,
+            "Invalid count of bytes in ring."
+        );
+    }
+
+    //
+    //  Move semantics.
+    //
+    {
+        xap::core::buffer::BufferQueue src;
+        src.push(xap::core::buffer::Buffer(data1, data1len));
+        src.push(xap::core::buffer::Buffer(data2, data2len));
+
+        xap::core::buffer::BufferQueue moved(std::move(src));
+        xap::test::assert_equal<size_t>(
+            src.get_remaining_size(),
+            0U,
+            "Invalid remaining size after moved 1."
+        );
+        xap::test::assert_equal<size_t>(
+            moved.get_remaining_size(),
+            data1len + data2len,
+            "Invalid remaining size after moved 2."
+        );
+
+        xap::core::buffer::BufferQueue assigned;
+        assigned.push(buffer3);
+        assigned = std::move(moved);
+        check_buffer_with_string(
+            assigned.pop_all(),
+            "01020304A1B2C3D4",
+            "Invalid pop value 8."
+        );
+    }
+
+    //
+    //  Framing.
+    //
+    {
+        //  Peek across chunk boundaries.
+        const uint8_t part1[] = {0x00, 0x03, 0xAA};
+        const uint8_t part2[] = {0xBB, 0xCC, 0x00};
+        const uint8_t part3[] = {0x01, 0xDD};
+        xap::core::buffer::BufferQueue framed;
+        framed.push(xap::core::buffer::Buffer(part1, sizeof(part1)));
+        framed.push(xap::core::buffer::Buffer(part2, sizeof(part2)));
+        xap::test::assert_equal<uint16_t>(
+            framed.peek_uint16_be(0U),
+            0x0003U,
+            "Invalid peek value 1."
+        );
+        xap::test::assert_equal<uint32_t>(
+            framed.peek_uint32_le(1U),
+            0xCCBBAA03U,
+            "Invalid peek value 2."
+        );
+        xap::test::assert_equal<uint8_t>(
+            framed.peek_uint8(5U),
+            0x00U,
+            "Invalid peek value 3."
+        );
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                framed.peek_uint16_be(5U);
+            },
+            "peek_uint16_be(5U) didn't throw."
+        );
+        xap::test::assert_equal<size_t>(
+            framed.get_remaining_size(),
+            6U,
+            "Peek consumed bytes."
+        );
+
+        //  Length-prefixed frames (the second one is incomplete at first).
+        xap::core::buffer::Buffer frame;
+        xap::test::assert_ok(
+            framed.try_pop_frame_length_prefixed(2U, false, frame),
+            "Frame 1 was not popped."
+        );
+        check_buffer_with_string(frame, "AABBCC", "Invalid frame 1.");
+        xap::test::assert_ok(
+            !framed.try_pop_frame_length_prefixed(2U, false, frame),
+            "Incomplete frame 2 was popped."
+        );
+        xap::test::assert_equal<size_t>(
+            framed.get_remaining_size(),
+            1U,
+            "Incomplete frame 2 was consumed."
+        );
+        framed.push(xap::core::buffer::Buffer(part3, sizeof(part3)));
+        xap::test::assert_ok(
+            framed.try_pop_frame_length_prefixed(2U, false, frame),
+            "Frame 2 was not popped."
+        );
+        check_buffer_with_string(frame, "DD", "Invalid frame 2.");
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                framed.try_pop_frame_length_prefixed(3U, false, frame);
+            },
+            "Invalid header width didn't throw."
+        );
+
+        //  Zero-copy frame inside one chunk.
+        const uint8_t whole[] = {0x02, 0x00, 0x00, 0x00, 0x11, 0x22};
+        xap::core::buffer::Buffer whole_buffer(whole, sizeof(whole));
+        framed.push(whole_buffer);
+        xap::test::assert_ok(
+            framed.try_pop_frame_length_prefixed(4U, true, frame),
+            "Frame 3 was not popped."
+        );
+        xap::test::assert_ok(
+            frame.get_pointer() == whole_buffer.get_pointer() + 4U,
+            "Frame 3 was copied."
+        );
+
+        //  Delimited frames (the delimiter straddles chunks).
+        const uint8_t line1[] = {'G', 'E', 'T', '\r'};
+        const uint8_t line2[] = {'\n', 'O', 'K', '\r', '\n', 'X'};
+        const uint8_t crlf[] = {'\r', '\n'};
+        const xap::core::buffer::Buffer delimiter(crlf, sizeof(crlf));
+        xap::core::buffer::BufferQueue lines;
+        lines.push(xap::core::buffer::Buffer(line1, sizeof(line1)));
+        xap::test::assert_ok(
+            !lines.try_pop_until(delimiter, frame),
+            "Incomplete line was popped."
+        );
+        lines.push(xap::core::buffer::Buffer(line2, sizeof(line2)));
+        xap::test::assert_equal<size_t>(
+            lines.index_of(delimiter),
+            3U,
+            "Invalid delimiter position."
+        );
+        xap::test::assert_ok(
+            lines.try_pop_until(delimiter, frame),
+            "Line 1 was not popped."
+        );
+        check_buffer_with_string(frame, "474554", "Invalid line 1.");
+        xap::test::assert_ok(
+            lines.try_pop_until(delimiter, frame),
+            "Line 2 was not popped."
+        );
+        check_buffer_with_string(frame, "4F4B", "Invalid line 2.");
+        xap::test::assert_ok(
+            !lines.try_pop_until(delimiter, frame),
+            "Line 3 was popped."
+        );
+        xap::test::assert_equal<size_t>(
+            lines.get_remaining_size(),
+            1U,
+            "Invalid remaining size after lines."
+        );
+
+        //  A line pushed byte by byte, polled after each push (the search 
+        //  resumes where the previous one stopped).
+        const char *stream = "HELLO\r\r\nWORLD\r\n";
+        xap::core::buffer::BufferQueue bytes;
+        std::vector<std::string> polled;
+        for (size_t i = 0U; stream[i] != '\0'; ++i) {
+            bytes.push(xap::core::buffer::Buffer(
+                reinterpret_cast<const uint8_t*>(stream + i), 
+                1U
+            ));
+            while (bytes.try_pop_until(delimiter, frame)) {
+                polled.push_back(std::string(
+                    reinterpret_cast<const char*>(frame.get_pointer()), 
+                    frame.get_length()
+                ));
+                xap::test::assert_equal<size_t>(
+                    i, 
+                    polled.size() == 1U ? 7U : 14U, 
+                    "Line was popped at an invalid push."
+                );
+            }
+        }
+        xap::test::assert_ok(
+            polled.size() == 2U && 
+            polled[0U] == "HELLO\r" && 
+            polled[1U] == "WORLD" && 
+            bytes.get_remaining_size() == 0U,
+            "Invalid lines popped byte by byte."
+        );
+
+        //  Another delimiter restarts the search from the queue front.
+        const uint8_t abc[] = {'a', 'b', 'c'};
+        const uint8_t b_only[] = {'b'};
+        bytes.push(xap::core::buffer::Buffer(abc, sizeof(abc)));
+        xap::test::assert_ok(
+            !bytes.try_pop_until(delimiter, frame) && 
+            bytes.try_pop_until(
+                xap::core::buffer::Buffer(b_only, sizeof(b_only)), 
+                frame
+            ) && 
+            frame.get_length() == 1U && frame[0U] == 'a',
+            "Invalid pop with another delimiter."
+        );
+
+        //  Search from an offset (inside and across chunks).
+        const uint8_t twice1[] = {'a', 'b', '\r', '\n', 'a', 'b', '\r'};
+        const uint8_t twice2[] = {'\n'};
+        xap::core::buffer::BufferQueue twice;
+        twice.push(xap::core::buffer::Buffer(twice1, sizeof(twice1)));
+        twice.push(xap::core::buffer::Buffer(twice2, sizeof(twice2)));
+        xap::test::assert_ok(
+            twice.index_of(delimiter, 0U) == 2U && 
+            twice.index_of(delimiter, 3U) == 6U && 
+            twice.index_of(delimiter, 7U) == xap::core::buffer::Buffer::NPOS &&
+            twice.index_of(xap::core::buffer::Buffer(), 8U) == 8U && 
+            twice.index_of(xap::core::buffer::Buffer(), 9U) == 
+                xap::core::buffer::Buffer::NPOS,
+            "Invalid search from offset."
+        );
+
+        //  A delimiter spanning three chunks.
+        const uint8_t sync[] = {0x7E, 0x7E, 0x7E};
+        const uint8_t one[] = {0x7E};
+        xap::core::buffer::BufferQueue spans;
+        spans.push(xap::core::buffer::Buffer(part1, sizeof(part1)));
+        spans.push(xap::core::buffer::Buffer(one, sizeof(one)));
+        spans.push(xap::core::buffer::Buffer(one, sizeof(one)));
+        spans.push(xap::core::buffer::Buffer(one, sizeof(one)));
+        xap::test::assert_equal<size_t>(
+            spans.index_of(xap::core::buffer::Buffer(sync, sizeof(sync))),
+            3U,
+            "Invalid spanning delimiter position."
+        );
+    }
+
+    //
+    //  Backpressure.
+    //
+    {
+        const uint8_t data[] = {0x01, 0x02, 0x03, 0x04};
+        const xap::core::buffer::Buffer chunk(data, sizeof(data));
+        CountingListener listener;
+        xap::core::buffer::BufferQueue bounded;
+        bounded.set_max_size(10U);
+        bounded.set_watermarks(8U, 2U, &listener);
+        xap::test::assert_equal<size_t>(
+            bounded.get_max_size(),
+            10U,
+            "Invalid maximum size."
+        );
+
+        xap::test::assert_ok(bounded.try_push(chunk), "Push 1 failed.");
+        xap::test::assert_ok(!bounded.is_high(), "High too early.");
+        xap::test::assert_ok(bounded.try_push(chunk), "Push 2 failed.");
+        xap::test::assert_ok(bounded.is_high(), "Not high.");
+        xap::test::assert_equal<size_t>(
+            listener.high,
+            1U,
+            "Invalid high notification count."
+        );
+
+        //  2 bytes left in the budget.
+        xap::test::assert_ok(!bounded.try_push(chunk), "Pushed over budget.");
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                bounded.push(chunk);
+            },
+            "Pushed over budget without exception."
+        );
+        xap::core::buffer::Buffer moved(chunk);
+        xap::test::assert_ok(
+            !bounded.try_push(std::move(moved)) && 
+            moved.get_length() == 4U,
+            "Rejected buffer was moved."
+        );
+        xap::test::assert_ok(
+            bounded.try_push(chunk.slice(0U, 2U)),
+            "Push to the budget failed."
+        );
+        xap::test::assert_equal<size_t>(
+            bounded.get_remaining_size(),
+            10U,
+            "Invalid remaining size at budget."
+        );
+
+        //  Hysteresis: low is notified only at the low watermark.
+        bounded.consume(5U);
+        xap::test::assert_ok(bounded.is_high(), "Not high above low.");
+        xap::test::assert_equal<size_t>(
+            listener.low,
+            0U,
+            "Low notified too early."
+        );
+        bounded.pop_view(3U);
+        xap::test::assert_ok(!bounded.is_high(), "Still high.");
+        xap::test::assert_equal<size_t>(
+            listener.low,
+            1U,
+            "Invalid low notification count."
+        );
+        bounded.pop_all();
+        xap::test::assert_equal<size_t>(
+            listener.low,
+            1U,
+            "Low notified twice."
+        );
+
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                bounded.set_watermarks(1U, 2U, &listener);
+            },
+            "Invalid watermarks were accepted."
+        );
+    }
+
+    //
+    //  Typed pops (across chunks).
+    //
+    {
+        xap::core::buffer::BufferQueue queue;
+        const uint8_t part1[] = {0x01, 0x02, 0x03, 0x04, 0x05};
+        const uint8_t part2[] = {0x06, 0x07, 0x08, 0x09, 0x3F};
+        const uint8_t part3[] = {0x80, 0x00, 0x00, 0xFF, 0xFF};
+        const uint8_t part4[] = {0xFF, 0xFF, 0x0F, 0x03};
+        queue.push(xap::core::buffer::Buffer(part1, sizeof(part1)));
+        queue.push(xap::core::buffer::Buffer(part2, sizeof(part2)));
+        queue.push(xap::core::buffer::Buffer(part3, sizeof(part3)));
+        queue.push(xap::core::buffer::Buffer(part4, sizeof(part4)));
+
+        xap::test::assert_ok(
+            queue.pop_uint8() == 0x01U &&
+            queue.pop_uint16_le() == 0x0302U &&
+            queue.pop_uint32_be() == 0x04050607U &&
+            queue.pop_uint16_be() == 0x0809U &&
+            queue.pop_float_be() == 1.0F &&
+            queue.pop_varint() == 0xFFFFFFFFU &&
+            queue.pop_varint_signed() == -2,
+            "Invalid popped typed values."
+        );
+        xap::test::assert_equal<size_t>(
+            queue.get_remaining_size(),
+            0U,
+            "Invalid remaining size after typed pops."
+        );
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                queue.pop_varint();
+            },
+            "Popped varint from empty queue."
+        );
+
+        const uint8_t overlong[] = {
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x02
+        };
+        queue.push(xap::core::buffer::Buffer(overlong, sizeof(overlong)));
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                queue.pop_varint();
+            },
+            "Popped overlong varint."
+        );
+        xap::test::assert_equal<size_t>(
+            queue.get_remaining_size(),
+            10U,
+            "Failed pop consumed bytes."
+        );
+    }
+
+    //
+    //  Transactional fetcher (look ahead, rewind and commit).
+    //
+    {
+        xap::core::buffer::BufferQueue queue;
+        xap::core::buffer::BufferQueueFetcher fetcher(queue);
+        xap::test::assert_ok(
+            fetcher.is_end() && fetcher.get_remaining_size() == 0U,
+            "Fetcher of empty queue is not ended."
+        );
+
+        //  A frame is a 16-bit big-endian length and the payload, pushed
+        //  in pieces which split both the header and the payload.
+        const uint8_t piece1[] = {0x00};
+        const uint8_t piece2[] = {0x05, 'h', 'e'};
+        const uint8_t piece3[] = {'l', 'l', 'o', 0x00, 0x02, 'o', 'k'};
+        const uint8_t *pieces[] = {piece1, piece2, piece3};
+        const size_t piece_sizes[] = {
+            sizeof(piece1), sizeof(piece2), sizeof(piece3)
+        };
+        std::vector<std::string> frames;
+        for (size_t i = 0U; i < 3U; ++i) {
+            queue.push(xap::core::buffer::Buffer(pieces[i], piece_sizes[i]));
+            while (true) {
+                fetcher.mark();
+                if (fetcher.get_remaining_size() < 2U) {
+                    break;
+                }
+                const uint16_t length = fetcher.fetch_uint16_be();
+                if (fetcher.get_remaining_size() < length) {
+                    fetcher.rewind();
+                    break;
+                }
+                const xap::core::buffer::Buffer payload =
+                    fetcher.fetch_bytes(length);
+                frames.push_back(std::string(
+                    reinterpret_cast<const char*>(payload.get_pointer()),
+                    payload.get_length()
+                ));
+                fetcher.commit();
+            }
+            xap::test::assert_equal<size_t>(
+                fetcher.get_position(),
+                0U,
+                "Fetcher position was not rewound."
+            );
+        }
+        xap::test::assert_ok(
+            frames.size() == 2U &&
+            frames[0U] == "hello" &&
+            frames[1U] == "ok" &&
+            queue.get_remaining_size() == 0U,
+            "Invalid frames parsed by fetcher."
+        );
+
+        //  Typed fetches across chunks, fetching doesn't consume.
+        const uint8_t head[] = {0x01, 0x02, 0x03};
+        const uint8_t tail[] = {
+            0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D,
+            0x0E, 0x0F, 0x10
+        };
+        queue.push(xap::core::buffer::Buffer(head, sizeof(head)));
+        queue.push(xap::core::buffer::Buffer(tail, sizeof(tail)));
+        xap::test::assert_ok(
+            fetcher.fetch() == 0x01U &&
+            fetcher.fetch_uint32_le() == 0x05040302U &&
+            fetcher.fetch_uint64_be() == 0x060708090A0B0C0DULL &&
+            fetcher.fetch_uint16_le() == 0x0F0EU &&
+            fetcher.get_remaining_size() == 1U &&
+            queue.get_remaining_size() == 16U,
+            "Invalid typed fetches."
+        );
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                fetcher.fetch_uint16_be();
+            },
+            "Fetched beyond the queue."
+        );
+        xap::test::assert_equal<size_t>(
+            fetcher.get_remaining_size(),
+            1U,
+            "Failed fetch moved the cursor."
+        );
+
+        //  Zero-copy fetch inside one chunk, coalesced across chunks.
+        fetcher.reset();
+        fetcher.skip(1U);
+        const xap::core::buffer::Buffer inside = fetcher.fetch_bytes(2U);
+        xap::core::buffer::BufferSegment segments[2];
+        queue.get_segments(segments, 2U);
+        xap::test::assert_ok(
+            inside.get_pointer() == segments[0U].pointer + 1U &&
+            inside[1U] == 0x03U,
+            "Fetch inside one chunk was copied."
+        );
+        fetcher.rewind();
+        fetcher.skip(2U);
+        const xap::core::buffer::Buffer across = fetcher.fetch_bytes(3U);
+        xap::test::assert_ok(
+            across[0U] == 0x03U && across[1U] == 0x04U && across[2U] == 0x05U,
+            "Invalid fetch across chunks."
+        );
+
+        //  Commit in the middle of a chunk.
+        fetcher.commit();
+        xap::test::assert_ok(
+            queue.get_remaining_size() == 11U &&
+            fetcher.get_position() == 0U &&
+            fetcher.fetch() == 0x06U &&
+            queue.peek_uint8(0U) == 0x06U,
+            "Invalid commit."
+        );
+    }
+
+    //
+    //  Typed fetches (varint across chunks, rewind and commit).
+    //
+    {
+        xap::core::buffer::BufferQueue queue;
+        xap::core::buffer::BufferQueueFetcher fetcher(queue);
+
+        //  The varint 300 (0xAC 0x02) is split between two pushes.
+        const uint8_t part1[] = {0x01, 0xAC};
+        const uint8_t part2[] = {
+            0x02, 0xFE, 0xFF, 0x00, 0x00, 0x80, 0x3F,
+            0x3F, 0xF0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03
+        };
+        queue.push(xap::core::buffer::Buffer(part1, sizeof(part1)));
+        xap::test::assert_equal<uint8_t>(
+            fetcher.fetch_uint8(),
+            0x01U,
+            "Invalid fetched byte."
+        );
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                fetcher.fetch_varint();
+            },
+            "Fetched truncated varint."
+        );
+        xap::test::assert_ok(
+            fetcher.get_position() == 1U && fetcher.get_remaining_size() == 1U,
+            "Failed fetch moved the cursor."
+        );
+
+        queue.push(xap::core::buffer::Buffer(part2, sizeof(part2)));
+        xap::test::assert_ok(
+            fetcher.fetch_varint() == 300U && fetcher.get_position() == 3U,
+            "Invalid varint across chunks."
+        );
+        fetcher.rewind();
+        xap::test::assert_ok(
+            fetcher.fetch_uint8() == 0x01U &&
+            fetcher.fetch_varint() == 300U,
+            "Invalid varint after rewind."
+        );
+        fetcher.commit();
+        xap::test::assert_ok(
+            queue.get_remaining_size() == 15U &&
+            fetcher.fetch_sint16_le() == -2 &&
+            fetcher.fetch_float_le() == 1.0F &&
+            fetcher.fetch_double_be() == 1.0 &&
+            fetcher.fetch_varint_signed() == -2 &&
+            fetcher.is_end(),
+            "Invalid fetched typed values."
+        );
+        fetcher.commit();
+        xap::test::assert_equal<size_t>(
+            queue.get_remaining_size(),
+            0U,
+            "Invalid remaining size after commit."
+        );
+    }
+
+    //
+    //  Compaction and retained size.
+    //
+    {
+        //  A small live tail of a big chunk is copied out on consumption.
+        xap::core::buffer::Buffer big(1048576U);
+        big[1048575U] = 0x5AU;
+        const xap::core::buffer::Buffer header = big.slice(0U, 16U);
+        xap::test::assert_ok(
+            header.get_storage_length() == 1048576U &&
+            header.is_sharing_storage(big) &&
+            !header.is_sharing_storage(xap::core::buffer::Buffer(16U)),
+            "Invalid storage of a slice."
+        );
+
+        xap::core::buffer::BufferQueue queue;
+        queue.push(big);
+        queue.push(big.slice(0U, 1024U));
+        xap::test::assert_equal<size_t>(
+            queue.get_retained_size(),
+            1048576U,
+            "Shared storage was counted twice."
+        );
+        queue.consume(1048000U);
+        xap::test::assert_equal<size_t>(
+            queue.get_retained_size(),
+            1048576U,
+            "Compacted with compaction disabled."
+        );
+
+        queue.set_compaction(10U);
+        queue.consume(1U);
+        xap::test::assert_ok(
+            queue.get_remaining_size() == 1599U &&
+            queue.get_retained_size() == 1599U &&
+            queue.peek_uint8(574U) == 0x5AU,
+            "Invalid compaction of the front chunk."
+        );
+        xap::test::assert_equal<size_t>(
+            queue.compact(),
+            0U,
+            "Compacted a compacted queue."
+        );
+
+        //  Chunks below the minimum storage and live chunks are kept.
+        xap::core::buffer::BufferQueue other;
+        other.set_compaction(50U, 4096U);
+        other.push(xap::core::buffer::Buffer(4095U).slice(0U, 1U));
+        other.push(xap::core::buffer::Buffer(8192U).slice(0U, 4097U));
+        other.push(xap::core::buffer::Buffer(8192U).slice(0U, 16U));
+        xap::test::assert_ok(
+            other.get_retained_size() == 20479U &&
+            other.compact() == 1U &&
+            other.get_retained_size() == 12303U &&
+            other.get_remaining_size() == 4114U,
+            "Invalid compaction of all chunks."
+        );
+
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                other.set_compaction(101U);
+            },
+            "Invalid live percent."
+        );
+    }
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,192 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+//
+//  Imports.
+//
+#include "common.h"
+
+#include <xap/core/buffer/error.h>
+#include <xap/core/buffer/record.h>
+#include <string.h>
+
+//
+//  Private structures.
+//
+
+//
+//  Test record.
+//
+struct TestRecord {
+    uint8_t     kind;
+    int16_t     delta;
+    uint32_t    length;
+    uint64_t    sequence;
+    float       scale;
+    double      weight;
+    uint16_t    samples[3];
+};
+
+//
+//  Test layout.
+//
+typedef xap::core::buffer::RecordLayout<
+    XAP_CORE_BUFFER_RECORD_FIELD(TestRecord, kind, RECORD_BIG_ENDIAN),
+    XAP_CORE_BUFFER_RECORD_FIELD(TestRecord, delta, RECORD_LITTLE_ENDIAN),
+    xap::core::buffer::RecordPadding<1U>,
+    XAP_CORE_BUFFER_RECORD_FIELD(TestRecord, length, RECORD_BIG_ENDIAN),
+    XAP_CORE_BUFFER_RECORD_FIELD(TestRecord, sequence, RECORD_LITTLE_ENDIAN),
+    XAP_CORE_BUFFER_RECORD_FIELD(TestRecord, scale, RECORD_BIG_ENDIAN),
+    XAP_CORE_BUFFER_RECORD_FIELD(TestRecord, weight, RECORD_LITTLE_ENDIAN),
+    XAP_CORE_BUFFER_RECORD_ARRAY(TestRecord, samples, RECORD_BIG_ENDIAN)
+> TestLayout;
+
+static_assert(TestLayout::SIZE == 34U, "Invalid record size.");
+static_assert(TestLayout::Offset<3U>::VALUE == 4U, "Invalid field offset.");
+static_assert(TestLayout::Offset<7U>::VALUE == 28U, "Invalid field offset.");
+
+//
+//  Entry.
+//
+int main() {
+    const uint8_t raw[] = {
+        0x7F,
+        0xFE, 0xFF,
+        0xEE,
+        0x01, 0x02, 0x03, 0x04,
+        0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01,
+        0x3F, 0x80, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC0,
+        0x00, 0x01, 0x00, 0x02, 0xFF, 0xFF
+    };
+
+    //
+    //  Case 1: decode from buffer.
+    //
+    {
+        uint8_t prefixed[sizeof(raw) + 2U] = {0xAA, 0xBB};
+        memcpy(prefixed + 2U, raw, sizeof(raw));
+        xap::core::buffer::Buffer buffer(prefixed, sizeof(prefixed));
+
+        const TestRecord record = TestLayout::decode<TestRecord>(buffer, 2U);
+        xap::test::assert_ok(
+            record.kind == 0x7FU &&
+            record.delta == -2 &&
+            record.length == 0x01020304U &&
+            record.sequence == 0x0102030405060708ULL &&
+            record.scale == 1.0F &&
+            record.weight == -2.0,
+            "Case 1: invalid scalar fields."
+        );
+        xap::test::assert_ok(
+            record.samples[0] == 1U &&
+            record.samples[1] == 2U &&
+            record.samples[2] == 0xFFFFU,
+            "Case 1: invalid array field."
+        );
+
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                TestLayout::decode<TestRecord>(buffer, 3U);
+            },
+            "Case 1: no exception raised for out-of-range record."
+        );
+    }
+
+    //
+    //  Case 2: encode (round trip, padding zero-filled).
+    //
+    {
+        xap::core::buffer::Buffer source(raw, sizeof(raw));
+        const TestRecord record = TestLayout::decode<TestRecord>(source);
+
+        xap::core::buffer::Buffer encoded(sizeof(raw));
+        encoded.fill(0x55U);
+        TestLayout::encode(record, encoded);
+        xap::test::assert_equal<uint8_t>(
+            encoded[3U],
+            0x00U,
+            "Case 2: padding was not zero-filled."
+        );
+        encoded.write_uint8(0xEEU, 3U);
+        xap::test::assert_ok(
+            encoded == source,
+            "Case 2: encoded bytes mismatched."
+        );
+
+        xap::core::buffer::Buffer small(sizeof(raw) - 1U);
+        small.fill(0x55U);
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                TestLayout::encode(record, small);
+            },
+            "Case 2: no exception raised for out-of-range record."
+        );
+        xap::test::assert_equal<uint8_t>(
+            small[0U],
+            0x55U,
+            "Case 2: failed encode modified the buffer."
+        );
+    }
+
+    //
+    //  Case 3: encode into a shared copy-on-write buffer.
+    //
+    {
+        TestRecord record = TestRecord();
+        record.kind = 0x01U;
+        xap::core::buffer::Buffer buffer(TestLayout::SIZE);
+        buffer.fill(0x00U);
+        buffer.set_copy_on_write(true);
+        const xap::core::buffer::Buffer alias = buffer;
+
+        TestLayout::encode(record, buffer);
+        xap::test::assert_ok(
+            buffer[0U] == 0x01U && alias[0U] == 0x00U,
+            "Case 3: shared storage was modified."
+        );
+    }
+
+    //
+    //  Case 4: fetch and write.
+    //
+    {
+        xap::core::buffer::Buffer doubled(sizeof(raw) * 2U - 1U);
+        xap::core::buffer::Buffer(raw, sizeof(raw)).copy(doubled);
+        xap::core::buffer::BufferFetcher fetcher(doubled);
+
+        TestRecord record;
+        TestLayout::fetch(fetcher, record);
+        xap::test::assert_equal<size_t>(
+            fetcher.get_remaining_size(),
+            sizeof(raw) - 1U,
+            "Case 4: invalid remaining size."
+        );
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                TestLayout::fetch<TestRecord>(fetcher);
+            },
+            "Case 4: no exception raised for truncated record."
+        );
+        xap::test::assert_equal<size_t>(
+            fetcher.get_remaining_size(),
+            sizeof(raw) - 1U,
+            "Case 4: cursor moved by the failed fetch."
+        );
+
+        xap::core::buffer::BufferWriter writer;
+        writer.write_uint8(0x00U);
+        TestLayout::write(record, writer);
+        xap::core::buffer::Buffer written = writer.finish();
+        written.write_uint8(0xEEU, 4U);
+        xap::test::assert_ok(
+            written.slice(1U) == xap::core::buffer::Buffer(raw, sizeof(raw)),
+            "Case 4: written bytes mismatched."
+        );
+    }
+
+    return 0;
+}
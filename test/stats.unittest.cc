@@ -0,0 +1,210 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+//
+//  Imports.
+//
+#include "common.h"
+
+#include <xap/core/buffer/buffer.h>
+#include <xap/core/buffer/queue.h>
+#include <xap/core/buffer/stats.h>
+#include <thread>
+
+//
+//  Private variables.
+//
+
+//  The counters received by the hook.
+static xap::core::buffer::BufferStats g_hook_stats;
+static size_t g_hook_calls = 0U;
+
+//
+//  Private functions.
+//
+
+/**
+ *  Accumulate the counters passed to the hook.
+ *
+ *  @param stats
+ *      The counters.
+ *  @param context
+ *      The context (unused).
+ */
+static void stats_test_hook(
+    const xap::core::buffer::BufferStats &stats,
+    void *context
+) {
+    (void)context;
+    g_hook_stats.allocations += stats.allocations;
+    g_hook_stats.allocated_bytes += stats.allocated_bytes;
+    g_hook_stats.copied_bytes += stats.copied_bytes;
+    ++g_hook_calls;
+}
+
+//
+//  Entry.
+//
+int main() {
+    xap::test::assert_ok(
+        xap::core::buffer::buffer_stats_is_enabled(),
+        "Instrumentation is not compiled in."
+    );
+
+    //
+    //  Case 1: allocations and frees.
+    //
+    {
+        xap::core::buffer::buffer_stats_reset();
+        const uint64_t live =
+            xap::core::buffer::buffer_stats_get_snapshot().live_bytes;
+        {
+            xap::core::buffer::Buffer buffer(100U);
+            xap::core::buffer::Buffer alias = buffer;
+            const xap::core::buffer::BufferStats stats =
+                xap::core::buffer::buffer_stats_get_snapshot();
+            xap::test::assert_ok(
+                stats.allocations == 1U &&
+                stats.allocated_bytes == 100U &&
+                stats.frees == 0U &&
+                stats.live_bytes == live + 100U,
+                "Case 1: invalid allocation counters."
+            );
+        }
+        const xap::core::buffer::BufferStats stats =
+            xap::core::buffer::buffer_stats_get_snapshot();
+        xap::test::assert_ok(
+            stats.frees == 1U && stats.live_bytes == live,
+            "Case 1: invalid free counters."
+        );
+    }
+
+    //
+    //  Case 2: copies and slices.
+    //
+    {
+        const uint8_t raw[] = {1, 2, 3, 4, 5, 6, 7, 8};
+        xap::core::buffer::Buffer source(raw, sizeof(raw));
+        xap::core::buffer::Buffer destination(8U);
+        xap::core::buffer::buffer_stats_reset();
+
+        source.copy(destination);
+        xap::core::buffer::Buffer halves[2] = {
+            source.slice(0U, 4U),
+            source.slice(4U)
+        };
+        xap::core::buffer::Buffer whole =
+            xap::core::buffer::Buffer::concat(halves, 2U);
+
+        const xap::core::buffer::BufferStats stats =
+            xap::core::buffer::buffer_stats_get_snapshot();
+        xap::test::assert_equal<uint64_t>(
+            stats.copied_bytes,
+            16U,
+            "Case 2: invalid copied bytes."
+        );
+        xap::test::assert_equal<uint64_t>(
+            stats.slices,
+            2U,
+            "Case 2: invalid slice count."
+        );
+        xap::test::assert_equal<uint64_t>(
+            stats.allocations,
+            1U,
+            "Case 2: invalid allocation count."
+        );
+    }
+
+    //
+    //  Case 3: queue pops.
+    //
+    {
+        xap::core::buffer::BufferQueue queue;
+        queue.push(xap::core::buffer::Buffer(10U));
+        queue.push(xap::core::buffer::Buffer(6U));
+        xap::core::buffer::buffer_stats_reset();
+
+        queue.pop(12U);
+        queue.pop_all();
+
+        xap::test::assert_equal<uint64_t>(
+            xap::core::buffer::buffer_stats_get_snapshot().copied_bytes,
+            16U,
+            "Case 3: invalid copied bytes."
+        );
+    }
+
+    //
+    //  Case 4: peak live bytes.
+    //
+    {
+        xap::core::buffer::buffer_stats_reset();
+        const uint64_t live =
+            xap::core::buffer::buffer_stats_get_snapshot().live_bytes;
+        {
+            xap::core::buffer::Buffer first(1000U);
+            xap::core::buffer::Buffer second(500U);
+        }
+        {
+            xap::core::buffer::Buffer third(200U);
+        }
+        xap::core::buffer::BufferStats stats =
+            xap::core::buffer::buffer_stats_get_snapshot();
+        xap::test::assert_ok(
+            stats.live_bytes == live &&
+            stats.peak_live_bytes == live + 1500U,
+            "Case 4: invalid peak live bytes."
+        );
+
+        xap::core::buffer::buffer_stats_reset();
+        stats = xap::core::buffer::buffer_stats_get_snapshot();
+        xap::test::assert_ok(
+            stats.allocations == 0U &&
+            stats.peak_live_bytes == stats.live_bytes,
+            "Case 4: counters were not reset."
+        );
+    }
+
+    //
+    //  Case 5: export hook.
+    //
+    {
+        xap::core::buffer::buffer_stats_set_hook(stats_test_hook, nullptr);
+        xap::core::buffer::buffer_stats_reset();
+        {
+            xap::core::buffer::Buffer buffer(64U);
+        }
+        xap::core::buffer::buffer_stats_flush();
+        xap::test::assert_ok(
+            g_hook_calls == 1U &&
+            g_hook_stats.allocations == 1U &&
+            g_hook_stats.allocated_bytes == 64U,
+            "Case 5: invalid flushed counters."
+        );
+        xap::test::assert_equal<uint64_t>(
+            xap::core::buffer::buffer_stats_get_snapshot().allocations,
+            0U,
+            "Case 5: counters were not reset after flush."
+        );
+
+        //  The counters of a thread are flushed when it exits.
+        std::thread worker([]() {
+            const uint8_t raw[] = {1, 2, 3};
+            xap::core::buffer::Buffer buffer(raw, sizeof(raw));
+        });
+        worker.join();
+        xap::test::assert_ok(
+            g_hook_calls == 2U &&
+            g_hook_stats.allocations == 2U &&
+            g_hook_stats.allocated_bytes == 67U &&
+            g_hook_stats.copied_bytes == 3U,
+            "Case 5: counters of the exited thread were not flushed."
+        );
+        xap::core::buffer::buffer_stats_set_hook(nullptr, nullptr);
+    }
+
+    return 0;
+}
@@ -0,0 +1,179 @@
+//
+//  Copyright 2019 - 2021 The XOrange Studio. All rights reserved.
+//  Use of this source code is governed by a BSD-style license that can be
+//  found in the LICENSE.md file.
+//
+
+//
+//  Imports.
+//
+#include "common.h"
+
+#include <xap/core/buffer/error.h>
+#include <xap/core/buffer/writer.h>
+#include <utility>
+
+//
+//  Entry.
+//
+int main() {
+    //
+    //  Case 1: typed values.
+    //
+    {
+        xap::core::buffer::BufferWriter writer;
+        writer.write_uint8(0x01U);
+        writer.write_uint16_be(0x0203U);
+        writer.write_uint16_le(0x0504U);
+        writer.write_uint32_be(0x06070809U);
+        writer.write_uint32_le(0x0D0C0B0AU);
+        writer.write_uint64_be(0x0E0F101112131415ULL);
+        writer.write_uint64_le(0x1D1C1B1A19181716ULL);
+        writer.write_float_be(1.0F);
+        writer.write_double_le(-2.0);
+        const uint8_t raw[] = {0xAA, 0xBB};
+        writer.write_bytes(raw, sizeof(raw));
+        writer.write_bytes(xap::core::buffer::Buffer(raw, 1U));
+
+        xap::core::buffer::Buffer result = writer.finish();
+        xap::test::assert_equal<size_t>(
+            result.get_length(),
+            44U,
+            "Case 1: invalid length."
+        );
+        for (size_t i = 0U; i < 29U; ++i) {
+            xap::test::assert_equal<uint8_t>(
+                result[i],
+                static_cast<uint8_t>(i + 1U),
+                "Case 1: invalid integer bytes."
+            );
+        }
+        xap::test::assert_ok(
+            result.read_float_be(29U) == 1.0F &&
+            result.read_double_le(33U) == -2.0,
+            "Case 1: invalid float-point values."
+        );
+        xap::test::assert_ok(
+            result[41U] == 0xAAU &&
+            result[42U] == 0xBBU &&
+            result[43U] == 0xAAU,
+            "Case 1: invalid raw bytes."
+        );
+        xap::test::assert_equal<size_t>(
+            writer.get_length(),
+            0U,
+            "Case 1: writer not empty after finished."
+        );
+    }
+
+    //
+    //  Case 2: growth, reserve and finish without copying.
+    //
+    {
+        xap::core::buffer::BufferWriter writer(4U);
+        xap::test::assert_equal<size_t>(
+            writer.get_capacity(),
+            4U,
+            "Case 2: invalid initial capacity."
+        );
+        for (size_t i = 0U; i < 1000U; ++i) {
+            writer.write_uint8(static_cast<uint8_t>(i & 0xFFU));
+        }
+        xap::test::assert_ok(
+            writer.get_capacity() >= 1000U && writer.get_capacity() < 4096U,
+            "Case 2: invalid grown capacity."
+        );
+        writer.reserve(8192U);
+        xap::test::assert_equal<size_t>(
+            writer.get_capacity(),
+            8192U,
+            "Case 2: invalid reserved capacity."
+        );
+
+        xap::core::buffer::BufferWriter copied(writer);
+        copied.patch_uint8(0xFFU, 0U);
+        xap::core::buffer::Buffer result = writer.finish();
+        xap::test::assert_ok(
+            result.get_length() == 1000U &&
+            result[0U] == 0x00U &&
+            result[999U] == static_cast<uint8_t>(999U & 0xFFU),
+            "Case 2: invalid written bytes."
+        );
+        xap::test::assert_ok(
+            result.is_unique(),
+            "Case 2: storage still referenced by writer."
+        );
+
+        xap::core::buffer::BufferWriter moved(std::move(copied));
+        xap::test::assert_ok(
+            moved.get_length() == 1000U && copied.get_length() == 0U,
+            "Case 2: invalid moved writer."
+        );
+        moved.clear();
+        xap::test::assert_equal<size_t>(
+            moved.finish().get_length(),
+            0U,
+            "Case 2: cleared writer not empty."
+        );
+    }
+
+    //
+    //  Case 3: back-patching.
+    //
+    {
+        xap::core::buffer::BufferWriter writer;
+        const size_t length_offset = writer.skip(4U);
+        writer.write_uint16_be(0x1234U);
+        writer.write_uint32_le(0x56789ABCU);
+        writer.patch_uint32_be(
+            static_cast<uint32_t>(writer.get_length() - 4U),
+            length_offset
+        );
+        writer.patch_uint16_le(0x1234U, 4U);
+        xap::test::assert_throw<xap::core::buffer::BufferException>(
+            [&]() {
+                writer.patch_uint32_le(0U, 7U);
+            },
+            "Case 3: patched out of range."
+        );
+
+        xap::core::buffer::Buffer result = writer.finish();
+        xap::test::assert_ok(
+            result.read_uint32_be(0U) == 6U &&
+            result.read_uint16_le(4U) == 0x1234U &&
+            result.read_uint32_le(6U) == 0x56789ABCU,
+            "Case 3: invalid patched bytes."
+        );
+    }
+
+    //
+    //  Case 4: varints.
+    //
+    {
+        xap::core::buffer::BufferWriter writer;
+        writer.write_varint(0U);
+        writer.write_varint(127U);
+        writer.write_varint(300U);
+        writer.write_varint(UINT64_MAX);
+        writer.write_varint_signed(-1);
+        writer.write_varint_signed(1);
+        writer.write_varint_signed(-64);
+        xap::core::buffer::Buffer result = writer.finish();
+
+        const uint8_t expect[] = {
+            0x00,
+            0x7F,
+            0xAC, 0x02,
+            0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01,
+            0x01,
+            0x02,
+            0x7F
+        };
+        xap::test::assert_ok(
+            result == xap::core::buffer::Buffer(expect, sizeof(expect)),
+            "Case 4: invalid varint bytes."
+        );
+    }
+
+    return 0;
+}